@@ -68,7 +68,7 @@ namespace Auth
 
                 // Start the handshake timeout
                 auto self1 = shared_from_this();
-                m_handshakeTimeoutTimer.expires_after(std::chrono::milliseconds(Server::Instance().GetSettings().HANDSHAKING_AND_IDLE_TIMEOUT_MS));
+                m_handshakeTimeoutTimer.expires_after(std::chrono::milliseconds(Server::Instance().GetSettings().HANDSHAKING_AND_IDLE_TIMEOUT_MS.Get()));
                 m_handshakeTimeoutTimer.async_wait([this, self1](boost::system::error_code const& ec) { HandshakeTimeoutHandler(ec); });
 
                 auto self2 = shared_from_this();
@@ -87,7 +87,7 @@ namespace Auth
                         {
                             if (ec)
                             {
-                                LOG_ERROR("Error during handshake: {}", ec.what());
+                                MLOG_ERROR(NETWORK, "Error during handshake: {}", ec.what());
                             }
 
                             CloseSocket();
@@ -109,10 +109,10 @@ namespace Auth
         else if (m_UnderlyingState == UnderlyingState::CONNECTED)
         {
             // Check for connected timeout
-            if (now - m_lastActivity > std::chrono::milliseconds(Server::Instance().GetSettings().CONNECTED_AND_IDLE_TIMEOUT_MS))
+            if (now - m_lastActivity > std::chrono::milliseconds(Server::Instance().GetSettings().CONNECTED_AND_IDLE_TIMEOUT_MS.Get()))
             {
                 // Kick this client for inactivity
-                LOG_DEBUG("Kicking a client for connected-inactivity.");
+                MLOG_DEBUG(NETWORK, "Kicking a client for connected-inactivity.");
                 CloseSocket();
             }
         }
@@ -129,14 +129,14 @@ namespace Auth
         if (m_UnderlyingState == UnderlyingState::HANDSHAKING)
         {
             m_handshakeTimedout = true;
-            LOG_DEBUG("Kicking a client for handshake-inactivity.");
+            MLOG_DEBUG(NETWORK, "Kicking a client for handshake-inactivity.");
             CloseSocket();
         }
     }
 
     int AuthSession::AsyncReadCallback()
     {
-        LOG_DEBUG("AuthSession ReadCallback");
+        MLOG_DEBUG(NETWORK, "AuthSession ReadCallback");
 
         NetworkMessage& packet = m_inBuffer;
 
@@ -148,7 +148,7 @@ namespace Auth
             if (it == Handlers.end())
             {
                 // Discard packet, nothing we should handle
-                LOG_DEBUG("Discarding the packet CMD: '{}' and disconnecting the client...", cmd);
+                MLOG_DEBUG(NETWORK, "Discarding the packet CMD: '{}' and disconnecting the client...", cmd);
                 packet.Clear();
                 return -1;
                 // No tolerance for the Auth server. For WorldServer we may have some tolerance for messages that gets corrupted in flight
@@ -157,7 +157,7 @@ namespace Auth
             // Check if the current cmd matches our state
             if (m_status != it->second.status)
             {
-                LOG_WARNING("Status mismatch for user: {}. Status is '{}' but should have been '{}'. Closing the connection...", m_data.username, static_cast<int>(m_status), static_cast<int>(it->second.status));
+                MLOG_WARNING(NETWORK, "Status mismatch for user: {}. Status is '{}' but should have been '{}'. Closing the connection...", m_data.username, static_cast<int>(m_status), static_cast<int>(it->second.status));
                 return -1;
             }
 
@@ -194,7 +194,7 @@ namespace Auth
             if (++m_packetsProcessed > MAX_PACKETS_EXCHANGE_PER_CLIENT)
             {
                 // We got more packets than we were anticipating for a login
-                LOG_DEBUG("MAX_PACKETS_EXCHANGE_PER_CLIENT reached, kicking the client...");
+                MLOG_DEBUG(NETWORK, "MAX_PACKETS_EXCHANGE_PER_CLIENT reached, kicking the client...");
                 packet.Clear();
                 return -1;
             }
@@ -204,24 +204,24 @@ namespace Auth
                 // Call the Handler's function and ensure it returns true
                 if (!(*this.*it->second.handler)())
                 {
-                    LOG_DEBUG("Executing handler returned false for Packet ID: {} - Username: {}", cmd, m_data.username);
+                    MLOG_DEBUG(NETWORK, "Executing handler returned false for Packet ID: {} - Username: {}", cmd, m_data.username);
                     return -1;
                 }
             }
             // Exceptions caught during callback handling must close the socket
             catch (const mysqlx::Error& err)
             {
-                LOG_CRITICAL("Exception caught during callback handling. MySQL Error: {}", err.what());
+                MLOG_CRITICAL(NETWORK, "Exception caught during callback handling. MySQL Error: {}", err.what());
                 return -1;
             }
             catch (const std::exception& err)
             {
-                LOG_CRITICAL("Exception caught during callback handling. Standard Exception: {}", err.what());
+                MLOG_CRITICAL(NETWORK, "Exception caught during callback handling. Standard Exception: {}", err.what());
                 return -1;
             }
             catch (...)
             {
-                LOG_CRITICAL("Exception caught during callback handling. Unknown exception.");
+                MLOG_CRITICAL(NETWORK, "Exception caught during callback handling. Unknown exception.");
                 return -1;
             }
 
@@ -240,7 +240,7 @@ namespace Auth
 
         if (m_closeAfterSend && m_outQueue.size() == 0)
         {
-            LOG_DEBUG("Send Callback called on m_closeAfterSend.");
+            MLOG_DEBUG(NETWORK, "Send Callback called on m_closeAfterSend.");
             CloseSocket();
         }
     }
@@ -279,7 +279,7 @@ namespace Auth
         // Check version
         if (m_data.versionMajor == serverSettings.CLIENT_VERSION_MAJOR && m_data.versionMinor == serverSettings.CLIENT_VERSION_MINOR && m_data.versionRevision == serverSettings.CLIENT_VERSION_REVISION)
         {
-            LOG_DEBUG("Handling AuthLoginInfo for user: {}", m_data.username);
+            MLOG_DEBUG(NETWORK, "Handling AuthLoginInfo for user: {}", m_data.username);
             m_status = SocketStatus::LOGIN_ATTEMPT; // this will flag this client as someone who already sent a GATHER_INFO, so if the same client sends the same packet again, we'll have a status mismatch
 
             // Proof of Work generation
@@ -346,13 +346,13 @@ namespace Auth
             if (!std::isalnum(static_cast<unsigned char>(pcktData->password[i])))
                 return false;
 
-        LOG_DEBUG("Handling AuthLoginProof for user {}", m_data.username);
+        MLOG_DEBUG(NETWORK, "Handling AuthLoginProof for user {}", m_data.username);
         m_status = SocketStatus::LOGIN_ATTEMPT_PENDING;
 
         // Check challenge first
         if (!VerifyProofOfWork(&m_data.challenge[0], &pcktData->answer, m_data.difficulty))
         {
-            LOG_DEBUG("VerifyProofOfWork failed for user {}", m_data.username);
+            MLOG_DEBUG(NETWORK, "VerifyProofOfWork failed for user {}", m_data.username);
 
             m_closeAfterSend = true;
             Packet reply;
@@ -406,12 +406,12 @@ namespace Auth
 
         if (ec != 0)
         {
-            LOG_DEBUG("DBCallback_AuthLoginProofPacket's query returned an error. There's no way to continue authentication. Dropping socket.");
+            MLOG_DEBUG(NETWORK, "DBCallback_AuthLoginProofPacket's query returned an error. There's no way to continue authentication. Dropping socket.");
             CloseSocket();
             return false;
         }
 
-        LOG_DEBUG("Handling DBCallback_AuthLoginProofPacket for user {}!!", m_data.username);
+        MLOG_DEBUG(NETWORK, "Handling DBCallback_AuthLoginProofPacket for user {}!!", m_data.username);
 
         // DB callbacks should also update last activity
         m_lastActivity = std::chrono::steady_clock::now();
@@ -424,7 +424,7 @@ namespace Auth
             // We do a fake hash just like the else below, and just call HandlePasswordHashResult(false).
             // This would prevent users enumeration via failed attempts, but would triggers useless crypto_pwhash_str_verify - TODO needs to estimate the performances savings
             // Instead of actually performing a crypto_pwhash_str_verify we could just delay the response by a random value of ms in an interval [x,y] estimated via real hash execution times
-            LOG_CRITICAL("Account {} doesn't exist.", m_data.username);
+            MLOG_CRITICAL(NETWORK, "Account {} doesn't exist.", m_data.username);
             std::string hash = "$argon2id$v=19$m=65536,t=2,p=1$CjmAucKFN9/a9Kfj0bFrKw$WaopYKnajv9K6GRfwo0st3sp9xOCDBWdV51s8N5BAYg"; // TODO store this somewhere instead of allocating it each time?
             std::string pass = "thisisapass";
             std::weak_ptr<AuthSession> weakSelf = shared_from_this();
@@ -447,7 +447,7 @@ namespace Auth
             // TODO manage in RAM password properly
             m_data.accountID = row[0].get<uint32_t>();
 
-            LOG_INFO("Account {} has DB AccountID: {}.", m_data.username, m_data.accountID);
+            MLOG_INFO(NETWORK, "Account {} has DB AccountID: {}.", m_data.username, m_data.accountID);
 
             std::string hash = row[1].get<std::string>();
             std::string pass = m_data.pass;
@@ -486,7 +486,7 @@ namespace Auth
         auto& dbworker = Server::Instance().GetLoginDBWPool();
         if (!authenticated)
         {
-            LOG_INFO("User {} tried to send proof with a wrong password.", this->GetRemoteAddressAndPort());
+            MLOG_INFO(NETWORK, "User {} tried to send proof with a wrong password.", this->GetRemoteAddressAndPort());
 
             // TODO also make this a toggleable in config settings, for now we avoid log only on the fake-hash path
             if (!preventLog)
@@ -495,6 +495,7 @@ namespace Auth
                 {
                     DBRequest req(m_ioContextRef, true);
                     req.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::INS_LOG_WRONG_PASSWORD), {this->GetRemoteAddressAndPort(), m_data.username, "WRONG_PASSWORD"} });
+                    req.m_priority = DBRequestPriority::BACKGROUND;
                     dbworker.TryEnqueue(std::move(req));
                 }
             }
@@ -518,7 +519,7 @@ namespace Auth
 
             m_data.iv.ResetCounter();
 
-            LOG_DEBUG("Client's IV Random Prefix: {} | Server's IV Random Prefix: {}", m_data.randIVPrefix, m_data.iv.prefix);
+            MLOG_DEBUG(NETWORK, "Client's IV Random Prefix: {} | Server's IV Random Prefix: {}", m_data.randIVPrefix, m_data.iv.prefix);
 
             // Calculate a random session key
             m_data.sessionKey = AES::GenerateSessionKey();
@@ -531,7 +532,7 @@ namespace Auth
             }
             std::string sessionStr = sessionStrStream.str();
 
-            LOG_DEBUG("Session key for user {} is {}.", m_data.username, sessionStr);
+            MLOG_DEBUG(NETWORK, "Session key for user {} is {}.", m_data.username, sessionStr);
 
             // Write session key to packet
             for (int i = 0; i < AES_128_KEY_SIZE; ++i)
@@ -547,11 +548,24 @@ namespace Auth
                 req.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::DEL_PREV_SESSIONS),  {m_data.accountID} });
                 req.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::INS_NEW_SESSION),    {m_data.accountID, mysqlx::bytes(m_data.sessionKey.data(), m_data.sessionKey.size()), this->GetRemoteAddress(), mysqlx::bytes(m_data.greetCode.data(), m_data.greetCode.size())} });
                 req.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::UPD_ON_LOGIN),       {1, Utility::time_stamp(), m_data.accountID} });
+                req.m_orderingKey = m_data.accountID; // two logins of the same account must replace the sessions in order
+
+                // Hand the session to the NECROWorld on this host once it's committed, it will find it there before it can find it on the DB.
+                // Sent from the DBWorker thread, so the world never gets a greetcode that's not on the DB yet (its invalidation would miss it)
+                SessionKeyHandoffSender& handoff = Server::Instance().GetSessionKeyHandoff();
+                if (handoff.IsOpen())
+                {
+                    req.m_completionFunc = [&handoff, accountID = m_data.accountID, greetCode = m_data.greetCode, sessionKey = m_data.sessionKey](uint32_t ec)
+                        {
+                            if (ec == static_cast<uint32_t>(DBRequestError::NONE))
+                                handoff.Send(accountID, greetCode, sessionKey);
+                        };
+                }
 
                 // Handle failure, this is posted on this io_context from the cryptoThreads so return false won't close the socket
                 if (!dbworker.TryEnqueue(std::move(req)))
                 {
-                    LOG_DEBUG("DBWorker was full after password hash verification for {}.", m_data.username);
+                    MLOG_DEBUG(NETWORK, "DBWorker was full after password hash verification for {}.", m_data.username);
                     CloseSocket();
                     return false;
                 }
@@ -592,13 +606,13 @@ namespace Auth
             uint8_t ipAddr[4];
             if (inet_pton(AF_INET, realms[i].ip.c_str(), ipAddr) != 1)
             {
-                LOG_ERROR("Invalid IPv4 for realm '{}', skipping it.", realms[i].name);
+                MLOG_ERROR(NETWORK, "Invalid IPv4 for realm '{}', skipping it.", realms[i].name);
                 continue;
             }
 
             if (realms[i].name.size() > REALM_MAX_NAME_SIZE)
             {
-                LOG_ERROR("Realm name too long for '{}', skipping it.", realms[i].name);
+                MLOG_ERROR(NETWORK, "Realm name too long for '{}', skipping it.", realms[i].name);
                 continue;
             }
 
@@ -623,7 +637,7 @@ namespace Auth
         NetworkMessage m(std::move(p));
         QueuePacket(std::move(m));
 
-        LOG_OK("HandleGatherRealmlistPacket: sent {} realm(s)", realmCount);
+        MLOG_OK(NETWORK, "HandleGatherRealmlistPacket: sent {} realm(s)", realmCount);
         return true;
     }
 }
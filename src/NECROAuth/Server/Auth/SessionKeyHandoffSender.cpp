@@ -0,0 +1,67 @@
+#include "SessionKeyHandoffSender.h"
+
+#include <ctime>
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+namespace Auth
+{
+	int SessionKeyHandoffSender::Open(boost::asio::io_context& io, uint16_t port, const std::string& secret)
+	{
+		boost::system::error_code ec;
+
+		auto socket = std::make_unique<boost::asio::ip::udp::socket>(io);
+		socket->open(boost::asio::ip::udp::v4(), ec);
+		if (!ec)
+			socket->non_blocking(true, ec);
+
+		if (ec)
+		{
+			MLOG_ERROR(NETWORK, "Could not open the session key handoff socket: {}", ec.message());
+			return -1;
+		}
+
+		m_endpoint = boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::loopback(), port);
+		m_secret = secret;
+		m_socket = std::move(socket);
+
+		MLOG_OK(NETWORK, "Pushing the issued session keys to 127.0.0.1:{}.", port);
+		return 0;
+	}
+
+	void SessionKeyHandoffSender::Close()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_socket)
+			return;
+
+		boost::system::error_code ec;
+		m_socket->close(ec);
+		m_socket.reset();
+	}
+
+	void SessionKeyHandoffSender::Send(uint32_t accountID, const std::array<uint8_t, AES_128_KEY_SIZE>& greetCode, const std::array<uint8_t, AES_128_KEY_SIZE>& sessionKey)
+	{
+		SessionKeyHandoffMessage msg;
+		msg.accountID = accountID;
+		msg.issuedAt = static_cast<uint64_t>(time(nullptr));
+		msg.greetCode = greetCode;
+		msg.sessionKey = sessionKey;
+
+		uint8_t buffer[SESSION_KEY_HANDOFF_MESSAGE_SIZE];
+		msg.Serialize(m_secret, buffer);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_socket)
+			return;
+
+		boost::system::error_code ec;
+		m_socket->send_to(boost::asio::buffer(buffer, sizeof(buffer)), m_endpoint, 0, ec);
+		if (ec)
+			MLOG_DEBUG(NETWORK, "Session key handoff for account {} not sent ({}), the world will read it from MySQL.", accountID, ec.message());
+	}
+}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <array>
+#include <mutex>
+#include <memory>
+
+#include <boost/asio.hpp>
+
+#include "SessionKeyHandoff.h"
+
+namespace NECRO
+{
+namespace Auth
+{
+	//-----------------------------------------------------------------------------------------------------
+	// Pushes the sessions issued by the AuthSessions to the NECROWorld on this host (see SessionKeyHandoff.h).
+	// Send is called from the DBWorker threads once the session is committed on MySQL, the socket is non-blocking
+	// and a datagram that can't be sent right away is dropped (the world falls back to MySQL).
+	//-----------------------------------------------------------------------------------------------------
+	class SessionKeyHandoffSender
+	{
+	private:
+		std::mutex										m_mutex;
+		std::unique_ptr<boost::asio::ip::udp::socket>	m_socket;
+		boost::asio::ip::udp::endpoint					m_endpoint;
+		std::string										m_secret;
+
+	public:
+		int		Open(boost::asio::io_context& io, uint16_t port, const std::string& secret);
+		void	Close();
+
+		bool	IsOpen() const { return m_socket != nullptr; }
+
+		void	Send(uint32_t accountID, const std::array<uint8_t, AES_128_KEY_SIZE>& greetCode, const std::array<uint8_t, AES_128_KEY_SIZE>& sessionKey);
+	};
+}
+}
@@ -51,12 +51,12 @@ namespace Auth
 
 			bool couldBeSpam = false;
 
-			if (config.ENABLE_SPAM_PREVENTION)
+			if (config.ENABLE_SPAM_PREVENTION.Get())
 				couldBeSpam = DoIPSpamPrevention(clientIP);
 
 			if (!couldBeSpam)
 			{
-				LOG_DEBUG("New client accepted! Put into {}", tID);
+				MLOG_DEBUG(NETWORK, "New client accepted! Put into {}", tID);
 				std::shared_ptr<AuthSession> newConn = std::make_shared<AuthSession>(std::move(sock), m_networkThreads[tID]->GetSSLContext());
 
 				m_networkThreads[tID]->QueueNewSocket(newConn);
@@ -64,14 +64,14 @@ namespace Auth
 			else
 			{
 				// TODO if iprequestmap size fills, this is spammed as well
-				LOG_DEBUG("IP {} made too many requests {}! Dropping connection.", clientIP, config.MAX_CONNECTION_ATTEMPTS_PER_INTERVAL);
+				MLOG_DEBUG(NETWORK, "IP {} made too many requests {}! Dropping connection.", clientIP, config.MAX_CONNECTION_ATTEMPTS_PER_INTERVAL.Get());
 				sock.close(closeEc);
 			}
 		}
 		else
 		{
 			// MAX_CONNECTED_CLIENTS_PER_THREAD reached
-			LOG_DEBUG("MAX_CONNECTED_CLIENTS_PER_THREAD reached! Dropping connection.");
+			MLOG_DEBUG(NETWORK, "MAX_CONNECTED_CLIENTS_PER_THREAD reached! Dropping connection.");
 			sock.close(closeEc);
 		}
 
@@ -80,7 +80,7 @@ namespace Auth
 
 	void SocketManager::OnAcceptError(boost::system::error_code ec, int tID)
 	{
-		LOG_ERROR("Accept failed on tID {}: {}. Calling SocketManagerHandler again.", tID, ec.what());
+		MLOG_ERROR(NETWORK, "Accept failed on tID {}: {}. Calling SocketManagerHandler again.", tID, ec.what());
 
 		// TODO Maybe sleep a bit?
 
@@ -97,7 +97,7 @@ namespace Auth
 		if (it != m_ipRequestMap.end())
 		{
 			// If the number of tries exceed the limit, block this request
-			if (it->second.tries >= config.MAX_CONNECTION_ATTEMPTS_PER_INTERVAL)
+			if (it->second.tries >= config.MAX_CONNECTION_ATTEMPTS_PER_INTERVAL.Get())
 				return true;
 			else
 			{
@@ -6,6 +6,8 @@
 #include "Packet.h"
 
 #include <memory>
+#include <fstream>
+#include <cstdio>
 #include <openssl/ssl.h>
 
 
@@ -34,13 +36,23 @@ namespace Auth
 	{
 		auto& conf = Config::Instance();
 
-		// Apply config
-		ConsoleLogger::Instance().m_logEnabled = conf.GetBool("ConsoleLoggingEnabled", true);
-		FileLogger::Instance().m_logEnabled = conf.GetBool("FileLoggingEnabled", true);
+		// Apply config, logging and the other settings that can change while running
+		ApplyLiveSettings(conf, false);
 
-		// Initialize the log levels
-		ConsoleLogger::Instance().m_logEnabledSet = std::bitset<static_cast<int>(Logger::LogLevel::LAST_VALUE)>(conf.GetString("ConsoleLoggingLevel", "111111"));
-		FileLogger::Instance().m_logEnabledSet = std::bitset<static_cast<int>(Logger::LogLevel::LAST_VALUE)>(conf.GetString("FileLoggingLevel", "111111"));
+		// Log lines are written by the LogBackend thread, when a thread's ring is full its lines are dropped (and counted) or it waits
+		if (conf.GetBool("AsyncLoggingEnabled", true))
+		{
+			LogOverflowPolicy policy = conf.GetString("AsyncLoggingOverflowPolicy", "drop") == "block" ? LogOverflowPolicy::BLOCK : LogOverflowPolicy::DROP;
+			LogBackend::Instance().Start(conf.GetInt("AsyncLoggingRingSize", 8192), policy, conf.GetInt("AsyncLoggingFlushIntervalMs", 1000));
+		}
+
+		// The file lines are recorded unformatted in the binary log instead, decoded offline with --decode-log
+		if (conf.GetBool("BinaryLoggingEnabled", false))
+		{
+			std::string binaryLogFile = conf.GetString("BinaryLoggingFile", "authserver.nlog");
+			if (!BinaryLog::Instance().Open(binaryLogFile, conf.GetInt("BinaryLoggingFlushIntervalMs", 1000)))
+				LOG_ERROR("Could not open the binary log '{}', the file lines stay in text.", binaryLogFile);
+		}
 
 		m_configSettings.CLIENT_VERSION_MAJOR = conf.GetInt("CLIENT_VERSION_MAJOR", 1);
 		m_configSettings.CLIENT_VERSION_MINOR = conf.GetInt("CLIENT_VERSION_MINOR", 0);
@@ -48,28 +60,109 @@ namespace Auth
 
 		m_configSettings.DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS = conf.GetInt("DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS", 60000);
 		m_configSettings.IP_BASED_REQUEST_CLEANUP_INTERVAL_MS = conf.GetInt("IP_BASED_REQUEST_CLEANUP_INTERVAL_MS", 120000);
+		m_configSettings.DATABASE_STATS_REPORT_INTERVAL_MS = conf.GetInt("DATABASE_STATS_REPORT_INTERVAL_MS", 60000);
+		m_configSettings.DATABASE_STATS_FILE = conf.GetString("DATABASE_STATS_FILE", "");
 
 		m_configSettings.MAX_CONNECTED_CLIENTS_PER_THREAD = conf.GetInt("MAX_CONNECTED_CLIENTS_PER_THREAD", -1);
 		m_configSettings.MANAGER_SERVER_PORT = conf.GetInt("MANAGER_SERVER_PORT", 61531);
 		m_configSettings.NETWORK_THREADS_COUNT = conf.GetInt("NETWORK_THREADS_COUNT", -1);
 		m_configSettings.CRYPTO_THREADS_COUNT = conf.GetInt("CRYPTO_THREADS_COUNT", 1);
 		m_configSettings.LOGIN_DATABASE_THREADS_COUNT = conf.GetInt("LOGIN_DATABASE_THREADS_COUNT", 1);
+		m_configSettings.LOGIN_DATABASE_MAX_THREADS_COUNT = conf.GetInt("LOGIN_DATABASE_MAX_THREADS_COUNT", -1);
+		m_configSettings.DATABASE_ELASTIC_GROW_QUEUE_DEPTH = conf.GetInt("DATABASE_ELASTIC_GROW_QUEUE_DEPTH", 256);
+		m_configSettings.DATABASE_ELASTIC_GROW_WAIT_MS = conf.GetInt("DATABASE_ELASTIC_GROW_WAIT_MS", 200);
+		m_configSettings.DATABASE_ELASTIC_SHRINK_IDLE_MS = conf.GetInt("DATABASE_ELASTIC_SHRINK_IDLE_MS", 300000);
 
 		// Spam prevention
-		m_configSettings.ENABLE_SPAM_PREVENTION = conf.GetInt("ENABLE_SPAM_PREVENTION", 1);
 		m_configSettings.CONNECTION_ATTEMPT_CLEANUP_INTERVAL_MIN = conf.GetInt("CONNECTION_ATTEMPT_CLEANUP_INTERVAL_MIN", 1);
-		m_configSettings.MAX_CONNECTION_ATTEMPTS_PER_INTERVAL = conf.GetInt("MAX_CONNECTION_ATTEMPTS_PER_INTERVAL", 10);
-
-		m_configSettings.CONNECTED_AND_IDLE_TIMEOUT_MS = conf.GetInt("CONNECTED_AND_IDLE_TIMEOUT_MS", 10000);
-		m_configSettings.HANDSHAKING_AND_IDLE_TIMEOUT_MS = conf.GetInt("HANDSHAKING_AND_IDLE_TIMEOUT_MS", 10000);
 
 		// Realmlist
 		m_configSettings.REALMLIST_UPDATE_INTERVAL_MS = conf.GetInt("REALMLIST_UPDATE_INTERVAL_MS", 60000);
 
+		m_configSettings.SESSION_KEY_HANDOFF_PORT = conf.GetInt("SESSION_KEY_HANDOFF_PORT", 61600);
+		m_configSettings.SESSION_KEY_HANDOFF_SECRET = conf.GetString("SESSION_KEY_HANDOFF_SECRET", "");
+
+		m_configSettings.CONFIG_RELOAD_CHECK_INTERVAL_MS = conf.GetInt("CONFIG_RELOAD_CHECK_INTERVAL_MS", 5000);
+
 		// DB Connection
 		m_configSettings.LOGIN_DATABASE_URI = conf.GetString("LOGIN_DATABASE_URI", "");
 	}
 
+	// ------------------------------------------------------------------------------------------------------------------
+	// Settings that can be tuned while the server is running, applied at startup and by every config reload.
+	// Invalid values are rejected and the current ones are kept
+	// ------------------------------------------------------------------------------------------------------------------
+	bool Server::ApplyLiveSettings(Config& conf, bool reload)
+	{
+		bool valid = true;
+
+		// A missing key keeps the current value, like the LiveSettings
+		ConsoleLogger::Instance().m_logEnabled = conf.GetBool("ConsoleLoggingEnabled", ConsoleLogger::Instance().m_logEnabled.load());
+		FileLogger::Instance().m_logEnabled = conf.GetBool("FileLoggingEnabled", FileLogger::Instance().m_logEnabled.load());
+
+		// Log levels of the Loggers
+		Logger::LogLevels levels = ConsoleLogger::Instance().GetEnabledLevels();
+		if (LoadLogLevels(conf, "ConsoleLoggingLevel", levels))
+			ConsoleLogger::Instance().SetEnabledLevels(levels);
+		else
+			valid = false;
+
+		levels = FileLogger::Instance().GetEnabledLevels();
+		if (LoadLogLevels(conf, "FileLoggingLevel", levels))
+			FileLogger::Instance().SetEnabledLevels(levels);
+		else
+			valid = false;
+
+		// Levels of the modules, on top of the ones of the Loggers (MLOG_ macros)
+		const std::pair<Logger::LogModule, const char*> moduleLevels[] = {
+			{ Logger::LogModule::NETWORK, "NetworkLoggingLevel" },
+			{ Logger::LogModule::DATABASE, "DatabaseLoggingLevel" }
+		};
+
+		for (const auto& m : moduleLevels)
+		{
+			levels = Logger::GetModuleLevels(m.first);
+			if (LoadLogLevels(conf, m.second, levels))
+				Logger::SetModuleLevels(m.first, levels);
+			else
+				valid = false;
+		}
+
+		valid &= m_configSettings.CONNECTED_AND_IDLE_TIMEOUT_MS.Load(conf, reload);
+		valid &= m_configSettings.HANDSHAKING_AND_IDLE_TIMEOUT_MS.Load(conf, reload);
+		valid &= m_configSettings.DATABASE_GROUP_COMMIT_MAX_BATCH.Load(conf, reload);
+		valid &= m_configSettings.DATABASE_GROUP_COMMIT_MAX_DELAY_MS.Load(conf, reload);
+		valid &= m_configSettings.ENABLE_SPAM_PREVENTION.Load(conf, reload);
+		valid &= m_configSettings.MAX_CONNECTION_ATTEMPTS_PER_INTERVAL.Load(conf, reload);
+
+		// At startup the pool is set up by Init, the DBWorkers pick the new values up on their next drain
+		if (reload)
+			m_loginDBPool.SetGroupCommit(m_configSettings.DATABASE_GROUP_COMMIT_MAX_BATCH.Get(), m_configSettings.DATABASE_GROUP_COMMIT_MAX_DELAY_MS.Get());
+
+		return valid;
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// Config hot reload: the file is read into its own Config (Config::Instance() keeps the startup values) and only the
+	// live settings are applied from it
+	// ------------------------------------------------------------------------------------------------------------------
+	bool Server::ReloadConfig()
+	{
+		Config conf;
+		if (!conf.Load(AUTH_CONFIG_FILE_PATH, false))
+		{
+			LOG_ERROR("[CONFIG] Could not reload {}.", AUTH_CONFIG_FILE_PATH);
+			return false;
+		}
+
+		if (ApplyLiveSettings(conf, true))
+			LOG_OK("[CONFIG] {} reloaded, live settings applied. The other settings need a restart.", AUTH_CONFIG_FILE_PATH);
+		else
+			LOG_WARNING("[CONFIG] {} reloaded, some live settings were rejected and kept their values.", AUTH_CONFIG_FILE_PATH);
+
+		return true;
+	}
+
 	int Server::Init()
 	{
 		m_isRunning = false;
@@ -119,11 +212,13 @@ namespace Auth
 			return -5;
 		}
 
-		if (m_loginDBPool.Setup(dbLoginThreadsCount, m_configSettings.LOGIN_DATABASE_URI) != 0)
+		if (m_loginDBPool.Setup(dbLoginThreadsCount, m_configSettings.LOGIN_DATABASE_URI, m_configSettings.LOGIN_DATABASE_MAX_THREADS_COUNT) != 0)
 		{
 			LOG_ERROR("Could not initialize m_loginDbWorker Pool, MySQL may be not running.");
 			return -6;
 		}
+		m_loginDBPool.SetGroupCommit(m_configSettings.DATABASE_GROUP_COMMIT_MAX_BATCH.Get(), m_configSettings.DATABASE_GROUP_COMMIT_MAX_DELAY_MS.Get());
+		m_loginDBPool.SetElasticThresholds(m_configSettings.DATABASE_ELASTIC_GROW_QUEUE_DEPTH, m_configSettings.DATABASE_ELASTIC_GROW_WAIT_MS, m_configSettings.DATABASE_ELASTIC_SHRINK_IDLE_MS);
 
 		if (m_loginDBPool.Start() != 0)
 		{
@@ -144,6 +239,10 @@ namespace Auth
 
 		m_socketManager = std::make_unique<SocketManager>(networkThreadsCount, m_ioContext, m_configSettings.MANAGER_SERVER_PORT);
 
+		// Optional, the NECROWorld reads the sessions from MySQL if it doesn't get them from here
+		if (!m_configSettings.SESSION_KEY_HANDOFF_SECRET.empty() && m_sessionKeyHandoff.Open(m_ioContext, m_configSettings.SESSION_KEY_HANDOFF_PORT, m_configSettings.SESSION_KEY_HANDOFF_SECRET) != 0)
+			LOG_WARNING("Session key handoff could not be started, the NECROWorld will read the sessions from MySQL.");
+
 		return 0;
 	}
 
@@ -171,6 +270,23 @@ namespace Auth
 		m_ipRequestCleanupTimer.expires_after(std::chrono::milliseconds(1));
 		m_ipRequestCleanupTimer.async_wait([this](boost::system::error_code const& ec) { IPRequestCleanupHandler(); });
 
+		// Post DB stats reports
+		if (m_configSettings.DATABASE_STATS_REPORT_INTERVAL_MS > 0)
+		{
+			m_databaseStatsTimer.expires_after(std::chrono::milliseconds(m_configSettings.DATABASE_STATS_REPORT_INTERVAL_MS));
+			m_databaseStatsTimer.async_wait([this](boost::system::error_code const& ec) { DatabaseStatsHandler(); });
+		}
+
+		// Watch the config file for the live settings
+		if (m_configSettings.CONFIG_RELOAD_CHECK_INTERVAL_MS > 0)
+		{
+			std::error_code err;
+			m_configWriteTime = std::filesystem::last_write_time(AUTH_CONFIG_FILE_PATH, err);
+
+			m_configReloadCheckTimer.expires_after(std::chrono::milliseconds(m_configSettings.CONFIG_RELOAD_CHECK_INTERVAL_MS));
+			m_configReloadCheckTimer.async_wait([this](boost::system::error_code const& ec) { ConfigReloadCheckHandler(); });
+		}
+
 		// Get realmlist straight away (DirectExecute)
 		{
 			DBRequest req(m_ioContext, false);
@@ -236,7 +352,15 @@ namespace Auth
 		m_socketManager->StopThreads();
 		m_socketManager->JoinThreads();
 
+		m_sessionKeyHandoff.Close();
+
 		LOG_OK("Shut down of the NECROAuth completed.");
+
+		// Last, so the shutdown logs of every thread are written too
+		BinaryLog::Instance().Close();
+
+		// Writes the last lines, logs are synchronous from here
+		LogBackend::Instance().Stop();
 		return 0;
 	}
 
@@ -249,9 +373,11 @@ namespace Auth
 		m_keepLoginDatabaseAliveTimer.expires_after(std::chrono::milliseconds(m_configSettings.DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS));
 		m_keepLoginDatabaseAliveTimer.async_wait([this](boost::system::error_code const& ec) { KeepDatabaseAliveHandler(); });
 
-		// Enqueue a keep alive packet
+		// Enqueue a keep alive packet, useless if it can't run before the next one
 		DBRequest keepAlivePacket(m_ioContext, true);
 		keepAlivePacket.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::KEEP_ALIVE), {} });
+		keepAlivePacket.m_priority = DBRequestPriority::MAINTENANCE;
+		keepAlivePacket.m_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_configSettings.DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS);
 		m_loginDBPool.EnqueueInAll(std::move(keepAlivePacket));
 
 		// Keep alive the direct connection as well
@@ -271,6 +397,50 @@ namespace Auth
 		m_socketManager->IPRequestMapCleanup();
 	}
 
+	void Server::DatabaseStatsHandler()
+	{
+		m_databaseStatsTimer.expires_after(std::chrono::milliseconds(m_configSettings.DATABASE_STATS_REPORT_INTERVAL_MS));
+		m_databaseStatsTimer.async_wait([this](boost::system::error_code const& ec) { DatabaseStatsHandler(); });
+
+		DBStatsExposition exposition;
+		m_loginDBPool.ReportStats("login", exposition);
+
+		if (m_configSettings.DATABASE_STATS_FILE.empty())
+			return;
+
+		// Write aside and rename, so the scraper never reads a half written file
+		const std::string tmpPath = m_configSettings.DATABASE_STATS_FILE + ".tmp";
+		{
+			std::ofstream file(tmpPath, std::ios::trunc);
+			if (!file.is_open())
+			{
+				LOG_WARNING("Could not write the DB stats file at: '{}'.", tmpPath);
+				return;
+			}
+			file << exposition.Render();
+		}
+
+		// rename replaces the file atomically on POSIX, Windows' fails if it exists
+#ifdef _WIN32
+		std::remove(m_configSettings.DATABASE_STATS_FILE.c_str());
+#endif
+		std::rename(tmpPath.c_str(), m_configSettings.DATABASE_STATS_FILE.c_str());
+	}
+
+	void Server::ConfigReloadCheckHandler()
+	{
+		m_configReloadCheckTimer.expires_after(std::chrono::milliseconds(m_configSettings.CONFIG_RELOAD_CHECK_INTERVAL_MS));
+		m_configReloadCheckTimer.async_wait([this](boost::system::error_code const& ec) { ConfigReloadCheckHandler(); });
+
+		std::error_code err;
+		std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(AUTH_CONFIG_FILE_PATH, err);
+		if (err || writeTime == m_configWriteTime)
+			return;
+
+		m_configWriteTime = writeTime;
+		ReloadConfig();
+	}
+
 	void Server::UpdateRealmlistHandler()
 	{
 		// LOG_DEBUG("UpdateRealmlistHandler...");
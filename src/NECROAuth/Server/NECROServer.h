@@ -1,10 +1,14 @@
 #pragma once
 
+#include <filesystem>
+
 #include <boost/asio.hpp>
 
 #include "Config.h"
+#include "LiveSetting.h"
 #include "ConsoleLogger.h"
 #include "FileLogger.h"
+#include "LogBackend.h"
 #include "SocketManager.h"
 
 #include "LoginDatabase.h"
@@ -12,6 +16,7 @@
 #include "AsioThreadPool.h"
 
 #include "RealmList.h"
+#include "SessionKeyHandoffSender.h"
 
 #define SODIUM_STATIC
 #include <sodium.h>
@@ -50,31 +55,47 @@ namespace Auth
 			// Handler updates
 			uint32_t DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS = 60000;
 			uint32_t IP_BASED_REQUEST_CLEANUP_INTERVAL_MS = 120000;
+			uint32_t DATABASE_STATS_REPORT_INTERVAL_MS = 60000;	// 0 disables the DB stats reports
+			std::string DATABASE_STATS_FILE;					// Prometheus text file rewritten at every report, empty to disable
 
 			// Server settings
 			uint16_t	MANAGER_SERVER_PORT = 61531;
 			int			MAX_CONNECTED_CLIENTS_PER_THREAD = -1;	//-1 equals to no check
 			int			NETWORK_THREADS_COUNT = -1;				//-1 equals to std::thread::hardware_concurrency()
-			uint32_t	CONNECTED_AND_IDLE_TIMEOUT_MS = 10000;	// After CONNECTED_AND_IDLE_TIMEOUT_MS, kick the client if he doesn't proceed with the communication
-			int			HANDSHAKING_AND_IDLE_TIMEOUT_MS = 10000;
+			LiveSetting<uint32_t>	CONNECTED_AND_IDLE_TIMEOUT_MS{ "CONNECTED_AND_IDLE_TIMEOUT_MS", 10000, 1000, 3600000 };	// After CONNECTED_AND_IDLE_TIMEOUT_MS, kick the client if he doesn't proceed with the communication
+			LiveSetting<uint32_t>	HANDSHAKING_AND_IDLE_TIMEOUT_MS{ "HANDSHAKING_AND_IDLE_TIMEOUT_MS", 10000, 1000, 3600000 };
 			int			CRYPTO_THREADS_COUNT = 1;
 			int			LOGIN_DATABASE_THREADS_COUNT = 1;
+			int			LOGIN_DATABASE_MAX_THREADS_COUNT = -1;	// -1 (or <= THREADS_COUNT) disables the elastic pool
+			int			DATABASE_ELASTIC_GROW_QUEUE_DEPTH = 256;
+			uint32_t	DATABASE_ELASTIC_GROW_WAIT_MS = 200;
+			uint32_t	DATABASE_ELASTIC_SHRINK_IDLE_MS = 300000;
+			LiveSetting<int>		DATABASE_GROUP_COMMIT_MAX_BATCH{ "DATABASE_GROUP_COMMIT_MAX_BATCH", 64, 1, 4096 };	// 1 disables the group commit of fire-and-forget requests
+			LiveSetting<uint32_t>	DATABASE_GROUP_COMMIT_MAX_DELAY_MS{ "DATABASE_GROUP_COMMIT_MAX_DELAY_MS", 5, 0, 1000 };
 
 			// Spam prevention
-			bool		ENABLE_SPAM_PREVENTION = 1;
-			uint32_t	CONNECTION_ATTEMPT_CLEANUP_INTERVAL_MIN = 1;
-			uint32_t	MAX_CONNECTION_ATTEMPTS_PER_INTERVAL = 10;
+			LiveSetting<bool>		ENABLE_SPAM_PREVENTION{ "ENABLE_SPAM_PREVENTION", true, false, true };
+			uint32_t				CONNECTION_ATTEMPT_CLEANUP_INTERVAL_MIN = 1;
+			LiveSetting<uint32_t>	MAX_CONNECTION_ATTEMPTS_PER_INTERVAL{ "MAX_CONNECTION_ATTEMPTS_PER_INTERVAL", 10, 1, 100000 };
 
 			// Realmlist
 			uint32_t REALMLIST_UPDATE_INTERVAL_MS = 60000;
 
+			// Session key handoff to the NECROWorld on this host, an empty secret disables it
+			uint16_t	SESSION_KEY_HANDOFF_PORT = 61600;
+			std::string	SESSION_KEY_HANDOFF_SECRET;
+
+			// The LiveSettings (and the log levels) are reloaded when the config file changes, checked every
+			// CONFIG_RELOAD_CHECK_INTERVAL_MS (0 disables it). The other settings need a restart
+			uint32_t	CONFIG_RELOAD_CHECK_INTERVAL_MS = 5000;
+
 			// DB Connection
 			std::string LOGIN_DATABASE_URI;
 		};
 
 	public:
 		Server() :
-			m_isRunning(false), m_keepLoginDatabaseAliveTimer(m_ioContext), m_ipRequestCleanupTimer(m_ioContext), m_realmlistUpdateTimer(m_ioContext)
+			m_isRunning(false), m_keepLoginDatabaseAliveTimer(m_ioContext), m_ipRequestCleanupTimer(m_ioContext), m_realmlistUpdateTimer(m_ioContext), m_databaseStatsTimer(m_ioContext), m_configReloadCheckTimer(m_ioContext)
 		{
 		}
 
@@ -97,15 +118,24 @@ namespace Auth
 		std::unique_ptr<SocketManager>	m_socketManager;
 
 		DatabaseWorkerPool<LoginDatabase> m_loginDBPool;
+		SessionKeyHandoffSender m_sessionKeyHandoff;
 
 		// Handlers on main ioContext 
 		boost::asio::steady_timer m_keepLoginDatabaseAliveTimer;
 		boost::asio::steady_timer m_ipRequestCleanupTimer;
 		boost::asio::steady_timer m_realmlistUpdateTimer;
+		boost::asio::steady_timer m_databaseStatsTimer;
+		boost::asio::steady_timer m_configReloadCheckTimer;
+		std::filesystem::file_time_type m_configWriteTime;
 
 		void KeepDatabaseAliveHandler();
 		void IPRequestCleanupHandler();
 		void UpdateRealmlistHandler();
+		void DatabaseStatsHandler();
+		void ConfigReloadCheckHandler();
+
+		// Settings that can change while running, false if any was rejected
+		bool ApplyLiveSettings(Config& conf, bool reload);
 
 	public:
 		DatabaseWorkerPool<LoginDatabase>& GetLoginDBWPool()
@@ -120,6 +150,9 @@ namespace Auth
 		void	Stop();
 		int		Shutdown();
 
+		// Reads the config file again and applies its LiveSettings and log levels, false if it couldn't be read
+		bool	ReloadConfig();
+
 
 		const ConfigSettings& GetSettings() const
 		{
@@ -130,6 +163,11 @@ namespace Auth
 		{
 			return m_cryptoThreads;
 		}
+
+		SessionKeyHandoffSender& GetSessionKeyHandoff()
+		{
+			return m_sessionKeyHandoff;
+		}
 	};
 }
 }
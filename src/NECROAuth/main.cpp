@@ -2,8 +2,28 @@
 
 #include "NECROServer.h"
 
-int main()
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char* argv[])
 {
+	// Offline decoding of a binary log: NECROAuth --decode-log <file> [output], the text goes to stdout without output
+	if (argc >= 3 && std::strcmp(argv[1], "--decode-log") == 0)
+	{
+		if (argc < 4)
+			return NECRO::BinaryLog::Decode(argv[2], std::cout);
+
+		std::ofstream out(argv[3]);
+		if (!out.is_open())
+		{
+			std::cerr << "Could not open the output file: " << argv[3] << std::endl;
+			return -1;
+		}
+
+		return NECRO::BinaryLog::Decode(argv[2], out);
+	}
+
 	auto& server = NECRO::Auth::Server::Instance();
 
 	if (server.Init() == 0)
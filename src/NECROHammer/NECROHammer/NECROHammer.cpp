@@ -55,8 +55,8 @@ namespace Hammer
 		ConsoleLogger::Instance().m_logEnabled = conf.GetBool("ConsoleLoggingEnabled", true);
 		FileLogger::Instance().m_logEnabled = conf.GetBool("FileLoggingEnabled", true);
 
-		ConsoleLogger::Instance().m_logEnabledSet = std::bitset<static_cast<int>(Logger::LogLevel::LAST_VALUE)>(conf.GetString("ConsoleLoggingLevel", "111111"));
-		FileLogger::Instance().m_logEnabledSet = std::bitset<static_cast<int>(Logger::LogLevel::LAST_VALUE)>(conf.GetString("FileLoggingLevel", "111111"));
+		ConsoleLogger::Instance().SetEnabledLevels(Logger::LogLevels(conf.GetString("ConsoleLoggingLevel", "111111")));
+		FileLogger::Instance().SetEnabledLevels(Logger::LogLevels(conf.GetString("FileLoggingLevel", "111111")));
 
 		m_configSettings.THREADS_COUNT = conf.GetInt("THREADS_COUNT", -1);
 	}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CharacterCache.h"
+
+namespace
+{
+    using namespace NECRO;
+    using namespace NECRO::World;
+
+    CharacterRow MakeRow(uint32_t charID, uint8_t level = 1)
+    {
+        CharacterRow row;
+        row.id = charID;
+        row.name = "char" + std::to_string(charID);
+        row.level = level;
+        return row;
+    }
+
+    bool IsCached(CharacterCache& cache, uint32_t accountID)
+    {
+        std::vector<CharacterRow> rows;
+        return cache.GetAccountCharacters(accountID, rows);
+    }
+
+    bool HasCharacter(CharacterCache& cache, uint32_t charID)
+    {
+        CharacterRow row;
+        return cache.GetCharacter(charID, row);
+    }
+}
+
+TEST(CharacterCache, PopulatedAccountIsServed)
+{
+    CharacterCache cache;
+    cache.Setup(4);
+
+    cache.PopulateAccount(1, { MakeRow(10), MakeRow(11) });
+
+    std::vector<CharacterRow> rows;
+    ASSERT_TRUE(cache.GetAccountCharacters(1, rows));
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].accountID, 1u);   // not selected by CHAR_SEL_ENUM, set by the cache
+
+    CharacterRow row;
+    ASSERT_TRUE(cache.GetCharacter(11, row));
+    EXPECT_EQ(row.accountID, 1u);
+    EXPECT_EQ(row.name, "char11");
+
+    // Empty accounts are cached too
+    cache.PopulateAccount(2, {});
+    ASSERT_TRUE(cache.GetAccountCharacters(2, rows));
+    EXPECT_TRUE(rows.empty());
+}
+
+TEST(CharacterCache, LeastRecentlyUsedAccountIsEvicted)
+{
+    CharacterCache cache;
+    cache.Setup(2);
+
+    cache.PopulateAccount(1, { MakeRow(10) });
+    cache.PopulateAccount(2, { MakeRow(20) });
+
+    // Account 1 is used, so 2 is the least recently used
+    EXPECT_TRUE(HasCharacter(cache, 10));
+    cache.PopulateAccount(3, { MakeRow(30) });
+
+    EXPECT_TRUE(IsCached(cache, 1));
+    EXPECT_FALSE(IsCached(cache, 2));
+    EXPECT_TRUE(IsCached(cache, 3));
+
+    // The characters of the evicted account go with it
+    EXPECT_FALSE(HasCharacter(cache, 20));
+
+    size_t accounts = 0;
+    uint64_t hits = 0, misses = 0;
+    cache.GetStats(accounts, hits, misses);
+    EXPECT_EQ(accounts, 2u);
+}
+
+TEST(CharacterCache, PopulateDoesNotOverwriteACachedAccount)
+{
+    CharacterCache cache;
+    cache.Setup(4);
+
+    cache.PopulateAccount(1, { MakeRow(10, 5) });
+
+    CharacterData save{};
+    save.id = 10;
+    save.accountID = 1;
+    save.level = 9;
+    save.xp = 1234;
+    save.zone = 3;
+    save.pos_x = 1.0f;
+    cache.UpdateCharacter(save);
+
+    // A CHAR_SEL_ENUM that ran before the save reached MySQL
+    cache.PopulateAccount(1, { MakeRow(10, 5), MakeRow(11) });
+
+    std::vector<CharacterRow> rows;
+    ASSERT_TRUE(cache.GetAccountCharacters(1, rows));
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].level, 9);
+    EXPECT_EQ(rows[0].xp, 1234u);
+    EXPECT_EQ(rows[0].zone, 3u);
+    EXPECT_FALSE(HasCharacter(cache, 11));
+}
+
+TEST(CharacterCache, UpdateOfAnUncachedCharacterIsIgnored)
+{
+    CharacterCache cache;
+    cache.Setup(4);
+    cache.PopulateAccount(1, { MakeRow(10) });
+
+    CharacterData save{};
+    save.id = 99;
+    save.accountID = 1;
+    save.level = 50;
+    cache.UpdateCharacter(save);
+
+    save.accountID = 2;
+    cache.UpdateCharacter(save);
+
+    EXPECT_FALSE(HasCharacter(cache, 99));
+    EXPECT_FALSE(IsCached(cache, 2));
+
+    CharacterRow row;
+    ASSERT_TRUE(cache.GetCharacter(10, row));
+    EXPECT_EQ(row.level, 1);
+}
+
+TEST(CharacterCache, RemoveCharacterKeepsTheCharIDIndexConsistent)
+{
+    CharacterCache cache;
+    cache.Setup(4);
+    cache.PopulateAccount(1, { MakeRow(10), MakeRow(11) });
+    cache.PopulateAccount(2, { MakeRow(20) });
+
+    cache.RemoveCharacter(1, 10);
+    EXPECT_FALSE(HasCharacter(cache, 10));
+    EXPECT_TRUE(HasCharacter(cache, 11));
+
+    std::vector<CharacterRow> rows;
+    ASSERT_TRUE(cache.GetAccountCharacters(1, rows));
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].id, 11u);
+
+    // Removing a character through the wrong account doesn't touch it
+    cache.RemoveCharacter(1, 20);
+    EXPECT_TRUE(HasCharacter(cache, 20));
+    ASSERT_TRUE(cache.GetAccountCharacters(2, rows));
+    EXPECT_EQ(rows.size(), 1u);
+}
+
+TEST(CharacterCache, InvalidateAccountDropsItsCharacters)
+{
+    CharacterCache cache;
+    cache.Setup(4);
+    cache.PopulateAccount(1, { MakeRow(10), MakeRow(11) });
+    cache.PopulateAccount(2, { MakeRow(20) });
+
+    cache.InvalidateAccount(1);
+    EXPECT_FALSE(IsCached(cache, 1));
+    EXPECT_FALSE(HasCharacter(cache, 10));
+    EXPECT_FALSE(HasCharacter(cache, 11));
+    EXPECT_TRUE(HasCharacter(cache, 20));
+
+    // Reloaded from MySQL on the next enum, with the new character
+    cache.PopulateAccount(1, { MakeRow(10), MakeRow(11), MakeRow(12) });
+    EXPECT_TRUE(HasCharacter(cache, 12));
+
+    // Its slot in the LRU went with it too
+    cache.InvalidateAccount(2);
+    cache.InvalidateAccount(2);
+    size_t accounts = 0;
+    uint64_t hits = 0, misses = 0;
+    cache.GetStats(accounts, hits, misses);
+    EXPECT_EQ(accounts, 1u);
+}
+
+TEST(CharacterCache, ZeroMaxAccountsDisablesTheCache)
+{
+    CharacterCache cache;
+    cache.Setup(0);
+    EXPECT_FALSE(cache.IsEnabled());
+
+    cache.PopulateAccount(1, { MakeRow(10) });
+    EXPECT_FALSE(IsCached(cache, 1));
+    EXPECT_FALSE(HasCharacter(cache, 10));
+
+    size_t accounts = 0;
+    uint64_t hits = 0, misses = 0;
+    cache.GetStats(accounts, hits, misses);
+    EXPECT_EQ(accounts, 0u);
+    EXPECT_EQ(hits, 0u);
+    EXPECT_EQ(misses, 2u);
+}
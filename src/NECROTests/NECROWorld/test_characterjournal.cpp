@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "CharacterJournalFile.h"
+#include "CharacterData.h"
+
+namespace
+{
+    using namespace NECRO;
+    using namespace NECRO::World;
+
+    using Record = std::array<uint8_t, CHARACTER_JOURNAL_RECORD_SIZE>;
+
+    CharacterJournalEntry MakeEntry(uint64_t seq)
+    {
+        CharacterJournalEntry entry;
+        entry.seq = seq;
+        entry.charID = 100 + static_cast<uint32_t>(seq);
+        entry.accountID = 7;
+        entry.dirtyMask = CHARACTER_DIRTY_LOCATION;
+        entry.level = 12;
+        entry.xp = 3400;
+        entry.zone = 2;
+        entry.pos_x = 10.5f;
+        entry.pos_y = -3.25f;
+        entry.pos_z = 0.0f;
+        return entry;
+    }
+
+    void ExpectSameEntry(const CharacterJournalEntry& a, const CharacterJournalEntry& b)
+    {
+        EXPECT_EQ(a.seq, b.seq);
+        EXPECT_EQ(a.charID, b.charID);
+        EXPECT_EQ(a.accountID, b.accountID);
+        EXPECT_EQ(a.dirtyMask, b.dirtyMask);
+        EXPECT_EQ(a.level, b.level);
+        EXPECT_EQ(a.xp, b.xp);
+        EXPECT_EQ(a.zone, b.zone);
+        EXPECT_EQ(a.pos_x, b.pos_x);
+        EXPECT_EQ(a.pos_y, b.pos_y);
+        EXPECT_EQ(a.pos_z, b.pos_z);
+    }
+
+    // Writes journal files in the test temp dir
+    class CharacterJournalFileTest : public ::testing::Test
+    {
+    protected:
+        std::string m_path;
+
+        void SetUp() override
+        {
+            m_path = ::testing::TempDir() + "necro_test.journal";
+        }
+
+        void TearDown() override
+        {
+            std::remove(m_path.c_str());
+        }
+
+        void WriteJournal(uint32_t magic, uint16_t version, const std::vector<uint8_t>& records)
+        {
+            std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+            file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+            file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size()));
+        }
+
+        // Records of the entries in the current version
+        static std::vector<uint8_t> Serialize(uint64_t firstSeq, size_t count)
+        {
+            std::vector<uint8_t> records;
+            for (size_t i = 0; i < count; ++i)
+            {
+                Record record{};
+                CharacterJournalFile::Serialize(MakeEntry(firstSeq + i), record.data());
+                records.insert(records.end(), record.begin(), record.end());
+            }
+            return records;
+        }
+    };
+}
+
+TEST(CharacterJournalRecord, RoundtripRecoversEntry)
+{
+    CharacterJournalEntry sent = MakeEntry(42);
+
+    Record record{};
+    CharacterJournalFile::Serialize(sent, record.data());
+
+    CharacterJournalEntry received;
+    ASSERT_TRUE(CharacterJournalFile::Deserialize(record.data(), CHARACTER_JOURNAL_VERSION, received));
+    ExpectSameEntry(received, sent);
+}
+
+TEST(CharacterJournalRecord, EveryByteIsCoveredByTheChecksum)
+{
+    Record record{};
+    CharacterJournalFile::Serialize(MakeEntry(1), record.data());
+
+    for (size_t i = 0; i < record.size(); ++i)
+    {
+        Record corrupted = record;
+        corrupted[i] ^= 0x01;
+
+        CharacterJournalEntry received;
+        EXPECT_FALSE(CharacterJournalFile::Deserialize(corrupted.data(), CHARACTER_JOURNAL_VERSION, received)) << "byte " << i;
+    }
+}
+
+TEST(CharacterJournalRecord, ZeroedRecordIsRejected)
+{
+    // What a preallocated but never written record looks like
+    Record record{};
+
+    CharacterJournalEntry received;
+    EXPECT_FALSE(CharacterJournalFile::Deserialize(record.data(), CHARACTER_JOURNAL_VERSION, received));
+}
+
+TEST_F(CharacterJournalFileTest, ReadsAllTheRecords)
+{
+    WriteJournal(CHARACTER_JOURNAL_MAGIC, CHARACTER_JOURNAL_VERSION, Serialize(1, 3));
+
+    std::vector<CharacterJournalEntry> entries;
+    uint16_t version = 0;
+    ASSERT_EQ(CharacterJournalFile::Read(m_path, entries, version), 0);
+    EXPECT_EQ(version, CHARACTER_JOURNAL_VERSION);
+
+    ASSERT_EQ(entries.size(), 3u);
+    for (size_t i = 0; i < entries.size(); ++i)
+        ExpectSameEntry(entries[i], MakeEntry(1 + i));
+}
+
+TEST_F(CharacterJournalFileTest, TornLastRecordIsDropped)
+{
+    std::vector<uint8_t> records = Serialize(1, 3);
+
+    // Crash while writing the third record
+    records.resize(records.size() - CHARACTER_JOURNAL_RECORD_SIZE / 2);
+    WriteJournal(CHARACTER_JOURNAL_MAGIC, CHARACTER_JOURNAL_VERSION, records);
+
+    std::vector<CharacterJournalEntry> entries;
+    uint16_t version = 0;
+    ASSERT_EQ(CharacterJournalFile::Read(m_path, entries, version), 0);
+
+    ASSERT_EQ(entries.size(), 2u);
+    ExpectSameEntry(entries[0], MakeEntry(1));
+    ExpectSameEntry(entries[1], MakeEntry(2));
+}
+
+TEST_F(CharacterJournalFileTest, CorruptedRecordEndsTheJournal)
+{
+    std::vector<uint8_t> records = Serialize(1, 4);
+
+    // The second record is complete but damaged, what follows it isn't trusted either
+    records[CHARACTER_JOURNAL_RECORD_SIZE + 10] ^= 0xFF;
+    WriteJournal(CHARACTER_JOURNAL_MAGIC, CHARACTER_JOURNAL_VERSION, records);
+
+    std::vector<CharacterJournalEntry> entries;
+    uint16_t version = 0;
+    ASSERT_EQ(CharacterJournalFile::Read(m_path, entries, version), 0);
+
+    ASSERT_EQ(entries.size(), 1u);
+    ExpectSameEntry(entries[0], MakeEntry(1));
+}
+
+TEST_F(CharacterJournalFileTest, HeaderOnlyJournalIsEmpty)
+{
+    WriteJournal(CHARACTER_JOURNAL_MAGIC, CHARACTER_JOURNAL_VERSION, {});
+
+    std::vector<CharacterJournalEntry> entries;
+    uint16_t version = 0;
+    EXPECT_EQ(CharacterJournalFile::Read(m_path, entries, version), 0);
+    EXPECT_TRUE(entries.empty());
+}
+
+TEST_F(CharacterJournalFileTest, Version1RecordsAreReplayedAsDirtyAll)
+{
+    // A version 1 record is the current one without the dirty mask
+    CharacterJournalEntry sent = MakeEntry(5);
+
+    std::vector<uint8_t> record(CHARACTER_JOURNAL_RECORD_SIZE_V1);
+    uint8_t* p = record.data();
+    auto put = [&p](const auto& v) { std::memcpy(p, &v, sizeof(v)); p += sizeof(v); };
+    put(sent.seq);
+    put(sent.charID);
+    put(sent.accountID);
+    put(sent.level);
+    put(sent.xp);
+    put(sent.zone);
+    put(sent.pos_x);
+    put(sent.pos_y);
+    put(sent.pos_z);
+    put(CharacterJournalFile::Checksum(record.data(), static_cast<size_t>(p - record.data())));
+
+    WriteJournal(CHARACTER_JOURNAL_MAGIC, 1, record);
+
+    std::vector<CharacterJournalEntry> entries;
+    uint16_t version = 0;
+    ASSERT_EQ(CharacterJournalFile::Read(m_path, entries, version), 0);
+    EXPECT_EQ(version, 1);
+
+    ASSERT_EQ(entries.size(), 1u);
+    sent.dirtyMask = CHARACTER_DIRTY_ALL;
+    ExpectSameEntry(entries[0], sent);
+}
+
+TEST_F(CharacterJournalFileTest, NotAJournalFails)
+{
+    std::vector<CharacterJournalEntry> entries;
+    uint16_t version = 0;
+
+    WriteJournal(0x12345678, CHARACTER_JOURNAL_VERSION, Serialize(1, 1));
+    EXPECT_EQ(CharacterJournalFile::Read(m_path, entries, version), -2);
+
+    // Written by a newer server
+    WriteJournal(CHARACTER_JOURNAL_MAGIC, CHARACTER_JOURNAL_VERSION + 1, Serialize(1, 1));
+    EXPECT_EQ(CharacterJournalFile::Read(m_path, entries, version), -2);
+
+    WriteJournal(CHARACTER_JOURNAL_MAGIC, 0, {});
+    EXPECT_EQ(CharacterJournalFile::Read(m_path, entries, version), -2);
+
+    std::remove(m_path.c_str());
+    EXPECT_EQ(CharacterJournalFile::Read(m_path, entries, version), -1);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "CharacterNameIndex.h"
+
+namespace
+{
+    using namespace NECRO;
+    using namespace NECRO::World;
+}
+
+TEST(CharacterNameIndex, NormalizeFoldsOnlyUppercaseLetters)
+{
+    EXPECT_EQ(CharacterNameIndex::Normalize("Necro42"), "necro42");
+    EXPECT_EQ(CharacterNameIndex::Normalize("ALLCAPS"), "allcaps");
+    EXPECT_EQ(CharacterNameIndex::Normalize("lower09"), "lower09");
+    EXPECT_EQ(CharacterNameIndex::Normalize(""), "");
+}
+
+TEST(CharacterNameIndex, IsTakenIgnoresCase)
+{
+    CharacterNameIndex index;
+    index.Add("Arthas");
+
+    EXPECT_TRUE(index.IsTaken("Arthas"));
+    EXPECT_TRUE(index.IsTaken("arthas"));
+    EXPECT_TRUE(index.IsTaken("ARTHAS"));
+    EXPECT_TRUE(index.IsTaken("aRtHaS"));
+
+    EXPECT_FALSE(index.IsTaken("Arthas1"));
+    EXPECT_FALSE(index.IsTaken("Artha"));
+}
+
+TEST(CharacterNameIndex, AddOfTheSameNameInAnotherCaseIsOneName)
+{
+    CharacterNameIndex index;
+    index.Add("Jaina");
+    index.Add("JAINA");
+    index.Add("jaina");
+
+    EXPECT_EQ(index.Size(), 1u);
+
+    index.Add("Jaina2");
+    EXPECT_EQ(index.Size(), 2u);
+}
+
+TEST(CharacterNameIndex, RemoveIgnoresCase)
+{
+    CharacterNameIndex index;
+    index.Add("Thrall");
+    index.Add("Sylvanas");
+
+    // Deleted through the name MySQL returned, which may not be the one it was added with
+    index.Remove("THRALL");
+    EXPECT_FALSE(index.IsTaken("Thrall"));
+    EXPECT_FALSE(index.IsTaken("thrall"));
+    EXPECT_TRUE(index.IsTaken("Sylvanas"));
+    EXPECT_EQ(index.Size(), 1u);
+
+    // Removing a name that isn't there is harmless
+    index.Remove("thrall");
+    EXPECT_EQ(index.Size(), 1u);
+}
+
+TEST(CharacterNameIndex, NotLoadedOrEnforcedByDefault)
+{
+    CharacterNameIndex index;
+    EXPECT_FALSE(index.IsLoaded());
+    EXPECT_FALSE(index.IsUniqueEnforced());
+
+    index.SetLoaded();
+    index.SetUniqueEnforced(true);
+    EXPECT_TRUE(index.IsLoaded());
+    EXPECT_TRUE(index.IsUniqueEnforced());
+
+    index.SetUniqueEnforced(false);
+    EXPECT_FALSE(index.IsUniqueEnforced());
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "TickProfiler.h"
+
+namespace
+{
+    using namespace NECRO;
+    using namespace NECRO::World;
+
+    uint64_t PhaseUs(const TickProfiler::TickRecord& record, TickPhase phase)
+    {
+        return record.phasesUs[static_cast<int>(phase)];
+    }
+}
+
+TEST(TickProfiler, PhasesAccumulateDuringTheTick)
+{
+    TickProfiler profiler;
+    profiler.Setup(true, 0, 0);
+
+    profiler.BeginTick(3);
+    profiler.AddPhase(TickPhase::ZONES_UPDATE, 100);
+    profiler.AddPhase(TickPhase::ZONES_UPDATE, 50);     // called once per zone
+    profiler.AddPhase(TickPhase::PERIODIC_SAVES, 20);
+    profiler.SetCmdsExecuted(4);
+    profiler.EndTick();
+
+    const TickProfiler::TickRecord& record = profiler.GetCurrentTick();
+    EXPECT_EQ(record.tick, 3u);
+    EXPECT_EQ(PhaseUs(record, TickPhase::ZONES_UPDATE), 150u);
+    EXPECT_EQ(PhaseUs(record, TickPhase::PERIODIC_SAVES), 20u);
+    EXPECT_EQ(PhaseUs(record, TickPhase::EXECUTE_WORLD_CMDS), 0u);
+    EXPECT_EQ(record.cmdsExecuted, 4u);
+}
+
+TEST(TickProfiler, BeginTickStartsFromZero)
+{
+    TickProfiler profiler;
+    profiler.Setup(true, 0, 0);
+
+    profiler.BeginTick(1);
+    profiler.AddPhase(TickPhase::TRANSFER_ENTITIES, 70);
+    profiler.AddZone(5, 10, 3, 1);
+    profiler.SetCmdsExecuted(2);
+    profiler.EndTick();
+
+    profiler.BeginTick(2);
+    const TickProfiler::TickRecord& record = profiler.GetCurrentTick();
+    EXPECT_EQ(record.tick, 2u);
+    EXPECT_EQ(PhaseUs(record, TickPhase::TRANSFER_ENTITIES), 0u);
+    EXPECT_EQ(record.zonesUpdated, 0u);
+    EXPECT_EQ(record.entitiesUpdated, 0u);
+    EXPECT_EQ(record.cmdsExecuted, 0u);
+    EXPECT_EQ(record.slowestZoneUs, 0u);
+}
+
+TEST(TickProfiler, ZonesAreCountedAndTheSlowestIsKept)
+{
+    TickProfiler profiler;
+    profiler.Setup(true, 0, 0);
+
+    profiler.BeginTick(1);
+    profiler.AddZone(1, 30, 10, 0);
+    profiler.AddZone(2, 90, 4, 2);
+    profiler.AddZone(3, 60, 1, 1);
+    profiler.EndTick();
+
+    const TickProfiler::TickRecord& record = profiler.GetCurrentTick();
+    EXPECT_EQ(record.zonesUpdated, 3u);
+    EXPECT_EQ(record.entitiesUpdated, 15u);
+    EXPECT_EQ(record.entitiesTransferred, 3u);
+    EXPECT_EQ(record.slowestZoneID, 2u);
+    EXPECT_EQ(record.slowestZoneUs, 90u);
+}
+
+TEST(TickProfiler, SlowTickIsCaptured)
+{
+    TickProfiler profiler;
+    profiler.Setup(true, 1, 0);
+
+    // Fast tick
+    profiler.BeginTick(1);
+    profiler.EndTick();
+    EXPECT_EQ(profiler.GetSlowTicksSinceReport(), 0u);
+
+    profiler.BeginTick(2);
+    profiler.AddPhase(TickPhase::ZONES_UPDATE, 1500);
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    profiler.EndTick();
+
+    EXPECT_EQ(profiler.GetSlowTicksSinceReport(), 1u);
+    EXPECT_GE(profiler.GetCurrentTick().totalUs, 1000u);
+
+    // The counters of the slow tick are the ones dumped
+    EXPECT_EQ(profiler.GetCurrentTick().tick, 2u);
+    EXPECT_EQ(PhaseUs(profiler.GetCurrentTick(), TickPhase::ZONES_UPDATE), 1500u);
+}
+
+TEST(TickProfiler, ZeroThresholdDisablesSlowTickCapture)
+{
+    TickProfiler profiler;
+    profiler.Setup(true, 0, 0);
+
+    profiler.BeginTick(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    profiler.EndTick();
+
+    EXPECT_EQ(profiler.GetSlowTicksSinceReport(), 0u);
+}
+
+TEST(TickProfiler, ReportResetsTheSlowTicksCount)
+{
+    TickProfiler profiler;
+    profiler.Setup(true, 1, 1);
+
+    profiler.BeginTick(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    profiler.EndTick();
+
+    // The report interval went by during the tick, so the slow tick was reported with it
+    EXPECT_EQ(profiler.GetSlowTicksSinceReport(), 0u);
+}
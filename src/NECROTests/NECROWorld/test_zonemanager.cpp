@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "NDBDataStoreManager.h"
+#include "ZoneManager.h"
+
+namespace
+{
+    using namespace NECRO;
+    using namespace NECRO::World;
+
+    const uint32_t EXTERIOR_MAP_ID = 1;
+    const uint32_t DUNGEON_MAP_ID = 2;
+
+    const uint32_t HIBERNATE_AFTER_MS = 1000;
+    const uint32_t TEARDOWN_AFTER_MS = 5000;
+
+    // A 3x2 map with one layer, used by both the exterior and the instanced map
+    const char* TEST_TILEDEF =
+        "1,0,0,0,0,0,0,0,0,0,0\n"
+        "ENDTILESETS\n";
+
+    const char* TEST_MAP =
+        "tiledefName = necro_test.ntdef;\n"
+        "width = 3;\n"
+        "height = 2;\n"
+        "nLayers = 1;\n"
+        "layer0:\n{\n1,1,1\n1,1,1\n};\n"
+        "PrefabList:\n";
+
+    const char* TEST_MAPS_DB =
+        "DEFINITION_START\n"
+        "ID:maps_db\n"
+        "DEFINITION_END\n"
+        "STRUCTURE_START\n"
+        "ID:int\n"
+        "MapName:string\n"
+        "MapType:int\n"
+        "Width:int\n"
+        "Height:int\n"
+        "NLayers:int\n"
+        "MapFileName:string\n"
+        "STRUCTURE_END\n"
+        "ROWS_START\n"
+        "1, Exterior, 0, 3, 2, 1, necro_test.nmap;\n"
+        "2, Dungeon, 1, 3, 2, 1, necro_test.nmap;\n"
+        "ROWS_END\n"
+        "NDB_END\n";
+
+    // Loads the maps_db above from the test temp dir, the map directories point there while the test runs
+    class ZoneManagerTest : public ::testing::Test
+    {
+    protected:
+        const char* m_prevMapsDir = nullptr;
+        const char* m_prevTiledefsDir = nullptr;
+        std::string m_dir;
+        std::vector<std::string> m_files;
+
+        std::shared_ptr<NDBDataStoreManager> m_stores;
+        ZoneManager m_zones;
+
+        void SetUp() override
+        {
+            m_dir = ::testing::TempDir();
+            m_prevMapsDir = MAPFILES_DIRECTORY;
+            m_prevTiledefsDir = TILEDEFS_DIRECTORY;
+            MAPFILES_DIRECTORY = m_dir.c_str();
+            TILEDEFS_DIRECTORY = m_dir.c_str();
+
+            WriteFile("necro_test.ntdef", TEST_TILEDEF);
+            WriteFile("necro_test.nmap", TEST_MAP);
+            WriteFile("necro_test_maps.ndb", TEST_MAPS_DB);
+
+            NDBReader reader;
+            ASSERT_TRUE(reader.Open(m_dir + "necro_test_maps.ndb"));
+
+            m_stores = std::make_shared<NDBDataStoreManager>();
+            ASSERT_EQ(m_stores->LoadStore(reader), 0);
+
+            m_zones.Setup(1, HIBERNATE_AFTER_MS, TEARDOWN_AFTER_MS);
+        }
+
+        void TearDown() override
+        {
+            MAPFILES_DIRECTORY = m_prevMapsDir;
+            TILEDEFS_DIRECTORY = m_prevTiledefsDir;
+
+            for (const std::string& f : m_files)
+                std::remove((m_dir + f).c_str());
+        }
+
+        void WriteFile(const std::string& name, const std::string& content)
+        {
+            std::ofstream file(m_dir + name, std::ios::trunc);
+            file << content;
+            m_files.push_back(name);
+        }
+
+        std::vector<uint32_t> UpdateLifecycle(uint32_t now)
+        {
+            std::vector<uint32_t> destroyed;
+            m_zones.UpdateLifecycle(now, destroyed);
+            return destroyed;
+        }
+    };
+}
+
+TEST_F(ZoneManagerTest, InstanceHibernatesThenIsTornDownAndItsShellIsPooled)
+{
+    ASSERT_EQ(m_zones.GetShellsPoolCount(), 1u);
+
+    const uint32_t zoneID = m_zones.CreateInstance(DUNGEON_MAP_ID, 100, m_stores);
+    ASSERT_EQ(zoneID, INSTANCED_ZONES_FIRST_ID);
+    EXPECT_EQ(m_zones.GetShellsPoolCount(), 0u);
+
+    Zone* zone = m_zones.FindZone(zoneID);
+    ASSERT_NE(zone, nullptr);
+    EXPECT_TRUE(zone->IsActive());
+    EXPECT_EQ(zone->GetMapID(), DUNGEON_MAP_ID);
+
+    // A freshly spawned instance gets the full grace period
+    EXPECT_TRUE(UpdateLifecycle(100 + HIBERNATE_AFTER_MS - 1).empty());
+    EXPECT_TRUE(zone->IsActive());
+
+    EXPECT_TRUE(UpdateLifecycle(100 + HIBERNATE_AFTER_MS).empty());
+    EXPECT_FALSE(zone->IsActive());
+    EXPECT_EQ(m_zones.FindZone(zoneID), zone);
+
+    std::vector<uint32_t> destroyed = UpdateLifecycle(100 + TEARDOWN_AFTER_MS);
+    ASSERT_EQ(destroyed.size(), 1u);
+    EXPECT_EQ(destroyed[0], zoneID);
+    EXPECT_EQ(m_zones.FindZone(zoneID), nullptr);
+
+    // The shell went back to the pool and the next instance is spawned from it
+    EXPECT_EQ(m_zones.GetShellsPoolCount(), 1u);
+
+    const uint32_t nextZoneID = m_zones.CreateInstance(DUNGEON_MAP_ID, 200 + TEARDOWN_AFTER_MS, m_stores);
+    EXPECT_EQ(nextZoneID, INSTANCED_ZONES_FIRST_ID + 1);
+    EXPECT_EQ(m_zones.FindZone(nextZoneID), zone);
+    EXPECT_TRUE(zone->IsActive());
+    EXPECT_EQ(m_zones.GetShellsPoolCount(), 0u);
+}
+
+TEST_F(ZoneManagerTest, ExteriorOnlyHibernates)
+{
+    Zone* zone = m_zones.InstantiateZone(EXTERIOR_MAP_ID, EXTERIOR_MAP_ID, 0, m_stores);
+    ASSERT_NE(zone, nullptr);
+
+    EXPECT_TRUE(UpdateLifecycle(TEARDOWN_AFTER_MS * 10).empty());
+    EXPECT_FALSE(zone->IsActive());
+    EXPECT_EQ(m_zones.FindZone(EXTERIOR_MAP_ID), zone);
+}
+
+TEST_F(ZoneManagerTest, ShellsPoolIsCapped)
+{
+    // Two instances with a pool of one: the second one is allocated
+    const uint32_t first = m_zones.CreateInstance(DUNGEON_MAP_ID, 0, m_stores);
+    const uint32_t second = m_zones.CreateInstance(DUNGEON_MAP_ID, 0, m_stores);
+    ASSERT_NE(first, 0u);
+    ASSERT_NE(second, 0u);
+    EXPECT_EQ(m_zones.GetShellsPoolCount(), 0u);
+
+    // Both torn down, only one shell is kept
+    EXPECT_EQ(UpdateLifecycle(TEARDOWN_AFTER_MS).size(), 2u);
+    EXPECT_TRUE(m_zones.GetZones().empty());
+    EXPECT_EQ(m_zones.GetShellsPoolCount(), 1u);
+}
+
+TEST_F(ZoneManagerTest, OnlyInstancedMapsCanBeInstanced)
+{
+    EXPECT_EQ(m_zones.CreateInstance(EXTERIOR_MAP_ID, 0, m_stores), 0u);
+    EXPECT_EQ(m_zones.CreateInstance(99, 0, m_stores), 0u);
+    EXPECT_TRUE(m_zones.GetZones().empty());
+    EXPECT_EQ(m_zones.GetShellsPoolCount(), 1u);
+
+    // Already loaded
+    ASSERT_NE(m_zones.InstantiateZone(EXTERIOR_MAP_ID, EXTERIOR_MAP_ID, 0, m_stores), nullptr);
+    EXPECT_EQ(m_zones.InstantiateZone(EXTERIOR_MAP_ID, EXTERIOR_MAP_ID, 0, m_stores), nullptr);
+    EXPECT_EQ(m_zones.GetZones().size(), 1u);
+    EXPECT_FALSE(m_zones.DestroyZone(12345));
+}
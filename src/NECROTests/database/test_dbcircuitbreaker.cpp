@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "DBCircuitBreaker.h"
+
+namespace
+{
+    using namespace NECRO;
+    using Clock = std::chrono::steady_clock;
+
+    void Open(DBCircuitBreaker& breaker)
+    {
+        for (uint32_t i = 0; i < DB_CIRCUIT_BREAKER_FAILURES_THRESHOLD; ++i)
+            breaker.OnConnectionFailure();
+    }
+
+    // Fails a probe and returns the backoff it set, bounded by the times taken around it
+    void FailProbe(DBCircuitBreaker& breaker, Clock::duration& outMinBackoff, Clock::duration& outMaxBackoff)
+    {
+        ASSERT_TRUE(breaker.TryBeginProbe(breaker.GetNextProbeTime()));
+
+        Clock::time_point before = Clock::now();
+        breaker.OnProbeResult(false);
+        Clock::time_point after = Clock::now();
+
+        outMinBackoff = breaker.GetNextProbeTime() - after;
+        outMaxBackoff = breaker.GetNextProbeTime() - before;
+    }
+}
+
+TEST(DBCircuitBreaker, OpensAfterThresholdFailures)
+{
+    DBCircuitBreaker breaker;
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::CLOSED);
+
+    for (uint32_t i = 0; i + 1 < DB_CIRCUIT_BREAKER_FAILURES_THRESHOLD; ++i)
+        breaker.OnConnectionFailure();
+
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::CLOSED);
+    EXPECT_TRUE(breaker.AllowRequest());
+
+    breaker.OnConnectionFailure();
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::OPEN);
+    EXPECT_FALSE(breaker.AllowRequest());
+}
+
+TEST(DBCircuitBreaker, SuccessResetsTheConsecutiveFailures)
+{
+    DBCircuitBreaker breaker;
+
+    for (uint32_t i = 0; i + 1 < DB_CIRCUIT_BREAKER_FAILURES_THRESHOLD; ++i)
+        breaker.OnConnectionFailure();
+
+    breaker.OnConnectionSuccess();
+    breaker.OnConnectionFailure();
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::CLOSED);
+}
+
+TEST(DBCircuitBreaker, ProbeWaitsForTheBackoff)
+{
+    DBCircuitBreaker breaker;
+
+    // Closed, nothing to probe
+    EXPECT_FALSE(breaker.TryBeginProbe());
+
+    Clock::time_point before = Clock::now();
+    Open(breaker);
+
+    Clock::time_point nextProbe = breaker.GetNextProbeTime();
+    EXPECT_GE(nextProbe - before, std::chrono::milliseconds(DB_CIRCUIT_BREAKER_MIN_BACKOFF_MS));
+
+    EXPECT_FALSE(breaker.TryBeginProbe(nextProbe - std::chrono::milliseconds(1)));
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::OPEN);
+
+    EXPECT_TRUE(breaker.TryBeginProbe(nextProbe));
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::HALF_OPEN);
+    EXPECT_FALSE(breaker.AllowRequest());
+
+    // One prober at a time
+    EXPECT_FALSE(breaker.TryBeginProbe(nextProbe + std::chrono::seconds(60)));
+}
+
+TEST(DBCircuitBreaker, FailedProbeDoublesTheBackoffUpToMax)
+{
+    DBCircuitBreaker breaker;
+    Open(breaker);
+
+    uint32_t expectedMs = DB_CIRCUIT_BREAKER_MIN_BACKOFF_MS;
+    for (int i = 0; i < 10; ++i)
+    {
+        expectedMs = std::min(expectedMs * 2, DB_CIRCUIT_BREAKER_MAX_BACKOFF_MS);
+
+        Clock::duration minBackoff, maxBackoff;
+        FailProbe(breaker, minBackoff, maxBackoff);
+
+        EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::OPEN);
+        EXPECT_LE(minBackoff, std::chrono::milliseconds(expectedMs)) << "probe " << i;
+        EXPECT_GE(maxBackoff, std::chrono::milliseconds(expectedMs)) << "probe " << i;
+    }
+
+    EXPECT_EQ(expectedMs, DB_CIRCUIT_BREAKER_MAX_BACKOFF_MS);
+}
+
+TEST(DBCircuitBreaker, SuccessfulProbeClosesAndBumpsTheGeneration)
+{
+    DBCircuitBreaker breaker;
+    EXPECT_EQ(breaker.GetGeneration(), 0u);
+
+    Open(breaker);
+    Clock::duration minBackoff, maxBackoff;
+    FailProbe(breaker, minBackoff, maxBackoff);
+    EXPECT_EQ(breaker.GetGeneration(), 0u);
+
+    ASSERT_TRUE(breaker.TryBeginProbe(breaker.GetNextProbeTime()));
+    breaker.OnProbeResult(true);
+
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::CLOSED);
+    EXPECT_TRUE(breaker.AllowRequest());
+    EXPECT_EQ(breaker.GetGeneration(), 1u);
+
+    // The backoff starts from the min again on the next outage
+    Clock::time_point before = Clock::now();
+    Open(breaker);
+    EXPECT_LE(breaker.GetNextProbeTime() - before, std::chrono::milliseconds(DB_CIRCUIT_BREAKER_MIN_BACKOFF_MS) + std::chrono::seconds(1));
+    EXPECT_EQ(breaker.GetGeneration(), 1u);
+}
+
+TEST(DBCircuitBreaker, FailuresAreIgnoredWhileNotClosed)
+{
+    DBCircuitBreaker breaker;
+    Open(breaker);
+
+    // The failures of the other DBWorkers while it's open don't push the probe back
+    Clock::time_point nextProbe = breaker.GetNextProbeTime();
+    for (int i = 0; i < 5; ++i)
+        breaker.OnConnectionFailure();
+
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::OPEN);
+    EXPECT_EQ(breaker.GetNextProbeTime(), nextProbe);
+
+    ASSERT_TRUE(breaker.TryBeginProbe(nextProbe));
+    for (int i = 0; i < 5; ++i)
+        breaker.OnConnectionFailure();
+
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::HALF_OPEN);
+    EXPECT_EQ(breaker.GetNextProbeTime(), nextProbe);
+
+    // Only the probe result gets it out of HALF_OPEN, and the failures above were not counted
+    breaker.OnProbeResult(true);
+    for (uint32_t i = 0; i + 1 < DB_CIRCUIT_BREAKER_FAILURES_THRESHOLD; ++i)
+        breaker.OnConnectionFailure();
+
+    EXPECT_EQ(breaker.GetState(), DBCircuitBreaker::State::CLOSED);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "DBWorkerRouter.h"
+
+namespace
+{
+    using namespace NECRO;
+
+    // First key that hashes to 'worker' over n DBWorkers
+    uint64_t KeyHashedTo(size_t worker, size_t n)
+    {
+        uint64_t key = 1;
+        while (DBWorkerRouter::HashKey(key, n) != worker)
+            ++key;
+        return key;
+    }
+}
+
+TEST(DBWorkerRouter, HashIsStableAndInRange)
+{
+    for (uint64_t key = 0; key < 1000; ++key)
+    {
+        EXPECT_LT(DBWorkerRouter::HashKey(key, 4), 4u);
+        EXPECT_EQ(DBWorkerRouter::HashKey(key, 4), DBWorkerRouter::HashKey(key, 4));
+        EXPECT_EQ(DBWorkerRouter::HashKey(key, 1), 0u);
+        EXPECT_EQ(DBWorkerRouter::HashKey(key, 0), 0u);
+    }
+}
+
+TEST(DBWorkerRouter, UnpinnedRouteDoesNotPin)
+{
+    DBWorkerRouter router;
+    router.Setup(4);
+
+    const uint64_t key = KeyHashedTo(3, 4);
+    EXPECT_EQ(router.RouteKey(key, 4, false), 3u);
+    EXPECT_EQ(router.GetPinnedKeys(3), 0u);
+
+    // Nothing in flight, so it follows the hash over the new active count
+    EXPECT_EQ(router.RouteKey(key, 2, false), DBWorkerRouter::HashKey(key, 2));
+}
+
+TEST(DBWorkerRouter, KeyStaysOnItsWorkerAcrossAShrink)
+{
+    DBWorkerRouter router;
+    router.Setup(3);
+
+    // The key is on the last DBWorker, which is retired while its requests are in flight
+    const uint64_t key = KeyHashedTo(2, 3);
+    ASSERT_EQ(router.RouteKey(key, 3, true), 2u);
+    EXPECT_EQ(router.GetPinnedKeys(2), 1u);
+
+    router.BeginRetiring(2);
+
+    // Requests enqueued after the shrink still go after the ones already there
+    EXPECT_EQ(router.RouteKey(key, 2, true), 2u);
+    EXPECT_EQ(router.RouteKey(key, 2, false), 2u);
+    EXPECT_EQ(router.GetPinnedKeys(2), 1u);
+
+    // Drained but the key is still pinned
+    EXPECT_FALSE(router.CanStopRetiring(0));
+
+    router.ReleaseKey(key);
+    EXPECT_FALSE(router.CanStopRetiring(0));
+
+    router.ReleaseKey(key);
+    EXPECT_EQ(router.GetPinnedKeys(2), 0u);
+    EXPECT_FALSE(router.CanStopRetiring(1));    // still something queued
+    EXPECT_TRUE(router.CanStopRetiring(0));
+
+    router.OnRetiringStopped();
+    EXPECT_FALSE(router.GetRetiringWorker().has_value());
+
+    // Once unpinned the key follows the hash over the active DBWorkers
+    EXPECT_EQ(router.RouteKey(key, 2, true), DBWorkerRouter::HashKey(key, 2));
+    EXPECT_LT(DBWorkerRouter::HashKey(key, 2), 2u);
+}
+
+TEST(DBWorkerRouter, KeyStaysOnItsWorkerAcrossAGrow)
+{
+    DBWorkerRouter router;
+    router.Setup(3);
+
+    // A key whose hash changes when the pool grows from 2 to 3
+    uint64_t key = 1;
+    while (DBWorkerRouter::HashKey(key, 2) == DBWorkerRouter::HashKey(key, 3))
+        ++key;
+
+    const size_t worker = DBWorkerRouter::HashKey(key, 2);
+    ASSERT_EQ(router.RouteKey(key, 2, true), worker);
+
+    // Grown while in flight
+    EXPECT_EQ(router.RouteKey(key, 3, true), worker);
+
+    router.ReleaseKey(key);
+    EXPECT_EQ(router.RouteKey(key, 3, false), worker);
+
+    router.ReleaseKey(key);
+    EXPECT_EQ(router.GetPinnedKeys(worker), 0u);
+    EXPECT_EQ(router.RouteKey(key, 3, true), DBWorkerRouter::HashKey(key, 3));
+}
+
+TEST(DBWorkerRouter, GrowTakesBackTheRetiringWorker)
+{
+    DBWorkerRouter router;
+    router.Setup(3);
+
+    const uint64_t key = KeyHashedTo(2, 3);
+    router.RouteKey(key, 3, true);
+    router.BeginRetiring(2);
+
+    // Not the retiring one
+    EXPECT_FALSE(router.TakeBackRetiring(1));
+    ASSERT_TRUE(router.GetRetiringWorker().has_value());
+
+    // Grown back before it was drained, the key never left it
+    EXPECT_TRUE(router.TakeBackRetiring(2));
+    EXPECT_FALSE(router.GetRetiringWorker().has_value());
+    EXPECT_FALSE(router.CanStopRetiring(0));
+    EXPECT_EQ(router.RouteKey(key, 3, true), 2u);
+    EXPECT_EQ(router.GetPinnedKeys(2), 1u);
+}
+
+TEST(DBWorkerRouter, ReleaseOfAnUnpinnedKeyIsIgnored)
+{
+    DBWorkerRouter router;
+    router.Setup(2);
+
+    router.ReleaseKey(42);
+
+    const uint64_t a = KeyHashedTo(0, 2);
+    const uint64_t b = KeyHashedTo(1, 2);
+    router.RouteKey(a, 2, true);
+    router.RouteKey(b, 2, true);
+    EXPECT_EQ(router.GetPinnedKeys(0), 1u);
+    EXPECT_EQ(router.GetPinnedKeys(1), 1u);
+
+    // Released more times than it was pinned, the other key is untouched
+    router.ReleaseKey(a);
+    router.ReleaseKey(a);
+    EXPECT_EQ(router.GetPinnedKeys(0), 0u);
+    EXPECT_EQ(router.GetPinnedKeys(1), 1u);
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Logger.h"
+#include "BinaryLog.h"
+
+namespace
+{
+    using namespace NECRO;
+
+    const uint8_t TEST_LEVEL = static_cast<uint8_t>(Logger::LogLevel::LOG_LEVEL_INFO);
+
+    // Records to a binary log in the test temp dir, Decode() returns its text
+    class BinaryLogTest : public ::testing::Test
+    {
+    protected:
+        std::string m_path;
+
+        void SetUp() override
+        {
+            m_path = ::testing::TempDir() + "necro_test.nblog";
+            std::remove(m_path.c_str());
+            ASSERT_TRUE(BinaryLog::Instance().Open(m_path, 1000));
+        }
+
+        void TearDown() override
+        {
+            BinaryLog::Instance().Close();
+            std::remove(m_path.c_str());
+        }
+
+        int Decode(std::string& outText)
+        {
+            std::ostringstream out;
+            int ret = BinaryLog::Decode(m_path, out);
+            outText = out.str();
+            return ret;
+        }
+
+        std::vector<uint8_t> ReadFile()
+        {
+            std::ifstream in(m_path, std::ios::binary);
+            return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        }
+
+        void WriteFile(const std::vector<uint8_t>& data)
+        {
+            std::ofstream out(m_path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+    };
+}
+
+TEST_F(BinaryLogTest, EveryArgTypeRoundTrips)
+{
+    BinaryLog::Site intSite, uintSite, floatSite, doubleSite, boolSite, charSite, stringSite;
+
+    BinaryLog::Record(intSite, TEST_LEVEL, "int.cpp", 1, "int {} {} {} {}",
+        std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), static_cast<int8_t>(-5), -1);
+    BinaryLog::Record(uintSite, TEST_LEVEL, "uint.cpp", 2, "uint {} {} {}",
+        std::numeric_limits<uint64_t>::max(), static_cast<uint16_t>(65535), 0u);
+    BinaryLog::Record(floatSite, TEST_LEVEL, "float.cpp", 3, "float {} {}", 1.5f, -0.25f);
+    BinaryLog::Record(doubleSite, TEST_LEVEL, "double.cpp", 4, "double {} {:.3f}", 1e100, 3.14159);
+    BinaryLog::Record(boolSite, TEST_LEVEL, "bool.cpp", 5, "bool {} {}", true, false);
+    BinaryLog::Record(charSite, TEST_LEVEL, "char.cpp", 6, "char {}{}", 'x', 'Y');
+    BinaryLog::Record(stringSite, TEST_LEVEL, "string.cpp", 7, "string {}|{}|{}|{}",
+        std::string("std"), "literal", std::string_view("view"), std::string());
+
+    BinaryLog::Instance().Close();
+
+    std::string text;
+    ASSERT_EQ(Decode(text), 0);
+
+    EXPECT_NE(text.find("[int.cpp:1] int -9223372036854775808 9223372036854775807 -5 -1\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("[uint.cpp:2] uint 18446744073709551615 65535 0\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("[float.cpp:3] float 1.5 -0.25\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("[double.cpp:4] double 1e+100 3.142\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("[bool.cpp:5] bool true false\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("[char.cpp:6] char xY\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("[string.cpp:7] string std|literal|view|\n"), std::string::npos) << text;
+}
+
+TEST_F(BinaryLogTest, LongStringIsCut)
+{
+    BinaryLog::Site site;
+    BinaryLog::Record(site, TEST_LEVEL, "long.cpp", 1, "<{}>", std::string(BinaryLog::MAX_STRING_ARG_SIZE + 100, 'a'));
+    BinaryLog::Instance().Close();
+
+    std::string text;
+    ASSERT_EQ(Decode(text), 0);
+    EXPECT_NE(text.find("<" + std::string(BinaryLog::MAX_STRING_ARG_SIZE, 'a') + ">"), std::string::npos);
+}
+
+TEST_F(BinaryLogTest, EventsOfAFollowingOpenAreDecoded)
+{
+    BinaryLog::Site site;
+    BinaryLog::Record(site, TEST_LEVEL, "reopen.cpp", 1, "first {}", 1);
+    BinaryLog::Instance().Close();
+
+    // Appends a second header, the site is written again
+    ASSERT_TRUE(BinaryLog::Instance().Open(m_path, 1000));
+    BinaryLog::Record(site, TEST_LEVEL, "reopen.cpp", 1, "first {}", 2);
+    BinaryLog::Instance().Close();
+
+    std::string text;
+    ASSERT_EQ(Decode(text), 0);
+    EXPECT_NE(text.find("first 1\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("first 2\n"), std::string::npos) << text;
+}
+
+TEST_F(BinaryLogTest, TruncatedRecordIsIgnored)
+{
+    BinaryLog::Site site;
+    for (int i = 0; i < 3; ++i)
+        BinaryLog::Record(site, TEST_LEVEL, "truncated.cpp", 1, "event {} {}", i, std::string("payload"));
+    BinaryLog::Instance().Close();
+
+    std::vector<uint8_t> data = ReadFile();
+    ASSERT_GT(data.size(), 4u);
+
+    // Crash in the middle of the last event
+    data.resize(data.size() - 4);
+    WriteFile(data);
+
+    std::string text;
+    ASSERT_EQ(Decode(text), 0);
+    EXPECT_NE(text.find("event 0 payload\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("event 1 payload\n"), std::string::npos) << text;
+    EXPECT_EQ(text.find("event 2"), std::string::npos) << text;
+
+    // Crash in the middle of the header of the last event
+    data = ReadFile();
+    data.resize(data.size() - 16);
+    WriteFile(data);
+
+    ASSERT_EQ(Decode(text), 0);
+    EXPECT_NE(text.find("event 0 payload\n"), std::string::npos) << text;
+    EXPECT_EQ(text.find("event 2"), std::string::npos) << text;
+}
+
+TEST_F(BinaryLogTest, TruncatedSiteIsIgnored)
+{
+    BinaryLog::Instance().Close();
+
+    // Header and the start of a SITE record only
+    std::vector<uint8_t> data = ReadFile();
+    data.push_back(static_cast<uint8_t>(BinaryLog::RecordKind::SITE));
+    data.push_back(1);
+    WriteFile(data);
+
+    std::string text;
+    EXPECT_EQ(Decode(text), 0);
+    EXPECT_TRUE(text.empty());
+}
+
+TEST_F(BinaryLogTest, NotABinaryLogFails)
+{
+    BinaryLog::Instance().Close();
+
+    std::string text;
+    WriteFile({ 'n', 'o', 't', ' ', 'a', ' ', 'l', 'o', 'g' });
+    EXPECT_EQ(Decode(text), -2);
+
+    // Too short for the header
+    WriteFile({ 'N', 'B' });
+    EXPECT_EQ(Decode(text), -2);
+
+    std::remove(m_path.c_str());
+    EXPECT_EQ(Decode(text), -1);
+}
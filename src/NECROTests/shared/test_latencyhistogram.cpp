@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "LatencyHistogram.h"
+
+namespace
+{
+    using namespace NECRO;
+
+    // Index of the only non-empty bucket of a histogram that got a single sample
+    size_t BucketOf(uint64_t sample)
+    {
+        LatencyHistogram h;
+        h.Record(sample);
+        LatencyHistogram::Snapshot s = h.TakeSnapshot(false);
+
+        for (size_t i = 0; i < LatencyHistogram::BUCKETS_N; ++i)
+            if (s.buckets[i] != 0)
+                return i;
+
+        return LatencyHistogram::BUCKETS_N;
+    }
+}
+
+TEST(LatencyHistogram, SamplesGoInPowerOfTwoBuckets)
+{
+    EXPECT_EQ(BucketOf(0), 0u);
+    EXPECT_EQ(BucketOf(1), 1u);
+    EXPECT_EQ(BucketOf(2), 2u);
+    EXPECT_EQ(BucketOf(3), 2u);
+    EXPECT_EQ(BucketOf(4), 3u);
+    EXPECT_EQ(BucketOf(1023), 10u);
+    EXPECT_EQ(BucketOf(1024), 11u);
+    EXPECT_EQ(BucketOf(UINT64_MAX), LatencyHistogram::BUCKETS_N - 1);
+}
+
+TEST(LatencyHistogram, CountSumMaxAndAvg)
+{
+    LatencyHistogram h;
+    for (uint64_t v : { 5, 10, 15, 30 })
+        h.Record(v);
+
+    LatencyHistogram::Snapshot s = h.TakeSnapshot(false);
+    EXPECT_EQ(s.count, 4u);
+    EXPECT_EQ(s.sum, 60u);
+    EXPECT_EQ(s.max, 30u);
+    EXPECT_EQ(s.Avg(), 15u);
+}
+
+TEST(LatencyHistogram, EmptySnapshotReportsZero)
+{
+    LatencyHistogram h;
+    LatencyHistogram::Snapshot s = h.TakeSnapshot(false);
+
+    EXPECT_EQ(s.count, 0u);
+    EXPECT_EQ(s.Avg(), 0u);
+    EXPECT_EQ(s.Percentile(0.5), 0u);
+    EXPECT_EQ(s.Percentile(0.99), 0u);
+}
+
+TEST(LatencyHistogram, PercentileIsUpperBoundOfItsBucket)
+{
+    LatencyHistogram h;
+    for (int i = 0; i < 90; ++i)
+        h.Record(10);   // bucket [8, 16)
+    for (int i = 0; i < 10; ++i)
+        h.Record(600);  // bucket [512, 1024)
+
+    LatencyHistogram::Snapshot s = h.TakeSnapshot(false);
+    EXPECT_EQ(s.Percentile(0.0), 15u);
+    EXPECT_EQ(s.Percentile(0.50), 15u);
+    EXPECT_EQ(s.Percentile(0.89), 15u);
+
+    // The upper bound of the last bucket (1023) is clamped to the max sample
+    EXPECT_EQ(s.Percentile(0.90), 600u);
+    EXPECT_EQ(s.Percentile(0.99), 600u);
+    EXPECT_EQ(s.Percentile(1.0), 600u);
+}
+
+TEST(LatencyHistogram, ZeroSamplesHaveZeroPercentile)
+{
+    LatencyHistogram h;
+    h.Record(0);
+    h.Record(0);
+    h.Record(100);
+
+    LatencyHistogram::Snapshot s = h.TakeSnapshot(false);
+    EXPECT_EQ(s.Percentile(0.5), 0u);
+    EXPECT_EQ(s.Percentile(0.99), 100u);
+}
+
+TEST(LatencyHistogram, SnapshotWithResetRestartsFromZero)
+{
+    LatencyHistogram h;
+    h.Record(7);
+    h.Record(70);
+
+    LatencyHistogram::Snapshot first = h.TakeSnapshot(true);
+    EXPECT_EQ(first.count, 2u);
+    EXPECT_EQ(first.max, 70u);
+
+    LatencyHistogram::Snapshot second = h.TakeSnapshot(false);
+    EXPECT_EQ(second.count, 0u);
+    EXPECT_EQ(second.sum, 0u);
+    EXPECT_EQ(second.max, 0u);
+    for (uint64_t b : second.buckets)
+        EXPECT_EQ(b, 0u);
+
+    // Without reset the values are kept
+    h.Record(3);
+    EXPECT_EQ(h.TakeSnapshot(false).count, 1u);
+    EXPECT_EQ(h.TakeSnapshot(false).count, 1u);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "Config.h"
+#include "LiveSetting.h"
+
+namespace
+{
+    using namespace NECRO;
+
+    // Writes the lines to a config file in the test temp dir and loads it
+    void LoadConfig(Config& conf, const std::string& lines)
+    {
+        const std::string path = ::testing::TempDir() + "necro_test_livesetting.conf";
+        {
+            std::ofstream file(path, std::ios::trunc);
+            file << lines;
+        }
+
+        ASSERT_TRUE(conf.Load(path, false));
+        std::remove(path.c_str());
+    }
+}
+
+TEST(LiveSetting, ValidValueIsApplied)
+{
+    Config conf;
+    LoadConfig(conf, "TEST_SETTING = 25\n");
+
+    LiveSetting<uint32_t> setting("TEST_SETTING", 10, 1, 100);
+    EXPECT_TRUE(setting.Load(conf, false));
+    EXPECT_EQ(setting.Get(), 25u);
+}
+
+TEST(LiveSetting, MissingKeyKeepsCurrentValue)
+{
+    Config conf;
+    LoadConfig(conf, "OTHER_SETTING = 25\n");
+
+    LiveSetting<uint32_t> setting("TEST_SETTING", 10, 1, 100);
+    EXPECT_TRUE(setting.Load(conf, false));
+    EXPECT_EQ(setting.Get(), 10u);
+
+    LiveSetting<bool> flag("TEST_FLAG", false, false, true);
+    EXPECT_TRUE(flag.Load(conf, false));
+    EXPECT_FALSE(flag.Get());
+}
+
+TEST(LiveSetting, NonNumericValueIsRejected)
+{
+    Config conf;
+    LoadConfig(conf, "TEST_SETTING = fast\n");
+
+    LiveSetting<uint32_t> setting("TEST_SETTING", 10, 1, 100);
+    EXPECT_FALSE(setting.Load(conf, false));
+    EXPECT_EQ(setting.Get(), 10u);
+}
+
+TEST(LiveSetting, OutOfRangeValueIsRejected)
+{
+    Config conf;
+    LiveSetting<uint32_t> setting("TEST_SETTING", 10, 1, 100);
+
+    LoadConfig(conf, "TEST_SETTING = 101\n");
+    EXPECT_FALSE(setting.Load(conf, false));
+    EXPECT_EQ(setting.Get(), 10u);
+
+    LoadConfig(conf, "TEST_SETTING = 0\n");
+    EXPECT_FALSE(setting.Load(conf, false));
+    EXPECT_EQ(setting.Get(), 10u);
+
+    // Negative values don't wrap around for unsigned settings
+    LoadConfig(conf, "TEST_SETTING = -5\n");
+    EXPECT_FALSE(setting.Load(conf, false));
+    EXPECT_EQ(setting.Get(), 10u);
+
+    // Bounds are inclusive
+    LoadConfig(conf, "TEST_SETTING = 100\n");
+    EXPECT_TRUE(setting.Load(conf, false));
+    EXPECT_EQ(setting.Get(), 100u);
+}
+
+TEST(LiveSetting, RejectedValueKeepsPreviouslyLoadedOne)
+{
+    Config conf;
+    LiveSetting<int32_t> setting("TEST_SETTING", 10, -50, 50);
+
+    LoadConfig(conf, "TEST_SETTING = -20\n");
+    EXPECT_TRUE(setting.Load(conf, true));
+    EXPECT_EQ(setting.Get(), -20);
+
+    LoadConfig(conf, "TEST_SETTING = abc\n");
+    EXPECT_FALSE(setting.Load(conf, true));
+    EXPECT_EQ(setting.Get(), -20);
+}
+
+TEST(LoggerParseLevels, ValidMaskIsParsedCriticalFirst)
+{
+    Logger::LogLevels levels;
+
+    ASSERT_TRUE(Logger::ParseLevels("100001", levels));
+    EXPECT_TRUE(levels.test(static_cast<size_t>(Logger::LogLevel::LOG_LEVEL_CRITICAL)));
+    EXPECT_TRUE(levels.test(static_cast<size_t>(Logger::LogLevel::LOG_LEVEL_INFO)));
+    EXPECT_FALSE(levels.test(static_cast<size_t>(Logger::LogLevel::LOG_LEVEL_DEBUG)));
+    EXPECT_FALSE(levels.test(static_cast<size_t>(Logger::LogLevel::LOG_LEVEL_ERROR)));
+    EXPECT_EQ(levels.count(), 2u);
+
+    ASSERT_TRUE(Logger::ParseLevels("000000", levels));
+    EXPECT_TRUE(levels.none());
+
+    ASSERT_TRUE(Logger::ParseLevels("111111", levels));
+    EXPECT_TRUE(levels.all());
+}
+
+TEST(LoggerParseLevels, InvalidMaskLeavesLevelsUntouched)
+{
+    Logger::LogLevels levels;
+    ASSERT_TRUE(Logger::ParseLevels("110011", levels));
+    const Logger::LogLevels before = levels;
+
+    EXPECT_FALSE(Logger::ParseLevels("", levels));
+    EXPECT_FALSE(Logger::ParseLevels("11111", levels));     // too short
+    EXPECT_FALSE(Logger::ParseLevels("1111111", levels));   // too long
+    EXPECT_FALSE(Logger::ParseLevels("11a111", levels));
+    EXPECT_FALSE(Logger::ParseLevels("112111", levels));
+
+    EXPECT_EQ(levels, before);
+}
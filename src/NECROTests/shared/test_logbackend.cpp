@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Logger.h"
+#include "LogBackend.h"
+
+namespace
+{
+    using namespace NECRO;
+
+    LogRecord MakeRecord(int line)
+    {
+        LogRecord record;
+        record.line = line;
+        record.message = "line " + std::to_string(line);
+        return record;
+    }
+
+    // Counts the lines written to it
+    class CountingLogger : public Logger
+    {
+    public:
+        std::atomic<size_t> m_written{ 0 };
+
+    protected:
+        void Write(const std::string&, LogLevel, const char*, int, const std::string&) override
+        {
+            m_written.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void Flush() override {}
+    };
+}
+
+TEST(LogRing, CapacityIsRoundedUpToAPowerOfTwo)
+{
+    LogRing ring(5);
+
+    size_t pushed = 0;
+    while (ring.TryPush(MakeRecord(static_cast<int>(pushed))))
+        pushed++;
+
+    EXPECT_EQ(pushed, 8u);
+}
+
+TEST(LogRing, FullRingRejectsAndKeepsTheRecord)
+{
+    LogRing ring(4);
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(ring.TryPush(MakeRecord(i)));
+
+    // A BLOCK push retries with the same record, so a failed push must not move from it
+    LogRecord rejected = MakeRecord(99);
+    EXPECT_FALSE(ring.TryPush(std::move(rejected)));
+    EXPECT_EQ(rejected.message, "line 99");
+
+    // One pop makes room for exactly one
+    LogRecord out;
+    ASSERT_TRUE(ring.TryPop(out));
+    EXPECT_EQ(out.line, 0);
+    EXPECT_TRUE(ring.TryPush(std::move(rejected)));
+    EXPECT_FALSE(ring.TryPush(MakeRecord(100)));
+}
+
+TEST(LogRing, OrderIsKeptAcrossWraparounds)
+{
+    LogRing ring(4);
+    int nextPush = 0, nextPop = 0;
+
+    // Three at a time, so the slots wrap at a different offset every round
+    for (int round = 0; round < 50; ++round)
+    {
+        for (int i = 0; i < 3; ++i)
+            ASSERT_TRUE(ring.TryPush(MakeRecord(nextPush++)));
+
+        LogRecord out;
+        for (int i = 0; i < 3; ++i)
+        {
+            ASSERT_TRUE(ring.TryPop(out));
+            EXPECT_EQ(out.line, nextPop);
+            EXPECT_EQ(out.message, "line " + std::to_string(nextPop));
+            nextPop++;
+        }
+    }
+
+    EXPECT_TRUE(ring.IsEmpty());
+    LogRecord out;
+    EXPECT_FALSE(ring.TryPop(out));
+}
+
+TEST(LogBackend, StopWritesEveryPushedLine)
+{
+    CountingLogger logger;
+    constexpr int THREADS = 4;
+    constexpr int LINES_PER_THREAD = 5000;
+
+    // Small rings, so the BLOCK pushes wait on the backend while it's stopped
+    LogBackend::Instance().Start(16, LogOverflowPolicy::BLOCK, 1000);
+
+    std::atomic<int> started{ 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&logger, &started]()
+            {
+                started.fetch_add(1);
+                for (int i = 0; i < LINES_PER_THREAD; ++i)
+                    logger.Log("line", Logger::LogLevel::LOG_LEVEL_INFO, __FILE__, __LINE__);
+            });
+    }
+
+    while (started.load() < THREADS)
+        std::this_thread::yield();
+
+    // Lines pushed before, during and after the stop are all written, either by the backend or synchronously
+    LogBackend::Instance().Stop();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_FALSE(LogBackend::Instance().IsRunning());
+    EXPECT_EQ(logger.m_written.load(), static_cast<size_t>(THREADS * LINES_PER_THREAD));
+}
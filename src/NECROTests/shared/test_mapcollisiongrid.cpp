@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "MapCollisionGrid.h"
+
+namespace
+{
+    using namespace NECRO;
+
+    // Tile 1 is walkable, tile 2 has a collider
+    const char* TEST_TILEDEF =
+        "1,0,0,0,0,0,0,0,0,0,0\n"
+        "2,0,1,0,0,32,32,0,0,0,0\n"
+        "ENDTILESETS\n";
+
+    // Writes the map files in the test temp dir and points the map directories there while the test runs
+    class MapCollisionGridTest : public ::testing::Test
+    {
+    protected:
+        const char* m_prevMapsDir = nullptr;
+        const char* m_prevTiledefsDir = nullptr;
+        std::string m_dir;
+        std::vector<std::string> m_files;
+
+        void SetUp() override
+        {
+            m_dir = ::testing::TempDir();
+            m_prevMapsDir = MAPFILES_DIRECTORY;
+            m_prevTiledefsDir = TILEDEFS_DIRECTORY;
+            MAPFILES_DIRECTORY = m_dir.c_str();
+            TILEDEFS_DIRECTORY = m_dir.c_str();
+
+            WriteFile("necro_test.ntdef", TEST_TILEDEF);
+        }
+
+        void TearDown() override
+        {
+            MAPFILES_DIRECTORY = m_prevMapsDir;
+            TILEDEFS_DIRECTORY = m_prevTiledefsDir;
+
+            for (const std::string& f : m_files)
+                std::remove((m_dir + f).c_str());
+        }
+
+        void WriteFile(const std::string& name, const std::string& content)
+        {
+            std::ofstream file(m_dir + name, std::ios::trunc);
+            file << content;
+            m_files.push_back(name);
+        }
+
+        // One string per row: '#' blocking, '.' walkable, ' ' empty
+        bool Load(MapCollisionGrid& grid, const std::vector<std::vector<std::string>>& layers)
+        {
+            const size_t height = layers[0].size();
+            const size_t width = layers[0][0].size();
+
+            std::string map = "tiledefName = necro_test.ntdef;\n";
+            map += "width = " + std::to_string(width) + ";\n";
+            map += "height = " + std::to_string(height) + ";\n";
+            map += "nLayers = " + std::to_string(layers.size()) + ";\n";
+
+            for (size_t l = 0; l < layers.size(); ++l)
+            {
+                map += "layer" + std::to_string(l) + ":\n{\n";
+                for (const std::string& row : layers[l])
+                {
+                    for (size_t x = 0; x < row.size(); ++x)
+                    {
+                        map += row[x] == '#' ? "2" : row[x] == '.' ? "1" : "0";
+                        map += x + 1 < row.size() ? "," : "\n";
+                    }
+                }
+                map += "};\n";
+            }
+            map += "PrefabList:\n";
+
+            WriteFile("necro_test.nmap", map);
+            return grid.LoadFromFile("necro_test.nmap");
+        }
+    };
+}
+
+TEST_F(MapCollisionGridTest, LoadsWalkableAndBlockingCells)
+{
+    MapCollisionGrid grid;
+    ASSERT_TRUE(Load(grid, { { "..#",
+                               ". #" } }));
+
+    EXPECT_TRUE(grid.IsLoaded());
+    EXPECT_TRUE(grid.IsWalkable(0, 0, 0));
+    EXPECT_FALSE(grid.IsBlocking(0, 0, 0));
+    EXPECT_TRUE(grid.IsBlocking(0, 2, 0));
+    EXPECT_FALSE(grid.IsWalkable(0, 2, 0));
+
+    // Empty cells are neither walkable nor blocking
+    EXPECT_FALSE(grid.IsWalkable(0, 1, 1));
+    EXPECT_FALSE(grid.IsBlocking(0, 1, 1));
+}
+
+TEST_F(MapCollisionGridTest, StraightLines)
+{
+    MapCollisionGrid grid;
+    ASSERT_TRUE(Load(grid, { { ".....",
+                               "..#..",
+                               "....." } }));
+
+    EXPECT_FALSE(grid.IsLineBlocked(0, 0, 0, 4, 0));
+    EXPECT_FALSE(grid.IsLineBlocked(0, 4, 2, 0, 2));
+    EXPECT_TRUE(grid.IsLineBlocked(0, 0, 1, 4, 1));
+    EXPECT_TRUE(grid.IsLineBlocked(0, 2, 0, 2, 2));
+
+    // Stopping right before the blocking cell is fine
+    EXPECT_FALSE(grid.IsLineBlocked(0, 0, 1, 1, 1));
+    EXPECT_TRUE(grid.IsLineBlocked(0, 0, 1, 2, 1));
+
+    // Not moving
+    EXPECT_FALSE(grid.IsLineBlocked(0, 3, 2, 3, 2));
+}
+
+TEST_F(MapCollisionGridTest, DiagonalCantSqueezeBetweenTwoBlockingCells)
+{
+    MapCollisionGrid grid;
+    ASSERT_TRUE(Load(grid, { { ".#.",
+                               "#..",
+                               "..." } }));
+
+    // (1, 1) is free, but both the cells around the corner are blocking
+    EXPECT_TRUE(grid.IsLineBlocked(0, 0, 0, 1, 1));
+    EXPECT_TRUE(grid.IsLineBlocked(0, 1, 1, 0, 0));
+}
+
+TEST_F(MapCollisionGridTest, DiagonalPassesNextToASingleBlockingCell)
+{
+    MapCollisionGrid grid;
+    ASSERT_TRUE(Load(grid, { { ".#.",
+                               "...",
+                               "..." } }));
+
+    EXPECT_FALSE(grid.IsLineBlocked(0, 0, 0, 1, 1));
+    EXPECT_FALSE(grid.IsLineBlocked(0, 0, 0, 2, 2));
+    EXPECT_FALSE(grid.IsLineBlocked(0, 2, 2, 0, 0));
+}
+
+TEST_F(MapCollisionGridTest, OutOfMapIsBlocking)
+{
+    MapCollisionGrid grid;
+    ASSERT_TRUE(Load(grid, { { "...",
+                               "..." } }));
+
+    EXPECT_TRUE(grid.IsBlocking(0, -1, 0));
+    EXPECT_TRUE(grid.IsBlocking(0, 3, 0));
+    EXPECT_TRUE(grid.IsBlocking(0, 0, 2));
+    EXPECT_TRUE(grid.IsBlocking(1, 0, 0));   // layer that doesn't exist
+    EXPECT_FALSE(grid.IsWalkable(0, 0, -1));
+
+    EXPECT_TRUE(grid.IsLineBlocked(0, 0, 0, -1, 0));
+    EXPECT_TRUE(grid.IsLineBlocked(0, 2, 1, 5, 1));
+    EXPECT_TRUE(grid.IsLineBlocked(0, 1, 1, 1, 2));
+    EXPECT_TRUE(grid.IsLineBlocked(0, 0, 0, 2, 5));
+    EXPECT_TRUE(grid.IsLineBlocked(1, 0, 0, 1, 0));
+    EXPECT_TRUE(grid.IsLineBlocked(-1, 0, 0, 1, 0));
+}
+
+TEST_F(MapCollisionGridTest, StartCellIsSkippedUnlessIncluded)
+{
+    MapCollisionGrid grid;
+    ASSERT_TRUE(Load(grid, { { "#..",
+                               "..." } }));
+
+    // An entity stuck in a blocking cell can walk out of it
+    EXPECT_FALSE(grid.IsLineBlocked(0, 0, 0, 2, 0));
+    EXPECT_TRUE(grid.IsLineBlocked(0, 0, 0, 2, 0, true));
+
+    // Starting out of the map
+    EXPECT_FALSE(grid.IsLineBlocked(0, -1, 1, 0, 1));
+    EXPECT_TRUE(grid.IsLineBlocked(0, -1, 1, 0, 1, true));
+}
+
+TEST_F(MapCollisionGridTest, LayersCollideOnlyWithThemselves)
+{
+    MapCollisionGrid grid;
+    ASSERT_TRUE(Load(grid, { { "...",
+                               "..." },
+                             { ".#.",
+                               ".#." } }));
+
+    EXPECT_FALSE(grid.IsLineBlocked(0, 0, 0, 2, 0));
+    EXPECT_TRUE(grid.IsLineBlocked(1, 0, 0, 2, 0));
+    EXPECT_TRUE(grid.IsBoxBlocked(1, 0, 0, 2, 1));
+    EXPECT_FALSE(grid.IsBoxBlocked(0, 0, 0, 2, 1));
+}
+
+TEST_F(MapCollisionGridTest, MissingMapFileFailsToLoad)
+{
+    MapCollisionGrid grid;
+    EXPECT_FALSE(grid.LoadFromFile("necro_test_missing.nmap"));
+    EXPECT_FALSE(grid.IsLoaded());
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "NDBReader.h"
+
+namespace
+{
+    using namespace NECRO;
+
+    const char* TEST_STRUCTURE =
+        "DEFINITION_START\n"
+        "ID:test_db\n"
+        "DEFINITION_END\n"
+        "STRUCTURE_START\n"
+        "ID:int\n"
+        "Name:string\n"
+        "Speed:float\n"
+        "Enabled:bool\n"
+        "STRUCTURE_END\n";
+
+    // Writes the NDB in the test temp dir and removes it when the test ends
+    class NDBReaderTest : public ::testing::Test
+    {
+    protected:
+        std::string m_path;
+
+        void SetUp() override
+        {
+            m_path = ::testing::TempDir() + "necro_test.ndb";
+        }
+
+        void TearDown() override
+        {
+            std::remove(m_path.c_str());
+        }
+
+        void WriteFile(const std::string& content)
+        {
+            std::ofstream file(m_path, std::ios::trunc);
+            file << content;
+        }
+
+        // Opens a NDB with TEST_STRUCTURE and the given rows, true if all the rows were read without errors
+        bool ReadRows(const std::string& rows, size_t& outRowsRead)
+        {
+            WriteFile(std::string(TEST_STRUCTURE) + rows);
+
+            NDBReader reader;
+            if (!reader.Open(m_path))
+                return false;
+
+            NDBRow row;
+            uint32_t rowID = 0;
+            while (reader.ReadRow(row, rowID));
+
+            outRowsRead = reader.GetRowsRead();
+            return !reader.HasFailed();
+        }
+    };
+}
+
+TEST_F(NDBReaderTest, ReadsRowsIntoTheColumnsSlots)
+{
+    WriteFile(std::string(TEST_STRUCTURE) +
+        "ROWS_START\n"
+        "# comment\n"
+        "1, First Row, 1.5, true;\n"
+        "\n"
+        "7, Second, -2, false;\n"
+        "ROWS_END\n"
+        "NDB_END\n");
+
+    NDBReader reader;
+    ASSERT_TRUE(reader.Open(m_path));
+    EXPECT_EQ(reader.GetID(), "test_db");
+
+    NDBColumn<int> id("ID");
+    NDBColumn<std::string> name("Name");
+    NDBColumn<float> speed("Speed");
+    NDBColumn<bool> enabled("Enabled");
+    ASSERT_TRUE(reader.GetSchema().Bind(id, name, speed, enabled));
+
+    NDBRow row;
+    uint32_t rowID = 0;
+
+    ASSERT_TRUE(reader.ReadRow(row, rowID));
+    EXPECT_EQ(rowID, 1u);
+    EXPECT_EQ(id.Get(row), 1);
+    EXPECT_EQ(name.Get(row), "FirstRow");   // spaces are deleted
+    EXPECT_FLOAT_EQ(speed.Get(row), 1.5f);
+    EXPECT_TRUE(enabled.Get(row));
+
+    ASSERT_TRUE(reader.ReadRow(row, rowID));
+    EXPECT_EQ(rowID, 7u);
+    EXPECT_EQ(name.Get(row), "Second");
+    EXPECT_FLOAT_EQ(speed.Get(row), -2.0f);
+    EXPECT_FALSE(enabled.Get(row));
+
+    EXPECT_FALSE(reader.ReadRow(row, rowID));
+    EXPECT_FALSE(reader.HasFailed());
+    EXPECT_EQ(reader.GetRowsRead(), 2u);
+}
+
+TEST_F(NDBReaderTest, MissingFileFailsToOpen)
+{
+    NDBReader reader;
+    EXPECT_FALSE(reader.Open(::testing::TempDir() + "necro_test_missing.ndb"));
+    EXPECT_TRUE(reader.HasFailed());
+}
+
+TEST_F(NDBReaderTest, MalformedStructureFailsToOpen)
+{
+    NDBReader reader;
+
+    // Unsupported type
+    WriteFile("STRUCTURE_START\nID:int\nName:text\nSTRUCTURE_END\nROWS_START\nROWS_END\n");
+    EXPECT_FALSE(reader.Open(m_path));
+    EXPECT_TRUE(reader.HasFailed());
+
+    // The first column is not the int ID
+    WriteFile("STRUCTURE_START\nName:string\nID:int\nSTRUCTURE_END\nROWS_START\nROWS_END\n");
+    EXPECT_FALSE(reader.Open(m_path));
+    EXPECT_TRUE(reader.HasFailed());
+
+    // Column defined twice
+    WriteFile("STRUCTURE_START\nID:int\nName:string\nName:string\nSTRUCTURE_END\nROWS_START\nROWS_END\n");
+    EXPECT_FALSE(reader.Open(m_path));
+    EXPECT_TRUE(reader.HasFailed());
+
+    // Rows without a structure
+    WriteFile("DEFINITION_START\nID:test_db\nDEFINITION_END\nROWS_START\n1;\nROWS_END\n");
+    EXPECT_FALSE(reader.Open(m_path));
+    EXPECT_TRUE(reader.HasFailed());
+}
+
+TEST_F(NDBReaderTest, WrongNumberOfValuesFails)
+{
+    size_t rowsRead = 0;
+
+    EXPECT_FALSE(ReadRows("ROWS_START\n1, Name, 1.0, true;\n2, Name, 1.0, true, extra;\nROWS_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 1u);
+
+    EXPECT_FALSE(ReadRows("ROWS_START\n1, Name, 1.0;\nROWS_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 0u);
+}
+
+TEST_F(NDBReaderTest, BadIntFails)
+{
+    size_t rowsRead = 0;
+
+    EXPECT_FALSE(ReadRows("ROWS_START\nabc, Name, 1.0, true;\nROWS_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 0u);
+
+    // Trailing characters aren't ignored
+    EXPECT_FALSE(ReadRows("ROWS_START\n12abc, Name, 1.0, true;\nROWS_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 0u);
+
+    EXPECT_FALSE(ReadRows("ROWS_START\n99999999999, Name, 1.0, true;\nROWS_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 0u);
+}
+
+TEST_F(NDBReaderTest, BadFloatFails)
+{
+    size_t rowsRead = 0;
+
+    EXPECT_FALSE(ReadRows("ROWS_START\n1, Name, fast, true;\nROWS_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 0u);
+
+    EXPECT_FALSE(ReadRows("ROWS_START\n1, Name, 1.5x, true;\nROWS_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 0u);
+
+    EXPECT_FALSE(ReadRows("ROWS_START\n1, Name, , true;\nROWS_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 0u);
+}
+
+TEST_F(NDBReaderTest, MissingRowsEndFails)
+{
+    size_t rowsRead = 0;
+
+    // Truncated file, the rows read are only part of the NDB
+    EXPECT_FALSE(ReadRows("ROWS_START\n1, Name, 1.0, true;\n2, Name, 2.0, false;\n", rowsRead));
+    EXPECT_EQ(rowsRead, 2u);
+
+    // NDB_END closes the rows too
+    EXPECT_TRUE(ReadRows("ROWS_START\n1, Name, 1.0, true;\nNDB_END\n", rowsRead));
+    EXPECT_EQ(rowsRead, 1u);
+}
+
+TEST_F(NDBReaderTest, NoRowsIsValid)
+{
+    WriteFile(std::string(TEST_STRUCTURE) + "NDB_END\n");
+
+    NDBReader reader;
+    ASSERT_TRUE(reader.Open(m_path));
+
+    NDBRow row;
+    uint32_t rowID = 0;
+    EXPECT_FALSE(reader.ReadRow(row, rowID));
+    EXPECT_FALSE(reader.HasFailed());
+    EXPECT_EQ(reader.GetRowsRead(), 0u);
+}
@@ -256,3 +256,70 @@ TEST(NetworkMessage, TwoFramesInBufferDecryptSequentially)
 
     EXPECT_EQ(receiver.GetActiveSize(), 0u);
 }
+
+TEST(NetworkMessage, AESEncryptAppendBatchDecryptsInOrder)
+{
+    auto key = MakeKey();
+    AES::IV iv;
+    std::vector<uint8_t> aad;
+
+    // Different sizes, enough of them to outgrow the default buffer of the batch
+    std::vector<std::vector<uint8_t>> packets;
+    for (size_t size : { 1, 37, 200, 480, 16, 480, 300, 480, 480, 480, 480, 480 })
+    {
+        std::vector<uint8_t> p(size);
+        for (size_t i = 0; i < size; ++i)
+            p[i] = static_cast<uint8_t>(packets.size() * 31 + i);
+        packets.push_back(std::move(p));
+    }
+
+    NetworkMessage batch;
+    size_t expectedSize = 0;
+    for (const auto& p : packets)
+    {
+        ASSERT_EQ(batch.AESEncryptAppend(p.data(), p.size(), key.data(), iv, aad.data(), static_cast<int>(aad.size())), static_cast<int>(p.size()));
+        expectedSize += FRAME_HEADER_SIZE + GCM_IV_SIZE + GCM_TAG_SIZE + p.size();
+    }
+    ASSERT_GT(expectedSize, Packet::DEFAULT_PCKT_SIZE);
+    ASSERT_EQ(batch.GetActiveSize(), expectedSize);
+
+    // One write on the wire, received in one go
+    NetworkMessage receiver;
+    receiver.Write(batch.GetReadPointer(), batch.GetActiveSize());
+
+    uint64_t expectedCounterForNextPacket = 0;
+    for (const auto& p : packets)
+    {
+        int pt = receiver.AESDecrypt(key.data(), aad.data(), static_cast<int>(aad.size()), expectedCounterForNextPacket);
+        ASSERT_EQ(pt, static_cast<int>(p.size()));
+        EXPECT_EQ(0, std::memcmp(receiver.GetDecryptedPacketPtr(), p.data(), p.size()));
+    }
+
+    EXPECT_EQ(receiver.GetActiveSize(), 0u);
+}
+
+TEST(NetworkMessage, AESEncryptAppendFollowsAESEncryptCounter)
+{
+    auto key = MakeKey();
+    AES::IV iv;
+    std::vector<uint8_t> aad = { 'B', 'C' };
+
+    std::vector<uint8_t> p1 = { 'o','w','n' };
+    std::vector<uint8_t> p2 = { 's','h','a','r','e','d' };
+
+    // A packet of the session itself followed by an appended broadcast, on the same IV
+    NetworkMessage message;
+    EncryptFrame(message, p1, key, iv, aad);
+    ASSERT_GE(message.AESEncryptAppend(p2.data(), p2.size(), key.data(), iv, aad.data(), static_cast<int>(aad.size())), 0);
+
+    NetworkMessage receiver;
+    receiver.Write(message.GetReadPointer(), message.GetActiveSize());
+
+    uint64_t expectedCounterForNextPacket = 0;
+
+    ASSERT_EQ(receiver.AESDecrypt(key.data(), aad.data(), static_cast<int>(aad.size()), expectedCounterForNextPacket), static_cast<int>(p1.size()));
+    EXPECT_EQ(0, std::memcmp(receiver.GetDecryptedPacketPtr(), p1.data(), p1.size()));
+
+    ASSERT_EQ(receiver.AESDecrypt(key.data(), aad.data(), static_cast<int>(aad.size()), expectedCounterForNextPacket), static_cast<int>(p2.size()));
+    EXPECT_EQ(0, std::memcmp(receiver.GetDecryptedPacketPtr(), p2.data(), p2.size()));
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "SessionKeyHandoff.h"
+
+namespace
+{
+    using namespace NECRO;
+
+    const std::string SECRET = "handoff-test-secret";
+
+    SessionKeyHandoffMessage MakeMessage()
+    {
+        SessionKeyHandoffMessage msg;
+        msg.accountID = 4242;
+        msg.issuedAt = 1700000000ull;
+        for (size_t i = 0; i < msg.greetCode.size(); ++i)
+        {
+            msg.greetCode[i] = static_cast<uint8_t>(0xA0 + i);
+            msg.sessionKey[i] = static_cast<uint8_t>(0x10 + i);
+        }
+        return msg;
+    }
+}
+
+TEST(SessionKeyHandoff, RoundtripRecoversMessage)
+{
+    SessionKeyHandoffMessage sent = MakeMessage();
+
+    std::array<uint8_t, SESSION_KEY_HANDOFF_MESSAGE_SIZE> datagram{};
+    sent.Serialize(SECRET, datagram.data());
+
+    SessionKeyHandoffMessage received;
+    ASSERT_TRUE(received.Deserialize(SECRET, datagram.data(), datagram.size()));
+
+    EXPECT_EQ(received.accountID, sent.accountID);
+    EXPECT_EQ(received.issuedAt, sent.issuedAt);
+    EXPECT_EQ(received.greetCode, sent.greetCode);
+    EXPECT_EQ(received.sessionKey, sent.sessionKey);
+}
+
+TEST(SessionKeyHandoff, WrongSecretRejected)
+{
+    std::array<uint8_t, SESSION_KEY_HANDOFF_MESSAGE_SIZE> datagram{};
+    MakeMessage().Serialize(SECRET, datagram.data());
+
+    SessionKeyHandoffMessage received;
+    EXPECT_FALSE(received.Deserialize("another-secret", datagram.data(), datagram.size()));
+}
+
+TEST(SessionKeyHandoff, TamperedPayloadRejected)
+{
+    std::array<uint8_t, SESSION_KEY_HANDOFF_MESSAGE_SIZE> datagram{};
+    MakeMessage().Serialize(SECRET, datagram.data());
+
+    // Every byte of the payload is covered by the HMAC
+    for (size_t i = sizeof(uint32_t); i < SESSION_KEY_HANDOFF_PAYLOAD_SIZE; ++i)
+    {
+        auto tampered = datagram;
+        tampered[i] ^= 0x01;
+
+        SessionKeyHandoffMessage received;
+        EXPECT_FALSE(received.Deserialize(SECRET, tampered.data(), tampered.size())) << "byte " << i;
+    }
+}
+
+TEST(SessionKeyHandoff, TamperedHMACRejected)
+{
+    std::array<uint8_t, SESSION_KEY_HANDOFF_MESSAGE_SIZE> datagram{};
+    MakeMessage().Serialize(SECRET, datagram.data());
+
+    datagram[SESSION_KEY_HANDOFF_MESSAGE_SIZE - 1] ^= 0x80;
+
+    SessionKeyHandoffMessage received;
+    EXPECT_FALSE(received.Deserialize(SECRET, datagram.data(), datagram.size()));
+}
+
+TEST(SessionKeyHandoff, WrongSizeOrMagicRejected)
+{
+    std::array<uint8_t, SESSION_KEY_HANDOFF_MESSAGE_SIZE + 1> datagram{};
+    MakeMessage().Serialize(SECRET, datagram.data());
+
+    SessionKeyHandoffMessage received;
+    EXPECT_FALSE(received.Deserialize(SECRET, datagram.data(), SESSION_KEY_HANDOFF_MESSAGE_SIZE - 1));
+    EXPECT_FALSE(received.Deserialize(SECRET, datagram.data(), SESSION_KEY_HANDOFF_MESSAGE_SIZE + 1));
+
+    datagram[0] ^= 0xFF;
+    EXPECT_FALSE(received.Deserialize(SECRET, datagram.data(), SESSION_KEY_HANDOFF_MESSAGE_SIZE));
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <algorithm>
+
+#include "CharacterData.h"
+#include "CharactersDatabase.h"
+
+namespace NECRO
+{
+namespace World
+{
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Write-through cache of the characters rows, by account. The world server is the only writer of necrochars.characters,
+	// so once an account is loaded (first CHAR_SEL_ENUM) its characters list and enter-world lookups are served from here.
+	//
+	// - Populated with the result of CHAR_SEL_ENUM. An account already cached is never overwritten by a populate, the cached
+	//   rows have the saves that may not have reached MySQL yet (journal)
+	// - Saves update the cached rows, deletes remove them, creates invalidate the account (the new ID is only known by MySQL)
+	// - Bounded to maxAccounts, least recently used accounts are evicted first. maxAccounts = 0 disables the cache
+	//
+	// Called from the NetworkThreads (enum, enter world, create, delete) and the simulation thread (saves).
+	// -------------------------------------------------------------------------------------------------------------------------
+	class CharacterCache
+	{
+	private:
+		struct AccountEntry
+		{
+			std::vector<CharacterRow>		characters;	// id and accountID are always set
+			std::list<uint32_t>::iterator	lruIt;
+		};
+
+		std::mutex m_mutex;
+
+		size_t m_maxAccounts = 0;
+
+		// AccountID -> characters
+		// CharID -> AccountID
+		std::unordered_map<uint32_t, AccountEntry>	m_accounts;
+		std::unordered_map<uint32_t, uint32_t>		m_charIdToAccount;
+		std::list<uint32_t>							m_lru; // most recently used first
+
+		uint64_t m_hits = 0;
+		uint64_t m_misses = 0;
+
+		void Touch(AccountEntry& entry)
+		{
+			m_lru.splice(m_lru.begin(), m_lru, entry.lruIt);
+		}
+
+		void EraseAccount(std::unordered_map<uint32_t, AccountEntry>::iterator it)
+		{
+			for (const CharacterRow& c : it->second.characters)
+				m_charIdToAccount.erase(c.id);
+
+			m_lru.erase(it->second.lruIt);
+			m_accounts.erase(it);
+		}
+
+	public:
+		void Setup(size_t maxAccounts)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_maxAccounts = maxAccounts;
+		}
+
+		bool IsEnabled() const
+		{
+			return m_maxAccounts > 0;
+		}
+
+		// Characters list of the account, false if it's not cached
+		bool GetAccountCharacters(uint32_t accountID, std::vector<CharacterRow>& out)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto it = m_accounts.find(accountID);
+			if (it == m_accounts.end())
+			{
+				m_misses++;
+				return false;
+			}
+
+			m_hits++;
+			Touch(it->second);
+			out = it->second.characters;
+			return true;
+		}
+
+		// Same row CHAR_SEL_BY_CHARID would return, false if it's not cached
+		bool GetCharacter(uint32_t charID, CharacterRow& out)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto cIt = m_charIdToAccount.find(charID);
+			if (cIt == m_charIdToAccount.end())
+			{
+				m_misses++;
+				return false;
+			}
+
+			AccountEntry& entry = m_accounts[cIt->second];
+			for (const CharacterRow& c : entry.characters)
+			{
+				if (c.id == charID)
+				{
+					m_hits++;
+					Touch(entry);
+					out = c;
+					return true;
+				}
+			}
+
+			m_misses++;
+			return false;
+		}
+
+		// Rows of CHAR_SEL_ENUM for accountID
+		void PopulateAccount(uint32_t accountID, const std::vector<CharacterRow>& rows)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (m_maxAccounts == 0 || m_accounts.find(accountID) != m_accounts.end())
+				return;
+
+			while (m_accounts.size() >= m_maxAccounts && !m_lru.empty())
+				EraseAccount(m_accounts.find(m_lru.back()));
+
+			m_lru.push_front(accountID);
+
+			AccountEntry& entry = m_accounts[accountID];
+			entry.lruIt = m_lru.begin();
+			entry.characters = rows;
+
+			for (CharacterRow& c : entry.characters)
+			{
+				c.accountID = accountID;
+				m_charIdToAccount[c.id] = accountID;
+			}
+		}
+
+		// Write-through of a save, only the saved columns
+		void UpdateCharacter(const CharacterData& charData)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto it = m_accounts.find(charData.accountID);
+			if (it == m_accounts.end())
+				return;
+
+			for (CharacterRow& c : it->second.characters)
+			{
+				if (c.id == charData.id)
+				{
+					c.level = charData.level;
+					c.xp = charData.xp;
+					c.zone = charData.zone;
+					c.pos_x = charData.pos_x;
+					c.pos_y = charData.pos_y;
+					c.pos_z = charData.pos_z;
+					return;
+				}
+			}
+		}
+
+		void RemoveCharacter(uint32_t accountID, uint32_t charID)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto it = m_accounts.find(accountID);
+			if (it == m_accounts.end())
+				return;
+
+			std::vector<CharacterRow>& chars = it->second.characters;
+			auto removed = std::remove_if(chars.begin(), chars.end(), [charID](const CharacterRow& c) { return c.id == charID; });
+			if (removed == chars.end())
+				return; // not a character of this account
+
+			chars.erase(removed, chars.end());
+			m_charIdToAccount.erase(charID);
+		}
+
+		// The account is reloaded from MySQL on its next enum
+		void InvalidateAccount(uint32_t accountID)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto it = m_accounts.find(accountID);
+			if (it != m_accounts.end())
+				EraseAccount(it);
+		}
+
+		void GetStats(size_t& accounts, uint64_t& hits, uint64_t& misses)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			accounts = m_accounts.size();
+			hits = m_hits;
+			misses = m_misses;
+		}
+	};
+}
+}
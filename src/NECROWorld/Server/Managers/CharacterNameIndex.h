@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
+
+namespace NECRO
+{
+namespace World
+{
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Names of all the characters, loaded at startup, to answer "is this name taken?" without querying MySQL.
+	//
+	// The names are kept case-folded (names are ASCII alphanumeric, MySQL compares them case-insensitive), so the index
+	// matches the UNIQUE key on characters.name. The insert still checks the name on MySQL, which stays the final arbiter.
+	// Without that key (sql/CHARACTERS_NAME_UNIQUE.sql not applied) the insert can't, so the MySQL name check is kept.
+	//
+	// Called from the NetworkThreads.
+	// -------------------------------------------------------------------------------------------------------------------------
+	class CharacterNameIndex
+	{
+	private:
+		std::mutex						m_mutex;
+		std::unordered_set<std::string>	m_names;
+		std::atomic<bool>				m_loaded{ false };
+		std::atomic<bool>				m_uniqueEnforced{ false };
+
+	public:
+		static std::string Normalize(const std::string& name)
+		{
+			std::string normalized(name);
+			for (char& c : normalized)
+				if (c >= 'A' && c <= 'Z')
+					c = static_cast<char>(c - 'A' + 'a');
+
+			return normalized;
+		}
+
+		// Only a loaded index can answer, until then the checks go to MySQL
+		bool IsLoaded() const
+		{
+			return m_loaded.load(std::memory_order_acquire);
+		}
+
+		void SetLoaded()
+		{
+			m_loaded.store(true, std::memory_order_release);
+		}
+
+		// Whether MySQL has the name_UNIQUE key, checked at startup. Until then the insert isn't trusted to reject a taken name
+		bool IsUniqueEnforced() const
+		{
+			return m_uniqueEnforced.load(std::memory_order_acquire);
+		}
+
+		void SetUniqueEnforced(bool enforced)
+		{
+			m_uniqueEnforced.store(enforced, std::memory_order_release);
+		}
+
+		void Add(const std::string& name)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_names.insert(Normalize(name));
+		}
+
+		void Remove(const std::string& name)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_names.erase(Normalize(name));
+		}
+
+		bool IsTaken(const std::string& name)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_names.find(Normalize(name)) != m_names.end();
+		}
+
+		size_t Size()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_names.size();
+		}
+	};
+}
+}
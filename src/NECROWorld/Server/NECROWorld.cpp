@@ -2,7 +2,11 @@
 
 #include "SocketUtility.h"
 #include "TCPSocket.h"
+#include "ProcessMemory.h"
 #include <memory>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
 
 namespace NECRO
 {
@@ -12,13 +16,23 @@ namespace World
 	{
 		auto& conf = Config::Instance();
 
-		// Apply config
-		ConsoleLogger::Instance().m_logEnabled = conf.GetBool("ConsoleLoggingEnabled", true);
-		FileLogger::Instance().m_logEnabled = conf.GetBool("FileLoggingEnabled", true);
+		// Apply config, logging and the other settings that can change while running
+		ApplyLiveSettings(conf, false);
 
-		// Initialize the log levels
-		ConsoleLogger::Instance().m_logEnabledSet = std::bitset<static_cast<int>(Logger::LogLevel::LAST_VALUE)>(conf.GetString("ConsoleLoggingLevel", "111111"));
-		FileLogger::Instance().m_logEnabledSet = std::bitset<static_cast<int>(Logger::LogLevel::LAST_VALUE)>(conf.GetString("FileLoggingLevel", "111111"));
+		// Log lines are written by the LogBackend thread, when a thread's ring is full its lines are dropped (and counted) or it waits
+		if (conf.GetBool("AsyncLoggingEnabled", true))
+		{
+			LogOverflowPolicy policy = conf.GetString("AsyncLoggingOverflowPolicy", "drop") == "block" ? LogOverflowPolicy::BLOCK : LogOverflowPolicy::DROP;
+			LogBackend::Instance().Start(conf.GetInt("AsyncLoggingRingSize", 8192), policy, conf.GetInt("AsyncLoggingFlushIntervalMs", 1000));
+		}
+
+		// The file lines are recorded unformatted in the binary log instead, decoded offline with --decode-log
+		if (conf.GetBool("BinaryLoggingEnabled", false))
+		{
+			std::string binaryLogFile = conf.GetString("BinaryLoggingFile", "worldserver.nlog");
+			if (!BinaryLog::Instance().Open(binaryLogFile, conf.GetInt("BinaryLoggingFlushIntervalMs", 1000)))
+				LOG_ERROR("Could not open the binary log '{}', the file lines stay in text.", binaryLogFile);
+		}
 
 		m_configSettings.CLIENT_VERSION_MAJOR = conf.GetInt("CLIENT_VERSION_MAJOR", 1);
 		m_configSettings.CLIENT_VERSION_MINOR = conf.GetInt("CLIENT_VERSION_MINOR", 0);
@@ -26,24 +40,141 @@ namespace World
 
 		m_configSettings.DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS = conf.GetInt("DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS", 60000);
 		m_configSettings.IP_BASED_REQUEST_CLEANUP_INTERVAL_MS = conf.GetInt("IP_BASED_REQUEST_CLEANUP_INTERVAL_MS", 120000);
+		m_configSettings.DATABASE_STATS_REPORT_INTERVAL_MS = conf.GetInt("DATABASE_STATS_REPORT_INTERVAL_MS", 60000);
+		m_configSettings.DATABASE_STATS_FILE = conf.GetString("DATABASE_STATS_FILE", "");
 
 		m_configSettings.MANAGER_SERVER_PORT = conf.GetInt("MANAGER_SERVER_PORT", 61532);
 		m_configSettings.NETWORK_THREADS_COUNT = conf.GetInt("NETWORK_THREADS_COUNT", 1);
 		m_configSettings.ASIO_THREADS_COUNT = conf.GetInt("ASIO_THREADS_COUNT", 1);
 		m_configSettings.MAX_CONNECTED_CLIENTS_PER_THREAD = conf.GetInt("MAX_CONNECTED_CLIENTS_PER_THREAD", -1);
-		m_configSettings.CONNECTED_AND_IDLE_TIMEOUT_MS = conf.GetInt("CONNECTED_AND_IDLE_TIMEOUT_MS", 300000);
 		m_configSettings.LOGIN_DATABASE_THREADS_COUNT = conf.GetInt("LOGIN_DATABASE_THREADS_COUNT", 1);
 		m_configSettings.CHARACTERS_DATABASE_THREADS_COUNT = conf.GetInt("CHARACTERS_DATABASE_THREADS_COUNT", 1);
+		m_configSettings.LOGIN_DATABASE_MAX_THREADS_COUNT = conf.GetInt("LOGIN_DATABASE_MAX_THREADS_COUNT", -1);
+		m_configSettings.CHARACTERS_DATABASE_MAX_THREADS_COUNT = conf.GetInt("CHARACTERS_DATABASE_MAX_THREADS_COUNT", -1);
+		m_configSettings.DATABASE_ELASTIC_GROW_QUEUE_DEPTH = conf.GetInt("DATABASE_ELASTIC_GROW_QUEUE_DEPTH", 256);
+		m_configSettings.DATABASE_ELASTIC_GROW_WAIT_MS = conf.GetInt("DATABASE_ELASTIC_GROW_WAIT_MS", 200);
+		m_configSettings.DATABASE_ELASTIC_SHRINK_IDLE_MS = conf.GetInt("DATABASE_ELASTIC_SHRINK_IDLE_MS", 300000);
 
 		// Spam prevention
-		m_configSettings.ENABLE_SPAM_PREVENTION = conf.GetInt("ENABLE_SPAM_PREVENTION", 1);
 		m_configSettings.CONNECTION_ATTEMPT_CLEANUP_INTERVAL_MIN = conf.GetInt("CONNECTION_ATTEMPT_CLEANUP_INTERVAL_MIN", 1);
-		m_configSettings.MAX_CONNECTION_ATTEMPTS_PER_INTERVAL = conf.GetInt("MAX_CONNECTION_ATTEMPTS_PER_INTERVAL", 10);
+
+		// WorldCmds recording
+		m_configSettings.WORLD_CMD_RECORDING_ENABLED = conf.GetBool("WORLD_CMD_RECORDING_ENABLED", false);
+		m_configSettings.WORLD_CMD_RECORDING_FILE = conf.GetString("WORLD_CMD_RECORDING_FILE", "worldcmds.rec");
+
+		m_configSettings.CHARACTER_JOURNAL_ENABLED = conf.GetBool("CHARACTER_JOURNAL_ENABLED", true);
+		m_configSettings.CHARACTER_JOURNAL_FILE = conf.GetString("CHARACTER_JOURNAL_FILE", "characters.journal");
+		m_configSettings.CHARACTER_JOURNAL_FSYNC_INTERVAL_MS = conf.GetInt("CHARACTER_JOURNAL_FSYNC_INTERVAL_MS", 50);
+		m_configSettings.CHARACTER_JOURNAL_FLUSH_INTERVAL_MS = conf.GetInt("CHARACTER_JOURNAL_FLUSH_INTERVAL_MS", 1000);
+		m_configSettings.CHARACTER_JOURNAL_COMPACT_SIZE_KB = conf.GetInt("CHARACTER_JOURNAL_COMPACT_SIZE_KB", 4096);
+
+		m_configSettings.CHARACTER_SAVE_INTERVAL_MS = conf.GetInt("CHARACTER_SAVE_INTERVAL_MS", 300000);
+		m_configSettings.CHARACTER_CACHE_MAX_ACCOUNTS = conf.GetInt("CHARACTER_CACHE_MAX_ACCOUNTS", 20000);
+		m_configSettings.CHARACTER_NAME_INDEX_ENABLED = conf.GetBool("CHARACTER_NAME_INDEX_ENABLED", true);
+
+		m_configSettings.SESSION_KEY_HANDOFF_PORT = conf.GetInt("SESSION_KEY_HANDOFF_PORT", 61600);
+		m_configSettings.SESSION_KEY_HANDOFF_SECRET = conf.GetString("SESSION_KEY_HANDOFF_SECRET", "");
+
+		// Tick profiler
+		m_configSettings.TICK_PROFILER_ENABLED = conf.GetBool("TICK_PROFILER_ENABLED", true);
+		m_configSettings.TICK_PROFILER_SLOW_TICK_MS = conf.GetInt("TICK_PROFILER_SLOW_TICK_MS", 50);
+		m_configSettings.TICK_PROFILER_REPORT_INTERVAL_MS = conf.GetInt("TICK_PROFILER_REPORT_INTERVAL_MS", 60000);
+
+		// Zones lifecycle
+		m_configSettings.ZONE_HIBERNATE_AFTER_MS = conf.GetInt("ZONE_HIBERNATE_AFTER_MS", 30000);
+		m_configSettings.ZONE_TEARDOWN_AFTER_MS = conf.GetInt("ZONE_TEARDOWN_AFTER_MS", 600000);
+		m_configSettings.ZONE_SHELL_POOL_SIZE = conf.GetInt("ZONE_SHELL_POOL_SIZE", 8);
+
+		m_configSettings.NDB_RELOAD_CHECK_INTERVAL_MS = conf.GetInt("NDB_RELOAD_CHECK_INTERVAL_MS", 5000);
+		m_configSettings.CONFIG_RELOAD_CHECK_INTERVAL_MS = conf.GetInt("CONFIG_RELOAD_CHECK_INTERVAL_MS", 5000);
 
 		m_configSettings.LOGIN_DATABASE_URI = conf.GetString("LOGIN_DATABASE_URI", "");
 		m_configSettings.CHARACTERS_DATABASE_URI = conf.GetString("CHARACTERS_DATABASE_URI", "");
 	}
 
+	int Server::LoadNDBs()
+	{
+		// Write time of the files loaded, the reload check compares against it
+		if (!NDBDataStoreManager::GetLastWriteTime(m_ndbsWriteTime))
+			LOG_WARNING("Could not read the write time of the NDBs, they won't be reloaded when they change.");
+
+		// Stores are populated straight from the NDB files, one row at a time, so the whole NDBs are never in memory
+		auto stores = std::make_shared<NDBDataStoreManager>();
+		int ndbsStoresReturnVal = stores->LoadAll();
+		if (ndbsStoresReturnVal == 0)
+		{
+			LOG_ERROR("m_dataStores.LoadAll returned 0!");
+			return -9;
+		}
+		else
+			LOG_OK("Loaded {} NDBDataStores!", ndbsStoresReturnVal);
+
+		stores->SetVersion(++m_dataStoresVersion);
+		std::atomic_store(&m_dataStores, std::shared_ptr<const NDBDataStoreManager>(std::move(stores)));
+
+		LOG_INFO("Memory after loading the NDBDataStores: RSS {} MB, peak RSS {} MB.", Utility::GetCurrentRSS() / (1024 * 1024), Utility::GetPeakRSS() / (1024 * 1024));
+		return 0;
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// Settings that can be tuned while the server is running, applied at startup and by every config reload.
+	// Invalid values are rejected and the current ones are kept
+	// ------------------------------------------------------------------------------------------------------------------
+	bool Server::ApplyLiveSettings(Config& conf, bool reload)
+	{
+		bool valid = true;
+
+		// A missing key keeps the current value, like the LiveSettings
+		ConsoleLogger::Instance().m_logEnabled = conf.GetBool("ConsoleLoggingEnabled", ConsoleLogger::Instance().m_logEnabled.load());
+		FileLogger::Instance().m_logEnabled = conf.GetBool("FileLoggingEnabled", FileLogger::Instance().m_logEnabled.load());
+
+		// Log levels of the Loggers
+		Logger::LogLevels levels = ConsoleLogger::Instance().GetEnabledLevels();
+		if (LoadLogLevels(conf, "ConsoleLoggingLevel", levels))
+			ConsoleLogger::Instance().SetEnabledLevels(levels);
+		else
+			valid = false;
+
+		levels = FileLogger::Instance().GetEnabledLevels();
+		if (LoadLogLevels(conf, "FileLoggingLevel", levels))
+			FileLogger::Instance().SetEnabledLevels(levels);
+		else
+			valid = false;
+
+		// Levels of the modules, on top of the ones of the Loggers (MLOG_ macros)
+		const std::pair<Logger::LogModule, const char*> moduleLevels[] = {
+			{ Logger::LogModule::NETWORK, "NetworkLoggingLevel" },
+			{ Logger::LogModule::DATABASE, "DatabaseLoggingLevel" },
+			{ Logger::LogModule::WORLD, "WorldLoggingLevel" },
+			{ Logger::LogModule::NDB, "NDBLoggingLevel" }
+		};
+
+		for (const auto& m : moduleLevels)
+		{
+			levels = Logger::GetModuleLevels(m.first);
+			if (LoadLogLevels(conf, m.second, levels))
+				Logger::SetModuleLevels(m.first, levels);
+			else
+				valid = false;
+		}
+
+		valid &= m_configSettings.CONNECTED_AND_IDLE_TIMEOUT_MS.Load(conf, reload);
+		valid &= m_configSettings.DATABASE_GROUP_COMMIT_MAX_BATCH.Load(conf, reload);
+		valid &= m_configSettings.DATABASE_GROUP_COMMIT_MAX_DELAY_MS.Load(conf, reload);
+		valid &= m_configSettings.ENABLE_SPAM_PREVENTION.Load(conf, reload);
+		valid &= m_configSettings.MAX_CONNECTION_ATTEMPTS_PER_INTERVAL.Load(conf, reload);
+		valid &= m_configSettings.WORLD_MIN_TICK_INTERVAL_MS.Load(conf, reload);
+
+		// At startup the pools are set up by Init, the DBWorkers pick the new values up on their next drain
+		if (reload)
+		{
+			m_loginDbPool.SetGroupCommit(m_configSettings.DATABASE_GROUP_COMMIT_MAX_BATCH.Get(), m_configSettings.DATABASE_GROUP_COMMIT_MAX_DELAY_MS.Get());
+			m_charactersDBPool.SetGroupCommit(m_configSettings.DATABASE_GROUP_COMMIT_MAX_BATCH.Get(), m_configSettings.DATABASE_GROUP_COMMIT_MAX_DELAY_MS.Get());
+		}
+
+		return valid;
+	}
+
 	int Server::Init()
 	{
 		m_isRunning = false;
@@ -75,11 +206,13 @@ namespace World
 		}
 
 		// Init DBWorkers (pools?)
-		if (m_loginDbPool.Setup(dbLoginThreadsCount, m_configSettings.LOGIN_DATABASE_URI) != 0)
+		if (m_loginDbPool.Setup(dbLoginThreadsCount, m_configSettings.LOGIN_DATABASE_URI, m_configSettings.LOGIN_DATABASE_MAX_THREADS_COUNT) != 0)
 		{
 			LOG_ERROR("Could not initialize dbworker, MySQL may be not running.");
 			return -3;
 		}
+		m_loginDbPool.SetGroupCommit(m_configSettings.DATABASE_GROUP_COMMIT_MAX_BATCH.Get(), m_configSettings.DATABASE_GROUP_COMMIT_MAX_DELAY_MS.Get());
+		m_loginDbPool.SetElasticThresholds(m_configSettings.DATABASE_ELASTIC_GROW_QUEUE_DEPTH, m_configSettings.DATABASE_ELASTIC_GROW_WAIT_MS, m_configSettings.DATABASE_ELASTIC_SHRINK_IDLE_MS);
 
 		if (m_loginDbPool.Start() != 0)
 		{
@@ -99,11 +232,13 @@ namespace World
 			return -5;
 		}
 
-		if (m_charactersDBPool.Setup(dbCharactersThreadsCount, m_configSettings.CHARACTERS_DATABASE_URI) != 0)
+		if (m_charactersDBPool.Setup(dbCharactersThreadsCount, m_configSettings.CHARACTERS_DATABASE_URI, m_configSettings.CHARACTERS_DATABASE_MAX_THREADS_COUNT) != 0)
 		{
 			LOG_ERROR("Could not initialize CharactersDBWorker, MySQL may be not running.");
 			return -6;
 		}
+		m_charactersDBPool.SetGroupCommit(m_configSettings.DATABASE_GROUP_COMMIT_MAX_BATCH.Get(), m_configSettings.DATABASE_GROUP_COMMIT_MAX_DELAY_MS.Get());
+		m_charactersDBPool.SetElasticThresholds(m_configSettings.DATABASE_ELASTIC_GROW_QUEUE_DEPTH, m_configSettings.DATABASE_ELASTIC_GROW_WAIT_MS, m_configSettings.DATABASE_ELASTIC_SHRINK_IDLE_MS);
 
 		if (m_charactersDBPool.Start() != 0)
 		{
@@ -112,32 +247,51 @@ namespace World
 		}
 		LOG_OK("Characters DBWorker started successfully! {} threads.", dbCharactersThreadsCount);
 
-		// Load NDBs
-		int ndbsLoadReturnVal = m_ndbs.LoadFromDefinition();
-
-		if (ndbsLoadReturnVal == 0)
+		// Apply the saves left unapplied by the last run before anyone can log in
+		if (m_configSettings.CHARACTER_JOURNAL_ENABLED)
 		{
-			LOG_ERROR("m_ndbs.LoadFromDefinition returned 0!");
-			return -8;
+			if (m_characterJournal.Open(m_configSettings.CHARACTER_JOURNAL_FILE, m_charactersDBPool, m_asioPool.m_ioContext, m_configSettings.CHARACTER_JOURNAL_FSYNC_INTERVAL_MS,
+										m_configSettings.CHARACTER_JOURNAL_FLUSH_INTERVAL_MS, static_cast<size_t>(m_configSettings.CHARACTER_JOURNAL_COMPACT_SIZE_KB) * 1024) != 0)
+			{
+				LOG_ERROR("Could not open the character journal at '{}'.", m_configSettings.CHARACTER_JOURNAL_FILE);
+				return -11;
+			}
 		}
-		else
-			LOG_OK("Loaded {} NDBs!", ndbsLoadReturnVal);
 
-		// After loading the NDBs, we can load the DataStores and have the fixed, contract-based agreement between game code and DB data
-		// TODO: NDB in memory footprint (even if it's just a spike at load) can become huge for very big databases (like a full fledged MMORPG items db). A better way to load the stores would be to avoid loading the whole NDB in memory first
-		// and just do: LoadOneRow -> LoadOneStoreDef -> DiscardTheNDBRow
-		int ndbsStoresReturnVal = m_dataStores.LoadAll(m_ndbs);
-		if (ndbsStoresReturnVal == 0)
+		m_characterCache.Setup(static_cast<size_t>(std::max(m_configSettings.CHARACTER_CACHE_MAX_ACCOUNTS, 0)));
+
+		// Load the character names (DirectExecute), rows are added as they're read. If it fails, name checks keep going to MySQL
+		if (m_configSettings.CHARACTER_NAME_INDEX_ENABLED)
 		{
-			LOG_ERROR("m_dataStores.LoadAll returned false! NDB: 'maps_db' could not be loaded.");
-			return -9;
+			// Without the UNIQUE key the insert can't reject a taken name, so every name keeps being checked on MySQL
+			DBRequest uniqueReq(m_asioPool.m_ioContext, false);
+			uniqueReq.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SEL_NAME_UNIQUE_INDEX), {} });
+
+			std::vector<mysqlx::SqlResult> uniqueRes = m_charactersDBPool.DirectExecute(uniqueReq);
+			m_characterNameIndex.SetUniqueEnforced(!uniqueRes.empty() && uniqueRes[0].count() > 0);
+			if (!m_characterNameIndex.IsUniqueEnforced())
+				LOG_WARNING("The name_UNIQUE key on necrochars.characters is missing (see sql/CHARACTERS_NAME_UNIQUE.sql), free names will still be checked on MySQL.");
+
+			DBRequest req(m_asioPool.m_ioContext, false);
+			req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SEL_ALL_NAMES), {} });
+
+			std::vector<mysqlx::SqlResult> res = m_charactersDBPool.DirectExecute(req);
+
+			if (!res.empty())
+			{
+				while (mysqlx::Row row = res[0].fetchOne())
+					m_characterNameIndex.Add(row[0].get<std::string>());
+
+				m_characterNameIndex.SetLoaded();
+				LOG_OK("Character name index loaded, {} names.", m_characterNameIndex.Size());
+			}
+			else
+				LOG_WARNING("Could not load the character name index, name checks will go to MySQL.");
 		}
-		else
-			LOG_OK("Loaded {} NDBDataStores!", ndbsStoresReturnVal);
 
-		// We can unload the NDBs, we don't need them anymroe
-		m_ndbs.Clear();
-		LOG_OK("Cleared {} NDBs from memory!", ndbsLoadReturnVal);
+		int ndbsRes = LoadNDBs();
+		if (ndbsRes != 0)
+			return ndbsRes;
 
 		// Start network threads
 		int threadsCount = std::thread::hardware_concurrency();
@@ -154,6 +308,11 @@ namespace World
 
 		m_socketManager = std::make_unique<SocketManager>(threadsCount, m_asioPool.m_ioContext, m_configSettings.MANAGER_SERVER_PORT);
 
+		// Optional, without it every greetcode is looked up on MySQL
+		if (!m_configSettings.SESSION_KEY_HANDOFF_SECRET.empty() &&
+			m_sessionKeyHandoff.Open(m_asioPool.m_ioContext, m_configSettings.SESSION_KEY_HANDOFF_PORT, m_configSettings.SESSION_KEY_HANDOFF_SECRET, GREETCODE_VALIDITY_TIME_WINDOW_SECONDS) != 0)
+			LOG_WARNING("Session key handoff could not be started, greetcodes will be looked up on MySQL.");
+
 		return 0;
 	}
 
@@ -176,6 +335,27 @@ namespace World
 		m_asioPool.PostWork([this]() {KeepDatabasesAliveHandler(); });
 		m_asioPool.PostWork([this]() {IPRequestMapCleanupHandler(); });
 
+		if (m_configSettings.DATABASE_STATS_REPORT_INTERVAL_MS > 0)
+		{
+			m_databaseStatsTimer.expires_after(std::chrono::milliseconds(m_configSettings.DATABASE_STATS_REPORT_INTERVAL_MS));
+			m_databaseStatsTimer.async_wait([this](boost::system::error_code const& ec) { DatabaseStatsHandler(); });
+		}
+
+		if (m_configSettings.NDB_RELOAD_CHECK_INTERVAL_MS > 0)
+		{
+			m_ndbReloadCheckTimer.expires_after(std::chrono::milliseconds(m_configSettings.NDB_RELOAD_CHECK_INTERVAL_MS));
+			m_ndbReloadCheckTimer.async_wait([this](boost::system::error_code const& ec) { NDBReloadCheckHandler(); });
+		}
+
+		if (m_configSettings.CONFIG_RELOAD_CHECK_INTERVAL_MS > 0)
+		{
+			std::error_code err;
+			m_configWriteTime = std::filesystem::last_write_time(WORLD_CONFIG_FILE_PATH, err);
+
+			m_configReloadCheckTimer.expires_after(std::chrono::milliseconds(m_configSettings.CONFIG_RELOAD_CHECK_INTERVAL_MS));
+			m_configReloadCheckTimer.async_wait([this](boost::system::error_code const& ec) { ConfigReloadCheckHandler(); });
+		}
+
 		// Start network threads
 		m_socketManager->StartThreads();
 
@@ -190,16 +370,75 @@ namespace World
 	void Server::Update()
 	{
 		LOG_INFO("Starting up world simulation...");
-		m_worldSimulation.Start();
+		if (m_worldSimulation.Start() != 0)
+		{
+			LOG_CRITICAL("World simulation failed to start!");
+			Shutdown();
+			return;
+		}
 
 		LOG_OK("NECROWorld is running!");
+		LOG_INFO("Startup peak RSS {} MB, RSS {} MB.", Utility::GetPeakRSS() / (1024 * 1024), Utility::GetCurrentRSS() / (1024 * 1024));
+
 		while (m_worldSimulation.m_isRunning)
+		{
+			auto tickStart = std::chrono::steady_clock::now();
+
 			m_worldSimulation.Update();
 
+			// Tick rate cap, read every tick so a config reload applies right away
+			uint32_t minTickInterval = m_configSettings.WORLD_MIN_TICK_INTERVAL_MS.Get();
+			if (minTickInterval > 0)
+				std::this_thread::sleep_until(tickStart + std::chrono::milliseconds(minTickInterval));
+		}
+
+		m_worldSimulation.StopRecording();
+
 		// Here if somebody called Server::Stop()
 		Shutdown();
 	}
 
+	// ------------------------------------------------------------------------------------------------------------------
+	// Headless mode: only the config, the NDBs and the WorldSimulation are brought up. No MySQL, no network.
+	// ------------------------------------------------------------------------------------------------------------------
+	int Server::InitHeadless()
+	{
+		m_isRunning = false;
+		m_isHeadless = true;
+
+		LOG_OK("Booting up NECROServer in headless mode...");
+
+		if (!Config::Instance().Load(WORLD_CONFIG_FILE_PATH))
+		{
+			LOG_ERROR("Failed to load config file at: {}", WORLD_CONFIG_FILE_PATH);
+			return -1;
+		}
+
+		ApplySettings();
+
+		// Never record while replaying
+		m_configSettings.WORLD_CMD_RECORDING_ENABLED = false;
+
+		return LoadNDBs();
+	}
+
+	int Server::RunReplay(const std::string& recordingPath, bool realTime)
+	{
+		WorldCmdReplayer replayer;
+		if (replayer.Load(recordingPath) != 0)
+			return -1;
+
+		if (m_worldSimulation.Start() != 0)
+		{
+			LOG_CRITICAL("World simulation failed to start!");
+			return -2;
+		}
+
+		int res = replayer.Run(m_worldSimulation, realTime);
+		m_worldSimulation.Stop();
+		return res;
+	}
+
 	void Server::Stop()
 	{
 		LOG_OK("Stopping NECROWorld...");
@@ -213,7 +452,14 @@ namespace World
 		// Shutdown
 		LOG_OK("Shutting down NECROWorld...");
 
+		// Sync the last saves and hand the pending ones to the DBWorkers before they drain
+		m_characterJournal.Close();
+
 		m_asioPool.Stop();
+		m_sessionKeyHandoff.Close();
+
+		if (m_ndbReloadThread.joinable())
+			m_ndbReloadThread.join();
 
 		// Shutdown DBWorkers
 		m_loginDbPool.Stop();
@@ -233,9 +479,79 @@ namespace World
 
 		LOG_OK("Shut down of NECROWorld completed.");
 
+		// Last, so the shutdown logs of every thread are written too
+		BinaryLog::Instance().Close();
+
+		// Writes the last lines, logs are synchronous from here
+		LogBackend::Instance().Stop();
+
 		return 0;
 	}
 
+	// ------------------------------------------------------------------------------------------------------------------
+	// Live reload of the NDBs: the new stores are built on their own thread, while the simulation keeps running on the
+	// current ones, and published with an atomic swap. The WorldSimulation switches to them at the next tick.
+	// ------------------------------------------------------------------------------------------------------------------
+	bool Server::ReloadNDBStores()
+	{
+		if (m_ndbReloading.exchange(true))
+			return false;
+
+		// The previous reload is done (or about to return), this doesn't block
+		if (m_ndbReloadThread.joinable())
+			m_ndbReloadThread.join();
+
+		m_ndbReloadThread = std::thread([this]()
+			{
+				LOG_INFO("[NDB] Reloading the NDBDataStores...");
+
+				auto stores = std::make_shared<NDBDataStoreManager>();
+				int loaded = 0;
+				try
+				{
+					loaded = stores->LoadAll();
+				}
+				catch (const std::exception& e)
+				{
+					LOG_ERROR("[NDB] Exception while reloading the NDBDataStores: '{}'", e.what());
+				}
+
+				if (loaded == 0)
+					LOG_ERROR("[NDB] Reload failed, the NDBDataStores version {} stays in use.", m_dataStoresVersion);
+				else
+				{
+					stores->SetVersion(++m_dataStoresVersion);
+					std::atomic_store(&m_dataStores, std::shared_ptr<const NDBDataStoreManager>(std::move(stores)));
+					LOG_OK("[NDB] Published the NDBDataStores version {} ({} stores).", m_dataStoresVersion, loaded);
+				}
+
+				m_ndbReloading = false;
+			});
+
+		return true;
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// Config hot reload: the file is read into its own Config (Config::Instance() keeps the startup values) and only the
+	// live settings are applied from it
+	// ------------------------------------------------------------------------------------------------------------------
+	bool Server::ReloadConfig()
+	{
+		Config conf;
+		if (!conf.Load(WORLD_CONFIG_FILE_PATH, false))
+		{
+			LOG_ERROR("[CONFIG] Could not reload {}.", WORLD_CONFIG_FILE_PATH);
+			return false;
+		}
+
+		if (ApplyLiveSettings(conf, true))
+			LOG_OK("[CONFIG] {} reloaded, live settings applied. The other settings need a restart.", WORLD_CONFIG_FILE_PATH);
+		else
+			LOG_WARNING("[CONFIG] {} reloaded, some live settings were rejected and kept their values.", WORLD_CONFIG_FILE_PATH);
+
+		return true;
+	}
+
 	// Asio
 	void Server::KeepDatabasesAliveHandler()
 	{
@@ -245,9 +561,13 @@ namespace World
 		m_keepLoginDatabaseAliveTimer.expires_after(std::chrono::milliseconds(m_configSettings.DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS));
 		m_keepLoginDatabaseAliveTimer.async_wait([this](boost::system::error_code const& ec) { KeepDatabasesAliveHandler(); });
 
-		// Enqueue a keep alive packet
+		// Enqueue a keep alive packet, useless if it can't run before the next one
+		const auto keepAliveDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_configSettings.DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS);
+
 		DBRequest loginKeepAlivePacket(m_asioPool.m_ioContext, true);
 		loginKeepAlivePacket.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::KEEP_ALIVE), {} });
+		loginKeepAlivePacket.m_priority = DBRequestPriority::MAINTENANCE;
+		loginKeepAlivePacket.m_deadline = keepAliveDeadline;
 		m_loginDbPool.EnqueueInAll(std::move(loginKeepAlivePacket));
 
 		// Keep alive the direct connection as well
@@ -258,6 +578,8 @@ namespace World
 		// Enqueue a keep alive packet
 		DBRequest charactersKeepAlivePacket(m_asioPool.m_ioContext, true);
 		charactersKeepAlivePacket.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::KEEP_ALIVE), {} });
+		charactersKeepAlivePacket.m_priority = DBRequestPriority::MAINTENANCE;
+		charactersKeepAlivePacket.m_deadline = keepAliveDeadline;
 		m_charactersDBPool.EnqueueInAll(std::move(charactersKeepAlivePacket));
 
 		// Keep alive the direct connection as well
@@ -276,5 +598,76 @@ namespace World
 
 		m_socketManager->IPRequestMapCleanup();
 	}
+
+	void Server::NDBReloadCheckHandler()
+	{
+		m_ndbReloadCheckTimer.expires_after(std::chrono::milliseconds(m_configSettings.NDB_RELOAD_CHECK_INTERVAL_MS));
+		m_ndbReloadCheckTimer.async_wait([this](boost::system::error_code const& ec) { NDBReloadCheckHandler(); });
+
+		std::filesystem::file_time_type writeTime;
+		if (!NDBDataStoreManager::GetLastWriteTime(writeTime) || writeTime <= m_ndbsWriteTime)
+			return;
+
+		// If a reload is still running, this change is picked up at the next check
+		if (ReloadNDBStores())
+			m_ndbsWriteTime = writeTime;
+	}
+
+	void Server::ConfigReloadCheckHandler()
+	{
+		m_configReloadCheckTimer.expires_after(std::chrono::milliseconds(m_configSettings.CONFIG_RELOAD_CHECK_INTERVAL_MS));
+		m_configReloadCheckTimer.async_wait([this](boost::system::error_code const& ec) { ConfigReloadCheckHandler(); });
+
+		std::error_code err;
+		std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(WORLD_CONFIG_FILE_PATH, err);
+		if (err || writeTime == m_configWriteTime)
+			return;
+
+		m_configWriteTime = writeTime;
+		ReloadConfig();
+	}
+
+	void Server::DatabaseStatsHandler()
+	{
+		m_databaseStatsTimer.expires_after(std::chrono::milliseconds(m_configSettings.DATABASE_STATS_REPORT_INTERVAL_MS));
+		m_databaseStatsTimer.async_wait([this](boost::system::error_code const& ec) { DatabaseStatsHandler(); });
+
+		DBStatsExposition exposition;
+		m_loginDbPool.ReportStats("login", exposition);
+		m_charactersDBPool.ReportStats("characters", exposition);
+
+		if (m_characterCache.IsEnabled())
+		{
+			size_t accounts = 0;
+			uint64_t hits = 0, misses = 0;
+			m_characterCache.GetStats(accounts, hits, misses);
+
+			LOG_INFO("[CHARACTER CACHE] {} accounts cached | {} hits | {} misses (since startup)", accounts, hits, misses);
+			exposition.Add("necro_character_cache_accounts", "gauge", " " + std::to_string(accounts));
+			exposition.Add("necro_character_cache_hits_total", "counter", " " + std::to_string(hits));
+			exposition.Add("necro_character_cache_misses_total", "counter", " " + std::to_string(misses));
+		}
+
+		if (m_configSettings.DATABASE_STATS_FILE.empty())
+			return;
+
+		// Write aside and rename, so the scraper never reads a half written file
+		const std::string tmpPath = m_configSettings.DATABASE_STATS_FILE + ".tmp";
+		{
+			std::ofstream file(tmpPath, std::ios::trunc);
+			if (!file.is_open())
+			{
+				LOG_WARNING("Could not write the DB stats file at: '{}'.", tmpPath);
+				return;
+			}
+			file << exposition.Render();
+		}
+
+		// rename replaces the file atomically on POSIX, Windows' fails if it exists
+#ifdef _WIN32
+		std::remove(m_configSettings.DATABASE_STATS_FILE.c_str());
+#endif
+		std::rename(tmpPath.c_str(), m_configSettings.DATABASE_STATS_FILE.c_str());
+	}
 }
 }
@@ -1,19 +1,29 @@
 #pragma once
 
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+
 #include <boost/asio.hpp>
 
 #include "Config.h"
+#include "LiveSetting.h"
 #include "ConsoleLogger.h"
 #include "FileLogger.h"
+#include "LogBackend.h"
 #include "DatabaseWorkerPool.h"
 #include "AsioThreadPool.h"
 #include "SocketManager.h"
 #include "WorldSimulation.h"
+#include "WorldCmdReplayer.h"
 #include "SessionManager.h"
+#include "CharacterCache.h"
+#include "CharacterNameIndex.h"
+#include "CharacterJournal.h"
+#include "SessionKeyHandoffTable.h"
 #include "NDBDataStoreManager.h"
 
-#include "NDBManager.h"
-
 namespace NECRO
 {
 // ------------------------------------------------------------------------------------------------------------------------
@@ -42,26 +52,74 @@ namespace World
 			// Handler Updates
 			uint32_t DATABASE_ALIVE_HANDLER_UPDATE_INTERVAL_MS = 60000;
 			uint32_t IP_BASED_REQUEST_CLEANUP_INTERVAL_MS = 120000;
+			uint32_t DATABASE_STATS_REPORT_INTERVAL_MS = 60000;	// 0 disables the DB stats reports
+			std::string DATABASE_STATS_FILE;					// Prometheus text file rewritten at every report, empty to disable
 
 			// Server Settings
 			uint16_t	MANAGER_SERVER_PORT = 61532;
 			int			ASIO_THREADS_COUNT = 1;
 			int			NETWORK_THREADS_COUNT = 1;
 			int			MAX_CONNECTED_CLIENTS_PER_THREAD = -1; //-1 equals to no check
-			uint32_t	CONNECTED_AND_IDLE_TIMEOUT_MS = 300000;
+			LiveSetting<uint32_t>	CONNECTED_AND_IDLE_TIMEOUT_MS{ "CONNECTED_AND_IDLE_TIMEOUT_MS", 300000, 1000, 86400000 };
 			int			LOGIN_DATABASE_THREADS_COUNT = 1;
 			int			CHARACTERS_DATABASE_THREADS_COUNT = 1;
+			int			LOGIN_DATABASE_MAX_THREADS_COUNT = -1;		// -1 (or <= THREADS_COUNT) disables the elastic pool
+			int			CHARACTERS_DATABASE_MAX_THREADS_COUNT = -1;
+			int			DATABASE_ELASTIC_GROW_QUEUE_DEPTH = 256;
+			uint32_t	DATABASE_ELASTIC_GROW_WAIT_MS = 200;
+			uint32_t	DATABASE_ELASTIC_SHRINK_IDLE_MS = 300000;
+			LiveSetting<int>		DATABASE_GROUP_COMMIT_MAX_BATCH{ "DATABASE_GROUP_COMMIT_MAX_BATCH", 64, 1, 4096 };		// 1 disables the group commit of fire-and-forget requests
+			LiveSetting<uint32_t>	DATABASE_GROUP_COMMIT_MAX_DELAY_MS{ "DATABASE_GROUP_COMMIT_MAX_DELAY_MS", 5, 0, 1000 };
 
 			// Spam prevention
-			bool		ENABLE_SPAM_PREVENTION = 1;
-			uint32_t	CONNECTION_ATTEMPT_CLEANUP_INTERVAL_MIN = 1;
-			uint32_t	MAX_CONNECTION_ATTEMPTS_PER_INTERVAL = 10;
+			LiveSetting<bool>		ENABLE_SPAM_PREVENTION{ "ENABLE_SPAM_PREVENTION", true, false, true };
+			uint32_t				CONNECTION_ATTEMPT_CLEANUP_INTERVAL_MIN = 1;
+			LiveSetting<uint32_t>	MAX_CONNECTION_ATTEMPTS_PER_INTERVAL{ "MAX_CONNECTION_ATTEMPTS_PER_INTERVAL", 10, 1, 100000 };
+
+			// WorldCmds recording
+			bool		WORLD_CMD_RECORDING_ENABLED = false;
+			std::string	WORLD_CMD_RECORDING_FILE = "worldcmds.rec";
+
+			// Character saves journal
+			bool		CHARACTER_JOURNAL_ENABLED = true;
+			std::string	CHARACTER_JOURNAL_FILE = "characters.journal";
+			uint32_t	CHARACTER_JOURNAL_FSYNC_INTERVAL_MS = 50;
+			uint32_t	CHARACTER_JOURNAL_FLUSH_INTERVAL_MS = 1000;
+			uint32_t	CHARACTER_JOURNAL_COMPACT_SIZE_KB = 4096;
+
+			uint32_t	CHARACTER_SAVE_INTERVAL_MS = 300000;
+			int			CHARACTER_CACHE_MAX_ACCOUNTS = 20000;	// 0 disables the characters cache
+			bool		CHARACTER_NAME_INDEX_ENABLED = true;
+
+			// Session key handoff from the NECROAuth on this host, an empty secret disables it
+			uint16_t	SESSION_KEY_HANDOFF_PORT = 61600;
+			std::string	SESSION_KEY_HANDOFF_SECRET;
+
+			// Tick profiler
+			bool		TICK_PROFILER_ENABLED = true;
+			uint32_t	TICK_PROFILER_SLOW_TICK_MS = 50;
+			uint32_t	TICK_PROFILER_REPORT_INTERVAL_MS = 60000;
+
+			// Zones lifecycle
+			uint32_t	ZONE_HIBERNATE_AFTER_MS = 30000;
+			uint32_t	ZONE_TEARDOWN_AFTER_MS = 600000;
+			int			ZONE_SHELL_POOL_SIZE = 8;
+
+			// NDBs are reloaded when their files change, checked every NDB_RELOAD_CHECK_INTERVAL_MS (0 disables it)
+			uint32_t	NDB_RELOAD_CHECK_INTERVAL_MS = 5000;
+
+			// Simulation ticks are at least WORLD_MIN_TICK_INTERVAL_MS apart, 0 runs them back to back
+			LiveSetting<uint32_t>	WORLD_MIN_TICK_INTERVAL_MS{ "WORLD_MIN_TICK_INTERVAL_MS", 0, 0, 1000 };
+
+			// The LiveSettings (and the log levels) are reloaded when the config file changes, checked every
+			// CONFIG_RELOAD_CHECK_INTERVAL_MS (0 disables it). The other settings need a restart
+			uint32_t	CONFIG_RELOAD_CHECK_INTERVAL_MS = 5000;
 
 			std::string LOGIN_DATABASE_URI;
 			std::string CHARACTERS_DATABASE_URI;
 		};
 
-		Server() : m_isRunning(false), m_keepLoginDatabaseAliveTimer(m_asioPool.m_ioContext), m_ipRequestCleanupTimer(m_asioPool.m_ioContext)
+		Server() : m_isRunning(false), m_keepLoginDatabaseAliveTimer(m_asioPool.m_ioContext), m_ipRequestCleanupTimer(m_asioPool.m_ioContext), m_databaseStatsTimer(m_asioPool.m_ioContext), m_ndbReloadCheckTimer(m_asioPool.m_ioContext), m_configReloadCheckTimer(m_asioPool.m_ioContext)
 		{
 		}
 
@@ -74,26 +132,48 @@ namespace World
 	private:
 		// Status
 		bool m_isRunning;
+		bool m_isHeadless = false; // running just the simulation, without databases and network (replays)
 		ConfigSettings	m_configSettings;
 
 		// Asio - AsioThreadPool owns its own m_ioContext
 		AsioThreadPool m_asioPool;
 		boost::asio::steady_timer m_keepLoginDatabaseAliveTimer;
 		boost::asio::steady_timer m_ipRequestCleanupTimer;
+		boost::asio::steady_timer m_databaseStatsTimer;
+		boost::asio::steady_timer m_ndbReloadCheckTimer;
+		boost::asio::steady_timer m_configReloadCheckTimer;
+		std::filesystem::file_time_type m_configWriteTime;
+
+		int  LoadNDBs();
 
 		void KeepDatabasesAliveHandler();
 		void IPRequestMapCleanupHandler();
+		void DatabaseStatsHandler();
+		void NDBReloadCheckHandler();
+		void ConfigReloadCheckHandler();
+
+		// Settings that can change while running, false if any was rejected
+		bool ApplyLiveSettings(Config& conf, bool reload);
 
 		// NetworkThreads
 		std::unique_ptr<SocketManager> m_socketManager;
+		SessionKeyHandoffTable m_sessionKeyHandoff;
 
 		// Databases
 		DatabaseWorkerPool<LoginDatabase>		m_loginDbPool;
 		DatabaseWorkerPool<CharactersDatabase>	m_charactersDBPool;
+		CharacterJournal						m_characterJournal;
+		CharacterCache							m_characterCache;
+		CharacterNameIndex						m_characterNameIndex;
 
 		// Simulation
-		NDBManager				m_ndbs;
-		NDBDataStoreManager		m_dataStores;
+		// Published snapshot of the stores, only accessed with std::atomic_load/std::atomic_store. Readers keep the
+		// snapshot they got alive, an old version is freed when its last reader drops it
+		std::shared_ptr<const NDBDataStoreManager>	m_dataStores;
+		uint32_t									m_dataStoresVersion = 0;
+		std::atomic<bool>							m_ndbReloading{ false };
+		std::thread									m_ndbReloadThread;
+		std::filesystem::file_time_type				m_ndbsWriteTime;
 		WorldSimulation			m_worldSimulation;
 
 		// Managers
@@ -107,6 +187,15 @@ namespace World
 		void					Stop();
 		int						Shutdown();
 
+		// Headless mode, used to replay recorded WorldCmds offline
+		int						InitHeadless();
+		int						RunReplay(const std::string& recordingPath, bool realTime);
+
+		bool IsHeadless() const
+		{
+			return m_isHeadless;
+		}
+
 		DatabaseWorkerPool<LoginDatabase>& GetLoginDBPool()
 		{
 			return m_loginDbPool;
@@ -117,21 +206,48 @@ namespace World
 			return m_charactersDBPool;
 		}
 
+		CharacterJournal& GetCharacterJournal()
+		{
+			return m_characterJournal;
+		}
+
+		CharacterCache& GetCharacterCache()
+		{
+			return m_characterCache;
+		}
+
+		CharacterNameIndex& GetCharacterNameIndex()
+		{
+			return m_characterNameIndex;
+		}
+
 		const ConfigSettings& GetSettings() const
 		{
 			return m_configSettings;
 		}
 
-		const NDBDataStoreManager& GetNDBStoresManager() const
+		// Latest published version of the stores. The WorldSimulation picks it up at tick boundaries
+		std::shared_ptr<const NDBDataStoreManager> GetNDBStores() const
 		{
-			return m_dataStores;
+			return std::atomic_load(&m_dataStores);
 		}
 
+		// Rebuilds the stores from the NDB files on a background thread and publishes them, false if a reload is already running
+		bool ReloadNDBStores();
+
+		// Reads the config file again and applies its LiveSettings and log levels, false if it couldn't be read
+		bool ReloadConfig();
+
 		AsioThreadPool& GetAsioThreadPool()
 		{
 			return m_asioPool;
 		}
 
+		SessionKeyHandoffTable& GetSessionKeyHandoff()
+		{
+			return m_sessionKeyHandoff;
+		}
+
 		SessionManager& GetSessionManager()
 		{
 			return m_sessionManager;
@@ -0,0 +1,392 @@
+#include "CharacterJournal.h"
+#include "CharacterData.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+namespace World
+{
+	CharacterJournal::~CharacterJournal()
+	{
+		Close();
+	}
+
+	int CharacterJournal::Open(const std::string& path, DatabaseWorkerPool<CharactersDatabase>& charactersDB, boost::asio::io_context& callbackContext,
+								uint32_t fsyncIntervalMs, uint32_t flushIntervalMs, size_t compactSizeBytes)
+	{
+		m_path = path;
+		m_charactersDB = &charactersDB;
+		m_callbackContext = &callbackContext;
+		m_fsyncIntervalMs = fsyncIntervalMs > 0 ? fsyncIntervalMs : 1;
+		m_flushIntervalMs = flushIntervalMs;
+		m_compactSizeBytes = compactSizeBytes;
+
+		if (Replay() != 0)
+			return -1;
+
+		// Start from a journal that contains only what's still pending. If the compaction failed, a journal of an older version
+		// can't be appended to and is restarted (what's pending is still applied from memory).
+		Compact();
+		if (!m_file && OpenFile(m_fileVersion != CHARACTER_JOURNAL_VERSION) != 0)
+			return -2;
+
+		m_running = true;
+		m_thread = std::thread(&CharacterJournal::ThreadRoutine, this);
+
+		LOG_OK("[CHARACTER JOURNAL] Journaling character saves to '{}'.", m_path);
+		return 0;
+	}
+
+	void CharacterJournal::Close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+		m_cond.notify_one();
+
+		if (m_thread.joinable())
+			m_thread.join();
+
+		CloseFile();
+	}
+
+	void CharacterJournal::Append(const CharacterData& charData, uint8_t dirtyMask, bool urgent)
+	{
+		CharacterJournalEntry entry = MakeEntry(charData, dirtyMask);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (dirtyMask == CHARACTER_DIRTY_NONE)
+			{
+				// Nothing new to journal, but the last save may still be waiting for the next flush
+				auto it = m_pending.find(entry.charID);
+				if (!urgent || it == m_pending.end() || it->second.inFlight)
+					return;
+
+				it->second.inFlight = true;
+				entry = it->second.entry;
+			}
+			else
+			{
+				entry.seq = m_nextSeq++;
+
+				// Newer saves replace the older ones, only the latest state of a character has to reach MySQL
+				PendingSave& pending = m_pending[entry.charID];
+				entry.dirtyMask |= pending.entry.dirtyMask;
+				pending.entry = entry;
+				pending.inFlight = urgent;
+
+				m_writeBuffer.push_back(entry);
+			}
+		}
+
+		if (urgent)
+			EnqueueApply(entry);
+	}
+
+	CharacterJournalEntry CharacterJournal::MakeEntry(const CharacterData& charData, uint8_t dirtyMask)
+	{
+		CharacterJournalEntry entry;
+		entry.charID = charData.id;
+		entry.accountID = charData.accountID;
+		entry.dirtyMask = dirtyMask;
+		entry.level = charData.level;
+		entry.xp = charData.xp;
+		entry.zone = charData.zone;
+		entry.pos_x = charData.pos_x;
+		entry.pos_y = charData.pos_y;
+		entry.pos_z = charData.pos_z;
+		return entry;
+	}
+
+	DBRequestStep CharacterJournal::MakeSaveStep(const CharacterJournalEntry& entry)
+	{
+		switch (entry.dirtyMask)
+		{
+			case CHARACTER_DIRTY_PROGRESS:
+				return { static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SAVE_CHARACTER_PROGRESS), { entry.level, entry.xp, entry.charID } };
+			case CHARACTER_DIRTY_LOCATION:
+				return { static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SAVE_CHARACTER_LOCATION), { entry.zone, entry.pos_x, entry.pos_y, entry.pos_z, entry.charID } };
+			default:
+				return { static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SAVE_CHARACTER), { entry.level, entry.xp, entry.zone, entry.pos_x, entry.pos_y, entry.pos_z, entry.charID } };
+		}
+	}
+
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Reads the journal left by the last run and applies the latest entry of every character (DirectExecute, the DBWorkers
+	// callbacks aren't running yet). What can't be applied stays pending.
+	// -------------------------------------------------------------------------------------------------------------------------
+	int CharacterJournal::Replay()
+	{
+		// A crash during a compaction can leave only the rewritten journal
+		std::string readPath = m_path;
+		std::vector<CharacterJournalEntry> entries;
+		uint16_t version = 0;
+
+		int res = CharacterJournalFile::Read(readPath, entries, version);
+		if (res == -1)
+		{
+			readPath = m_path + ".tmp";
+			res = CharacterJournalFile::Read(readPath, entries, version);
+		}
+
+		if (res == -1)
+			return 0; // first run
+
+		if (res != 0)
+			return -1;
+
+		const size_t records = entries.size();
+		for (CharacterJournalEntry& entry : entries)
+		{
+			auto it = m_pending.find(entry.charID);
+			if (it == m_pending.end())
+				m_pending[entry.charID].entry = entry;
+			else if (it->second.entry.seq < entry.seq)
+			{
+				entry.dirtyMask |= it->second.entry.dirtyMask;
+				it->second.entry = entry;
+			}
+
+			if (entry.seq >= m_nextSeq)
+				m_nextSeq = entry.seq + 1;
+		}
+		m_fileVersion = version;
+
+		size_t applied = 0;
+		for (auto it = m_pending.begin(); it != m_pending.end();)
+		{
+			const CharacterJournalEntry& e = it->second.entry;
+
+			DBRequest req(*m_callbackContext, false);
+			req.m_steps.push_back(MakeSaveStep(e));
+			req.m_orderingKey = e.accountID;
+
+			if (!m_charactersDB->DirectExecute(req).empty())
+			{
+				applied++;
+				it = m_pending.erase(it);
+			}
+			else
+				++it;
+		}
+
+		if (records > 0)
+			LOG_OK("[CHARACTER JOURNAL] Replayed '{}': {} records, {} characters applied, {} still pending.", readPath, records, applied, m_pending.size());
+
+		return 0;
+	}
+
+	int CharacterJournal::OpenFile(bool truncate)
+	{
+		m_file = std::fopen(m_path.c_str(), truncate ? "wb" : "ab");
+		if (!m_file)
+		{
+			LOG_ERROR("[CHARACTER JOURNAL] Could not open the journal at '{}'.", m_path);
+			return -1;
+		}
+
+		std::fseek(m_file, 0, SEEK_END);
+		m_fileSize = static_cast<size_t>(std::ftell(m_file));
+
+		if (m_fileSize == 0)
+		{
+			std::fwrite(&CHARACTER_JOURNAL_MAGIC, sizeof(CHARACTER_JOURNAL_MAGIC), 1, m_file);
+			std::fwrite(&CHARACTER_JOURNAL_VERSION, sizeof(CHARACTER_JOURNAL_VERSION), 1, m_file);
+			m_fileSize = CHARACTER_JOURNAL_HEADER_SIZE;
+			Sync(m_file);
+		}
+
+		return 0;
+	}
+
+	void CharacterJournal::CloseFile()
+	{
+		if (!m_file)
+			return;
+
+		Sync(m_file);
+		std::fclose(m_file);
+		m_file = nullptr;
+	}
+
+	bool CharacterJournal::WriteEntries(FILE* file, const std::vector<CharacterJournalEntry>& entries, size_t& fileSize)
+	{
+		uint8_t buffer[CHARACTER_JOURNAL_RECORD_SIZE];
+		for (const CharacterJournalEntry& entry : entries)
+		{
+			CharacterJournalFile::Serialize(entry, buffer);
+			if (std::fwrite(buffer, CHARACTER_JOURNAL_RECORD_SIZE, 1, file) != 1)
+				return false;
+
+			fileSize += CHARACTER_JOURNAL_RECORD_SIZE;
+		}
+
+		return true;
+	}
+
+	bool CharacterJournal::Sync(FILE* file)
+	{
+		if (std::fflush(file) != 0)
+			return false;
+
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Rewrites the journal with only the pending entries. Entries appended meanwhile are still in m_writeBuffer and end up in
+	// the new file, entries that got applied meanwhile are just replayed (idempotent) if we crash before the next compaction.
+	// -------------------------------------------------------------------------------------------------------------------------
+	void CharacterJournal::Compact()
+	{
+		std::vector<CharacterJournalEntry> pending;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			pending.reserve(m_pending.size());
+			for (auto& [charID, save] : m_pending)
+				pending.push_back(save.entry);
+		}
+
+		const std::string tmpPath = m_path + ".tmp";
+		FILE* tmp = std::fopen(tmpPath.c_str(), "wb");
+		if (!tmp)
+		{
+			LOG_ERROR("[CHARACTER JOURNAL] Could not open '{}' for the compaction.", tmpPath);
+			return;
+		}
+
+		size_t tmpSize = CHARACTER_JOURNAL_HEADER_SIZE;
+		bool ok = std::fwrite(&CHARACTER_JOURNAL_MAGIC, sizeof(CHARACTER_JOURNAL_MAGIC), 1, tmp) == 1 &&
+				  std::fwrite(&CHARACTER_JOURNAL_VERSION, sizeof(CHARACTER_JOURNAL_VERSION), 1, tmp) == 1 &&
+				  WriteEntries(tmp, pending, tmpSize) && Sync(tmp);
+		std::fclose(tmp);
+
+		if (!ok)
+		{
+			LOG_ERROR("[CHARACTER JOURNAL] Compaction failed while writing '{}'.", tmpPath);
+			std::remove(tmpPath.c_str());
+			return;
+		}
+
+		// rename replaces the journal atomically on POSIX, Windows' fails if it exists
+		CloseFile();
+#ifdef _WIN32
+		std::remove(m_path.c_str());
+#endif
+		if (std::rename(tmpPath.c_str(), m_path.c_str()) != 0)
+			LOG_ERROR("[CHARACTER JOURNAL] Could not rename '{}' to '{}'.", tmpPath, m_path);
+
+		OpenFile(false);
+	}
+
+	void CharacterJournal::FlushPending()
+	{
+		std::vector<CharacterJournalEntry> toApply;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (auto& [charID, save] : m_pending)
+			{
+				if (save.inFlight)
+					continue;
+
+				save.inFlight = true;
+				toApply.push_back(save.entry);
+			}
+		}
+
+		for (const CharacterJournalEntry& entry : toApply)
+			EnqueueApply(entry);
+	}
+
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Fire-and-forget with a completion function instead of a callback: the saves of a flush stay group committable, and the
+	// confirmation comes from the DBWorker thread without a round trip through the io_context.
+	// -------------------------------------------------------------------------------------------------------------------------
+	void CharacterJournal::EnqueueApply(const CharacterJournalEntry& entry)
+	{
+		DBRequest req(*m_callbackContext, true);
+		req.m_steps.push_back(MakeSaveStep(entry));
+		req.m_orderingKey = entry.accountID;
+		req.m_priority = DBRequestPriority::BACKGROUND;
+
+		const uint32_t charID = entry.charID;
+		const uint64_t seq = entry.seq;
+		req.m_completionFunc = [this, charID, seq](uint32_t ec)
+			{
+				OnApplied(charID, seq, ec == static_cast<uint32_t>(DBRequestError::NONE));
+			};
+
+		m_charactersDB->Enqueue(std::move(req));
+	}
+
+	void CharacterJournal::OnApplied(uint32_t charID, uint64_t seq, bool success)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// A newer save replaced this one in the meantime, it's the newer one that has to be applied
+		auto it = m_pending.find(charID);
+		if (it == m_pending.end() || it->second.entry.seq != seq)
+			return;
+
+		if (success)
+			m_pending.erase(it);
+		else
+			it->second.inFlight = false; // retried at the next flush
+	}
+
+	void CharacterJournal::ThreadRoutine()
+	{
+		auto lastFlush = std::chrono::steady_clock::now();
+
+		while (true)
+		{
+			bool running;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_cond.wait_for(lock, std::chrono::milliseconds(m_fsyncIntervalMs), [this]() { return !m_running; });
+
+				running = m_running;
+				m_writing.swap(m_writeBuffer);
+			}
+
+			// One write and one sync for all the saves of the interval
+			if (!m_writing.empty())
+			{
+				if (!m_file || !WriteEntries(m_file, m_writing, m_fileSize) || !Sync(m_file))
+					LOG_ERROR("[CHARACTER JOURNAL] Failed to write {} entries on '{}', they'll only reach MySQL if it's up.", m_writing.size(), m_path);
+
+				m_writing.clear();
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			if (!running || now - lastFlush >= std::chrono::milliseconds(m_flushIntervalMs))
+			{
+				FlushPending();
+				lastFlush = now;
+			}
+
+			if (!running)
+				break;
+
+			if (m_compactSizeBytes > 0 && m_fileSize >= m_compactSizeBytes)
+				Compact();
+		}
+	}
+}
+}
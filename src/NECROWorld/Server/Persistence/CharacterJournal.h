@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+
+#include <boost/asio.hpp>
+
+#include "DatabaseWorkerPool.h"
+#include "CharacterJournalFile.h"
+
+namespace NECRO
+{
+struct CharacterData; // forward declare
+namespace World
+{
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Write-behind journal of the character saves.
+	//
+	// Append() only buffers the entry in memory, the journal thread writes the buffer to an append-only file and fsyncs it
+	// every fsyncIntervalMs (one fsync for all the saves of the interval), then applies the latest unapplied entry of every
+	// character to MySQL every flushIntervalMs. Entries stay pending until MySQL confirms them, so saves made while MySQL is
+	// slow or down are retried instead of lost, and are replayed from the file if the server crashes in the meantime.
+	// The entries are applied as fire-and-forget requests confirmed by their m_completionFunc, so the DBWorkers group commit
+	// the saves of a flush.
+	//
+	// Urgent entries (logout) are sent to the DB right away from the calling thread, so they keep the FIFO order with the
+	// requests of the same account (the characters list that follows a logout must see the save).
+	//
+	// When the file grows past compactSizeBytes it's rewritten with only the pending entries.
+	//
+	// A newer entry replacing a pending one inherits its dirty column groups, so what's applied always covers everything
+	// that changed since the last confirmed save.
+	// -------------------------------------------------------------------------------------------------------------------------
+	class CharacterJournal
+	{
+	private:
+		struct PendingSave
+		{
+			CharacterJournalEntry entry;
+			bool inFlight = false;
+		};
+
+		std::string		m_path;
+		FILE*			m_file = nullptr;
+		size_t			m_fileSize = 0;
+		uint16_t		m_fileVersion = CHARACTER_JOURNAL_VERSION;	// of the journal left by the last run
+
+		DatabaseWorkerPool<CharactersDatabase>* m_charactersDB = nullptr;
+		boost::asio::io_context*				m_callbackContext = nullptr;
+
+		uint32_t		m_fsyncIntervalMs = 0;
+		uint32_t		m_flushIntervalMs = 0;
+		size_t			m_compactSizeBytes = 0;
+
+		std::thread				m_thread;
+		std::mutex				m_mutex;
+		std::condition_variable	m_cond;
+		std::atomic<bool>		m_running{ false };
+
+		// Guarded by m_mutex
+		uint64_t											m_nextSeq = 1;
+		std::vector<CharacterJournalEntry>					m_writeBuffer;	// appended but not yet written on the file
+		std::unordered_map<uint32_t, PendingSave>			m_pending;		// charID -> latest entry not yet applied to MySQL
+
+		std::vector<CharacterJournalEntry>					m_writing;		// journal thread only
+
+		int		Replay();
+		int		OpenFile(bool truncate);
+		void	CloseFile();
+		bool	WriteEntries(FILE* file, const std::vector<CharacterJournalEntry>& entries, size_t& fileSize);
+		bool	Sync(FILE* file);
+		void	Compact();
+
+		void	FlushPending();
+		void	EnqueueApply(const CharacterJournalEntry& entry);
+		void	OnApplied(uint32_t charID, uint64_t seq, bool success);
+
+		void	ThreadRoutine();
+
+	public:
+		~CharacterJournal();
+
+		// Replays the unapplied entries left by the last run, then starts the journal thread
+		int		Open(const std::string& path, DatabaseWorkerPool<CharactersDatabase>& charactersDB, boost::asio::io_context& callbackContext,
+					uint32_t fsyncIntervalMs, uint32_t flushIntervalMs, size_t compactSizeBytes);
+
+		// Writes and syncs what's left and sends the pending entries to the DB one last time
+		void	Close();
+
+		bool	IsRunning() const { return m_running; }
+
+		// dirtyMask are the CHARACTER_DIRTY_ column groups to save. An urgent Append with nothing dirty still sends the pending
+		// entry of the character (if any) to the DB right away.
+		void	Append(const CharacterData& charData, uint8_t dirtyMask, bool urgent);
+
+		static CharacterJournalEntry	MakeEntry(const CharacterData& charData, uint8_t dirtyMask);
+
+		// The UPDATE that writes only the dirty column groups of the entry
+		static DBRequestStep			MakeSaveStep(const CharacterJournalEntry& entry);
+	};
+}
+}
@@ -0,0 +1,108 @@
+#include "CharacterJournalFile.h"
+#include "CharacterData.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+namespace World
+{
+	void CharacterJournalFile::Serialize(const CharacterJournalEntry& entry, uint8_t* out)
+	{
+		uint8_t* p = out;
+		std::memcpy(p, &entry.seq, sizeof(entry.seq));				p += sizeof(entry.seq);
+		std::memcpy(p, &entry.charID, sizeof(entry.charID));		p += sizeof(entry.charID);
+		std::memcpy(p, &entry.accountID, sizeof(entry.accountID));	p += sizeof(entry.accountID);
+		std::memcpy(p, &entry.dirtyMask, sizeof(entry.dirtyMask));	p += sizeof(entry.dirtyMask);
+		std::memcpy(p, &entry.level, sizeof(entry.level));			p += sizeof(entry.level);
+		std::memcpy(p, &entry.xp, sizeof(entry.xp));				p += sizeof(entry.xp);
+		std::memcpy(p, &entry.zone, sizeof(entry.zone));			p += sizeof(entry.zone);
+		std::memcpy(p, &entry.pos_x, sizeof(entry.pos_x));			p += sizeof(entry.pos_x);
+		std::memcpy(p, &entry.pos_y, sizeof(entry.pos_y));			p += sizeof(entry.pos_y);
+		std::memcpy(p, &entry.pos_z, sizeof(entry.pos_z));			p += sizeof(entry.pos_z);
+
+		uint32_t checksum = Checksum(out, static_cast<size_t>(p - out));
+		std::memcpy(p, &checksum, sizeof(checksum));
+	}
+
+	bool CharacterJournalFile::Deserialize(const uint8_t* in, uint16_t version, CharacterJournalEntry& entry)
+	{
+		const uint8_t* p = in;
+		std::memcpy(&entry.seq, p, sizeof(entry.seq));				p += sizeof(entry.seq);
+		std::memcpy(&entry.charID, p, sizeof(entry.charID));		p += sizeof(entry.charID);
+		std::memcpy(&entry.accountID, p, sizeof(entry.accountID));	p += sizeof(entry.accountID);
+
+		entry.dirtyMask = CHARACTER_DIRTY_ALL;
+		if (version >= 2)
+		{
+			std::memcpy(&entry.dirtyMask, p, sizeof(entry.dirtyMask));	p += sizeof(entry.dirtyMask);
+		}
+
+		std::memcpy(&entry.level, p, sizeof(entry.level));			p += sizeof(entry.level);
+		std::memcpy(&entry.xp, p, sizeof(entry.xp));				p += sizeof(entry.xp);
+		std::memcpy(&entry.zone, p, sizeof(entry.zone));			p += sizeof(entry.zone);
+		std::memcpy(&entry.pos_x, p, sizeof(entry.pos_x));			p += sizeof(entry.pos_x);
+		std::memcpy(&entry.pos_y, p, sizeof(entry.pos_y));			p += sizeof(entry.pos_y);
+		std::memcpy(&entry.pos_z, p, sizeof(entry.pos_z));			p += sizeof(entry.pos_z);
+
+		uint32_t checksum = 0;
+		std::memcpy(&checksum, p, sizeof(checksum));
+
+		return checksum == Checksum(in, static_cast<size_t>(p - in));
+	}
+
+	// FNV-1a, only used to detect torn or corrupted records
+	uint32_t CharacterJournalFile::Checksum(const uint8_t* data, size_t size)
+	{
+		uint32_t h = 2166136261u;
+		for (size_t i = 0; i < size; i++)
+		{
+			h ^= data[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+	int CharacterJournalFile::Read(const std::string& path, std::vector<CharacterJournalEntry>& outEntries, uint16_t& outVersion)
+	{
+		outEntries.clear();
+
+		FILE* file = std::fopen(path.c_str(), "rb");
+		if (!file)
+			return -1;
+
+		uint32_t magic = 0;
+		uint16_t version = 0;
+		if (std::fread(&magic, sizeof(magic), 1, file) != 1 || std::fread(&version, sizeof(version), 1, file) != 1 ||
+			magic != CHARACTER_JOURNAL_MAGIC || version == 0 || version > CHARACTER_JOURNAL_VERSION)
+		{
+			LOG_ERROR("[CHARACTER JOURNAL] '{}' is not a valid character journal.", path);
+			std::fclose(file);
+			return -2;
+		}
+
+		const size_t recordSize = version == 1 ? CHARACTER_JOURNAL_RECORD_SIZE_V1 : CHARACTER_JOURNAL_RECORD_SIZE;
+
+		uint8_t buffer[CHARACTER_JOURNAL_RECORD_SIZE];
+		while (std::fread(buffer, recordSize, 1, file) == 1)
+		{
+			CharacterJournalEntry entry;
+			if (!Deserialize(buffer, version, entry))
+			{
+				LOG_WARNING("[CHARACTER JOURNAL] Corrupted record after {} records in '{}', ignoring the rest of the journal.", outEntries.size(), path);
+				break;
+			}
+
+			outEntries.push_back(entry);
+		}
+
+		std::fclose(file);
+		outVersion = version;
+		return 0;
+	}
+}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace NECRO
+{
+namespace World
+{
+	// Journal file format:
+	// Header: [MAGIC (uint32) | VERSION (uint16)]
+	// Record: [SEQ (uint64) | CHAR_ID (uint32) | ACCOUNT_ID (uint32) | DIRTY_MASK (uint8) | LEVEL (uint8) | XP (uint32) | ZONE (uint32) | POS_X | POS_Y | POS_Z (float) | CHECKSUM (uint32)]
+	// Records have a fixed size, a torn or corrupted record (crash during a write) ends the journal.
+	// Version 1 records have no DIRTY_MASK, they're replayed as CHARACTER_DIRTY_ALL.
+	inline constexpr uint32_t CHARACTER_JOURNAL_MAGIC = 0x4A43454E; // "NECJ"
+	inline constexpr uint16_t CHARACTER_JOURNAL_VERSION = 2;
+	inline constexpr size_t CHARACTER_JOURNAL_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint16_t);
+	inline constexpr size_t CHARACTER_JOURNAL_RECORD_SIZE_V1 = 8 + 4 + 4 + 1 + 4 + 4 + 4 + 4 + 4 + 4;
+	inline constexpr size_t CHARACTER_JOURNAL_RECORD_SIZE = CHARACTER_JOURNAL_RECORD_SIZE_V1 + 1;
+
+	// Saved state of a character, the same fields as CHAR_SAVE_CHARACTER. Applying an entry is idempotent (absolute values).
+	// Only the column groups in dirtyMask (CHARACTER_DIRTY_) are written on the DB.
+	struct CharacterJournalEntry
+	{
+		uint64_t seq = 0;
+		uint32_t charID = 0;
+		uint32_t accountID = 0;
+		uint8_t dirtyMask = 0;
+		uint8_t level = 0;
+		uint32_t xp = 0;
+		uint32_t zone = 0;
+		float_t pos_x = 0.0f;
+		float_t pos_y = 0.0f;
+		float_t pos_z = 0.0f;
+	};
+
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Record encoding of the CharacterJournal file, kept apart from the journal thread and the DB so it can be tested alone.
+	// -------------------------------------------------------------------------------------------------------------------------
+	class CharacterJournalFile
+	{
+	public:
+		// out must hold CHARACTER_JOURNAL_RECORD_SIZE bytes, always written in the current version
+		static void		Serialize(const CharacterJournalEntry& entry, uint8_t* out);
+
+		// False if the checksum doesn't match (torn or corrupted record)
+		static bool		Deserialize(const uint8_t* in, uint16_t version, CharacterJournalEntry& entry);
+
+		static uint32_t	Checksum(const uint8_t* data, size_t size);
+
+		// Reads the records of the journal at path in file order, stopping at the first torn or corrupted one.
+		// Returns -1 if the file can't be opened, -2 if it's not a character journal
+		static int		Read(const std::string& path, std::vector<CharacterJournalEntry>& outEntries, uint16_t& outVersion);
+	};
+}
+}
@@ -50,7 +50,7 @@ namespace World
 		else
 		{
 			m_currentZone = nullptr;
-			LOG_ERROR("Tried to set Entity's with GUID '{}' new Zone, but the passed ptr was null!", m_guid);
+			MLOG_ERROR(WORLD, "Tried to set Entity's with GUID '{}' new Zone, but the passed ptr was null!", m_guid);
 
 			// Entity is an invalid state, TODO decide what to do
 		}
@@ -69,7 +69,7 @@ namespace World
 		else
 		{
 			m_currentCell = nullptr;
-			LOG_ERROR("Tried to set Entity's with GUID '{}' new Cell, but the passed ptr was null!", m_guid);
+			MLOG_ERROR(WORLD, "Tried to set Entity's with GUID '{}' new Cell, but the passed ptr was null!", m_guid);
 
 			// Entity is an invalid state, TODO decide what to do
 		}
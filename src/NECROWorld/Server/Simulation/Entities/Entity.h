@@ -68,6 +68,11 @@ namespace World
 			return m_guid;
 		}
 
+		const EntityType GetType() const
+		{
+			return m_type;
+		}
+
 		virtual void Update(uint32_t diff);
 
 		// Called as soon as the Entity is added to the map (via Zone::AddEntityToZone) and (m_currentZone, m_currentCell) are assigned
@@ -37,12 +37,23 @@ namespace World
         if (!m_playerPacketQueue->TryEnqueue(std::move(p)))
         {
             // The correction never left. Keep the current epoch so the client's packets are still accepted.
-            LOG_WARNING("Could not deliver a movement correction to PlayerEntity GUID: '{}'.", m_guid);
+            MLOG_WARNING(WORLD, "Could not deliver a movement correction to PlayerEntity GUID: '{}'.", m_guid);
             return false;
         }
 
         m_lastCorrectionID = nextCorrectionID;
-        LOG_DEBUG("Correction sent ID:'{}' (rejectedSeq '{}') to GUID '{}'", m_lastCorrectionID, rejectedSeq, m_guid);
+        MLOG_DEBUG(WORLD, "Correction sent ID:'{}' (rejectedSeq '{}') to GUID '{}'", m_lastCorrectionID, rejectedSeq, m_guid);
+        return true;
+    }
+
+    bool PlayerEntity::SendSharedPacket(const SharedPacket& p)
+    {
+        if (!m_playerPacketQueue->TryEnqueueShared(p))
+        {
+            MLOG_WARNING(WORLD, "Could not deliver a broadcast packet to PlayerEntity GUID: '{}'.", m_guid);
+            return false;
+        }
+
         return true;
     }
 #pragma endregion
@@ -19,6 +19,9 @@ namespace World
 		// Movement Epoch/Ack
 		uint32_t m_lastCorrectionID = 0;
 
+		// CHARACTER_DIRTY_ flags of what changed since the last save
+		uint8_t m_dirtyMask = CHARACTER_DIRTY_NONE;
+
 	public:
 		PlayerEntity(uint64_t guid, CharacterData charData, std::shared_ptr<PlayerPacketQueue> playerPQueue) : Entity(guid, EntityType::PLAYER_ENTITY), m_playerPacketQueue(std::move(playerPQueue)) // playerPQueue is a shared_ptr, not the resource itself
 		{
@@ -50,6 +53,9 @@ namespace World
 		void UpdateCharacterData()
 		{
 			// TODO Update all data
+			if (m_characterData->pos_x != m_posX || m_characterData->pos_y != m_posY || m_characterData->pos_z != m_posZ)
+				m_dirtyMask |= CHARACTER_DIRTY_LOCATION;
+
 			m_characterData->pos_x = m_posX;
 			m_characterData->pos_y = m_posY;
 			m_characterData->pos_z = m_posZ;
@@ -61,10 +67,24 @@ namespace World
 			return m_characterData.get();
 		}
 
+		void MarkDirty(uint8_t mask)
+		{
+			m_dirtyMask |= mask;
+		}
+
+		// Returns what changed since the last call, call it right after GetCharacterData() when saving
+		uint8_t TakeDirtyMask()
+		{
+			uint8_t mask = m_dirtyMask;
+			m_dirtyMask = CHARACTER_DIRTY_NONE;
+			return mask;
+		}
+
 		virtual void OnCellTransferFails() override;
 
 #pragma region Msgs
 		bool SendMovementCorrection(uint32_t rejectedSeq);
+		bool SendSharedPacket(const SharedPacket& p);
 #pragma endregion
 	};
 }
@@ -18,7 +18,7 @@ namespace World
 
 	bool Cell::AddEntityHere(Entity* e)
 	{
-		LOG_DEBUG("Entity {} added to cell ({},{})", e->GetGUID(), m_cellX, m_cellY);
+		MLOG_DEBUG(WORLD, "Entity {} added to cell ({},{})", e->GetGUID(), m_cellX, m_cellY);
 		m_entitiesHere.push_back(e);
 		return true;
 	}
@@ -29,7 +29,7 @@ namespace World
 		{
 			if (m_entitiesHere[i]->GetGUID() == guid)
 			{
-				LOG_DEBUG("Entity {} removed from cell ({},{})", m_entitiesHere[i]->GetGUID(), m_cellX, m_cellY);
+				MLOG_DEBUG(WORLD, "Entity {} removed from cell ({},{})", m_entitiesHere[i]->GetGUID(), m_cellX, m_cellY);
 				m_entitiesHere.erase(m_entitiesHere.begin() + i);
 				return true;
 			}
@@ -1,6 +1,10 @@
 #include "Zone.h"
+#include "PlayerEntity.h"
 
-#include "NECROWorld.h"
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+#include <algorithm>
 
 namespace NECRO
 {
@@ -8,23 +12,67 @@ namespace World
 {
 	void Zone::SetActive(bool v)
 	{
+		if (m_isActive == v)
+			return;
+
 		m_isActive = v;
 
 		// Eventual consequences of activating/deactivating a Zone
+		if (m_mapDef)
+			MLOG_DEBUG(WORLD, "[ZONES] ZoneID: '{}' (MapID: '{}') is now {}.", m_zoneID, m_mapDef->m_mapID, v ? "active" : "hibernating");
 	}
 
-	int Zone::LoadZoneFromMap(uint32_t mapID)
+	// -----------------------------------------------------------------------------------------------------------
+	// Binds a (pooled) shell to a map, making it a live Zone. Cell storage of a previously released 
+	// shell is reused, so binding a shell that was already used for the same map does not allocate.
+	// -----------------------------------------------------------------------------------------------------------
+	int Zone::Bind(uint32_t mapID, uint32_t zoneID, uint32_t now, std::shared_ptr<const NDBDataStoreManager> ndbStores)
+	{
+		m_zoneID = zoneID;
+
+		if (LoadZoneFromMap(mapID, std::move(ndbStores)) != 0)
+			return -1;
+
+		m_players.clear();
+		m_lastOccupiedTime = now; // a freshly bound Zone gets a full grace period before hibernating
+		m_isActive = true;
+		return 0;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Destroys all the entities and unbinds the Zone from its map. Vectors are cleared (not freed), the 
+	// WorldSimulation decides if the shell goes back in the pool or gets destroyed to reclaim the memory.
+	// -----------------------------------------------------------------------------------------------------------
+	void Zone::Release()
+	{
+		for (auto& it : m_entities)
+			it.second->OnBeingRemovedFromZone();
+
+		m_entities.clear();
+		m_entitiesWaitingForTransfer.clear();
+		m_cellMap.clear();
+
+		m_mapDef = nullptr;
+		m_ndbStores.reset();
+		m_zoneID = 0;
+		m_players.clear();
+		m_isActive = false;
+	}
+
+	int Zone::LoadZoneFromMap(uint32_t mapID, std::shared_ptr<const NDBDataStoreManager> ndbStores)
 	{
 		// Load from NDB
-		m_mapDef = Server::Instance().GetNDBStoresManager().GetMapDefStore().GetDef(mapID);
+		m_mapDef = ndbStores->GetMapDefStore().GetDef(mapID);
 
 		// Load MapDef
 		if (!m_mapDef)
 		{
-			LOG_ERROR("Could not load MapDef for mapID '{}'", mapID);
+			MLOG_ERROR(WORLD, "Could not load MapDef for mapID '{}'", mapID);
 			return -1;
 		}
 
+		m_ndbStores = std::move(ndbStores);
+
 		// Apply
 		m_cellMap.clear();
 		m_cellMap.reserve(m_mapDef->m_width* m_mapDef->m_height);
@@ -36,11 +84,35 @@ namespace World
 				cellID++;
 			}
 
-		LOG_INFO("[ZONES] Loaded: ZoneID: '{}' - MapID: '{} | Name: '{}' loaded! Width:'{}' | Height:'{}' - FileName: {}.", m_zoneID, m_mapDef->m_mapID, m_mapDef->m_mapName, m_mapDef->m_width, m_mapDef->m_height, m_mapDef->m_mapFileName);
+		MLOG_INFO(WORLD, "[ZONES] Loaded: ZoneID: '{}' - MapID: '{} | Name: '{}' loaded! Width:'{}' | Height:'{}' - FileName: {}.", m_zoneID, m_mapDef->m_mapID, m_mapDef->m_mapName, m_mapDef->m_width, m_mapDef->m_height, m_mapDef->m_mapFileName);
 		return 0;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------
+	// The cells are laid out on the size of the current MapDef, so a new MapDef is taken only if the size of the 
+	// map didn't change. Otherwise the Zone keeps its version until it's torn down (exteriors: until a restart).
+	// -----------------------------------------------------------------------------------------------------------
+	bool Zone::RebindDef(const std::shared_ptr<const NDBDataStoreManager>& ndbStores)
+	{
+		const MapDef* def = ndbStores->GetMapDefStore().GetDef(m_mapDef->m_mapID);
+
+		if (!def || def->m_width != m_mapDef->m_width || def->m_height != m_mapDef->m_height || def->m_nLayers != m_mapDef->m_nLayers)
+			return false;
+
+		m_mapDef = def;
+		m_ndbStores = ndbStores;
+		return true;
+	}
+
 	void Zone::Update(uint32_t diff)
+	{
+		UpdateCells(diff);
+
+		// After the whole map has been updated (or the TODO POIs, perform the transfer the entities that requested a transfer)
+		TransferPendingEntities();
+	}
+
+	void Zone::UpdateCells(uint32_t diff)
 	{
 		// Let's do a flat update for the whole map for now. The correct way will be to calculate where players are and only update the nearbies
 		for (int y = 0; y < m_mapDef->m_height; y++)
@@ -49,9 +121,6 @@ namespace World
 				Cell& cell = m_cellMap[y * m_mapDef->m_width + x];
 				cell.Update(diff);
 			}
-
-		// After the whole map has been updated (or the TODO POIs, perform the transfer the entities that requested a transfer)
-		TransferPendingEntities();
 	}
 
 	Entity* Zone::AddEntityToZone(std::unique_ptr<Entity> e)
@@ -76,22 +145,28 @@ namespace World
 				e->SetCurrentZonePtr(this);
 				e->SetCurrentCellPtr(currentCell);
 				m_entities.insert({ entityGUID, std::move(e) });
-				LOG_DEBUG("Entity {} added to Zone.", entityGUID);
+				MLOG_DEBUG(WORLD, "Entity {} added to Zone.", entityGUID);
 
 				Entity* ePtr = m_entities[entityGUID].get();
+				if (ePtr->GetType() == EntityType::PLAYER_ENTITY)
+				{
+					m_players.push_back(static_cast<PlayerEntity*>(ePtr));
+					SetActive(true); // a player entering wakes up an hibernating Zone
+				}
+
 				ePtr->OnBeingAddedToZone();
 				return ePtr;
 			}
 			else
 			{
 				// Invalid cell placement
-				LOG_WARNING("Tried to add entity GUID: '{}' to ZoneID: '{}' - But the position ({}, {}) is out of bounds! Entity is destroyed.", entityGUID, m_zoneID, e->m_posX, e->m_posY);
+				MLOG_WARNING(WORLD, "Tried to add entity GUID: '{}' to ZoneID: '{}' - But the position ({}, {}) is out of bounds! Entity is destroyed.", entityGUID, m_zoneID, e->m_posX, e->m_posY);
 				return nullptr;
 			}
 		}
 		else
 		{
-			LOG_WARNING("Tried to add entity GUID: '{}' to ZoneID: '{}' - But that GUID is already present in the m_entities list! Entity is destroyed.", entityGUID, m_zoneID);
+			MLOG_WARNING(WORLD, "Tried to add entity GUID: '{}' to ZoneID: '{}' - But that GUID is already present in the m_entities list! Entity is destroyed.", entityGUID, m_zoneID);
 			return nullptr;
 		}
 	}
@@ -101,15 +176,25 @@ namespace World
 		auto it = m_entities.find(entityGUID);
 		if (it == m_entities.end())
 		{
-			LOG_WARNING("Tried to remove entity GUID: '{}' from ZoneID: '{}' - But that GUID was not registered here!", entityGUID, m_zoneID);
+			MLOG_WARNING(WORLD, "Tried to remove entity GUID: '{}' from ZoneID: '{}' - But that GUID was not registered here!", entityGUID, m_zoneID);
 			return false;
 		}
 		else
 		{
+			if (it->second->GetType() == EntityType::PLAYER_ENTITY)
+			{
+				auto player = std::find(m_players.begin(), m_players.end(), it->second.get());
+				if (player != m_players.end())
+				{
+					*player = m_players.back();
+					m_players.pop_back();
+				}
+			}
+
 			it->second->OnBeingRemovedFromZone();
 			it->second->m_currentCell->RemoveEntityHere(entityGUID);
 			m_entities.erase(it);
-			LOG_WARNING("Removed Entity from GUID: '{}' from ZoneID: '{}'!", entityGUID, m_zoneID);
+			MLOG_WARNING(WORLD, "Removed Entity from GUID: '{}' from ZoneID: '{}'!", entityGUID, m_zoneID);
 			return true;
 		}
 	}
@@ -119,8 +204,11 @@ namespace World
 		m_entitiesWaitingForTransfer.push_back(ctx);
 	}
 
-	void Zone::TransferPendingEntities()
+	// Returns the number of transfer requests processed
+	uint32_t Zone::TransferPendingEntities()
 	{
+		uint32_t processed = static_cast<uint32_t>(m_entitiesWaitingForTransfer.size());
+
 		for (int i = 0; i < m_entitiesWaitingForTransfer.size(); i++)
 		{
 			EntityTransferCtx* ctx = &m_entitiesWaitingForTransfer[i];
@@ -136,7 +224,7 @@ namespace World
 
 				if (wantedCell)
 				{
-					LOG_DEBUG("ZoneID '{}' Transferring Entity GUID: '{}'!", m_zoneID, entityToTransfer->GetGUID());
+					MLOG_DEBUG(WORLD, "ZoneID '{}' Transferring Entity GUID: '{}'!", m_zoneID, entityToTransfer->GetGUID());
 
 					// Perform the transfer
 					entityToTransfer->m_currentCell->RemoveEntityHere(entityToTransfer->GetGUID());
@@ -147,7 +235,7 @@ namespace World
 				else
 				{
 					// Failed transfer! If this runs, there's a severe structural issue shouldnt really happen. 
-					LOG_ERROR("Critical Error: In ZoneID '{}', checked and sanitized Cell ({},{}) was marked as not in bound in this Zone!", m_zoneID, ctx->newGridPosX, ctx->newGridPosY);
+					MLOG_ERROR(WORLD, "Critical Error: In ZoneID '{}', checked and sanitized Cell ({},{}) was marked as not in bound in this Zone!", m_zoneID, ctx->newGridPosX, ctx->newGridPosY);
 				}
 			}
 			else
@@ -160,6 +248,7 @@ namespace World
 		}
 
 		m_entitiesWaitingForTransfer.clear();
+		return processed;
 	}
 
 	Entity* Zone::FindEntity(uint64_t guid) const
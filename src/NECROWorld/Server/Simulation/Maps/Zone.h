@@ -8,6 +8,7 @@
 #include <stdexcept>
 
 #include "MapDef.h"
+#include "NDBDataStoreManager.h"
 #include "Cell.h"
 #include "Entity.h"
 
@@ -15,6 +16,8 @@ namespace NECRO
 {
 namespace World
 {
+	class PlayerEntity;
+
 	// ---------------------------------------------------------------------------------------------------------------------------
 	// A loaded map in the Server is called a "Zone". It can be an exterior, a dungeon or anything in between.
 	// A Zone is an entry in the std::unordered_map<uint32_t, std::unique_ptr<Zone>>	m_zones and it represents a loaded Map.
@@ -25,37 +28,62 @@ namespace World
 	{
 	private:
 		const MapDef*	m_mapDef = nullptr; // Assigned in LoadZoneFromMap
+		std::shared_ptr<const NDBDataStoreManager> m_ndbStores; // version m_mapDef belongs to, kept alive while the Zone uses it
 		uint32_t		m_zoneID = 0;
 
 		// Zone state
 		bool m_isActive; // if the Zone is active or not. Inactive Zones will skip updating during a simulation step
 
+		// Lifecycle, driven by the WorldSimulation
+		std::vector<PlayerEntity*> m_players; // players in the Zone, so broadcasts don't scan every player of the world
+		uint32_t m_lastOccupiedTime = 0; // simulation time (ms) at which the Zone was last seen with players in it
+
 		std::unordered_map<uint64_t, std::unique_ptr<Entity>>	m_entities;
 		std::vector<Cell> m_cellMap;
 
 		// To perform Entity Cell Transfer
 		std::vector<EntityTransferCtx> m_entitiesWaitingForTransfer;
 
-	private:
-		// Entity Transfer
-		void TransferPendingEntities();
-
 	public:
-		Zone(uint32_t mapID, uint32_t zoneID) : m_isActive(true), m_zoneID(zoneID)
+		Zone(uint32_t mapID, uint32_t zoneID, std::shared_ptr<const NDBDataStoreManager> ndbStores) : m_isActive(true), m_zoneID(zoneID)
 		{
 			// Initialize the m_cellMap in base of the loaded m_mapDef->m_mapID
 			// TODO: for now maps that fail loading prevents the server to startup
-			if (LoadZoneFromMap(mapID) != 0)
+			if (LoadZoneFromMap(mapID, std::move(ndbStores)) != 0)
 				throw std::runtime_error("LoadZoneFromMap failed!");
 		}
 
+		// Constructs an empty shell, not bound to any map. Shells are kept pooled by the WorldSimulation and bound to a map with Bind()
+		Zone() : m_isActive(false)
+		{
+		}
+
 		const MapDef* GetDef() const { return m_mapDef; }
 
-		int		LoadZoneFromMap(uint32_t mapID);
+		int		LoadZoneFromMap(uint32_t mapID, std::shared_ptr<const NDBDataStoreManager> ndbStores);
+
+		// Switches to the MapDef of a newer NDBDataStores version, false if the Zone has to keep the current one
+		bool	RebindDef(const std::shared_ptr<const NDBDataStoreManager>& ndbStores);
+
+		// Shell lifecycle
+		int		Bind(uint32_t mapID, uint32_t zoneID, uint32_t now, std::shared_ptr<const NDBDataStoreManager> ndbStores);
+		void	Release();
 
 		void	SetActive(bool v);
+		bool	IsActive() const { return m_isActive; }
 		void	Update(uint32_t diff);
 
+		// Update() split in its two steps, so that they can be profiled separately
+		void		UpdateCells(uint32_t diff);
+		uint32_t	TransferPendingEntities();
+
+		bool		IsInstanced() const		{ return m_mapDef->IsInstanced(); }
+		uint32_t	GetPlayerCount() const	{ return static_cast<uint32_t>(m_players.size()); }
+		const std::vector<PlayerEntity*>& GetPlayers() const { return m_players; }
+		uint32_t	GetEntitiesCount() const { return static_cast<uint32_t>(m_entities.size()); }
+		uint32_t	GetLastOccupiedTime() const { return m_lastOccupiedTime; }
+		void		MarkOccupied(uint32_t now) { m_lastOccupiedTime = now; }
+
 		const uint32_t	GetZoneID() const	{ return m_zoneID; };
 
 		const uint32_t	GetMapID() const	{ return m_mapDef->m_mapID; };
@@ -63,6 +91,8 @@ namespace World
 		const int		GetHeight() const	{ return m_mapDef->m_height; };
 		const int		GetNLayers() const	{ return m_mapDef->m_nLayers; };
 
+		const MapCollisionGrid& GetCollisionGrid() const { return m_mapDef->m_collisionGrid; }
+
 		// Entities Management
 		Entity*		AddEntityToZone(std::unique_ptr<Entity> e);
 		bool		RemoveEntityFromZone(uint64_t guid);
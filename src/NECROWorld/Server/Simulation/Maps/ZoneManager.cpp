@@ -0,0 +1,121 @@
+#include "ZoneManager.h"
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+namespace World
+{
+	void ZoneManager::Setup(size_t shellsPoolSize, uint32_t hibernateAfterMs, uint32_t teardownAfterMs)
+	{
+		m_shellsPoolSize = shellsPoolSize;
+		m_hibernateAfterMs = hibernateAfterMs;
+		m_teardownAfterMs = teardownAfterMs;
+
+		m_shellsPool.clear();
+		for (size_t i = 0; i < m_shellsPoolSize; i++)
+			m_shellsPool.push_back(std::make_unique<Zone>());
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Keeps the shell for the next instance if the pool has room, otherwise the memory is reclaimed here
+	// -----------------------------------------------------------------------------------------------------------
+	void ZoneManager::ReleaseShell(std::unique_ptr<Zone> zone)
+	{
+		zone->Release();
+		if (m_shellsPool.size() < m_shellsPoolSize)
+			m_shellsPool.push_back(std::move(zone));
+	}
+
+	Zone* ZoneManager::InstantiateZone(uint32_t mapID, uint32_t zoneID, uint32_t now, std::shared_ptr<const NDBDataStoreManager> ndbStores)
+	{
+		if (m_zones.find(zoneID) != m_zones.end())
+		{
+			MLOG_WARNING(WORLD, "[ZONES] Tried to instantiate ZoneID: '{}' but it already exists!", zoneID);
+			return nullptr;
+		}
+
+		std::unique_ptr<Zone> zone;
+		if (!m_shellsPool.empty())
+		{
+			zone = std::move(m_shellsPool.back());
+			m_shellsPool.pop_back();
+		}
+		else
+			zone = std::make_unique<Zone>();
+
+		if (zone->Bind(mapID, zoneID, now, std::move(ndbStores)) != 0)
+		{
+			ReleaseShell(std::move(zone));
+			return nullptr;
+		}
+
+		Zone* zonePtr = zone.get();
+		m_zones.insert({ zoneID, std::move(zone) });
+		return zonePtr;
+	}
+
+	uint32_t ZoneManager::CreateInstance(uint32_t mapID, uint32_t now, const std::shared_ptr<const NDBDataStoreManager>& ndbStores)
+	{
+		const MapDef* def = ndbStores->GetMapDefStore().GetDef(mapID);
+		if (!def || !def->IsInstanced())
+		{
+			MLOG_WARNING(WORLD, "[ZONES] Tried to create an instance of MapID: '{}', which is not an instanced map!", mapID);
+			return 0;
+		}
+
+		uint32_t zoneID = m_nextInstanceZoneID++;
+		return InstantiateZone(mapID, zoneID, now, ndbStores) ? zoneID : 0;
+	}
+
+	bool ZoneManager::DestroyZone(uint32_t zoneID)
+	{
+		auto it = m_zones.find(zoneID);
+		if (it == m_zones.end())
+			return false;
+
+		std::unique_ptr<Zone> zone = std::move(it->second);
+		m_zones.erase(it);
+
+		MLOG_INFO(WORLD, "[ZONES] Tearing down ZoneID: '{}' (MapID: '{}').", zoneID, zone->GetMapID());
+		ReleaseShell(std::move(zone));
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Zones without players hibernate after m_hibernateAfterMs, instanced Zones without players are torn
+	// down after m_teardownAfterMs. Exterior Zones are persistent and only ever hibernate.
+	// A player entering a hibernating Zone wakes it up (see Zone::AddEntityToZone).
+	// -----------------------------------------------------------------------------------------------------------
+	void ZoneManager::UpdateLifecycle(uint32_t now, std::vector<uint32_t>& outDestroyed)
+	{
+		const size_t firstDestroyed = outDestroyed.size();
+
+		for (auto& [zoneID, zone] : m_zones)
+		{
+			if (zone->GetPlayerCount() > 0)
+			{
+				zone->MarkOccupied(now);
+				continue;
+			}
+
+			uint32_t emptyFor = now - zone->GetLastOccupiedTime();
+
+			if (zone->IsInstanced() && emptyFor >= m_teardownAfterMs)
+				outDestroyed.push_back(zoneID);
+			else if (zone->IsActive() && emptyFor >= m_hibernateAfterMs)
+				zone->SetActive(false);
+		}
+
+		for (size_t i = firstDestroyed; i < outDestroyed.size(); i++)
+			DestroyZone(outDestroyed[i]);
+	}
+
+	Zone* ZoneManager::FindZone(uint32_t zoneID)
+	{
+		auto it = m_zones.find(zoneID);
+		return it != m_zones.end() ? it->second.get() : nullptr;
+	}
+}
+}
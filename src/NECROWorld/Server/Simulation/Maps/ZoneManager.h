@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Zone.h"
+
+namespace NECRO
+{
+namespace World
+{
+	// Zones of EXTERIOR maps use the mapID as zoneID, instances get their zoneIDs from here onwards
+	inline constexpr uint32_t INSTANCED_ZONES_FIRST_ID = 0x10000;
+
+	// ---------------------------------------------------------------------------------------------------------------------------
+	// Owns all the Zones of the WorldSimulation and their lifecycle. Instances are spawned on demand from a pool of shells,
+	// Zones left without players hibernate and instances left without players are torn down, their shell goes back to the pool.
+	//
+	// Driven by the simulation time (ms) the WorldSimulation passes in. Called from the simulation thread only.
+	// ---------------------------------------------------------------------------------------------------------------------------
+	class ZoneManager
+	{
+	private:
+		// All the maps currently loaded in the server are called "zones"
+		// Some may be inactive, some may be expired/invalid (for example, an instanced dungeon that was cleared by the server)
+		std::unordered_map<uint32_t, std::unique_ptr<Zone>>	m_zones;
+
+		// Released shells are kept here (up to m_shellsPoolSize) to spawn instances without reallocating them
+		std::vector<std::unique_ptr<Zone>>	m_shellsPool;
+		size_t								m_shellsPoolSize = 0;
+		uint32_t							m_nextInstanceZoneID = INSTANCED_ZONES_FIRST_ID;
+
+		uint32_t	m_hibernateAfterMs = 0;
+		uint32_t	m_teardownAfterMs = 0;
+
+		void		ReleaseShell(std::unique_ptr<Zone> zone);
+
+	public:
+		// Prebuilds shellsPoolSize shells, these get bound to a map when an instance is requested
+		void		Setup(size_t shellsPoolSize, uint32_t hibernateAfterMs, uint32_t teardownAfterMs);
+
+		// Binds a Zone (taking a shell from the pool when available) to the given map and registers it
+		Zone*		InstantiateZone(uint32_t mapID, uint32_t zoneID, uint32_t now, std::shared_ptr<const NDBDataStoreManager> ndbStores);
+
+		// Spawns a new instance of an INSTANCED map, returns its zoneID or 0 on failure
+		uint32_t	CreateInstance(uint32_t mapID, uint32_t now, const std::shared_ptr<const NDBDataStoreManager>& ndbStores);
+
+		bool		DestroyZone(uint32_t zoneID);
+
+		// Hibernates and tears down the empty Zones, the zoneIDs torn down are appended to outDestroyed
+		void		UpdateLifecycle(uint32_t now, std::vector<uint32_t>& outDestroyed);
+
+		Zone*		FindZone(uint32_t zoneID);
+
+		std::unordered_map<uint32_t, std::unique_ptr<Zone>>& GetZones() { return m_zones; }
+
+		size_t		GetShellsPoolCount() const { return m_shellsPool.size(); }
+	};
+}
+}
@@ -0,0 +1,114 @@
+#include "TickProfiler.h"
+#include "PlayerPacketQueue.h"
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+namespace World
+{
+	void TickProfiler::Setup(bool enabled, uint32_t slowTickThresholdMs, uint32_t reportIntervalMs)
+	{
+		m_enabled = enabled;
+		m_slowTickThresholdUs = slowTickThresholdMs * 1000;
+		m_reportIntervalMs = reportIntervalMs;
+		m_lastReport = std::chrono::steady_clock::now();
+	}
+
+	void TickProfiler::BeginTick(uint32_t tick)
+	{
+		m_current = TickRecord();
+		m_current.tick = tick;
+		m_packetsAtTickStart = PlayerPacketQueue::GetTotalEnqueued();
+		m_tickStart = std::chrono::steady_clock::now();
+	}
+
+	void TickProfiler::AddPhase(TickPhase phase, uint64_t us)
+	{
+		m_current.phasesUs[static_cast<int>(phase)] += us;
+	}
+
+	void TickProfiler::AddZone(uint32_t zoneID, uint64_t us, uint32_t entities, uint32_t transfers)
+	{
+		m_current.zonesUpdated++;
+		m_current.entitiesUpdated += entities;
+		m_current.entitiesTransferred += transfers;
+
+		if (us >= m_current.slowestZoneUs)
+		{
+			m_current.slowestZoneUs = us;
+			m_current.slowestZoneID = zoneID;
+		}
+
+		auto& hist = m_zonesHistograms[zoneID];
+		if (!hist)
+			hist = std::make_unique<LatencyHistogram>();
+
+		hist->Record(us);
+	}
+
+	void TickProfiler::OnZoneDestroyed(uint32_t zoneID)
+	{
+		m_zonesHistograms.erase(zoneID);
+	}
+
+	void TickProfiler::EndTick()
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		m_current.totalUs = std::chrono::duration_cast<std::chrono::microseconds>(now - m_tickStart).count();
+		m_current.packetsProduced = PlayerPacketQueue::GetTotalEnqueued() - m_packetsAtTickStart;
+
+		m_tickHistogram.Record(m_current.totalUs);
+		for (int i = 0; i < static_cast<int>(TickPhase::COUNT); i++)
+			m_phasesHistograms[i].Record(m_current.phasesUs[i]);
+
+		if (m_slowTickThresholdUs > 0 && m_current.totalUs >= m_slowTickThresholdUs)
+		{
+			m_slowTicksSinceReport++;
+			DumpSlowTick();
+		}
+
+		if (m_reportIntervalMs > 0 && now - m_lastReport >= std::chrono::milliseconds(m_reportIntervalMs))
+		{
+			Report();
+			m_lastReport = now;
+		}
+	}
+
+	void TickProfiler::DumpSlowTick() const
+	{
+		MLOG_WARNING(WORLD, "[TICK PROFILER] Slow tick '{}': {}us | ExecuteWorldCmds: {}us ({} cmds) | ZonesUpdate: {}us ({} zones, {} entities) | TransferEntities: {}us ({} transfers) | ZonesLifecycle: {}us | PeriodicSaves: {}us | Packets produced: {} | Slowest ZoneID: '{}' ({}us)",
+			m_current.tick, m_current.totalUs,
+			m_current.phasesUs[static_cast<int>(TickPhase::EXECUTE_WORLD_CMDS)], m_current.cmdsExecuted,
+			m_current.phasesUs[static_cast<int>(TickPhase::ZONES_UPDATE)], m_current.zonesUpdated, m_current.entitiesUpdated,
+			m_current.phasesUs[static_cast<int>(TickPhase::TRANSFER_ENTITIES)], m_current.entitiesTransferred,
+			m_current.phasesUs[static_cast<int>(TickPhase::ZONES_LIFECYCLE)],
+			m_current.phasesUs[static_cast<int>(TickPhase::PERIODIC_SAVES)],
+			m_current.packetsProduced, m_current.slowestZoneID, m_current.slowestZoneUs);
+	}
+
+	void TickProfiler::Report()
+	{
+		LatencyHistogram::Snapshot ticks = m_tickHistogram.TakeSnapshot(true);
+		MLOG_INFO(WORLD, "[TICK PROFILER] {} ticks | p50: {}us | p99: {}us | max: {}us | slow ticks: {}", ticks.count, ticks.Percentile(0.50), ticks.Percentile(0.99), ticks.max, m_slowTicksSinceReport);
+		m_slowTicksSinceReport = 0;
+
+		for (int i = 0; i < static_cast<int>(TickPhase::COUNT); i++)
+		{
+			LatencyHistogram::Snapshot s = m_phasesHistograms[i].TakeSnapshot(true);
+			MLOG_INFO(WORLD, "[TICK PROFILER]   {} | p50: {}us | p99: {}us | max: {}us", TICK_PHASE_NAMES[i], s.Percentile(0.50), s.Percentile(0.99), s.max);
+		}
+
+		for (auto& [zoneID, hist] : m_zonesHistograms)
+		{
+			LatencyHistogram::Snapshot s = hist->TakeSnapshot(true);
+			if (s.count == 0) // hibernating
+				continue;
+
+			MLOG_INFO(WORLD, "[TICK PROFILER]   ZoneID '{}' | {} updates | p50: {}us | p99: {}us | max: {}us", zoneID, s.count, s.Percentile(0.50), s.Percentile(0.99), s.max);
+		}
+	}
+}
+}
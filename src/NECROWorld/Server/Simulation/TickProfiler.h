@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include "LatencyHistogram.h"
+
+namespace NECRO
+{
+namespace World
+{
+	enum class TickPhase
+	{
+		EXECUTE_WORLD_CMDS = 0,
+		ZONES_UPDATE,				// Cells/Entities update of all the active zones
+		TRANSFER_ENTITIES,			// Zone::TransferPendingEntities of all the active zones
+		ZONES_LIFECYCLE,
+		PERIODIC_SAVES,				// Characters saves of the current save wheel slot
+		COUNT
+	};
+
+	inline constexpr const char* TICK_PHASE_NAMES[static_cast<int>(TickPhase::COUNT)] = { "ExecuteWorldCmds", "ZonesUpdate", "TransferEntities", "ZonesLifecycle", "PeriodicSaves" };
+
+	// ------------------------------------------------------------------------------------------------------------------------------------------
+	// Records where the time of each WorldSimulation tick goes. Tick, phase and per-zone timings (microseconds) go into lock-free
+	// histograms that are reported (p50/p99/max) every TICK_PROFILER_REPORT_INTERVAL_MS. Ticks that take longer than
+	// TICK_PROFILER_SLOW_TICK_MS are dumped right away, with the counters of that tick.
+	//
+	// Lives in the WorldSimulation, Begin/End/Add functions are called only from the simulation thread.
+	// ------------------------------------------------------------------------------------------------------------------------------------------
+	class TickProfiler
+	{
+	public:
+		// What happened during the tick being profiled
+		struct TickRecord
+		{
+			uint32_t tick = 0;
+			uint64_t totalUs = 0;
+			uint64_t phasesUs[static_cast<int>(TickPhase::COUNT)] = {};
+
+			uint32_t cmdsExecuted = 0;
+			uint32_t zonesUpdated = 0;
+			uint32_t entitiesUpdated = 0;
+			uint32_t entitiesTransferred = 0;
+			uint64_t packetsProduced = 0;
+
+			// Slowest zone of the tick
+			uint32_t slowestZoneID = 0;
+			uint64_t slowestZoneUs = 0;
+		};
+
+	private:
+		bool		m_enabled = false;
+		uint32_t	m_slowTickThresholdUs = 0;
+		uint32_t	m_reportIntervalMs = 0;
+
+		std::chrono::steady_clock::time_point m_tickStart;
+		std::chrono::steady_clock::time_point m_lastReport;
+
+		TickRecord	m_current;
+		uint64_t	m_packetsAtTickStart = 0;
+		uint64_t	m_slowTicksSinceReport = 0;
+
+		LatencyHistogram m_tickHistogram;
+		LatencyHistogram m_phasesHistograms[static_cast<int>(TickPhase::COUNT)];
+		std::unordered_map<uint32_t, std::unique_ptr<LatencyHistogram>> m_zonesHistograms;
+
+		void DumpSlowTick() const;
+		void Report();
+
+	public:
+		void Setup(bool enabled, uint32_t slowTickThresholdMs, uint32_t reportIntervalMs);
+		bool IsEnabled() const { return m_enabled; }
+
+		void BeginTick(uint32_t tick);
+		void EndTick();
+
+		void AddPhase(TickPhase phase, uint64_t us);
+		void AddZone(uint32_t zoneID, uint64_t us, uint32_t entities, uint32_t transfers);
+		void SetCmdsExecuted(uint32_t n) { m_current.cmdsExecuted = n; }
+
+		void OnZoneDestroyed(uint32_t zoneID);
+
+		// The tick being profiled, or the last one after EndTick
+		const TickRecord& GetCurrentTick() const { return m_current; }
+		uint64_t GetSlowTicksSinceReport() const { return m_slowTicksSinceReport; }
+
+		static uint64_t ElapsedUs(std::chrono::steady_clock::time_point since)
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - since).count();
+		}
+	};
+}
+}
@@ -42,12 +42,14 @@ namespace World
 			WorldToCell(charData.pos_x, charData.pos_y, eventualCellX, eventualCellY);
 
 			// If the position is broken, reposition to the center of the world (this may be the graveyard)
+			bool repositioned = false;
 			if (!Utility::CellBoundCheck(eventualCellX, eventualCellY, zoneToSpawnIn->GetWidth(), zoneToSpawnIn->GetHeight()))
 			{
 				// Modify data
 				charData.pos_x = zoneToSpawnIn->GetWidth() / 2 * CELL_WIDTH;
 				charData.pos_y = zoneToSpawnIn->GetHeight() / 2 * CELL_HEIGHT;
 				charData.pos_z = 100.01f;
+				repositioned = true;
 			}
 
 			// Try to spawn the entity
@@ -62,15 +64,20 @@ namespace World
 				result.posY = res->m_posY;
 				result.posZ = res->m_posZ;
 
+				// The DB still has the broken position
+				if (repositioned)
+					res->MarkDirty(CHARACTER_DIRTY_LOCATION);
+
 				if (RegisterPlayer(result.guid, charData.id, res))
 				{
-					LOG_DEBUG("Spawned player '{}' in ZoneID: '{}' at position: ({}, {})", charData.characterName, result.zoneID, result.posX, result.posY);
+					MLOG_DEBUG(WORLD, "Spawned player '{}' in ZoneID: '{}' at position: ({}, {})", charData.characterName, result.zoneID, result.posX, result.posY);
+					m_recorder.RecordSpawnPlayer(m_worldLoopCounter, m_curTime, charData, result.guid);
 					return result;
 				}
 				// Character spawned but registration failed, undo the spawn!
 				else
 				{
-					LOG_DEBUG("Entity GUID '{}' is getting removed! WorldCmd_TryToSpawnPlayerCharacter failed to register the player!", result.guid);
+					MLOG_DEBUG(WORLD, "Entity GUID '{}' is getting removed! WorldCmd_TryToSpawnPlayerCharacter failed to register the player!", result.guid);
 					zoneToSpawnIn->RemoveEntityFromZone(result.guid);
 				}
 			}
@@ -78,17 +85,19 @@ namespace World
 		else
 		{
 			// TODO this currentyl drops the player, but we should teleport him to a safe zone instead, otherwsie if the player leaves the game on an instance that gets deleted by the server, he won't be able to play anymore
-			LOG_DEBUG("Entity GUID '{}' is trying to spawn in a zone that no longer exists ('{}')!", result.guid, charData.zone);
+			MLOG_DEBUG(WORLD, "Entity GUID '{}' is trying to spawn in a zone that no longer exists ('{}')!", result.guid, charData.zone);
 		}
 		
 		// Every other path that does not hit return result.success = true
 		result.success = false;
+		m_recorder.RecordSpawnPlayer(m_worldLoopCounter, m_curTime, charData, 0);
 		return result;
 	}
 
 	PlayerDespawnCmdResult WorldSimulation::WorldCmd_TryToDespawnPlayerCharacter(uint64_t guid)
 	{
 		PlayerDespawnCmdResult result;
+		m_recorder.RecordDespawnPlayer(m_worldLoopCounter, m_curTime, guid);
 
 		auto it = m_players.find(guid);
 		if (it != m_players.end())
@@ -99,7 +108,7 @@ namespace World
 
 			if (UnregisterPlayer(p->GetGUID(), p->GetCharID()))
 			{
-				LOG_WARNING("Player with GUID: '{}' CharID: '{}' has been unregistered from the WorldSimulation!", guid, charID);
+				MLOG_WARNING(WORLD, "Player with GUID: '{}' CharID: '{}' has been unregistered from the WorldSimulation!", guid, charID);
 
 				// Removal from Zone destroys the player (the Zone owns the entities), so we do this at the end
 				Zone* zone = p->GetCurrentZone();
@@ -111,7 +120,7 @@ namespace World
 				else
 				{
 					// When could this fail? Should never unless we allow p->m_currentZone to be nullptr during Zone transfers
-					LOG_CRITICAL("Despawn Character failed critically!");
+					MLOG_CRITICAL(WORLD, "Despawn Character failed critically!");
 				}
 
 				return result;
@@ -124,15 +133,45 @@ namespace World
 	}
 
 	// TODO: instead of having to find the player, the worldsession could just pass the pointer and be good given that these are only used in the world thread, but i want to throughly test it
+	// --------------------------------------------------------------------------------------------------------------------------------------
+	// Movements are short (see PLAYER_MOVEMENT_XY_MAX_DIFF_ALLOWED), so this only touches a couple of cells of the Zone's collision grid.
+	// The destination must have ground under it (layer 0) and the path can't cross cells that are blocking on the destination layer.
+	// --------------------------------------------------------------------------------------------------------------------------------------
+	bool WorldSimulation::IsMovementBlocked(const PlayerEntity* p, float_t posX, float_t posY, float_t posZ) const
+	{
+		const Zone* zone = p->GetCurrentZone();
+		if (!zone)
+			return true;
+
+		const MapCollisionGrid& grid = zone->GetCollisionGrid();
+		if (!grid.IsLoaded())
+			return false;
+
+		int fromX = 0, fromY = 0, toX = 0, toY = 0;
+		WorldToCell(p->m_posX, p->m_posY, fromX, fromY);
+		WorldToCell(posX, posY, toX, toY);
+
+		int layer = static_cast<int>(std::floor(posZ / LAYER_Z_COEFFICIENT));
+
+		// No ground at all under the destination
+		bool hasGround = grid.IsWalkable(0, toX, toY) || grid.IsBlocking(0, toX, toY);
+		if (!hasGround)
+			return true;
+
+		return grid.IsLineBlocked(layer, fromX, fromY, toX, toY);
+	}
+
 	void WorldSimulation::WorldCmd_TryToUpdatePlayerMovement(uint64_t guid, float_t posX, float_t posY, float_t posZ, uint8_t isoDirection, uint32_t curPacketSeq, uint32_t ackedCorrectionID)
 	{
+		m_recorder.RecordUpdatePlayerMovement(m_worldLoopCounter, m_curTime, guid, posX, posY, posZ, isoDirection, curPacketSeq, ackedCorrectionID);
+
 		PlayerEntity* p = FindPlayer(guid);
 
 		if (p)
 		{
 			if (ackedCorrectionID != p->GetLastCorrectionID())
 			{
-				LOG_DEBUG("Stale Movement packet! Dropping it silently. acked '{}' - m_lastCorrectionID '{}'", ackedCorrectionID, p->GetLastCorrectionID());
+				MLOG_DEBUG(WORLD, "Stale Movement packet! Dropping it silently. acked '{}' - m_lastCorrectionID '{}'", ackedCorrectionID, p->GetLastCorrectionID());
 				return;
 			}
 
@@ -146,6 +185,12 @@ namespace World
 			{
 				p->SendMovementCorrection(curPacketSeq);
 			}
+			// Check the path against the map's collision grid (walking through walls or out of the map)
+			else if (IsMovementBlocked(p, posX, posY, posZ))
+			{
+				MLOG_DEBUG(WORLD, "Movement of GUID '{}' to ({}, {}, {}) is blocked by the map!", guid, posX, posY, posZ);
+				p->SendMovementCorrection(curPacketSeq);
+			}
 			else
 			{
 				// Apply
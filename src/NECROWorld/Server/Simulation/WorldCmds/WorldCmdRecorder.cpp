@@ -0,0 +1,110 @@
+#include "WorldCmdRecorder.h"
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+namespace World
+{
+	int WorldCmdRecorder::Open(const std::string& path)
+	{
+		Close();
+
+		m_file.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_file.is_open())
+		{
+			MLOG_ERROR(WORLD, "[WORLDCMD RECORDER] Could not open recording file '{}'.", path);
+			return -1;
+		}
+
+		m_file.write(reinterpret_cast<const char*>(&WORLD_CMD_RECORDING_MAGIC), sizeof(WORLD_CMD_RECORDING_MAGIC));
+		m_file.write(reinterpret_cast<const char*>(&WORLD_CMD_RECORDING_VERSION), sizeof(WORLD_CMD_RECORDING_VERSION));
+
+		m_recording = true;
+		MLOG_OK(WORLD, "[WORLDCMD RECORDER] Recording WorldCmds to '{}'.", path);
+		return 0;
+	}
+
+	void WorldCmdRecorder::Close()
+	{
+		if (!m_file.is_open())
+			return;
+
+		m_file.flush();
+		m_file.close();
+		m_recording = false;
+	}
+
+	void WorldCmdRecorder::WriteRecord(uint32_t tick, uint32_t simTime, RecordedWorldCmdType type)
+	{
+		uint8_t typeVal = static_cast<uint8_t>(type);
+		uint16_t payloadSize = static_cast<uint16_t>(m_payload.Size());
+
+		m_file.write(reinterpret_cast<const char*>(&tick), sizeof(tick));
+		m_file.write(reinterpret_cast<const char*>(&simTime), sizeof(simTime));
+		m_file.write(reinterpret_cast<const char*>(&typeVal), sizeof(typeVal));
+		m_file.write(reinterpret_cast<const char*>(&payloadSize), sizeof(payloadSize));
+
+		if (payloadSize > 0)
+			m_file.write(reinterpret_cast<const char*>(m_payload.GetContentToRead()), payloadSize);
+
+		if (!m_file)
+		{
+			MLOG_ERROR(WORLD, "[WORLDCMD RECORDER] Failed to write on the recording file, recording stopped.");
+			Close();
+		}
+	}
+
+	void WorldCmdRecorder::RecordTick(uint32_t tick, uint32_t simTime)
+	{
+		if (!m_recording)
+			return;
+
+		m_payload.Clear();
+		WriteRecord(tick, simTime, RecordedWorldCmdType::TICK);
+	}
+
+	void WorldCmdRecorder::RecordSpawnPlayer(uint32_t tick, uint32_t simTime, const CharacterData& charData, uint64_t resultGUID)
+	{
+		if (!m_recording)
+			return;
+
+		m_payload.Clear();
+		m_payload << static_cast<uint64_t>(resultGUID);
+		m_payload << static_cast<uint32_t>(charData.id);
+		m_payload << static_cast<uint8_t>(charData.characterName.size());
+		m_payload << charData.characterName;
+		m_payload << charData.race << charData.gameClass << charData.gender << charData.level;
+		m_payload << charData.xp << charData.zone;
+		m_payload << charData.pos_x << charData.pos_y << charData.pos_z;
+
+		WriteRecord(tick, simTime, RecordedWorldCmdType::SPAWN_PLAYER);
+	}
+
+	void WorldCmdRecorder::RecordDespawnPlayer(uint32_t tick, uint32_t simTime, uint64_t guid)
+	{
+		if (!m_recording)
+			return;
+
+		m_payload.Clear();
+		m_payload << static_cast<uint64_t>(guid);
+
+		WriteRecord(tick, simTime, RecordedWorldCmdType::DESPAWN_PLAYER);
+	}
+
+	void WorldCmdRecorder::RecordUpdatePlayerMovement(uint32_t tick, uint32_t simTime, uint64_t guid, float_t posX, float_t posY, float_t posZ, uint8_t isoDirection, uint32_t curPacketSeq, uint32_t ackedCorrectionID)
+	{
+		if (!m_recording)
+			return;
+
+		m_payload.Clear();
+		m_payload << static_cast<uint64_t>(guid);
+		m_payload << posX << posY << posZ;
+		m_payload << isoDirection;
+		m_payload << curPacketSeq << ackedCorrectionID;
+
+		WriteRecord(tick, simTime, RecordedWorldCmdType::UPDATE_PLAYER_MOVEMENT);
+	}
+}
+}
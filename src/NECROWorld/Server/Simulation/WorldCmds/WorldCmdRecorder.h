@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <fstream>
+
+#include "Packet.h"
+#include "CharacterData.h"
+
+namespace NECRO
+{
+namespace World
+{
+	// Recording file format:
+	// Header: [MAGIC (uint32) | VERSION (uint16)]
+	// Record: [TICK (uint32) | SIMTIME_MS (uint32) | TYPE (uint8) | PAYLOAD_SIZE (uint16) | PAYLOAD]
+	//
+	// Since version 2 every tick starts with a TICK record, followed by the WorldCmds it executed.
+	// Version 1 recordings only have the WorldCmds records.
+	inline constexpr uint32_t WORLD_CMD_RECORDING_MAGIC = 0x5243574E; // "NWCR"
+	inline constexpr uint16_t WORLD_CMD_RECORDING_VERSION = 2;
+
+	enum class RecordedWorldCmdType : uint8_t
+	{
+		NONE = 0,
+		SPAWN_PLAYER,			// [RESULT_GUID (uint64) | CharacterData]
+		DESPAWN_PLAYER,			// [GUID (uint64)]
+		UPDATE_PLAYER_MOVEMENT,	// [GUID (uint64) | POS_X | POS_Y | POS_Z (float) | ISO_DIR (uint8) | PACKET_SEQ (uint32) | ACKED_CORRECTION_ID (uint32)]
+		TICK					// no payload, since version 2
+	};
+
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Writes every tick of the WorldSimulation and the decoded payload of every WorldCmd it executed to a compact
+	// binary log. The log can then be fed back into an headless WorldSimulation by the WorldCmdReplayer.
+	//
+	// WorldCmds are std::function closures and can't be serialized, so the WorldSimulation records each command
+	// from inside its WorldCmd_ function. This must only be used from the simulation thread.
+	// -------------------------------------------------------------------------------------------------------------------------
+	class WorldCmdRecorder
+	{
+	private:
+		std::ofstream	m_file;
+		bool			m_recording = false;
+		Packet			m_payload; // reused for every record
+
+		void WriteRecord(uint32_t tick, uint32_t simTime, RecordedWorldCmdType type);
+
+	public:
+		int		Open(const std::string& path);
+		void	Close();
+
+		bool	IsRecording() const { return m_recording; }
+
+		void	RecordTick(uint32_t tick, uint32_t simTime);
+		void	RecordSpawnPlayer(uint32_t tick, uint32_t simTime, const CharacterData& charData, uint64_t resultGUID);
+		void	RecordDespawnPlayer(uint32_t tick, uint32_t simTime, uint64_t guid);
+		void	RecordUpdatePlayerMovement(uint32_t tick, uint32_t simTime, uint64_t guid, float_t posX, float_t posY, float_t posZ, uint8_t isoDirection, uint32_t curPacketSeq, uint32_t ackedCorrectionID);
+	};
+}
+}
@@ -0,0 +1,257 @@
+#include "WorldCmdReplayer.h"
+#include "WorldSimulation.h"
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstring>
+
+namespace NECRO
+{
+namespace World
+{
+	// Little helper to read the fields of a recorded payload
+	class RecordedPayloadReader
+	{
+	private:
+		const std::vector<uint8_t>& m_data;
+		size_t m_rpos = 0;
+
+	public:
+		RecordedPayloadReader(const std::vector<uint8_t>& data) : m_data(data) {}
+
+		template <typename T> bool Read(T& out)
+		{
+			if (m_rpos + sizeof(T) > m_data.size())
+				return false;
+
+			std::memcpy(&out, m_data.data() + m_rpos, sizeof(T));
+			m_rpos += sizeof(T);
+			return true;
+		}
+
+		bool ReadString(std::string& out, size_t len)
+		{
+			if (m_rpos + len > m_data.size())
+				return false;
+
+			out.assign(reinterpret_cast<const char*>(m_data.data() + m_rpos), len);
+			m_rpos += len;
+			return true;
+		}
+	};
+
+	int WorldCmdReplayer::Load(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			MLOG_ERROR(WORLD, "[WORLDCMD REPLAYER] Could not open recording file '{}'.", path);
+			return -1;
+		}
+
+		uint32_t magic = 0;
+		uint16_t version = 0;
+		file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+		file.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+		if (!file || magic != WORLD_CMD_RECORDING_MAGIC || version == 0 || version > WORLD_CMD_RECORDING_VERSION)
+		{
+			MLOG_ERROR(WORLD, "[WORLDCMD REPLAYER] '{}' is not a valid recording (or has an unsupported version).", path);
+			return -2;
+		}
+
+		m_ticks.clear();
+		m_cmdsCount = 0;
+		while (true)
+		{
+			RecordedWorldCmd cmd;
+			uint8_t type = 0;
+			uint16_t payloadSize = 0;
+
+			file.read(reinterpret_cast<char*>(&cmd.tick), sizeof(cmd.tick));
+			if (file.eof())
+				break;
+
+			file.read(reinterpret_cast<char*>(&cmd.simTime), sizeof(cmd.simTime));
+			file.read(reinterpret_cast<char*>(&type), sizeof(type));
+			file.read(reinterpret_cast<char*>(&payloadSize), sizeof(payloadSize));
+
+			cmd.type = static_cast<RecordedWorldCmdType>(type);
+			cmd.payload.resize(payloadSize);
+			if (payloadSize > 0)
+				file.read(reinterpret_cast<char*>(cmd.payload.data()), payloadSize);
+
+			// A truncated last record is expected if the server crashed while recording
+			if (!file)
+			{
+				MLOG_WARNING(WORLD, "[WORLDCMD REPLAYER] Recording is truncated after {} ticks.", m_ticks.size());
+				break;
+			}
+
+			// Version 1 has no TICK records, a WorldCmd of a new tick starts it
+			if (cmd.type == RecordedWorldCmdType::TICK || m_ticks.empty() || m_ticks.back().tick != cmd.tick)
+				m_ticks.push_back(RecordedTick{ cmd.tick, cmd.simTime, {} });
+
+			if (cmd.type != RecordedWorldCmdType::TICK)
+			{
+				m_ticks.back().cmds.push_back(std::move(cmd));
+				m_cmdsCount++;
+			}
+		}
+
+		MLOG_OK(WORLD, "[WORLDCMD REPLAYER] Loaded {} ticks and {} WorldCmds from '{}'.", m_ticks.size(), m_cmdsCount, path);
+		return 0;
+	}
+
+	void WorldCmdReplayer::PostCmd(WorldSimulation& sim, const RecordedWorldCmd& cmd)
+	{
+		RecordedPayloadReader r(cmd.payload);
+
+		switch (cmd.type)
+		{
+			case RecordedWorldCmdType::SPAWN_PLAYER:
+			{
+				uint64_t recordedGUID = 0;
+				uint8_t nameLength = 0;
+				CharacterData charData;
+
+				bool ok = r.Read(recordedGUID) && r.Read(charData.id) && r.Read(nameLength) && r.ReadString(charData.characterName, nameLength) &&
+						r.Read(charData.race) && r.Read(charData.gameClass) && r.Read(charData.gender) && r.Read(charData.level) &&
+						r.Read(charData.xp) && r.Read(charData.zone) && r.Read(charData.pos_x) && r.Read(charData.pos_y) && r.Read(charData.pos_z);
+
+				if (!ok)
+					break;
+
+				charData.characterNameLength = nameLength;
+
+				std::shared_ptr<PlayerPacketQueue> packetQueue = std::make_shared<PlayerPacketQueue>();
+				m_packetQueues.push_back(packetQueue);
+
+				sim.PostWorldCmd([this, &sim, charData, packetQueue, recordedGUID]()
+					{
+						PlayerSpawnCmdResult res = sim.WorldCmd_TryToSpawnPlayerCharacter(charData, packetQueue);
+						if (res.success && recordedGUID != 0) // recordedGUID is 0 if the spawn failed in the recorded session
+							m_guidsMap[recordedGUID] = res.guid;
+					});
+				return;
+			}
+
+			case RecordedWorldCmdType::DESPAWN_PLAYER:
+			{
+				uint64_t recordedGUID = 0;
+				if (!r.Read(recordedGUID))
+					break;
+
+				sim.PostWorldCmd([this, &sim, recordedGUID]()
+					{
+						auto it = m_guidsMap.find(recordedGUID);
+						if (it == m_guidsMap.end())
+							return;
+
+						sim.WorldCmd_TryToDespawnPlayerCharacter(it->second);
+						m_guidsMap.erase(it);
+					});
+				return;
+			}
+
+			case RecordedWorldCmdType::UPDATE_PLAYER_MOVEMENT:
+			{
+				uint64_t recordedGUID = 0;
+				float_t posX, posY, posZ;
+				uint8_t isoDir;
+				uint32_t curPacketSeq, ackedCorrectionID;
+
+				if (!(r.Read(recordedGUID) && r.Read(posX) && r.Read(posY) && r.Read(posZ) && r.Read(isoDir) && r.Read(curPacketSeq) && r.Read(ackedCorrectionID)))
+					break;
+
+				sim.PostWorldCmd([this, &sim, recordedGUID, posX, posY, posZ, isoDir, curPacketSeq, ackedCorrectionID]()
+					{
+						auto it = m_guidsMap.find(recordedGUID);
+						if (it != m_guidsMap.end())
+							sim.WorldCmd_TryToUpdatePlayerMovement(it->second, posX, posY, posZ, isoDir, curPacketSeq, ackedCorrectionID);
+					});
+				return;
+			}
+
+			default:
+				break;
+		}
+
+		MLOG_WARNING(WORLD, "[WORLDCMD REPLAYER] Skipping malformed WorldCmd of type '{}' at tick '{}'.", static_cast<int>(cmd.type), cmd.tick);
+	}
+
+	int WorldCmdReplayer::Run(WorldSimulation& sim, bool realTime)
+	{
+		using namespace std::chrono;
+
+		if (m_ticks.empty())
+		{
+			MLOG_WARNING(WORLD, "[WORLDCMD REPLAYER] Nothing to replay.");
+			return -1;
+		}
+
+		m_guidsMap.clear();
+		m_packetQueues.clear();
+
+		std::vector<uint64_t> tickTimesUs;
+		std::vector<uint32_t> ticks;
+		tickTimesUs.reserve(m_ticks.size());
+		ticks.reserve(m_ticks.size());
+
+		const uint32_t firstSimTime = m_ticks.front().simTime;
+		const steady_clock::time_point replayStart = steady_clock::now();
+
+		MLOG_INFO(WORLD, "[WORLDCMD REPLAYER] Replaying {} ticks and {} WorldCmds ({})...", m_ticks.size(), m_cmdsCount, realTime ? "real time" : "full speed");
+
+		for (const RecordedTick& recordedTick : m_ticks)
+		{
+			const uint32_t simTime = recordedTick.simTime - firstSimTime;
+
+			// Queue all the cmds that ran in this tick
+			for (const RecordedWorldCmd& cmd : recordedTick.cmds)
+				PostCmd(sim, cmd);
+
+			if (realTime)
+				std::this_thread::sleep_until(replayStart + milliseconds(simTime));
+
+			steady_clock::time_point tickStart = steady_clock::now();
+			sim.UpdateAt(simTime);
+			tickTimesUs.push_back(duration_cast<microseconds>(steady_clock::now() - tickStart).count());
+			ticks.push_back(recordedTick.tick);
+
+			// Nobody is listening, throw away what the simulation sent to the players
+			for (auto& q : m_packetQueues)
+				q->Clear();
+		}
+
+		ReportTimings(tickTimesUs, ticks);
+		return 0;
+	}
+
+	void WorldCmdReplayer::ReportTimings(std::vector<uint64_t>& tickTimesUs, const std::vector<uint32_t>& ticks)
+	{
+		uint64_t total = 0;
+		size_t slowestIndex = 0;
+		for (size_t i = 0; i < tickTimesUs.size(); i++)
+		{
+			total += tickTimesUs[i];
+			if (tickTimesUs[i] > tickTimesUs[slowestIndex])
+				slowestIndex = i;
+		}
+
+		const uint64_t slowest = tickTimesUs[slowestIndex];
+		const uint32_t slowestTick = ticks[slowestIndex];
+
+		std::sort(tickTimesUs.begin(), tickTimesUs.end());
+		auto percentile = [&tickTimesUs](double p) { return tickTimesUs[static_cast<size_t>(p * (tickTimesUs.size() - 1))]; };
+
+		MLOG_OK(WORLD, "[WORLDCMD REPLAYER] Replayed {} ticks. Total: {}us | Avg: {}us | p50: {}us | p99: {}us | Max: {}us (recorded tick '{}')",
+			tickTimesUs.size(), total, total / tickTimesUs.size(), percentile(0.50), percentile(0.99), slowest, slowestTick);
+	}
+}
+}
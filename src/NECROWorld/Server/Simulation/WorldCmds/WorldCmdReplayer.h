@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "WorldCmdRecorder.h"
+#include "PlayerPacketQueue.h"
+
+namespace NECRO
+{
+namespace World
+{
+	class WorldSimulation;
+
+	struct RecordedWorldCmd
+	{
+		uint32_t				tick;
+		uint32_t				simTime;
+		RecordedWorldCmdType	type;
+		std::vector<uint8_t>	payload;
+	};
+
+	struct RecordedTick
+	{
+		uint32_t						tick;
+		uint32_t						simTime;
+		std::vector<RecordedWorldCmd>	cmds;
+	};
+
+	// -------------------------------------------------------------------------------------------------------------------------
+	// Loads a recording made by the WorldCmdRecorder and feeds it into a WorldSimulation, either as fast as possible or
+	// respecting the recorded timings, measuring how long each tick took. Meant to run in an headless server (no MySQL,
+	// no clients), see Server::RunReplay.
+	//
+	// Every recorded tick is replayed, including the ones that executed no WorldCmds, so the simulation sees the same
+	// sequence of time diffs it saw when recording. Version 1 recordings only have the ticks that executed WorldCmds.
+	// -------------------------------------------------------------------------------------------------------------------------
+	class WorldCmdReplayer
+	{
+	private:
+		std::vector<RecordedTick>	m_ticks;
+		size_t						m_cmdsCount = 0;
+
+		// Recorded GUID -> GUID the entity got in the replay
+		std::unordered_map<uint64_t, uint64_t> m_guidsMap;
+
+		// Packets queued by the simulation to the replayed players, discarded after every tick
+		std::vector<std::shared_ptr<PlayerPacketQueue>> m_packetQueues;
+
+		void PostCmd(WorldSimulation& sim, const RecordedWorldCmd& cmd);
+		void ReportTimings(std::vector<uint64_t>& tickTimesUs, const std::vector<uint32_t>& ticks);
+
+	public:
+		int		Load(const std::string& path);
+		int		Run(WorldSimulation& sim, bool realTime);
+	};
+}
+}
@@ -7,6 +7,8 @@
 #include "ConsoleLogger.h"
 #include "FileLogger.h"
 
+#include <algorithm>
+
 #include <boost/asio.hpp>
 
 namespace NECRO
@@ -15,13 +17,39 @@ namespace World
 {
 	int WorldSimulation::Start()
 	{
-		// Load all the default maps as Zones
-		uint32_t nextZoneID = 1; // TODO, properly manage this
-		m_zones.insert({ nextZoneID, std::make_unique<Zone>(1, nextZoneID)}); // 0: Load Exterior World
-		nextZoneID++;
+		const auto& settings = Server::Instance().GetSettings();
+
+		m_profiler.Setup(settings.TICK_PROFILER_ENABLED, settings.TICK_PROFILER_SLOW_TICK_MS, settings.TICK_PROFILER_REPORT_INTERVAL_MS);
+
+		// Prebuild the shells pool, these get bound to a map when an instance is requested
+		m_zoneManager.Setup(static_cast<size_t>(std::max(settings.ZONE_SHELL_POOL_SIZE, 0)), settings.ZONE_HIBERNATE_AFTER_MS, settings.ZONE_TEARDOWN_AFTER_MS);
+
+		m_ndbStores = Server::Instance().GetNDBStores();
+
+		// Load all the exterior maps as persistent Zones, instanced maps are spawned on demand
+		for (auto& [mapID, def] : m_ndbStores->GetMapDefStore().GetDefs())
+		{
+			if (def->IsInstanced())
+				continue;
+
+			if (!m_zoneManager.InstantiateZone(mapID, mapID, m_curTime, m_ndbStores))
+			{
+				MLOG_ERROR(WORLD, "Could not load the exterior map '{}' (MapID: '{}').", def->m_mapName, mapID);
+				return -1;
+			}
+		}
 
 		// Load the active instanced maps (saved on the DB)
 
+		if (settings.WORLD_CMD_RECORDING_ENABLED && m_recorder.Open(settings.WORLD_CMD_RECORDING_FILE) != 0)
+			MLOG_WARNING(WORLD, "WorldCmds recording was enabled but could not be started, running without it.");
+
+		m_saveIntervalMs = settings.CHARACTER_SAVE_INTERVAL_MS;
+		m_saveWheel.assign(CHARACTER_SAVE_WHEEL_SLOTS, {});
+		m_saveWheelSlots.clear();
+		m_nextSaveSlot = 0;
+		m_lastSaveSlotTime = 0;
+
 		m_worldLoopCounter = 0;
 		m_startTime = std::chrono::steady_clock::now();
 
@@ -33,28 +61,156 @@ namespace World
 	{
 		using namespace std::chrono;
 
+		UpdateAt(static_cast<uint32_t>(duration_cast<milliseconds>(steady_clock::now() - m_startTime).count()));
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// Runs a simulation step at the given simulation time (ms since Start). Update() feeds it the wall clock,
+	// the WorldCmdReplayer feeds it the recorded times.
+	// ------------------------------------------------------------------------------------------------------------------
+	void WorldSimulation::UpdateAt(uint32_t simTime)
+	{
 		m_worldLoopCounter++;
-		m_curTime = static_cast<uint32_t>(duration_cast<milliseconds>(steady_clock::now() - m_startTime).count());
+		m_curTime = simTime;
 		m_curTimeDiff = m_curTime - m_prevTime;
 
+		// The WorldCmds executed in this tick are recorded after it
+		m_recorder.RecordTick(m_worldLoopCounter, m_curTime);
+
 		// We can throttle here, define a tickrate and have a minDiff before update
+
+		// Tick boundary, nothing of this tick has used the stores yet
+		UpdateNDBStores();
 		
+		if (m_profiler.IsEnabled())
+		{
+			UpdateProfiled();
+			m_prevTime = m_curTime;
+			return;
+		}
+
 		// Execute queued cmds
 		ExecuteWorldCmds();
 
 		// TODO: This is highly parallelizable, we could have working sim threads working on different maps :D
-		for (auto& zone : m_zones)
-			zone.second->Update(m_curTimeDiff);
+		for (auto& zone : m_zoneManager.GetZones())
+			if (zone.second->IsActive()) // hibernating zones cost no tick time
+				zone.second->Update(m_curTimeDiff);
+
+		if (m_curTime - m_lastLifecycleCheck >= ZONES_LIFECYCLE_CHECK_INTERVAL_MS)
+		{
+			UpdateZonesLifecycle();
+			m_lastLifecycleCheck = m_curTime;
+		}
+
+		if (IsSaveSlotDue())
+			UpdatePeriodicSaves();
 		
 		m_prevTime = m_curTime;
 	}
 
+	// ------------------------------------------------------------------------------------------------------------------
+	// Same steps of UpdateAt, but each phase (and each zone) is timed and fed to the TickProfiler
+	// ------------------------------------------------------------------------------------------------------------------
+	void WorldSimulation::UpdateProfiled()
+	{
+		using clock = std::chrono::steady_clock;
+
+		m_profiler.BeginTick(m_worldLoopCounter);
+
+		clock::time_point t = clock::now();
+		m_profiler.SetCmdsExecuted(static_cast<uint32_t>(ExecuteWorldCmds()));
+		m_profiler.AddPhase(TickPhase::EXECUTE_WORLD_CMDS, TickProfiler::ElapsedUs(t));
+
+		for (auto& [zoneID, zone] : m_zoneManager.GetZones())
+		{
+			if (!zone->IsActive())
+				continue;
+
+			clock::time_point zoneStart = clock::now();
+			zone->UpdateCells(m_curTimeDiff);
+			uint64_t updateUs = TickProfiler::ElapsedUs(zoneStart);
+
+			clock::time_point transferStart = clock::now();
+			uint32_t transfers = zone->TransferPendingEntities();
+			uint64_t transferUs = TickProfiler::ElapsedUs(transferStart);
+
+			m_profiler.AddPhase(TickPhase::ZONES_UPDATE, updateUs);
+			m_profiler.AddPhase(TickPhase::TRANSFER_ENTITIES, transferUs);
+			m_profiler.AddZone(zoneID, updateUs + transferUs, zone->GetEntitiesCount(), transfers);
+		}
+
+		if (m_curTime - m_lastLifecycleCheck >= ZONES_LIFECYCLE_CHECK_INTERVAL_MS)
+		{
+			t = clock::now();
+			UpdateZonesLifecycle();
+			m_lastLifecycleCheck = m_curTime;
+			m_profiler.AddPhase(TickPhase::ZONES_LIFECYCLE, TickProfiler::ElapsedUs(t));
+		}
+
+		if (IsSaveSlotDue())
+		{
+			t = clock::now();
+			UpdatePeriodicSaves();
+			m_profiler.AddPhase(TickPhase::PERIODIC_SAVES, TickProfiler::ElapsedUs(t));
+		}
+
+		m_profiler.EndTick();
+	}
+
 	void WorldSimulation::Stop()
 	{
 		m_isRunning = false;
 	}
 
-	void WorldSimulation::ExecuteWorldCmds()
+	void WorldSimulation::StopRecording()
+	{
+		m_recorder.Close();
+	}
+
+	uint32_t WorldSimulation::CreateInstance(uint32_t mapID)
+	{
+		return m_zoneManager.CreateInstance(mapID, m_curTime, m_ndbStores);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Switches to the latest published NDBDataStores version (see Server::ReloadNDBStores). New Zones use it right
+	// away, live Zones switch to it if they can. The previous version is freed when its last Zone drops it.
+	// -----------------------------------------------------------------------------------------------------------
+	void WorldSimulation::UpdateNDBStores()
+	{
+		std::shared_ptr<const NDBDataStoreManager> latest = Server::Instance().GetNDBStores();
+		if (latest == m_ndbStores)
+			return;
+
+		m_ndbStores = std::move(latest);
+
+		uint32_t rebound = 0;
+		for (auto& [zoneID, zone] : m_zoneManager.GetZones())
+		{
+			if (zone->RebindDef(m_ndbStores))
+				rebound++;
+			else
+				MLOG_WARNING(WORLD, "[NDB] ZoneID: '{}' (MapID: '{}') keeps its previous MapDef, the new one is missing or has a different size.", zoneID, zone->GetMapID());
+		}
+
+		MLOG_INFO(WORLD, "[NDB] Simulation switched to the NDBDataStores version {}, {} of {} Zones rebound.", m_ndbStores->GetVersion(), rebound, m_zoneManager.GetZones().size());
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Hibernates and tears down the empty Zones (see ZoneManager::UpdateLifecycle), the profiler drops the
+	// stats of the torn down ones
+	// -----------------------------------------------------------------------------------------------------------
+	void WorldSimulation::UpdateZonesLifecycle()
+	{
+		std::vector<uint32_t> destroyed;
+		m_zoneManager.UpdateLifecycle(m_curTime, destroyed);
+
+		for (uint32_t zoneID : destroyed)
+			m_profiler.OnZoneDestroyed(zoneID);
+	}
+
+	size_t WorldSimulation::ExecuteWorldCmds()
 	{
 		std::vector<std::function<void()>> currentQueue;
 
@@ -72,9 +228,11 @@ namespace World
 			}
 			catch (...)
 			{
-				LOG_CRITICAL("Exception caught during WorldCmd execution. Handling: Unknown.");
+				MLOG_CRITICAL(WORLD, "Exception caught during WorldCmd execution. Handling: Unknown.");
 			}
 		}
+
+		return currentQueue.size();
 	}
 
 	void WorldSimulation::PostWorldCmd(std::function<void()> cmd)
@@ -83,6 +241,53 @@ namespace World
 		m_pendingCmds.push_back(std::move(cmd));
 	}
 
+	int WorldSimulation::BroadcastToZone(uint32_t zoneID, Packet&& p, uint64_t excludeGUID)
+	{
+		Zone* zone = m_zoneManager.FindZone(zoneID);
+		if (!zone)
+			return 0;
+
+		SharedPacket shared = std::make_shared<const Packet>(std::move(p));
+		int sent = 0;
+
+		for (PlayerEntity* player : zone->GetPlayers())
+		{
+			if (player->GetGUID() != excludeGUID && player->SendSharedPacket(shared))
+				sent++;
+		}
+
+		return sent;
+	}
+
+	int WorldSimulation::BroadcastToGUIDs(const std::vector<uint64_t>& guids, Packet&& p)
+	{
+		SharedPacket shared = std::make_shared<const Packet>(std::move(p));
+		int sent = 0;
+
+		for (uint64_t guid : guids)
+		{
+			PlayerEntity* player = FindPlayer(guid);
+			if (player && player->SendSharedPacket(shared))
+				sent++;
+		}
+
+		return sent;
+	}
+
+	int WorldSimulation::BroadcastToAll(Packet&& p, uint64_t excludeGUID)
+	{
+		SharedPacket shared = std::make_shared<const Packet>(std::move(p));
+		int sent = 0;
+
+		for (auto& [guid, player] : m_players)
+		{
+			if (guid != excludeGUID && player->SendSharedPacket(shared))
+				sent++;
+		}
+
+		return sent;
+	}
+
 	bool WorldSimulation::RegisterPlayer(uint64_t guid, uint32_t charID, PlayerEntity* player)
 	{
 		auto it = m_charIdToGuid.find(charID);
@@ -91,6 +296,7 @@ namespace World
 			// Register the player
 			m_players[guid] = player;
 			m_charIdToGuid[charID] = guid;
+			AddToSaveWheel(guid);
 			return true;
 		}
 
@@ -105,36 +311,117 @@ namespace World
 
 		m_charIdToGuid.erase(cIt);
 		m_players.erase(guid);
+		RemoveFromSaveWheel(guid);
 		return true;
 	}
 
+	void WorldSimulation::AddToSaveWheel(uint64_t guid)
+	{
+		if (m_saveWheel.empty())
+			return;
+
+		size_t slot = 0;
+		for (size_t i = 1; i < m_saveWheel.size(); i++)
+			if (m_saveWheel[i].size() < m_saveWheel[slot].size())
+				slot = i;
+
+		m_saveWheel[slot].push_back(guid);
+		m_saveWheelSlots[guid] = slot;
+	}
+
+	void WorldSimulation::RemoveFromSaveWheel(uint64_t guid)
+	{
+		auto it = m_saveWheelSlots.find(guid);
+		if (it == m_saveWheelSlots.end())
+			return;
+
+		std::vector<uint64_t>& slot = m_saveWheel[it->second];
+		auto gIt = std::find(slot.begin(), slot.end(), guid);
+		if (gIt != slot.end())
+		{
+			*gIt = slot.back();
+			slot.pop_back();
+		}
+
+		m_saveWheelSlots.erase(it);
+	}
+
+	bool WorldSimulation::IsSaveSlotDue() const
+	{
+		if (m_saveIntervalMs == 0 || m_saveWheel.empty())
+			return false;
+
+		const uint32_t slotMs = std::max<uint32_t>(m_saveIntervalMs / static_cast<uint32_t>(m_saveWheel.size()), 1);
+		return m_curTime - m_lastSaveSlotTime >= slotMs;
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// Saves the players of the next slot of the wheel that changed since their last save. At most one slot per tick,
+	// after a stall the wheel just resumes instead of saving several slots at once.
+	// ------------------------------------------------------------------------------------------------------------------
+	void WorldSimulation::UpdatePeriodicSaves()
+	{
+		m_lastSaveSlotTime = m_curTime;
+
+		for (uint64_t guid : m_saveWheel[m_nextSaveSlot])
+			if (PlayerEntity* p = FindPlayer(guid))
+				SavePlayer(p, false);
+
+		m_nextSaveSlot = (m_nextSaveSlot + 1) % m_saveWheel.size();
+	}
+
 	Zone* WorldSimulation::FindZone(uint32_t zoneID)
 	{
-		auto it = m_zones.find(zoneID);
-		return it != m_zones.end() ? it->second.get() : nullptr;
+		return m_zoneManager.FindZone(zoneID);
 	}
 
-	// Note on saving, possible TODO. The current architecture contains a unlikely but possible data race that happens when the player enters the world, leaves it and very quickly reconnects.
-	// If the dbworker thread is just 1, it's not a problem because it acts as a FIFO so the UPDATE (save) runs before the SELECT to list the characters.
-	// But if the dbworkers are 2, we could have a data race where the select is executed before the enqueued save. I should be extremely rare, but still possible
+	// Note on saving: when the player enters the world, leaves it and very quickly reconnects, the UPDATE (save) must run before the SELECT to list the characters.
+	// All the characters DB requests of an account carry the accountID as ordering key, so they all run on the same DBWorker, in FIFO order.
+	// With the CharacterJournal the save is journaled and sent to the DB right away (urgent), keeping that order.
 	bool WorldSimulation::SavePlayerOnDatabase(uint64_t guid)
 	{
 		PlayerEntity* p = FindPlayer(guid);
-		
-		if (p)
+		if (!p)
+			return false;
+
+		return SavePlayer(p, true);
+	}
+
+	// ------------------------------------------------------------------------------------------------------------------
+	// Writes only the column groups that changed since the last save, a character that didn't change isn't written at all.
+	// urgent (logout) sends the save to the DB right away, even when it was already journaled by a periodic save.
+	// ------------------------------------------------------------------------------------------------------------------
+	bool WorldSimulation::SavePlayer(PlayerEntity* p, bool urgent)
+	{
+		// Replaying without databases
+		if (Server::Instance().IsHeadless())
+			return true;
+
+		const CharacterData* charData = p->GetCharacterData();
+		const uint8_t dirtyMask = p->TakeDirtyMask();
+
+		if (dirtyMask != CHARACTER_DIRTY_NONE)
+			Server::Instance().GetCharacterCache().UpdateCharacter(*charData);
+
+		CharacterJournal& journal = Server::Instance().GetCharacterJournal();
+		if (journal.IsRunning())
 		{
-			const CharacterData* charData = p->GetCharacterData();
+			journal.Append(*charData, dirtyMask, urgent);
+			return true;
+		}
 
-			auto& dbWorker = Server::Instance().GetCharactersDBPool();
-			{
-				DBRequest req(Server::Instance().GetAsioThreadPool().m_ioContext, true);
+		if (dirtyMask == CHARACTER_DIRTY_NONE)
+			return true;
 
-				req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SAVE_CHARACTER), { charData->level, charData->xp, charData->zone, charData->pos_x, charData->pos_y, charData->pos_z, charData->id } });
-				dbWorker.Enqueue(std::move(req));
-			}
+		auto& dbWorker = Server::Instance().GetCharactersDBPool();
+		{
+			DBRequest req(Server::Instance().GetAsioThreadPool().m_ioContext, true);
+
+			req.m_steps.push_back(CharacterJournal::MakeSaveStep(CharacterJournal::MakeEntry(*charData, dirtyMask)));
+			req.m_orderingKey = charData->accountID;
+			req.m_priority = DBRequestPriority::BACKGROUND;
+			dbWorker.Enqueue(std::move(req));
 		}
-		else
-			return false;
 
 		return true;
 	}
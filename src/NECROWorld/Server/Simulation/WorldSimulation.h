@@ -8,8 +8,10 @@
 #include <functional>
 #include <mutex>
 
-#include "Zone.h"
+#include "ZoneManager.h"
 #include "WorldCmdTypes.h"
+#include "WorldCmdRecorder.h"
+#include "TickProfiler.h"
 #include "WorldSession.h"
 
 namespace NECRO
@@ -19,6 +21,12 @@ namespace World
 {
 	class PlayerEntity;
 
+	// How often the WorldSimulation checks the Zones for hibernation/teardown
+	inline constexpr uint32_t ZONES_LIFECYCLE_CHECK_INTERVAL_MS = 1000;
+
+	// The online players are spread across the slots of the save wheel, one slot is saved every CHARACTER_SAVE_INTERVAL_MS / CHARACTER_SAVE_WHEEL_SLOTS
+	inline constexpr uint32_t CHARACTER_SAVE_WHEEL_SLOTS = 60;
+
 	// ------------------------------------------------------------------------
 	// Simulation of the whole world. Contains all the Zones loaded of the game
 	// ------------------------------------------------------------------------
@@ -34,9 +42,12 @@ namespace World
 		uint32_t m_prevTime;
 		uint32_t m_curTimeDiff;
 
-		// All the maps currently loaded in the server are called "zones"
-		// Some may be inactive, some may be expired/invalid (for example, an instanced dungeon that was cleared by the server)
-		std::unordered_map<uint32_t, std::unique_ptr<Zone>>	m_zones;
+		// NDBDataStores version used by the simulation, switched to the published one at tick boundaries
+		std::shared_ptr<const NDBDataStoreManager>			m_ndbStores;
+
+		// All the Zones loaded and their lifecycle (instances, hibernation, teardown)
+		ZoneManager							m_zoneManager;
+		uint32_t							m_lastLifecycleCheck = 0;
 
 		// All the players in any Zone. They belong to the Zone they're currently and are indexed here for quick access
 		// CharID -> GUID
@@ -44,6 +55,14 @@ namespace World
 		std::unordered_map<uint32_t, uint64_t>				m_charIdToGuid;
 		std::unordered_map<uint64_t, PlayerEntity*>			m_players;
 
+		// Periodic saves. Players join the least loaded slot, so the saves (and the DB load) stay even across the interval
+		// GUID -> slot
+		uint32_t											m_saveIntervalMs = 0;
+		uint32_t											m_lastSaveSlotTime = 0;
+		size_t												m_nextSaveSlot = 0;
+		std::vector<std::vector<uint64_t>>					m_saveWheel;
+		std::unordered_map<uint64_t, size_t>				m_saveWheelSlots;
+
 		// ------------------------------------------------------------------------------------------------------------------------------------------------------
 		// A WorldCmd is a function or command that is issued by a WorldSession that requests to execute code on the main thread (simulation thread) and 
 		// eventually fire a callback on the thread that originatated the request (that thread may need to know the result of the Cmd to continue its processing)
@@ -51,15 +70,34 @@ namespace World
 		std::mutex m_cmdsMutex;
 		std::vector<std::function<void()>> m_pendingCmds;
 
+		// Optional, records the WorldCmds for offline replay (see WorldCmdReplayer)
+		WorldCmdRecorder m_recorder;
+
+		TickProfiler m_profiler;
+
 	public:
 		std::atomic<bool> m_isRunning;
 
 	private:
-		void			ExecuteWorldCmds();
+		size_t			ExecuteWorldCmds();
+		void			UpdateProfiled();
 		bool			RegisterPlayer(uint64_t guid, uint32_t charID, PlayerEntity* player);
 		bool			UnregisterPlayer(uint64_t guid, uint32_t charID);
+		bool			SavePlayer(PlayerEntity* p, bool urgent);
 		Zone*			FindZone(uint32_t zoneID);
 		PlayerEntity*	FindPlayer(uint64_t guid);
+		bool			IsMovementBlocked(const PlayerEntity* p, float_t posX, float_t posY, float_t posZ) const;
+
+		void			UpdateNDBStores();
+
+		// Zone lifecycle
+		void			UpdateZonesLifecycle();
+
+		// Periodic saves
+		void			AddToSaveWheel(uint64_t guid);
+		void			RemoveFromSaveWheel(uint64_t guid);
+		bool			IsSaveSlotDue() const;
+		void			UpdatePeriodicSaves();
 
 	public:
 		WorldSimulation() : m_isRunning(false), m_worldLoopCounter(0), m_curTime(0), m_prevTime(0), m_curTimeDiff(0)
@@ -68,12 +106,25 @@ namespace World
 
 		int		Start();
 		void	Update();
+		void	UpdateAt(uint32_t simTime);
 		void	Stop();
 
+		void	StopRecording();
+
 		bool	SavePlayerOnDatabase(uint64_t guid);
 
+		// Spawns a new instance of an INSTANCED map, returns its zoneID or 0 on failure
+		uint32_t	CreateInstance(uint32_t mapID);
+
 		void	PostWorldCmd(std::function<void()> cmd);
 
+		// Broadcasts - the packet is serialized once and shared by all the recipients, each WorldSession encrypts it on its own NetworkThread
+		// Return the number of players the packet was queued to. Nothing sends a server-to-many packet yet, these are the way to send
+		// the first ones (entity updates, chat) instead of a SendPacket loop
+		int		BroadcastToZone(uint32_t zoneID, Packet&& p, uint64_t excludeGUID = 0);
+		int		BroadcastToGUIDs(const std::vector<uint64_t>& guids, Packet&& p);
+		int		BroadcastToAll(Packet&& p, uint64_t excludeGUID = 0);
+
 		// Cmds - implemented in Simulation/WorldCmds/x.cpp
 		PlayerSpawnCmdResult	WorldCmd_TryToSpawnPlayerCharacter(CharacterData charData, std::shared_ptr<PlayerPacketQueue> playerPQueue);
 		PlayerDespawnCmdResult	WorldCmd_TryToDespawnPlayerCharacter(uint64_t guid);
@@ -19,7 +19,7 @@ namespace World
             return; // Nothing was spawned, this was just extra safety
 
         uint64_t guid = result.guid;
-        LOG_WARNING("EnterWorld result could not be delivered, rolling back the spawn of GUID: '{}'.", guid);
+        MLOG_WARNING(NETWORK, "EnterWorld result could not be delivered, rolling back the spawn of GUID: '{}'.", guid);
 
         Server::Instance().GetWorldSimulation().PostWorldCmd(
             [guid]()
@@ -41,20 +41,30 @@ namespace World
 
 		// Make sure that charID is associated with the accountid that originated the request
         std::shared_ptr<EnterWorldCtx> reqCtx = std::make_shared<EnterWorldCtx>(EnterWorldCtx({pckt->characterID}));
+
+        // Served from memory if the account was listed already
+        std::vector<CharacterRow> cachedRows(1);
+        if (Server::Instance().GetCharacterCache().GetCharacter(reqCtx->characterID, cachedRows[0]))
+        {
+            m_status = WorldSocketStatus::ENTERING_WORLD;
+            return DBCallback_HandleEnterWorldChecks(0, cachedRows, reqCtx);
+        }
+
         auto& dbworker = Server::Instance().GetCharactersDBPool();
         {
             DBRequest req(m_ioContextRef, false);
             req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SEL_BY_CHARID), {reqCtx->characterID } }); // check for characters limit on the account
+            req.m_orderingKey = m_data.accountID;
 
             // The callback needs to ensure the object still exists, as it may be deleted by the main thread while the dbrequest is being processed
             std::weak_ptr<WorldSession> weakSelf = shared_from_this();
-            req.m_callback = [weakSelf, reqCtx](uint32_t ec, std::vector<mysqlx::SqlResult>& res)
+            req.SetTypedCallback<CharacterRow>(&CharactersDatabase::DecodeCharacterByIDRow, [weakSelf, reqCtx](uint32_t ec, std::vector<CharacterRow>& rows)
                 {
                     if (auto lockedSelf = weakSelf.lock())
-                        return lockedSelf->DBCallback_HandleEnterWorldChecks(ec, res, reqCtx);
+                        return lockedSelf->DBCallback_HandleEnterWorldChecks(ec, rows, reqCtx);
 
                     return false; // WorldSession is destroyed (disconnect)
-                };
+                });
 
             req.m_cancelToken = weakSelf;
 
@@ -67,19 +77,19 @@ namespace World
 		return true;
 	}
 
-	bool WorldSession::DBCallback_HandleEnterWorldChecks(uint32_t ec, std::vector<mysqlx::SqlResult>& result, std::shared_ptr<EnterWorldCtx> reqCtx)
+	bool WorldSession::DBCallback_HandleEnterWorldChecks(uint32_t ec, std::vector<CharacterRow>& rows, std::shared_ptr<EnterWorldCtx> reqCtx)
 	{
         if (!IsOpen())
             return false;
 
         if (ec != 0)
         {
-            LOG_DEBUG("DBCallback_HandleEnterWorldChecks's query returned an error. There's no way to continue. Dropping socket.");
+            MLOG_DEBUG(NETWORK, "DBCallback_HandleEnterWorldChecks's query returned an error. There's no way to continue. Dropping socket.");
             CloseSocket();
             return false;
         }
 
-        LOG_DEBUG("Handling DBCallback_HandleEnterWorldChecks for user {}!", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Handling DBCallback_HandleEnterWorldChecks for user {}!", m_data.accountID);
 
         m_lastActivity = std::chrono::steady_clock::now();
 
@@ -88,7 +98,7 @@ namespace World
 
         // Check the callback
         // If CharID doesnt exist.
-        if (result[0].count() <= 0)
+        if (rows.empty())
         {
             // Send error message to the client, but don't drop him
             p << static_cast<uint8_t>(World::WorldResults::CHARACTER_NOT_FOUND);
@@ -96,7 +106,7 @@ namespace World
             int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
             if (encryptRes < 0)
             {
-                LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+                MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
                 CloseSocket();
                 return false;
             }
@@ -108,10 +118,10 @@ namespace World
         }
         else
         {
-            mysqlx::Row row = result[0].fetchOne(); //result[0] is result of m_step[0]
+            const CharacterRow& row = rows[0];
 
             // Check the account id of the row that returned
-            uint32_t dbAccountID = row[0].get<uint32_t>();
+            uint32_t dbAccountID = row.accountID;
 
             if (dbAccountID == m_data.accountID)
             {
@@ -121,17 +131,18 @@ namespace World
                 // Fill the remaining data from the DBRow
                 std::shared_ptr<NECRO::CharacterData> characterData = std::make_shared<NECRO::CharacterData>();
                 characterData->id = reqCtx->characterID;
-                characterData->characterName = row[1].get<std::string>();
+                characterData->accountID = dbAccountID;
+                characterData->characterName = row.name;
                 characterData->characterNameLength = characterData->characterName.length();
-                characterData->race     = static_cast<uint8_t>(row[2].get<int>());
-                characterData->gameClass = static_cast<uint8_t>(row[3].get<int>());
-                characterData->gender   = static_cast<uint8_t>(row[4].get<int>());
-                characterData->level    = static_cast<uint8_t>(row[5].get<int>());
-                characterData->xp       = static_cast<uint32_t>(row[6].get<uint32_t>());
-                characterData->zone     = static_cast<uint32_t>(row[7].get<uint32_t>());
-                characterData->pos_x    = static_cast<float_t>(row[8].get<float_t>());
-                characterData->pos_y    = static_cast<float_t>(row[9].get<float_t>());
-                characterData->pos_z    = static_cast<float_t>(row[10].get<float_t>());
+                characterData->race     = row.race;
+                characterData->gameClass = row.gameClass;
+                characterData->gender   = row.gender;
+                characterData->level    = row.level;
+                characterData->xp       = row.xp;
+                characterData->zone     = row.zone;
+                characterData->pos_x    = row.pos_x;
+                characterData->pos_y    = row.pos_y;
+                characterData->pos_z    = row.pos_z;
 
                 // Clear the PlayerPacketQueue, we're spawning a new player.
                 m_playerPacketQueue->Clear();
@@ -171,7 +182,7 @@ namespace World
                 int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
                 if (encryptRes < 0)
                 {
-                    LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+                    MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
                     CloseSocket();
                     return false;
                 }
@@ -195,7 +206,7 @@ namespace World
             return false;
         }
 
-        LOG_DEBUG("Handling WorldCmdCallback_OnEnterWorld for user {}!", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Handling WorldCmdCallback_OnEnterWorld for user {}!", m_data.accountID);
 
         m_lastActivity = std::chrono::steady_clock::now();
 
@@ -226,7 +237,7 @@ namespace World
         int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
         if (encryptRes < 0)
         {
-            LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+            MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
             CloseSocket();
             return false;
         }
@@ -251,7 +262,7 @@ namespace World
         }
         else
         {
-            LOG_DEBUG("m_status is IN_WORLD but PlayerGUID is invalid for AccountID:'{}'", m_data.accountID);
+            MLOG_DEBUG(NETWORK, "m_status is IN_WORLD but PlayerGUID is invalid for AccountID:'{}'", m_data.accountID);
             CloseSocket();
             return false;
         }
@@ -320,7 +331,7 @@ namespace World
         if (!IsOpen())
             return false;
 
-        LOG_DEBUG("Handling WorldCmdCallback_OnExitWorld for user {}!", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Handling WorldCmdCallback_OnExitWorld for user {}!", m_data.accountID);
 
         m_lastActivity = std::chrono::steady_clock::now();
 
@@ -340,7 +351,7 @@ namespace World
         int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
         if (encryptRes < 0)
         {
-            LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+            MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
             CloseSocket();
             return false;
         }
@@ -355,7 +366,7 @@ namespace World
         if (!IsOpen())
             return false;
 
-        LOG_DEBUG("Handling Handle_SPacketPlayerMovementUpdate for user {}", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Handling Handle_SPacketPlayerMovementUpdate for user {}", m_data.accountID);
 
         // Fixed size packet
         if (m_currentDecryptedPacket.GetActiveSize() != sizeof(SPacketPlayerMovementUpdate))
@@ -3,6 +3,7 @@
 #include <mutex>
 #include <vector>
 #include <atomic>
+#include <variant>
 
 #include "Packet.h"
 
@@ -12,6 +13,9 @@ namespace World
 {
 	inline constexpr size_t PLAYER_PACKET_QUEUE_MAX_SIZE = 1000;
 
+	// A queued packet is either owned by this player only or a broadcast buffer shared with other recipients
+	using QueuedPacket = std::variant<Packet, SharedPacket>;
+
 	// -----------------------------------------------------------------------------------------------------------------------------------------
 	// An object that is shared between the WorldSession and PlayerEntity to allow the PlayerEntity to hand packets to the WorldSession without
 	// any "hard link". This Queue is co-owned by the WorldSession and the PlayerEntity via shared_ptrs. 
@@ -23,8 +27,11 @@ namespace World
 	private:
 		std::mutex			m_mutex;
 
+		// Packets enqueued by the simulation on all the queues, sampled by the TickProfiler
+		static inline std::atomic<uint64_t> s_totalEnqueued{ 0 };
+
 		// Guarded by mutex
-		std::vector<Packet> m_queue;
+		std::vector<QueuedPacket> m_queue;
 
 	public:
 		bool TryEnqueue(Packet&& p)
@@ -35,11 +42,25 @@ namespace World
 				return false;
 
 			m_queue.push_back(std::move(p));
+			s_totalEnqueued.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Enqueues a broadcast packet without copying its content, only the refcount is touched
+		bool TryEnqueueShared(const SharedPacket& p)
+		{
+			std::lock_guard lock(m_mutex);
+
+			if (m_queue.size() >= PLAYER_PACKET_QUEUE_MAX_SIZE)
+				return false;
+
+			m_queue.push_back(p);
+			s_totalEnqueued.fetch_add(1, std::memory_order_relaxed);
 			return true;
 		}
 
 		// Swaps the queue with the vector passed as parameter
-		void DrainQueue(std::vector<Packet>& out)
+		void DrainQueue(std::vector<QueuedPacket>& out)
 		{
 			std::lock_guard lock(m_mutex);
 			m_queue.swap(out);
@@ -51,6 +72,11 @@ namespace World
 			std::lock_guard lock(m_mutex);
 			m_queue.clear();
 		}
+
+		static uint64_t GetTotalEnqueued()
+		{
+			return s_totalEnqueued.load(std::memory_order_relaxed);
+		}
 	};
 }
 }
@@ -0,0 +1,154 @@
+#include "SessionKeyHandoffTable.h"
+
+#include <ctime>
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+namespace World
+{
+	int SessionKeyHandoffTable::Open(boost::asio::io_context& io, uint16_t port, const std::string& secret, uint32_t ttlSeconds)
+	{
+		boost::system::error_code ec;
+
+		// Loopback only, the NECROAuth runs on this host
+		auto socket = std::make_unique<boost::asio::ip::udp::socket>(io);
+		socket->open(boost::asio::ip::udp::v4(), ec);
+		if (!ec)
+			socket->bind(boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::loopback(), port), ec);
+
+		if (ec)
+		{
+			MLOG_ERROR(NETWORK, "Could not bind the session key handoff socket on 127.0.0.1:{}: {}", port, ec.message());
+			return -1;
+		}
+
+		m_secret = secret;
+		m_ttlSeconds = ttlSeconds;
+		m_socket = std::move(socket);
+
+		AsyncReceive();
+
+		MLOG_OK(NETWORK, "Receiving the session keys from the NECROAuth on 127.0.0.1:{}.", port);
+		return 0;
+	}
+
+	void SessionKeyHandoffTable::Close()
+	{
+		if (!m_socket)
+			return;
+
+		boost::system::error_code ec;
+		m_socket->close(ec);
+	}
+
+	void SessionKeyHandoffTable::AsyncReceive()
+	{
+		m_socket->async_receive_from(boost::asio::buffer(m_recvBuffer), m_senderEndpoint,
+			[this](const boost::system::error_code& ec, size_t bytes)
+			{
+				if (ec == boost::asio::error::operation_aborted)
+					return; // closed
+
+				if (!ec)
+					OnReceive(bytes);
+
+				AsyncReceive();
+			});
+	}
+
+	void SessionKeyHandoffTable::OnReceive(size_t bytes)
+	{
+		SessionKeyHandoffMessage msg;
+		if (!msg.Deserialize(m_secret, m_recvBuffer.data(), bytes))
+		{
+			MLOG_WARNING(NETWORK, "Discarding an invalid session key handoff from {}.", m_senderEndpoint.address().to_string());
+			return;
+		}
+
+		// Stale (or replayed) handoff, the greetcode isn't valid anymore anyway
+		const uint64_t nowUnix = static_cast<uint64_t>(time(nullptr));
+		if (nowUnix > msg.issuedAt + m_ttlSeconds)
+			return;
+
+		const auto now = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Expire(now);
+
+		if (m_entries.size() >= SESSION_KEY_HANDOFF_MAX_ENTRIES)
+		{
+			MLOG_WARNING(NETWORK, "Session key handoff table is full, account {} will be read from MySQL.", msg.accountID);
+			return;
+		}
+
+		// A previous session of the account is revoked by the new one. The UDP datagrams can arrive out of order, an older
+		// session than the one we have is dropped (MySQL has it deleted already)
+		auto accountIt = m_accountGreetCodes.find(msg.accountID);
+		if (accountIt != m_accountGreetCodes.end() && accountIt->second != msg.greetCode)
+		{
+			auto prevIt = m_entries.find(accountIt->second);
+			if (prevIt != m_entries.end())
+			{
+				if (prevIt->second.issuedAt > msg.issuedAt)
+					return;
+
+				prevIt->second.used = true;
+				prevIt->second.sessionKey.fill(0);
+			}
+		}
+
+		// Never overwrite, a used greetcode has to stay used
+		auto [it, inserted] = m_entries.try_emplace(msg.greetCode);
+		if (!inserted)
+			return;
+
+		it->second.accountID = msg.accountID;
+		it->second.issuedAt = msg.issuedAt;
+		it->second.sessionKey = msg.sessionKey;
+		m_accountGreetCodes[msg.accountID] = msg.greetCode;
+		m_expirations.emplace_back(now + std::chrono::seconds(m_ttlSeconds), msg.greetCode);
+	}
+
+	void SessionKeyHandoffTable::Expire(std::chrono::steady_clock::time_point now)
+	{
+		while (!m_expirations.empty() && m_expirations.front().first <= now)
+		{
+			const GreetCode& greetCode = m_expirations.front().second;
+
+			auto it = m_entries.find(greetCode);
+			if (it != m_entries.end())
+			{
+				// Only if it's still the latest session of the account
+				auto accountIt = m_accountGreetCodes.find(it->second.accountID);
+				if (accountIt != m_accountGreetCodes.end() && accountIt->second == greetCode)
+					m_accountGreetCodes.erase(accountIt);
+
+				m_entries.erase(it);
+			}
+
+			m_expirations.pop_front();
+		}
+	}
+
+	SessionKeyHandoffTable::LookupResult SessionKeyHandoffTable::Take(const GreetCode& greetCode, uint32_t& accountID, std::array<uint8_t, AES_128_KEY_SIZE>& sessionKey)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Expire(std::chrono::steady_clock::now());
+
+		auto it = m_entries.find(greetCode);
+		if (it == m_entries.end())
+			return LookupResult::NOT_FOUND;
+
+		if (it->second.used)
+			return LookupResult::ALREADY_USED;
+
+		it->second.used = true;
+		accountID = it->second.accountID;
+		sessionKey = it->second.sessionKey;
+		return LookupResult::FOUND;
+	}
+}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+
+#include <boost/asio.hpp>
+
+#include "SessionKeyHandoff.h"
+
+namespace NECRO
+{
+namespace World
+{
+	// Upper bound of the sessions kept, handoffs received while full are dropped (MySQL fallback)
+	inline constexpr size_t SESSION_KEY_HANDOFF_MAX_ENTRIES = 65536;
+
+	//-----------------------------------------------------------------------------------------------------
+	// Sessions pushed by the NECROAuth on this host (see SessionKeyHandoff.h), by greetcode. WorldSessions
+	// look here first and go to MySQL only when the greetcode isn't known.
+	//
+	// Entries live for ttlSeconds (the greetcode validity window). A greetcode can be taken once, after that
+	// it's remembered as used until it expires, so a replay is rejected here instead of being let through to
+	// MySQL (where the greetcode is invalidated in the background).
+	//
+	// Entries are indexed by account too: a newer session of the same account revokes the previous greetcode
+	// (as DEL_PREV_SESSIONS does in MySQL), it's kept as used so it's rejected until it expires.
+	// The revocation needs the newer handoff: if its datagram is lost, the previous greetcode stays usable here
+	// (not on MySQL) until it expires, ttlSeconds is the longest that can last.
+	//
+	// The receive loop runs on the io_context passed to Open, Take is called from the NetworkThreads.
+	//-----------------------------------------------------------------------------------------------------
+	class SessionKeyHandoffTable
+	{
+	public:
+		enum class LookupResult : uint8_t
+		{
+			NOT_FOUND = 0,	// not handed off (or lost), ask MySQL
+			FOUND,
+			ALREADY_USED
+		};
+
+	private:
+		using GreetCode = std::array<uint8_t, AES_128_KEY_SIZE>;
+
+		struct GreetCodeHash
+		{
+			size_t operator()(const GreetCode& g) const
+			{
+				// Greetcodes are random bytes already
+				size_t h = 0;
+				std::memcpy(&h, g.data(), sizeof(h));
+				return h;
+			}
+		};
+
+		struct Entry
+		{
+			uint32_t								accountID = 0;
+			uint64_t								issuedAt = 0;
+			std::array<uint8_t, AES_128_KEY_SIZE>	sessionKey{};
+			bool									used = false;
+		};
+
+		using Expiration = std::pair<std::chrono::steady_clock::time_point, GreetCode>;
+
+		std::mutex												m_mutex;
+		std::unordered_map<GreetCode, Entry, GreetCodeHash>		m_entries;
+		std::unordered_map<uint32_t, GreetCode>					m_accountGreetCodes;	// latest greetcode of each account in m_entries
+		std::deque<Expiration>									m_expirations;	// same TTL for all, so in insertion order
+
+		std::unique_ptr<boost::asio::ip::udp::socket>				m_socket;
+		boost::asio::ip::udp::endpoint								m_senderEndpoint;
+		std::array<uint8_t, SESSION_KEY_HANDOFF_MESSAGE_SIZE + 1>	m_recvBuffer{}; // +1 to detect oversized datagrams
+		std::string													m_secret;
+		uint32_t													m_ttlSeconds = 0;
+
+		void	AsyncReceive();
+		void	OnReceive(size_t bytes);
+		void	Expire(std::chrono::steady_clock::time_point now);
+
+	public:
+		int		Open(boost::asio::io_context& io, uint16_t port, const std::string& secret, uint32_t ttlSeconds);
+		void	Close();
+
+		bool	IsOpen() const { return m_socket != nullptr; }
+
+		LookupResult	Take(const GreetCode& greetCode, uint32_t& accountID, std::array<uint8_t, AES_128_KEY_SIZE>& sessionKey);
+	};
+}
+}
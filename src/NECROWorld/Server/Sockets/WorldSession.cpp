@@ -78,10 +78,10 @@ namespace World
         else if (m_UnderlyingState == UnderlyingState::CONNECTED)
         {
             // Check for connected timeout
-            if (now - m_lastActivity > std::chrono::milliseconds(Server::Instance().GetSettings().CONNECTED_AND_IDLE_TIMEOUT_MS))
+            if (now - m_lastActivity > std::chrono::milliseconds(Server::Instance().GetSettings().CONNECTED_AND_IDLE_TIMEOUT_MS.Get()))
             {
                 // Kick this client for inactivity
-                LOG_DEBUG("Kicking a client for connected-inactivity.");
+                MLOG_DEBUG(NETWORK, "Kicking a client for connected-inactivity.");
                 CloseSocket();
                 return 0;
             }
@@ -103,28 +103,44 @@ namespace World
         if (m_status != WorldSocketStatus::IN_WORLD)
             return;
 
-        std::vector<Packet> toSend;
+        std::vector<QueuedPacket> toSend;
         m_playerPacketQueue->DrainQueue(toSend);
 
-        for (int i = 0; i < toSend.size(); i++)
+        if (toSend.empty())
+            return;
+
+        // Encrypt everything the simulation issued in a single batch, on this NetworkThread, into one NetworkMessage.
+        // Broadcast packets are shared between sessions, so we encrypt reading straight from the shared buffer.
+        size_t batchSize = 0;
+        for (const QueuedPacket& qp : toSend)
         {
-            // Encrypt and send simulation issued packets
-            NetworkMessage m(std::move(toSend[i]));
-            int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
+            const Packet& p = std::holds_alternative<Packet>(qp) ? std::get<Packet>(qp) : *std::get<SharedPacket>(qp);
+            batchSize += sizeof(uint32_t) + GCM_IV_SIZE + GCM_TAG_SIZE + p.Size();
+        }
+
+        NetworkMessage m(batchSize);
+        for (const QueuedPacket& qp : toSend)
+        {
+            const Packet& p = std::holds_alternative<Packet>(qp) ? std::get<Packet>(qp) : *std::get<SharedPacket>(qp);
+            if (p.Empty())
+                continue;
+
+            int encryptRes = m.AESEncryptAppend(p.GetContentToRead(), p.Size(), m_data.sessionKey.data(), m_data.iv, nullptr, 0);
             if (encryptRes < 0)
             {
-                LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+                MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
                 CloseSocket();
-                break;
+                return;
             }
+        }
 
+        if (m.GetActiveSize() > 0)
             QueuePacket(std::move(m));
-        }
     }
 
     int WorldSession::AsyncReadCallback()
     {
-        LOG_DEBUG("WorldSession ReadCallback");
+        MLOG_DEBUG(NETWORK, "WorldSession ReadCallback");
 
         NetworkMessage& encryptedPacket = m_inBuffer;
 
@@ -144,31 +160,56 @@ namespace World
             std::copy(encryptedPacket.GetReadPointer(), encryptedPacket.GetReadPointer() + AES_128_KEY_SIZE, m_data.greetCode.begin());
             encryptedPacket.ReadCompleted(AES_128_KEY_SIZE); // Consume the greetcode from the packet buffer
 
-            // Advance phase, we've got the greetcode, now let's fetch it from the db:
-            m_status = WorldSocketStatus::GATHER_SESSIONKEY_PENDING;
-
             auto& dbworker = Server::Instance().GetLoginDBPool();
+
+            // The NECROAuth on this host may have handed the session off already, no need to ask the DB then
+            SessionKeyHandoffTable::LookupResult handoff = SessionKeyHandoffTable::LookupResult::NOT_FOUND;
+            if (Server::Instance().GetSessionKeyHandoff().IsOpen())
+                handoff = Server::Instance().GetSessionKeyHandoff().Take(m_data.greetCode, m_data.accountID, m_data.sessionKey);
+
+            if (handoff == SessionKeyHandoffTable::LookupResult::ALREADY_USED)
             {
+                MLOG_DEBUG(NETWORK, "World greetcode was already used. Dropping.");
+                return -1;
+            }
+
+            if (handoff == SessionKeyHandoffTable::LookupResult::NOT_FOUND)
+            {
+                // Advance phase, we've got the greetcode, now let's fetch it from the db:
+                m_status = WorldSocketStatus::GATHER_SESSIONKEY_PENDING;
+
                 DBRequest req(m_ioContextRef, false);
                 req.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::SEL_SESSIONKEY_BY_GREETCODE), {mysqlx::bytes(m_data.greetCode.data(), m_data.greetCode.size())}});
                 req.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::INVALIDATE_GREETCODE), {mysqlx::bytes(m_data.greetCode.data(), m_data.greetCode.size())} });
 
                 // The callback needs to ensure the object still exists, as it may be deleted by while the dbrequest is being processed
                 std::weak_ptr<WorldSession> weakSelf = shared_from_this();
-                req.m_callback = [weakSelf](uint32_t ec, std::vector<mysqlx::SqlResult>& res)
+                req.SetTypedCallback<SessionKeyRow>(&LoginDatabase::DecodeSessionKeyRow, [weakSelf](uint32_t ec, std::vector<SessionKeyRow>& rows)
                     {
                         if (auto lockedSelf = weakSelf.lock())
-                            return lockedSelf->DBCallback_GreetcodeLookup(ec, res);
+                            return lockedSelf->DBCallback_GreetcodeLookup(ec, rows);
 
                         return false; // WorldSession is destroyed (disconnect)
-                    };
+                    });
 
                 req.m_cancelToken = weakSelf;
                 dbworker.Enqueue(std::move(req));
+
+                // We cannot decrypt anything until the DB responds, we stop reading for now until DB responds.
+                return 0;
+            }
+
+            // Handed off: still invalidate the greetcode on the DB for the other realms, nobody waits for it.
+            // The NECROAuth hands a session off only after it's committed, so the row is there to be updated
+            {
+                DBRequest req(m_ioContextRef, true);
+                req.m_steps.push_back({ static_cast<uint32_t>(LoginDatabaseStatements::INVALIDATE_GREETCODE), {mysqlx::bytes(m_data.greetCode.data(), m_data.greetCode.size())} });
+                req.m_priority = DBRequestPriority::BACKGROUND;
+                dbworker.Enqueue(std::move(req));
             }
 
-            // We cannot decrypt anything until the DB responds, we stop reading for now until DB responds.
-            return 0;
+            // Now we're ready to receive the encrypted AUTH_SESSION packet, it may be in the buffer already
+            m_status = WorldSocketStatus::SESSIONKEY_GATHERED;
         }
 
         while (encryptedPacket.GetActiveSize())
@@ -182,7 +223,7 @@ namespace World
                 if (plaintextLen == -1) // Short receive
                     break;
                 
-                LOG_WARNING("Decrypt failed for session {} (code {}). Closing.", m_data.accountID, plaintextLen);
+                MLOG_WARNING(NETWORK, "Decrypt failed for session {} (code {}). Closing.", m_data.accountID, plaintextLen);
                 return -1;
             }
 
@@ -201,14 +242,14 @@ namespace World
             auto it = Handlers.find(cmd);
             if (it == Handlers.end())
             {
-                LOG_DEBUG("Discarding unknown world packet. CMD: {}", cmd);
+                MLOG_DEBUG(NETWORK, "Discarding unknown world packet. CMD: {}", cmd);
                 m_currentDecryptedPacket.Clear();
                 return -1; // TODO we may want to add some tolerance for unknown packets for the world server
             }
 
             if (m_status != it->second.status)
             {
-                LOG_DEBUG("World status mismatch (got {} for cmd {}, expected {}). Closing.", static_cast<int>(m_status), cmd, static_cast<int>(it->second.status));
+                MLOG_DEBUG(NETWORK, "World status mismatch (got {} for cmd {}, expected {}). Closing.", static_cast<int>(m_status), cmd, static_cast<int>(it->second.status));
                 return -1;
             }
 
@@ -216,7 +257,7 @@ namespace World
             //uint16_t size = static_cast<uint16_t>(it->second.packetSize);
             //if (m_currentDecryptedPacket.GetActiveSize() != size)
             //{
-            //    LOG_DEBUG("Discarding client, packet size was {} but active {}", size, m_currentDecryptedPacket.GetActiveSize());
+            //    MLOG_DEBUG(NETWORK, "Discarding client, packet size was {} but active {}", size, m_currentDecryptedPacket.GetActiveSize());
             //    return -1; // Make sure packet's size is in line with what's expected
             //}
 
@@ -231,17 +272,17 @@ namespace World
             // Exceptions caught during callback handling must close the socket
             catch (const mysqlx::Error& err) 
             {
-                LOG_CRITICAL("Exception caught during callback handling. MySQL Error: {}", err.what());
+                MLOG_CRITICAL(NETWORK, "Exception caught during callback handling. MySQL Error: {}", err.what());
                 return -1;
             }
             catch (const std::exception& err) 
             {
-                LOG_CRITICAL("Exception caught during callback handling. Standard Exception: {}", err.what());
+                MLOG_CRITICAL(NETWORK, "Exception caught during callback handling. Standard Exception: {}", err.what());
                 return -1;
             }
             catch (...) 
             {
-                LOG_CRITICAL("Exception caught during callback handling. Unknown exception.");
+                MLOG_CRITICAL(NETWORK, "Exception caught during callback handling. Unknown exception.");
                 return -1;
             }
 
@@ -260,41 +301,41 @@ namespace World
 
         if (m_closeAfterSend && m_outQueue.size() == 0)
         {
-            LOG_DEBUG("Send Callback called on m_closeAfterSend.");
+            MLOG_DEBUG(NETWORK, "Send Callback called on m_closeAfterSend.");
             CloseSocket();
         }
     }
 
-    bool WorldSession::DBCallback_GreetcodeLookup(uint32_t ec, std::vector<mysqlx::SqlResult>& result)
+    bool WorldSession::DBCallback_GreetcodeLookup(uint32_t ec, std::vector<SessionKeyRow>& rows)
     {
         if (!IsOpen())
             return false;
 
         if (ec != 0)
         {
-            LOG_DEBUG("Greetcode lookup query failed. Dropping socket.");
+            MLOG_DEBUG(NETWORK, "Greetcode lookup query failed. Dropping socket.");
             CloseSocket();
             return false;
         }
 
-        mysqlx::Row row = result[0].fetchOne();
-        if (!row)
+        if (rows.empty())
         {
             // No session matches this greetcode, client never authenticated or replay
-            LOG_DEBUG("World greetcode not found in active_sessions. Dropping.");
+            MLOG_DEBUG(NETWORK, "World greetcode not found in active_sessions. Dropping.");
             CloseSocket();
             return false;
         }
 
-        // [userid, sessionKey, starttime, authip] TODO ADD USERNAME AS WELL
+        // TODO ADD USERNAME AS WELL
+        const SessionKeyRow& row = rows[0];
 
         // Make sure greetcode is still valid using starttime
         time_t now = time(nullptr);
-        time_t requestStartTime = static_cast<time_t>(row[2].get<uint32_t>());
+        time_t requestStartTime = static_cast<time_t>(row.startTime);
 
         if (now > requestStartTime + GREETCODE_VALIDITY_TIME_WINDOW_SECONDS)
         {
-            LOG_DEBUG("Request is too old, dropping the socket.");
+            MLOG_DEBUG(NETWORK, "Request is too old, dropping the socket.");
             CloseSocket();
             return false;
         }
@@ -302,16 +343,15 @@ namespace World
         // We could use a machine fingerprint check to compare who made the auth request and who made this request, it may be reduntant security wise 
         // but it could be an early rejection before the AES decrypt + GCM tag verification fails
 
-        m_data.accountID = row[0].get<uint32_t>();
+        m_data.accountID = row.userID;
 
-        mysqlx::bytes keyBytes = row[1].get<mysqlx::bytes>();
-        if (keyBytes.size() != AES_128_KEY_SIZE)
+        if (row.sessionKey.size() != AES_128_KEY_SIZE)
         {
-            LOG_CRITICAL("Stored sessionKey has wrong size ({}).", keyBytes.size());
+            MLOG_CRITICAL(NETWORK, "Stored sessionKey has wrong size ({}).", row.sessionKey.size());
             CloseSocket();
             return false;
         }
-        std::memcpy(m_data.sessionKey.data(), keyBytes.begin(), AES_128_KEY_SIZE);
+        std::memcpy(m_data.sessionKey.data(), row.sessionKey.data(), AES_128_KEY_SIZE);
 
         // Now we're ready to receive the encrypted AUTH_SESSION packet, and greetCode is invalidated.
         m_status = WorldSocketStatus::SESSIONKEY_GATHERED;
@@ -352,7 +392,7 @@ namespace World
         m_lastActivity = std::chrono::steady_clock::now();
         m_status = World::WorldSocketStatus::SELECTING_CHARACTERS;
 
-        LOG_DEBUG("Greet Packet handled! Gathering characters list for AccountID: {}", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Greet Packet handled! Gathering characters list for AccountID: {}", m_data.accountID);
 
         if (!Handle_SPacketEnumCharacter())
             return false;
@@ -370,22 +410,32 @@ namespace World
 
         m_lastActivity = std::chrono::steady_clock::now();
 
-        LOG_DEBUG("Handle_SPacketEnumCharacter: {}", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Handle_SPacketEnumCharacter: {}", m_data.accountID);
+
+        // Served from memory if the account was listed already
+        std::vector<CharacterRow> cachedRows;
+        if (Server::Instance().GetCharacterCache().GetAccountCharacters(m_data.accountID, cachedRows))
+            return DBCallback_HandleSPacketEnumCharacter(0, cachedRows);
 
         auto& dbworker = Server::Instance().GetCharactersDBPool();
         {
             DBRequest req(m_ioContextRef, false);
             req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SEL_ENUM), {m_data.accountID } });
+            req.m_orderingKey = m_data.accountID;
 
             // The callback needs to ensure the object still exists, as it may be deleted by the main thread while the dbrequest is being processed
             std::weak_ptr<WorldSession> weakSelf = shared_from_this();
-            req.m_callback = [weakSelf](uint32_t ec, std::vector<mysqlx::SqlResult>& res)
+            const uint32_t accountID = m_data.accountID;
+            req.SetTypedCallback<CharacterRow>(&CharactersDatabase::DecodeCharacterEnumRow, [weakSelf, accountID](uint32_t ec, std::vector<CharacterRow>& rows)
                 {
+                    if (ec == 0)
+                        Server::Instance().GetCharacterCache().PopulateAccount(accountID, rows);
+
                     if (auto lockedSelf = weakSelf.lock())
-                        return lockedSelf->DBCallback_HandleSPacketEnumCharacter(ec, res);
+                        return lockedSelf->DBCallback_HandleSPacketEnumCharacter(ec, rows);
 
                     return false; // WorldSession is destroyed (disconnect)
-                };
+                });
 
             req.m_cancelToken = weakSelf;
 
@@ -396,19 +446,19 @@ namespace World
         return true;
     }
 
-    bool WorldSession::DBCallback_HandleSPacketEnumCharacter(uint32_t ec, std::vector<mysqlx::SqlResult>& result)
+    bool WorldSession::DBCallback_HandleSPacketEnumCharacter(uint32_t ec, std::vector<CharacterRow>& rows)
     {
         if (!IsOpen())
             return false;
 
         if (ec != 0)
         {
-            LOG_DEBUG("DBCallback_HandleSPacketEnumCharacter's query returned an error. There's no way to continue. Dropping socket.");
+            MLOG_DEBUG(NETWORK, "DBCallback_HandleSPacketEnumCharacter's query returned an error. There's no way to continue. Dropping socket.");
             CloseSocket();
             return false;
         }
 
-        LOG_DEBUG("Handling DBCallback_HandleSPacketEnumCharacter for user {}!", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Handling DBCallback_HandleSPacketEnumCharacter for user {}!", m_data.accountID);
 
         // DB callbacks should also update last activity
         m_lastActivity = std::chrono::steady_clock::now();
@@ -417,62 +467,47 @@ namespace World
         Packet packet;
         packet << static_cast<uint16_t>(PacketIDs::ENUM_CHARACTERS);
 
-        mysqlx::Row row = result[0].fetchOne(); //result[0] is result of m_step[0]
-
         // Check if there's at leat one result
-        if (!row)
+        if (rows.empty())
         {
-            LOG_DEBUG("Account {} has no characters.", m_data.accountID);
+            MLOG_DEBUG(NETWORK, "Account {} has no characters.", m_data.accountID);
             packet << static_cast<uint8_t>(WorldResults::NO_CHARACTERS_FOR_THIS_ACCOUNT);
         }
         else
         {
             packet << static_cast<uint8_t>(WorldResults::SUCCESS);
 
-            // Collect all rows first so we can write the count before character data
-            std::vector<mysqlx::Row> rows;
-            rows.push_back(std::move(row)); // first row already fetched
-            while (mysqlx::Row next = result[0].fetchOne())
-                rows.push_back(std::move(next));
-
-            // Write size
-            // Get all the variable names sizes togheter
-            uint16_t namesSize = 0;
-            for (mysqlx::Row& charRow : rows)
-                namesSize += (charRow[1].get<std::string>()).length();
-
             // Write number of characters
             packet << static_cast<uint8_t>(rows.size());
 
-            for (mysqlx::Row& charRow : rows)
+            // Rows were already decoded by the DBWorker
+            for (const CharacterRow& charRow : rows)
             {
-                std::string characterName = charRow[1].get<std::string>();
-
-                packet << charRow[0].get<uint32_t>();                       // id
-                packet << static_cast<uint8_t>(characterName.length());     // characterNameLength
-                packet << characterName;                                    // characterName
+                packet << charRow.id;                                       // id
+                packet << static_cast<uint8_t>(charRow.name.length());      // characterNameLength
+                packet << charRow.name;                                     // characterName
 
-                packet << static_cast<uint8_t>(charRow[2].get<int>());       // race
-                packet << static_cast<uint8_t>(charRow[3].get<int>());       // gameClass
-                packet << static_cast<uint8_t>(charRow[4].get<int>());       // gender
+                packet << charRow.race;                                     // race
+                packet << charRow.gameClass;                                // gameClass
+                packet << charRow.gender;                                   // gender
 
-                packet << static_cast<uint8_t>(charRow[5].get<int>());       // level
-                packet << charRow[6].get<uint32_t>();                        // xp
+                packet << charRow.level;                                    // level
+                packet << charRow.xp;                                       // xp
 
-                packet << charRow[7].get<uint32_t>();                        // zone
-                packet << charRow[8].get<float>();                           // pos_x
-                packet << charRow[9].get<float>();                           // pos_y
-                packet << charRow[10].get<float>();                          // pos_z
+                packet << charRow.zone;                                     // zone
+                packet << charRow.pos_x;                                    // pos_x
+                packet << charRow.pos_y;                                    // pos_y
+                packet << charRow.pos_z;                                    // pos_z
             }
 
-            LOG_DEBUG("Written {} characters for AccountID: {}.", rows.size(), m_data.accountID);
+            MLOG_DEBUG(NETWORK, "Written {} characters for AccountID: {}.", rows.size(), m_data.accountID);
         }
 
         NetworkMessage m(std::move(packet));
         int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
         if (encryptRes < 0)
         {
-            LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+            MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
             CloseSocket();
             return false;
         }
@@ -545,7 +580,29 @@ namespace World
         // All good
 
         std::string charName((char const*)pcktData->characterName, pcktData->characterNameLength);
-        LOG_DEBUG("AccountID {} wants to create '{}', name size={}, race={}, class={}, gender={}.", m_data.accountID, charName, pcktData->characterNameLength, pcktData->race, pcktData->charClass, pcktData->gender);
+        MLOG_DEBUG(NETWORK, "AccountID {} wants to create '{}', name size={}, race={}, class={}, gender={}.", m_data.accountID, charName, pcktData->characterNameLength, pcktData->race, pcktData->charClass, pcktData->gender);
+
+        // Taken names are rejected from memory, free ones are still checked by the insert (or by the name check, without the UNIQUE key)
+        CharacterNameIndex& nameIndex = Server::Instance().GetCharacterNameIndex();
+        if (nameIndex.IsLoaded() && nameIndex.IsTaken(charName))
+        {
+            MLOG_DEBUG(NETWORK, "Name already in use!");
+
+            Packet p;
+            p << static_cast<uint16_t>(PacketIDs::CHAR_CREATE_NEW);
+            p << static_cast<uint8_t>(WorldResults::CHARACTER_NEW_NAME_ALREADY_IN_USE);
+
+            NetworkMessage m(std::move(p));
+            int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
+            if (encryptRes < 0)
+            {
+                MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+                return false;
+            }
+            QueuePacket(std::move(m));
+
+            return true;
+        }
 
         // Save players selection into a context
         std::shared_ptr<CreateCharacterCtx> reqCtx = std::make_shared<CreateCharacterCtx>(CreateCharacterCtx{ charName, pcktData->race, pcktData->charClass, pcktData->gender});
@@ -555,7 +612,9 @@ namespace World
         {
             DBRequest req(m_ioContextRef, false);
             req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_SEL_ENUM), {m_data.accountID } }); // check for characters limit on the account
-            req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_CHECK_NAME_ALREADY_IN_USE), {reqCtx->newCharacterName } }); // check for characters limit on the account
+            if (!nameIndex.IsLoaded() || !nameIndex.IsUniqueEnforced())
+                req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_CHECK_NAME_ALREADY_IN_USE), {reqCtx->newCharacterName } }); // check if the name is in use
+            req.m_orderingKey = m_data.accountID;
             //TODO: queries to check if race,gender,class exist in the DB definitions
             
             // The callback needs to ensure the object still exists, as it may be deleted by the main thread while the dbrequest is being processed
@@ -584,18 +643,18 @@ namespace World
 
         if (ec != 0)
         {
-            LOG_DEBUG("DBCallback_HandleCreateNewCharChecks's query returned an error. There's no way to continue. Dropping socket.");
+            MLOG_DEBUG(NETWORK, "DBCallback_HandleCreateNewCharChecks's query returned an error. There's no way to continue. Dropping socket.");
             CloseSocket();
             return false;
         }
 
-        LOG_DEBUG("Handling DBCallback_HandleCreateNewCharChecks for user {}!", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Handling DBCallback_HandleCreateNewCharChecks for user {}!", m_data.accountID);
 
         // DB callbacks should also update last activity
         m_lastActivity = std::chrono::steady_clock::now();
 
         // result[0] - characters number on the account
-        // result[1] - is name in use
+        // result[1] - is name in use (only if the name index is not loaded or the UNIQUE key on name is missing)
 
         // Fail cases
         Packet p;
@@ -604,27 +663,28 @@ namespace World
         if (result[0].count() >= MAX_CHARACTERS_N_PER_ACCOUNT)
         {
             // Account has all characters
-            LOG_DEBUG("Account has all characters!");
+            MLOG_DEBUG(NETWORK, "Account has all characters!");
 
             p << static_cast<uint8_t>(WorldResults::CHARACTER_NEW_ACCOUNT_HAS_MAX_CHARACTERS_ALLOWED);
         }
-        else  if (result[1].count() > 0)
+        else  if (result.size() > 1 && result[1].count() > 0)
         {
             // Name already in use
-            LOG_DEBUG("Name already in use!");
+            MLOG_DEBUG(NETWORK, "Name already in use!");
             p << static_cast<uint8_t>(WorldResults::CHARACTER_NEW_NAME_ALREADY_IN_USE);
         }
         else
         {
-            LOG_DEBUG("Checks passed!");
+            MLOG_DEBUG(NETWORK, "Checks passed!");
 
             // Character can be created, run creation query
             // TODO, here we would also have information and validation of the class/race, so that we can set custom start zone / positions / skills / whatever - for now we just hardcode them
             auto& dbworker = Server::Instance().GetCharactersDBPool();
             {
                 DBRequest req(m_ioContextRef, false);
-                req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_INS_CHARACTER), 
+                req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_INS_CHARACTER_IF_NAME_FREE), 
                     {m_data.accountID, ctx->newCharacterName, ctx->newCharacterRace, ctx->newCharacterClass, ctx->newCharacterGender, 1, 0, 1, 0.0f, 0.0f, 0.0f } });
+                req.m_orderingKey = m_data.accountID;
 
                 // The callback needs to ensure the object still exists, as it may be deleted by the main thread while the dbrequest is being processed
                 std::weak_ptr<WorldSession> weakSelf = shared_from_this();
@@ -655,7 +715,7 @@ namespace World
         int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
         if (encryptRes < 0)
         {
-            LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+            MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
             CloseSocket();
             return false;
         }
@@ -672,27 +732,43 @@ namespace World
         if (ec != 0)
         {
             // TODO, we could return a SERVER_BUSY and not drop the connection, but just cancel the current action if possible
-            LOG_DEBUG("DBCallback_HandleCreateNewCharFinal's query returned an error. There's no way to continue. Dropping socket.");
+            MLOG_DEBUG(NETWORK, "DBCallback_HandleCreateNewCharFinal's query returned an error. There's no way to continue. Dropping socket.");
             CloseSocket();
             return false;
         }
 
-        LOG_DEBUG("Handling DBCallback_HandleCreateNewCharFinal for user {}!", m_data.accountID);
-        LOG_DEBUG("Character Created!");
+        MLOG_DEBUG(NETWORK, "Handling DBCallback_HandleCreateNewCharFinal for user {}!", m_data.accountID);
+
+        // Either created now or taken by someone else in the meantime, the name is in use from now on
+        Server::Instance().GetCharacterNameIndex().Add(ctx->newCharacterName);
 
         // DB callbacks should also update last activity
         m_lastActivity = std::chrono::steady_clock::now();
 
-        // If ec error check passed, character was created
         Packet p;
         p << static_cast<uint16_t>(PacketIDs::CHAR_CREATE_NEW);
-        p << static_cast<uint8_t>(WorldResults::CHARACTER_NEW_SUCCESS);
+
+        // The insert affects no rows if the name was taken after the checks
+        if (result[0].getAffectedItemsCount() == 0)
+        {
+            MLOG_DEBUG(NETWORK, "Name already in use!");
+            p << static_cast<uint8_t>(WorldResults::CHARACTER_NEW_NAME_ALREADY_IN_USE);
+        }
+        else
+        {
+            MLOG_DEBUG(NETWORK, "Character Created!");
+
+            // The ID of the new character is only known by MySQL, the next enum reloads the account
+            Server::Instance().GetCharacterCache().InvalidateAccount(m_data.accountID);
+
+            p << static_cast<uint8_t>(WorldResults::CHARACTER_NEW_SUCCESS);
+        }
 
         NetworkMessage m(std::move(p));
         int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
         if (encryptRes < 0)
         {
-            LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+            MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
             CloseSocket();
             return false;
         }
@@ -726,7 +802,7 @@ namespace World
             return false;
 
         // 5. 
-        LOG_CRITICAL("{} {} {}", m_currentDecryptedPacket.GetActiveSize(), (sizeof(SPacketDeleteCharacter) - 1) + pcktData->characterNameLength, pcktData->size + S_PACKET_DELETE_CHAR_INITIAL_SIZE);
+        MLOG_CRITICAL(NETWORK, "{} {} {}", m_currentDecryptedPacket.GetActiveSize(), (sizeof(SPacketDeleteCharacter) - 1) + pcktData->characterNameLength, pcktData->size + S_PACKET_DELETE_CHAR_INITIAL_SIZE);
         if (m_currentDecryptedPacket.GetActiveSize() != (sizeof(SPacketDeleteCharacter)-1) + pcktData->characterNameLength || m_currentDecryptedPacket.GetActiveSize() != pcktData->size + S_PACKET_DELETE_CHAR_INITIAL_SIZE)
             return false;
 
@@ -749,6 +825,7 @@ namespace World
         {
             DBRequest req(m_ioContextRef, false);
             req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_CHECK_BELONGS_TO_ACCOUNTID), {pcktData->characterID, m_data.accountID } });
+            req.m_orderingKey = m_data.accountID;
 
             // The callback needs to ensure the object still exists, as it may be deleted by the main thread while the dbrequest is being processed
             std::weak_ptr<WorldSession> weakSelf = shared_from_this();
@@ -776,12 +853,12 @@ namespace World
 
         if (ec != 0)
         {
-            LOG_DEBUG("DBCallback_HandleDeleteCharacterChecks's query returned an error. There's no way to continue. Dropping socket.");
+            MLOG_DEBUG(NETWORK, "DBCallback_HandleDeleteCharacterChecks's query returned an error. There's no way to continue. Dropping socket.");
             CloseSocket();
             return false;
         }
 
-        LOG_DEBUG("Handling DBCallback_HandleDeleteCharacterChecks for user {}!", m_data.accountID);
+        MLOG_DEBUG(NETWORK, "Handling DBCallback_HandleDeleteCharacterChecks for user {}!", m_data.accountID);
 
         // DB callbacks should also update last activity
         m_lastActivity = std::chrono::steady_clock::now();
@@ -800,6 +877,7 @@ namespace World
                 {
                     DBRequest req(m_ioContextRef, false);
                     req.m_steps.push_back({ static_cast<uint32_t>(CharactersDatabaseStatements::CHAR_DELETE_CHARACTER), {ctx->characterIDToDelete, characterNameInDB, m_data.accountID} });
+                    req.m_orderingKey = m_data.accountID;
 
                     // The callback needs to ensure the object still exists, as it may be deleted by the main thread while the dbrequest is being processed
                     std::weak_ptr<WorldSession> weakSelf = shared_from_this();
@@ -833,7 +911,7 @@ namespace World
         int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
         if (encryptRes < 0)
         {
-            LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+            MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
             CloseSocket();
             return false;
         }
@@ -849,12 +927,15 @@ namespace World
 
         if (ec != 0)
         {
-            LOG_DEBUG("DBCallback_HandleDeleteCharacterFinal's query returned an error. There's no way to continue. Dropping socket.");
+            MLOG_DEBUG(NETWORK, "DBCallback_HandleDeleteCharacterFinal's query returned an error. There's no way to continue. Dropping socket.");
             CloseSocket();
             return false;
         }
 
-        LOG_DEBUG("Character {} delete!", ctx->characterNameToDelete);
+        MLOG_DEBUG(NETWORK, "Character {} delete!", ctx->characterNameToDelete);
+
+        Server::Instance().GetCharacterCache().RemoveCharacter(m_data.accountID, ctx->characterIDToDelete);
+        Server::Instance().GetCharacterNameIndex().Remove(ctx->characterNameToDelete);
 
         // DB callbacks should also update last activity
         m_lastActivity = std::chrono::steady_clock::now();
@@ -869,7 +950,7 @@ namespace World
         int encryptRes = m.AESEncrypt(m_data.sessionKey.data(), m_data.iv, nullptr, 0);
         if (encryptRes < 0)
         {
-            LOG_ERROR("Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
+            MLOG_ERROR(NETWORK, "Failed to encrypt packet, returned {}. Dropping the connection.", encryptRes);
             CloseSocket();
             return false;
         }
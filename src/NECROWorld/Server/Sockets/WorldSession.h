@@ -16,6 +16,9 @@
 
 namespace NECRO
 {
+    struct CharacterRow;
+    struct SessionKeyRow;
+
 namespace World
 {
     // GreetCode is valid for 30 seconds from its creation
@@ -122,11 +125,11 @@ public:
     int     AsyncReadCallback() override;
     void    AsyncWriteCallback() override;
 
-    bool    DBCallback_GreetcodeLookup(uint32_t ec, std::vector<mysqlx::SqlResult>& result);
+    bool    DBCallback_GreetcodeLookup(uint32_t ec, std::vector<SessionKeyRow>& rows);
     bool    HandleGreetPacket();
 
     bool    Handle_SPacketEnumCharacter();
-    bool    DBCallback_HandleSPacketEnumCharacter(uint32_t ec, std::vector<mysqlx::SqlResult>& result);
+    bool    DBCallback_HandleSPacketEnumCharacter(uint32_t ec, std::vector<CharacterRow>& rows);
     
     bool    Handle_SPacketCreateNewChar();
     bool    DBCallback_HandleCreateNewCharChecks(uint32_t ec, std::vector<mysqlx::SqlResult>& result, std::shared_ptr<CreateCharacterCtx> ctx);
@@ -137,7 +140,7 @@ public:
     bool    DBCallback_HandleDeleteCharacterFinal(uint32_t ec, std::vector<mysqlx::SqlResult>& result, std::shared_ptr<DeleteCharacterCtx> ctx);
 
     bool    Handle_SPacketEnterWorld();
-    bool    DBCallback_HandleEnterWorldChecks(uint32_t ec, std::vector<mysqlx::SqlResult>& result, std::shared_ptr<EnterWorldCtx> reqCtx);
+    bool    DBCallback_HandleEnterWorldChecks(uint32_t ec, std::vector<CharacterRow>& rows, std::shared_ptr<EnterWorldCtx> reqCtx);
     bool    WorldCmdCallback_OnEnterWorld(PlayerSpawnCmdResult result);
 
     bool    Handle_SPacketExitWorld();
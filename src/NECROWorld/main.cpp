@@ -2,10 +2,41 @@
 
 #include "NECROWorld.h"
 
-int main()
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char* argv[])
 {
 	auto& server = NECRO::World::Server::Instance();
 
+	// Offline decoding of a binary log: NECROWorld --decode-log <file> [output], the text goes to stdout without output
+	if (argc >= 3 && std::strcmp(argv[1], "--decode-log") == 0)
+	{
+		if (argc < 4)
+			return NECRO::BinaryLog::Decode(argv[2], std::cout);
+
+		std::ofstream out(argv[3]);
+		if (!out.is_open())
+		{
+			std::cerr << "Could not open the output file: " << argv[3] << std::endl;
+			return -1;
+		}
+
+		return NECRO::BinaryLog::Decode(argv[2], out);
+	}
+
+	// Offline replay of a WorldCmds recording: NECROWorld --replay <file> [--realtime]
+	if (argc >= 3 && std::strcmp(argv[1], "--replay") == 0)
+	{
+		bool realTime = argc >= 4 && std::strcmp(argv[3], "--realtime") == 0;
+
+		if (server.InitHeadless() != 0)
+			return -1;
+
+		return server.RunReplay(argv[2], realTime);
+	}
+
 	if (server.Init() == 0)
 	{
 		server.Start();
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "Logger.h"
+#include "FileLogger.h"
+#include "ConsoleLogger.h"
+
+namespace NECRO
+{
+	// Consecutive connection failures that open the circuit
+	inline constexpr uint32_t DB_CIRCUIT_BREAKER_FAILURES_THRESHOLD = 3;
+
+	// Backoff between recovery probes while the circuit is open, doubles after every failed probe
+	inline constexpr uint32_t DB_CIRCUIT_BREAKER_MIN_BACKOFF_MS = 500;
+	inline constexpr uint32_t DB_CIRCUIT_BREAKER_MAX_BACKOFF_MS = 30000;
+
+	//-----------------------------------------------------------------------------------------------------
+	// Shared by all the DBWorkers of a DatabaseWorkerPool, tracks if MySQL is reachable.
+	//
+	// CLOSED:		requests run normally, connection failures are counted
+	// OPEN:		after DB_CIRCUIT_BREAKER_FAILURES_THRESHOLD consecutive connection failures. Requests fail
+	//				immediately (DBRequestError::UNAVAILABLE) and one DBWorker at a time is allowed to probe
+	//				the connection, with exponential backoff between probes.
+	// HALF_OPEN:	a probe is in progress. A successful probe closes the circuit.
+	//
+	// Every close bumps the generation: only the probing DBWorker has a fresh session, the others compare the
+	// generation before executing and recreate theirs (it died with the old connection).
+	//-----------------------------------------------------------------------------------------------------
+	class DBCircuitBreaker
+	{
+	public:
+		enum class State : uint8_t
+		{
+			CLOSED = 0,
+			OPEN,
+			HALF_OPEN
+		};
+
+	private:
+		std::mutex								m_mutex;
+		std::atomic<State>						m_state{ State::CLOSED };
+		uint32_t								m_consecutiveFailures = 0;
+		uint32_t								m_backoffMs = DB_CIRCUIT_BREAKER_MIN_BACKOFF_MS;
+		std::chrono::steady_clock::time_point	m_nextProbe;
+		std::atomic<uint32_t>					m_generation{ 0 };
+
+	public:
+		State GetState() const
+		{
+			return m_state.load(std::memory_order_acquire);
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Lock-free check done before every request
+		//-----------------------------------------------------------------------------------------------------
+		bool AllowRequest() const
+		{
+			return GetState() == State::CLOSED;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Number of times the circuit was closed after being open
+		//-----------------------------------------------------------------------------------------------------
+		uint32_t GetGeneration() const
+		{
+			return m_generation.load(std::memory_order_acquire);
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// A connection to MySQL was established
+		//-----------------------------------------------------------------------------------------------------
+		void OnConnectionSuccess()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_consecutiveFailures = 0;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// A connection to MySQL failed (could not create the session, or the session died)
+		//-----------------------------------------------------------------------------------------------------
+		void OnConnectionFailure()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (m_state != State::CLOSED)
+				return;
+
+			m_consecutiveFailures++;
+			if (m_consecutiveFailures >= DB_CIRCUIT_BREAKER_FAILURES_THRESHOLD)
+			{
+				m_backoffMs = DB_CIRCUIT_BREAKER_MIN_BACKOFF_MS;
+				m_nextProbe = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_backoffMs);
+				m_state = State::OPEN;
+
+				MLOG_ERROR(DATABASE, "DB circuit breaker OPEN after {} consecutive connection failures. Failing requests until MySQL is back.", m_consecutiveFailures);
+			}
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Returns true if the caller has been elected to probe the connection (circuit goes HALF_OPEN), the caller
+		// must then report the result with OnProbeResult
+		//-----------------------------------------------------------------------------------------------------
+		bool TryBeginProbe(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now())
+		{
+			if (GetState() != State::OPEN)
+				return false;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_state != State::OPEN || now < m_nextProbe)
+				return false;
+
+			m_state = State::HALF_OPEN;
+			return true;
+		}
+
+		void OnProbeResult(bool success)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (success)
+			{
+				m_consecutiveFailures = 0;
+				m_backoffMs = DB_CIRCUIT_BREAKER_MIN_BACKOFF_MS;
+				m_generation.fetch_add(1, std::memory_order_release);
+				m_state = State::CLOSED;
+
+				MLOG_OK(DATABASE, "DB circuit breaker CLOSED, MySQL is reachable again.");
+			}
+			else
+			{
+				m_backoffMs = std::min(m_backoffMs * 2, DB_CIRCUIT_BREAKER_MAX_BACKOFF_MS);
+				m_nextProbe = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_backoffMs);
+				m_state = State::OPEN;
+
+				MLOG_WARNING(DATABASE, "DB circuit breaker probe failed, next one in {}ms.", m_backoffMs);
+			}
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// When the next probe is due, used by idle DBWorkers to wake up for it
+		//-----------------------------------------------------------------------------------------------------
+		std::chrono::steady_clock::time_point GetNextProbeTime()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_nextProbe;
+		}
+	};
+}
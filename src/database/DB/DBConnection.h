@@ -24,22 +24,22 @@ namespace NECRO
             {
                 // Establish a session to the MySQL server
                 m_session = std::make_unique<mysqlx::Session>(host, port, user, pass);
-                LOG_INFO("Database session initialized successfully.");
+                MLOG_INFO(DATABASE, "Database session initialized successfully.");
                 return 0;
             }
             catch (const mysqlx::Error& err)
             {
-                LOG_INFO(std::string("Error initializing DBConnection: ") + err.what());
+                MLOG_INFO(DATABASE, std::string("Error initializing DBConnection: ") + err.what());
                 return -1;
             }
             catch (std::exception& ex)
             {
-                LOG_INFO(std::string("Standard exception during DBConnection initialization: ") + ex.what());
+                MLOG_INFO(DATABASE, std::string("Standard exception during DBConnection initialization: ") + ex.what());
                 return -2;
             }
             catch (...)
             {
-                LOG_INFO(std::string("Unknown exception during DBConnection initialization."));
+                MLOG_INFO(DATABASE, std::string("Unknown exception during DBConnection initialization."));
                 return -3;
             }
 
@@ -54,15 +54,15 @@ namespace NECRO
             }
             catch (const mysqlx::Error& err)
             {
-                LOG_INFO(std::string("DBConnection Close Error: : ") + err.what());
+                MLOG_INFO(DATABASE, std::string("DBConnection Close Error: : ") + err.what());
             }
             catch (std::exception& ex)
             {
-                LOG_INFO(std::string("DBConnection Close Error: Standard exception: ") + ex.what());
+                MLOG_INFO(DATABASE, std::string("DBConnection Close Error: Standard exception: ") + ex.what());
             }
             catch (...)
             {
-                LOG_INFO(std::string("DBConnection Close Error: Unknown exception during session initialization."));
+                MLOG_INFO(DATABASE, std::string("DBConnection Close Error: Unknown exception during session initialization."));
             }
         }
     };
@@ -23,22 +23,22 @@ namespace NECRO
             {
                 std::string uri = "mysqlx://" + URI;
                 m_client = std::make_unique<mysqlx::Client>(uri, mysqlx::ClientOption::POOLING, false); // Pooling is disabled as it had something to do with some previous issues that are now fixed, need to test again
-                LOG_INFO("DBConnectionPool initialized successfully.");
+                MLOG_INFO(DATABASE, "DBConnectionPool initialized successfully.");
                 return 0;
             }
             catch (const mysqlx::Error& err)
             {
-                LOG_INFO(std::string("Error initializing DBConnectionPool: ") + err.what());
+                MLOG_INFO(DATABASE, std::string("Error initializing DBConnectionPool: ") + err.what());
                 return -1;
             }
             catch (std::exception& ex)
             {
-                LOG_INFO(std::string("Standard exception during DBConnectionPool initialization: ") + ex.what());
+                MLOG_INFO(DATABASE, std::string("Standard exception during DBConnectionPool initialization: ") + ex.what());
                 return -2;
             }
             catch (...)
             {
-                LOG_INFO(std::string("Unknown exception during DBConnectionPool initialization."));
+                MLOG_INFO(DATABASE, std::string("Unknown exception during DBConnectionPool initialization."));
                 return -3;
             }
 
@@ -53,15 +53,15 @@ namespace NECRO
             }
             catch (const mysqlx::Error& err)
             {
-                LOG_INFO(std::string("DBConnectionPool Close Error: : ") + err.what());
+                MLOG_INFO(DATABASE, std::string("DBConnectionPool Close Error: : ") + err.what());
             }
             catch (std::exception& ex)
             {
-                LOG_INFO(std::string("DBConnectionPool Close Error: Standard exception: ") + ex.what());
+                MLOG_INFO(DATABASE, std::string("DBConnectionPool Close Error: Standard exception: ") + ex.what());
             }
             catch (...)
             {
-                LOG_INFO(std::string("DBConnectionPool Close Error: Unknown exception during session initialization."));
+                MLOG_INFO(DATABASE, std::string("DBConnectionPool Close Error: Unknown exception during session initialization."));
             }
         }
     };
@@ -6,10 +6,33 @@
 #include <variant>
 #include <string>
 #include <optional>
+#include <chrono>
 
 #include <mysqlx/xdevapi.h>
 #include <boost/asio.hpp>
 
+// ------------------------------------------------------------------------------------------------------------------------------------------
+// Scheduling class of a DBRequest, each one has its own lane in the DBWorker, drained with DB_PRIORITY_WEIGHTS
+// ------------------------------------------------------------------------------------------------------------------------------------------
+enum class DBRequestPriority : uint8_t
+{
+	INTERACTIVE = 0,	// Someone (a client) is waiting for the result: logins, characters list, enter world...
+	BACKGROUND,			// Saves, logs
+	MAINTENANCE,		// Keep alives
+	COUNT
+};
+
+// ------------------------------------------------------------------------------------------------------------------------------------------
+// Values of DBRequest::m_errorCode, passed to the DBCallback
+// ------------------------------------------------------------------------------------------------------------------------------------------
+enum class DBRequestError : uint32_t
+{
+	NONE = 0,
+	FAILED,				// MySQL error, or the MySQL session could not be established
+	EXPIRED,			// The deadline passed before the request could be executed, it was never run
+	UNAVAILABLE			// MySQL is down (circuit breaker open), the request was failed without being run
+};
+
 // ------------------------------------------------------------------------------------------------------------------------------------------
 // To Support transactions, a DBRequest can be composed of multiple steps
 // ------------------------------------------------------------------------------------------------------------------------------------------
@@ -39,6 +62,14 @@ public:
 	boost::asio::io_context&											m_callbackContexRef; // the io_context that should execute the callback. This context is the same context that was used by the socket that made this DBRequest.
 	std::function<bool(uint32_t ec, std::vector<mysqlx::SqlResult>&)>	m_callback; // One callback for the whole transaction, with all the results from all the steps as parameter
 
+	// Optional worker-side decoding (see SetTypedCallback), runs on the DBWorker thread after a successful execution and returns the rows decoded.
+	// The m_sqlResults are released right after.
+	std::function<size_t(std::vector<mysqlx::SqlResult>&)>				m_decoder;
+
+	// Fire-and-forget requests only: called on the DBWorker thread when the request is done, with its error code (NONE once it's
+	// committed). Lets the caller track the outcome without a m_callback, so the request can still be group committed. Must be cheap.
+	std::function<void(uint32_t ec)>									m_completionFunc;
+
 	// A notice function allows to call code in the DB thread as soon as this DBRequest is executed and it's been put on the respQueue.
 	// For that reason, it can be executed before/after the function's callback.
 	// It was used in the AuthLegacy code to wake up the main thread from the poll()
@@ -51,6 +82,17 @@ public:
 	std::optional<std::weak_ptr<void>>			m_cancelToken;
 
 	std::chrono::steady_clock::time_point		m_creationTime;
+	std::chrono::steady_clock::time_point		m_completionTime; // set by the DBWorker when the response is queued for the callback
+
+	// Requests with the same ordering key (account id, character id...) are always routed to the same DBWorker by the DatabaseWorkerPool,
+	// so they are executed in the order they were enqueued. Requests without a key are balanced by load.
+	std::optional<uint64_t>						m_orderingKey;
+
+	DBRequestPriority							m_priority = DBRequestPriority::INTERACTIVE;
+
+	// If the request is still queued when the deadline passes, it's dropped and the callback receives DBRequestError::EXPIRED.
+	// When not set, the DBWorker sets it to m_creationTime + DB_REQUEST_TIMEOUT_IF_MYSQL_DOWN_MS for requests that have a callback.
+	std::optional<std::chrono::steady_clock::time_point> m_deadline;
 
 	DBRequest(boost::asio::io_context& io, bool fireAndForget) : m_callbackContexRef(io), m_fireAndForget(fireAndForget), m_cancelToken(std::nullopt), m_creationTime(std::chrono::steady_clock::now())
 	{
@@ -66,7 +108,10 @@ public:
 		m_callbackContexRef(copy.m_callbackContexRef),
 		m_steps(copy.m_steps),
 		m_fireAndForget(copy.m_fireAndForget),
-		m_creationTime(copy.m_creationTime)
+		m_creationTime(copy.m_creationTime),
+		m_orderingKey(copy.m_orderingKey),
+		m_priority(copy.m_priority),
+		m_deadline(copy.m_deadline)
 	{
 	}
 
@@ -82,4 +127,46 @@ public:
 	{
 		return !m_steps.empty();
 	}
+
+	// --------------------------------------------------------------------------------------------------------------------------------------
+	// Sets a callback that receives typed rows instead of the mysqlx::SqlResults. The rows of the first step are decoded with decodeRow
+	// on the DBWorker thread, so the thread that handles the callback (NetworkThread) only gets plain data.
+	// On error (ec != 0) rows is empty.
+	// --------------------------------------------------------------------------------------------------------------------------------------
+	template<class Row>
+	void SetTypedCallback(Row(*decodeRow)(mysqlx::Row&), std::function<bool(uint32_t ec, std::vector<Row>& rows)> callback)
+	{
+		auto rows = std::make_shared<std::vector<Row>>();
+
+		// Rows are fetched one at a time, results[0].count() would buffer the whole result first
+		m_decoder = [rows, decodeRow](std::vector<mysqlx::SqlResult>& results) -> size_t
+			{
+				if (results.empty())
+					return 0;
+
+				// The DBWorker turns a throw into ec = FAILED, the rows decoded until then must not reach the callback
+				try
+				{
+					while (mysqlx::Row row = results[0].fetchOne())
+						rows->push_back(decodeRow(row));
+				}
+				catch (...)
+				{
+					rows->clear();
+					throw;
+				}
+
+				return rows->size();
+			};
+
+		m_callback = [rows, cb = std::move(callback)](uint32_t ec, std::vector<mysqlx::SqlResult>&)
+			{
+				return cb(ec, *rows);
+			};
+	}
+
+	bool IsExpired(std::chrono::steady_clock::time_point now) const
+	{
+		return m_deadline && now > *m_deadline;
+	}
 };
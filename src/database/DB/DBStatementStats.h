@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <map>
+
+#include "Logger.h"
+#include "FileLogger.h"
+#include "ConsoleLogger.h"
+
+#include "LatencyHistogram.h"
+
+namespace NECRO
+{
+	// Max characters of the SQL shown next to the statement enum in the reports
+	inline constexpr size_t DB_STATS_SQL_PREVIEW_LENGTH = 60;
+
+	//-----------------------------------------------------------------------------------------------------
+	// Prometheus text exposition filled by the reports of every pool. The text format wants the samples of
+	// a metric family together under a single '# TYPE' line, so they're grouped here and written by Render.
+	//-----------------------------------------------------------------------------------------------------
+	class DBStatsExposition
+	{
+	private:
+		struct Family
+		{
+			std::string type;
+			std::string samples;
+		};
+
+		std::map<std::string, Family> m_families;
+
+	public:
+		// sample is the line without the family name, e.g. "{pool=\"login\"} 3" or "_count{pool=\"login\"} 3"
+		void Add(const std::string& family, const char* type, const std::string& sample)
+		{
+			Family& f = m_families[family];
+			f.type = type;
+			f.samples += family + sample + "\n";
+		}
+
+		std::string Render() const
+		{
+			std::string out;
+			for (const auto& [name, family] : m_families)
+				out += "# TYPE " + name + " " + family.type + "\n" + family.samples;
+
+			return out;
+		}
+	};
+
+	//-----------------------------------------------------------------------------------------------------
+	// Per-statement telemetry of a DatabaseWorkerPool:
+	//
+	// queueWaitUs:		from the creation of the DBRequest to the DBWorker picking it up (recorded for the first step)
+	// execUs:			execution of the statement on MySQL (group committed multi-row INSERTs count as one execution)
+	// rows:			rows decoded from the statement's result by typed callbacks (SetTypedCallback). Counted
+	//					where they're consumed, counting them at execution would make mysqlx buffer every result
+	// callbackDelayUs:	from the DBWorker completing the request to its callback starting on the NetworkThread
+	//
+	// The statements are registered in Setup and never change afterwards, so Get can be called from any
+	// thread without locking. Histograms are lock-free.
+	//-----------------------------------------------------------------------------------------------------
+	class DBStatementStats
+	{
+	public:
+		struct StatementStats
+		{
+			std::string			sqlPreview;
+			LatencyHistogram	queueWaitUs;
+			LatencyHistogram	execUs;
+			LatencyHistogram	rows;
+			LatencyHistogram	callbackDelayUs;
+
+			// Running totals of the histograms above since startup, for the Prometheus _sum and _count (only
+			// touched by Report)
+			uint64_t			totalSum[4] = {};
+			uint64_t			totalCount[4] = {};
+		};
+
+		enum TotalIndex : size_t
+		{
+			TOTAL_QUEUE_WAIT = 0,
+			TOTAL_EXEC,
+			TOTAL_ROWS,
+			TOTAL_CALLBACK_DELAY
+		};
+
+	private:
+		// Ordered so reports list the statements by enum value
+		std::map<uint32_t, std::unique_ptr<StatementStats>> m_statements;
+
+	public:
+		void Setup(const std::unordered_map<uint32_t, std::string>& statements)
+		{
+			for (const auto& [enumVal, sql] : statements)
+			{
+				auto stats = std::make_unique<StatementStats>();
+				stats->sqlPreview = sql.substr(0, DB_STATS_SQL_PREVIEW_LENGTH);
+				m_statements.emplace(enumVal, std::move(stats));
+			}
+		}
+
+		StatementStats* Get(uint32_t enumVal)
+		{
+			auto it = m_statements.find(enumVal);
+			return it != m_statements.end() ? it->second.get() : nullptr;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Logs the statements that ran since the last report and adds them to 'exposition' as Prometheus
+		// summaries: the quantiles are of the window since the last report (histograms restart from zero), _sum
+		// and _count are cumulative since startup.
+		//-----------------------------------------------------------------------------------------------------
+		void Report(const std::string& poolName, DBStatsExposition& exposition)
+		{
+			for (auto& [enumVal, stats] : m_statements)
+			{
+				LatencyHistogram::Snapshot wait = stats->queueWaitUs.TakeSnapshot(true);
+				LatencyHistogram::Snapshot exec = stats->execUs.TakeSnapshot(true);
+				LatencyHistogram::Snapshot rows = stats->rows.TakeSnapshot(true);
+				LatencyHistogram::Snapshot cb = stats->callbackDelayUs.TakeSnapshot(true);
+
+				// Never ran, nothing to export. Once it did, its counters are exported at every report
+				if (wait.count == 0 && exec.count == 0 && stats->totalCount[TOTAL_EXEC] == 0 && stats->totalCount[TOTAL_QUEUE_WAIT] == 0)
+					continue;
+
+				AppendExposition(exposition, "necro_db_queue_wait_us", poolName, enumVal, wait, *stats, TOTAL_QUEUE_WAIT);
+				AppendExposition(exposition, "necro_db_exec_us", poolName, enumVal, exec, *stats, TOTAL_EXEC);
+				AppendExposition(exposition, "necro_db_rows", poolName, enumVal, rows, *stats, TOTAL_ROWS);
+				AppendExposition(exposition, "necro_db_callback_delay_us", poolName, enumVal, cb, *stats, TOTAL_CALLBACK_DELAY);
+
+				if (wait.count == 0 && exec.count == 0)
+					continue;
+
+				MLOG_INFO(DATABASE, "[DB STATS] {} stmt {} '{}' | {} execs | wait p50: {}us p99: {}us | exec p50: {}us p99: {}us max: {}us | rows p50: {} max: {} | callback p50: {}us p99: {}us",
+					poolName, enumVal, stats->sqlPreview, exec.count,
+					wait.Percentile(0.50), wait.Percentile(0.99),
+					exec.Percentile(0.50), exec.Percentile(0.99), exec.max,
+					rows.Percentile(0.50), rows.max,
+					cb.Percentile(0.50), cb.Percentile(0.99));
+			}
+		}
+
+	private:
+		static void AppendExposition(DBStatsExposition& out, const char* metric, const std::string& poolName, uint32_t enumVal, const LatencyHistogram::Snapshot& s, StatementStats& stats, TotalIndex total)
+		{
+			stats.totalSum[total] += s.sum;
+			stats.totalCount[total] += s.count;
+
+			const std::string labels = "pool=\"" + poolName + "\",stmt=\"" + std::to_string(enumVal) + "\"";
+
+			out.Add(metric, "summary", "{" + labels + ",quantile=\"0.5\"} " + std::to_string(s.Percentile(0.50)));
+			out.Add(metric, "summary", "{" + labels + ",quantile=\"0.99\"} " + std::to_string(s.Percentile(0.99)));
+			out.Add(metric, "summary", "{" + labels + ",quantile=\"1\"} " + std::to_string(s.max));
+			out.Add(metric, "summary", "_sum{" + labels + "} " + std::to_string(stats.totalSum[total]));
+			out.Add(metric, "summary", "_count{" + labels + "} " + std::to_string(stats.totalCount[total]));
+		}
+	};
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <optional>
+#include <vector>
+
+namespace NECRO
+{
+	//-----------------------------------------------------------------------------------------------------
+	// Key routing of an elastic DatabaseWorkerPool, kept apart from the DBWorkers so it can be checked
+	// without MySQL.
+	//
+	// A key with requests in flight stays pinned to the DBWorker it was routed to, even if the active count
+	// changes in the meantime, so resizing the pool can't reorder the requests of the same key. The DBWorker
+	// being retired is stopped only once it's drained and no key is pinned to it anymore.
+	//-----------------------------------------------------------------------------------------------------
+	class DBWorkerRouter
+	{
+	private:
+		// Pinned DBWorker of an ordering key and how many of its requests are still in there
+		struct KeyRoute
+		{
+			size_t worker = 0;
+			size_t inFlight = 0;
+		};
+
+		std::mutex								m_keysMutex;
+		std::unordered_map<uint64_t, KeyRoute>	m_keyRoutes;
+		std::vector<size_t>						m_pinnedKeysPerWorker;
+
+		// DBWorker that doesn't receive new requests anymore and will be stopped as soon as it's drained.
+		// Only touched by the DatabaseWorkerPool under the unique lock of its m_resizeMutex
+		std::optional<size_t>					m_retiringWorker;
+
+	public:
+		void Setup(size_t totalWorkers)
+		{
+			std::lock_guard<std::mutex> lock(m_keysMutex);
+			m_keyRoutes.clear();
+			m_pinnedKeysPerWorker.assign(totalWorkers, 0);
+			m_retiringWorker.reset();
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Fibonacci hashing, spreads sequential ids across the n workers
+		//-----------------------------------------------------------------------------------------------------
+		static size_t HashKey(uint64_t key, size_t n)
+		{
+			uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+			return n <= 1 ? 0 : static_cast<size_t>((h >> 32) % n);
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// DBWorker of the key: the pinned one if the key has requests in flight, else its hash over the
+		// activeCount DBWorkers. If pin is true the request is counted in flight until ReleaseKey
+		//-----------------------------------------------------------------------------------------------------
+		size_t RouteKey(uint64_t key, size_t activeCount, bool pin)
+		{
+			std::lock_guard<std::mutex> lock(m_keysMutex);
+
+			auto it = m_keyRoutes.find(key);
+			if (it != m_keyRoutes.end())
+			{
+				if (pin)
+					it->second.inFlight++;
+
+				return it->second.worker;
+			}
+
+			size_t worker = HashKey(key, activeCount);
+
+			if (pin)
+			{
+				m_keyRoutes.emplace(key, KeyRoute{ worker, 1 });
+				m_pinnedKeysPerWorker[worker]++;
+			}
+
+			return worker;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// A pinned request of the key is done (or was never enqueued), the key is unpinned with its last one
+		//-----------------------------------------------------------------------------------------------------
+		void ReleaseKey(uint64_t key)
+		{
+			std::lock_guard<std::mutex> lock(m_keysMutex);
+
+			auto it = m_keyRoutes.find(key);
+			if (it == m_keyRoutes.end())
+				return;
+
+			if (--it->second.inFlight == 0)
+			{
+				m_pinnedKeysPerWorker[it->second.worker]--;
+				m_keyRoutes.erase(it);
+			}
+		}
+
+		size_t GetPinnedKeys(size_t worker)
+		{
+			std::lock_guard<std::mutex> lock(m_keysMutex);
+			return m_pinnedKeysPerWorker[worker];
+		}
+
+		const std::optional<size_t>& GetRetiringWorker() const
+		{
+			return m_retiringWorker;
+		}
+
+		// The last active DBWorker stops receiving new requests
+		void BeginRetiring(size_t worker)
+		{
+			m_retiringWorker = worker;
+		}
+
+		// Growing back to the retiring DBWorker: it's still running, returns true if it was taken back
+		bool TakeBackRetiring(size_t worker)
+		{
+			if (!m_retiringWorker || *m_retiringWorker != worker)
+				return false;
+
+			m_retiringWorker.reset();
+			return true;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// The retiring DBWorker can be stopped once it has nothing queued and no key is pinned to it,
+		// so nothing can be routed to it anymore
+		//-----------------------------------------------------------------------------------------------------
+		bool CanStopRetiring(size_t queuedRequests)
+		{
+			return m_retiringWorker && queuedRequests == 0 && GetPinnedKeys(*m_retiringWorker) == 0;
+		}
+
+		void OnRetiringStopped()
+		{
+			m_retiringWorker.reset();
+		}
+	};
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <unordered_map>
+#include <string>
+#include <cctype>
 
 #include "DBConnection.h"
 #include "DBConnectionPool.h"
@@ -15,6 +17,9 @@ namespace NECRO
 	protected:
 		std::unordered_map<uint32_t, std::string> m_statementsMap;
 
+		// Statements of the form 'INSERT ... VALUES (...)' split in [prefix up to VALUES, row tuple], they can be coalesced in a multi-row INSERT
+		std::unordered_map<uint32_t, std::pair<std::string, std::string>> m_multiRowInserts;
+
 	public:
 		DBConnectionPool m_pool;
 
@@ -35,9 +40,68 @@ namespace NECRO
 			if (it == m_statementsMap.end())
 			{
 				m_statementsMap.insert({ enumVal, statement });
+				RegisterMultiRowInsert(enumVal, statement);
 			}
 		}
 
+		//-----------------------------------------------------------------------------------------------------
+		// If the statement is a plain 'INSERT INTO t (...) VALUES (...)' (no ON DUPLICATE, no INSERT ... SELECT),
+		// remembers how to split it so that multiple rows can be inserted with a single statement.
+		//-----------------------------------------------------------------------------------------------------
+		void RegisterMultiRowInsert(uint32_t enumVal, const std::string& statement)
+		{
+			std::string upper = statement;
+			for (char& c : upper)
+				c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+			if (upper.rfind("INSERT", 0) != 0 || upper.find("SELECT") != std::string::npos || upper.find("ON DUPLICATE") != std::string::npos)
+				return;
+
+			size_t valuesPos = upper.find("VALUES");
+			if (valuesPos == std::string::npos)
+				return;
+
+			size_t tupleStart = statement.find('(', valuesPos);
+			size_t tupleEnd = statement.find_last_of(')');
+			if (tupleStart == std::string::npos || tupleEnd == std::string::npos || tupleEnd < tupleStart)
+				return;
+
+			// Nothing but ';' and spaces is allowed after the row tuple
+			if (statement.find_first_not_of(" \t\r\n;", tupleEnd + 1) != std::string::npos)
+				return;
+
+			m_multiRowInserts[enumVal] = { statement.substr(0, tupleStart), statement.substr(tupleStart, tupleEnd - tupleStart + 1) };
+		}
+
+		bool IsMultiRowInsert(uint32_t enumVal) const
+		{
+			return m_multiRowInserts.find(enumVal) != m_multiRowInserts.end();
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Returns the INSERT statement of enumVal with 'rows' row tuples, params have to be bound row after row
+		//-----------------------------------------------------------------------------------------------------
+		std::string GetMultiRowStatement(uint32_t enumVal, size_t rows) const
+		{
+			auto it = m_multiRowInserts.find(enumVal);
+			if (it == m_multiRowInserts.end())
+				throw std::invalid_argument("Database statement enum is not a multi-row insert: " + std::to_string(enumVal));
+
+			const auto& [prefix, tuple] = it->second;
+
+			std::string res;
+			res.reserve(prefix.size() + (tuple.size() + 1) * rows);
+			res += prefix;
+			for (size_t i = 0; i < rows; i++)
+			{
+				if (i > 0)
+					res += ',';
+				res += tuple;
+			}
+
+			return res;
+		}
+
 		//-----------------------------------------------------------------------------------------------------
 		// Returns a mysqlx::SqlStatement, ready to be bound with parameters and executed by the caller
 		//-----------------------------------------------------------------------------------------------------
@@ -50,6 +114,11 @@ namespace NECRO
 			return it->second;
 		}
 
+		const std::unordered_map<uint32_t, std::string>& GetStatements() const
+		{
+			return m_statementsMap;
+		}
+
 		virtual int Close() = 0;
 	};
 }
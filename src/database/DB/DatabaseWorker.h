@@ -3,22 +3,39 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 #include <queue>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
 #include <memory>
 #include <vector>
 
 #include "DBRequest.h"
+#include "DBCircuitBreaker.h"
+#include "DBStatementStats.h"
 #include "LoginDatabase.h"
 #include "CharactersDatabase.h"
 
 namespace NECRO
 {
-	inline constexpr int DB_REQUEST_TIMEOUT_IF_MYSQL_DOWN_MS = 10000; // This should be the same as the idle-timeout-kick of the server
+	inline constexpr int DB_REQUEST_TIMEOUT_IF_MYSQL_DOWN_MS = 10000; // This should be the same as the idle-timeout-kick of the server, default deadline of the requests that have a callback
 
-	// Max m_externalQueue size
+	// Max requests taken from each priority lane per drain, INTERACTIVE : BACKGROUND : MAINTENANCE
+	inline constexpr size_t DB_PRIORITY_WEIGHTS[static_cast<int>(DBRequestPriority::COUNT)] = { 128, 64, 8 };
+
+	// Max m_externalQueues size
 	// It's to prevent the server to go OOM by bounding the DB queues sizes
 	inline constexpr int DB_QUEUE_MAX_SIZE = 100000;
 
+	// Group commit defaults: max fire-and-forget requests per transaction and max time the oldest of them can wait for the batch to fill up
+	inline constexpr size_t DB_GROUP_COMMIT_DEFAULT_MAX_BATCH = 64;
+	inline constexpr uint32_t DB_GROUP_COMMIT_DEFAULT_MAX_DELAY_MS = 5;
+
+	// Executed requests are posted to their io_contexts in batches, flushed at the end of every drain or once this many are waiting
+	inline constexpr size_t DB_RESPONSES_BATCH_MAX_SIZE = 32;
+
 	//-----------------------------------------------------------------------------------------------------
 	// An abstraction of a thread that works on a database
 	// 
@@ -35,15 +52,28 @@ namespace NECRO
 
 		std::atomic<bool>			m_running{ false };
 
-		// Producer queue (main thread pushes work here)
-		// We use std::vector instead of std::queue because the queues are consumed all at once, so swapping vectors avoids element-by-element removal
-		std::vector<DBRequest>		m_externalQueue;
+		// Producer queues (main thread pushes work here), one lane per DBRequestPriority
+		// Lanes are consumed DB_PRIORITY_WEIGHTS[lane] requests at a time, so that a backlog of saves doesn't delay the logins
+		std::deque<DBRequest>		m_externalQueues[static_cast<int>(DBRequestPriority::COUNT)];
+		size_t						m_externalQueuedCount = 0;
 		std::mutex					m_externalQueueMutex;
 		std::condition_variable		m_execWakeupCond;
 
+		// Lane and number of queued requests for each ordering key that is in the m_externalQueues.
+		// A keyed request always goes in the lane of its already-queued requests, so that priorities never reorder the requests of the same key
+		struct PendingKey
+		{
+			int		lane;
+			size_t	count;
+		};
+		std::unordered_map<uint64_t, PendingKey> m_pendingKeys;
+
 		// Consumer queue
 		std::vector<DBRequest>		m_internalQueue;
 
+		// Executed requests waiting to be posted to their io_context, see FlushResponses
+		std::vector<DBRequest>		m_pendingResponses;
+
 		// Size watch to prevent OOM, limits the amount of active requests
 		// m_requestsSize is incremented when a new request arrives and is decremented when a requests is posted on the asio thread that originated the request
 		std::atomic<size_t>			m_requestsSize{0};
@@ -51,6 +81,25 @@ namespace NECRO
 		// Session for the DBWorker's own thread
 		std::unique_ptr<mysqlx::Session> m_persistentMysqlSession;
 
+		// Group commit of fire-and-forget requests, a m_groupCommitMaxBatch of 1 disables it. Atomics, they're tuned by the config reloads
+		std::atomic<size_t>			m_groupCommitMaxBatch{ DB_GROUP_COMMIT_DEFAULT_MAX_BATCH };
+		std::atomic<uint32_t>		m_groupCommitMaxDelayMs{ DB_GROUP_COMMIT_DEFAULT_MAX_DELAY_MS };
+
+		// Circuit breaker of the DatabaseWorkerPool this worker belongs to (if any), and its generation when the sessions were last
+		// known good (m_directCircuitGeneration is guarded by m_directPersistentConnMutex)
+		DBCircuitBreaker*			m_circuitBreaker = nullptr;
+		uint32_t					m_circuitGeneration = 0;
+		uint32_t					m_directCircuitGeneration = 0;
+
+		// Called (on this thread) with the ordering key of every keyed request once it's done, the DatabaseWorkerPool uses
+		// it to know when a key can be routed to another worker
+		std::function<void(uint64_t)> m_onKeyedRequestDone;
+		std::vector<uint64_t>		m_executingKeys;
+
+		// Per-statement telemetry of the DatabaseWorkerPool (if any) and time spent executing drains, for the utilization
+		DBStatementStats*			m_stats = nullptr;
+		std::atomic<uint64_t>		m_busyUs{ 0 };
+
 		// Session for direct (syncronous) requests
 		std::mutex						 m_directPersistentConnMutex;
 		std::unique_ptr<mysqlx::Session> m_directPersistentMysqlSession;
@@ -65,19 +114,19 @@ namespace NECRO
 			}
 			catch (const mysqlx::Error& err)  // catches MySQL Connector/C++ specific exceptions
 			{
-				LOG_ERROR("CreatePersistentMySQLSession MySQL error: {}", err.what());
+				MLOG_ERROR(DATABASE, "CreatePersistentMySQLSession MySQL error: {}", err.what());
 				m_persistentMysqlSession.reset();
 				return -1;
 			}
 			catch (const std::exception& ex)  // catches standard exceptions
 			{
-				LOG_ERROR("CreatePersistentMySQLSession Standard exception: {}", ex.what());
+				MLOG_ERROR(DATABASE, "CreatePersistentMySQLSession Standard exception: {}", ex.what());
 				m_persistentMysqlSession.reset();
 				return -1;
 			}
 			catch (...)
 			{
-				LOG_ERROR("CreatePersistentMySQLSession Unknown exception caught!");
+				MLOG_ERROR(DATABASE, "CreatePersistentMySQLSession Unknown exception caught!");
 				m_persistentMysqlSession.reset();
 				return -1;
 			}
@@ -94,7 +143,54 @@ namespace NECRO
 				m_persistentMysqlSession.reset();
 			}
 
-			return CreatePersistentMySQLSession();
+			int res = CreatePersistentMySQLSession();
+
+			if (m_circuitBreaker)
+			{
+				if (res == 0)
+					m_circuitBreaker->OnConnectionSuccess();
+				else
+					m_circuitBreaker->OnConnectionFailure();
+			}
+
+			return res;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Called when this worker is elected to check if MySQL came back while the circuit is open
+		//-----------------------------------------------------------------------------------------------------
+		void ProbeConnection()
+		{
+			bool success = RecreatePersistentMySQLSession() == 0 && IsPersistentSessionAlive();
+			m_circuitBreaker->OnProbeResult(success);
+
+			// This session is the fresh one already
+			if (success)
+				m_circuitGeneration = m_circuitBreaker->GetGeneration();
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// If the circuit was closed again since the last check, session was opened before MySQL went down and
+		// is dead: it's dropped, so the caller recreates it instead of failing its first request on it
+		//-----------------------------------------------------------------------------------------------------
+		static void DropSessionIfStale(DBCircuitBreaker* breaker, uint32_t& generation, std::unique_ptr<mysqlx::Session>& session)
+		{
+			if (!breaker)
+				return;
+
+			uint32_t current = breaker->GetGeneration();
+			if (current == generation)
+				return;
+
+			generation = current;
+
+			if (session)
+			{
+				try { session->close(); }
+				catch (...) {}
+
+				session.reset();
+			}
 		}
 
 		//-----------------------------------------------------------------------------------------------------
@@ -116,194 +212,536 @@ namespace NECRO
 			}
 		}
 
+		//-----------------------------------------------------------------------------------------------------
+		// Executes the statement and records its execution time in the pool stats. The rows aren't counted here,
+		// res.count() would make mysqlx fetch and buffer the whole result
+		//-----------------------------------------------------------------------------------------------------
+		mysqlx::SqlResult ExecuteStatement(mysqlx::SqlStatement& stmt, uint32_t enumVal)
+		{
+			if (!m_stats)
+				return stmt.execute();
+
+			const auto start = std::chrono::steady_clock::now();
+			mysqlx::SqlResult res = stmt.execute();
+			const auto end = std::chrono::steady_clock::now();
+
+			if (DBStatementStats::StatementStats* stats = m_stats->Get(enumVal))
+				stats->execUs.Record(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+			return res;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Executes a single DBRequest (a single statement or a transaction) on the persistent session
+		//-----------------------------------------------------------------------------------------------------
+		void ExecuteRequest(DBRequest& req)
+		{
+			if (req.IsExpired(std::chrono::steady_clock::now()))
+			{
+				DropRequest(req, DBRequestError::EXPIRED);
+				return;
+			}
+
+			// MySQL is down, don't pay the connection timeout for every request
+			if (m_circuitBreaker && !m_circuitBreaker->AllowRequest())
+			{
+				DropRequest(req, DBRequestError::UNAVAILABLE);
+				return;
+			}
+
+			DropSessionIfStale(m_circuitBreaker, m_circuitGeneration, m_persistentMysqlSession);
+
+			if (req.IsValid() && (!req.m_cancelToken || !req.m_cancelToken->expired()))
+			{
+				// Do stuff
+				try
+				{
+					// If the persistent session died, attempt to fire it back up once
+					if (!m_persistentMysqlSession)
+					{
+						if (RecreatePersistentMySQLSession() != 0)
+						{
+							// If firing it back fails, drop this request: set error code and push the response to let it arrive to the DBCallback handler 
+							req.m_errorCode = static_cast<uint32_t>(DBRequestError::FAILED);
+
+							// If the request requires a callback, push it
+							if (!req.m_fireAndForget)
+							{
+								ThreadPostResponse(std::move(req));
+							}
+							else
+								CompleteFireAndForget(req);
+
+							return;
+						}
+					}
+
+					if (m_persistentMysqlSession)
+					{
+						// Prepare the statement and execute it on the persistent mysql session
+
+						if (req.IsTransaction())
+						{
+							// Start the transaction
+							m_persistentMysqlSession->startTransaction();
+							for (size_t i = 0; i < req.m_steps.size(); i++)
+							{
+								mysqlx::SqlStatement stmt = m_persistentMysqlSession->sql(m_db->GetPreparedStatement(req.m_steps[i].m_enumVal));
+								for (auto& param : req.m_steps[i].m_bindParams)
+									stmt.bind(param);
+
+								req.m_sqlResults.push_back(ExecuteStatement(stmt, req.m_steps[i].m_enumVal));
+							}
+
+							m_persistentMysqlSession->commit();
+							req.m_committed = true;
+
+							// If the request requires a callback, set things up
+							if (!req.m_fireAndForget)
+							{
+								ThreadPostResponse(std::move(req));
+							}
+							else
+								CompleteFireAndForget(req);
+						}
+						else // Single request (m_steps[0] exists because this request IsValid())
+						{
+							mysqlx::SqlStatement stmt = m_persistentMysqlSession->sql(m_db->GetPreparedStatement(req.m_steps[0].m_enumVal));
+							for (auto& param : req.m_steps[0].m_bindParams)
+								stmt.bind(param);
+
+							req.m_sqlResults.push_back(ExecuteStatement(stmt, req.m_steps[0].m_enumVal));
+
+							// If the request requires a callback, set things up
+							if (!req.m_fireAndForget)
+							{
+								ThreadPostResponse(std::move(req));
+							}
+							else
+								CompleteFireAndForget(req);
+						}
+					}
+				}
+				catch (const mysqlx::Error& err)  // catches MySQL Connector/C++ specific exceptions
+				{
+					MLOG_ERROR(DATABASE, "DBWorker MySQL error: {}", err.what());
+
+					if (IsPersistentSessionAlive())
+					{
+						// Attempt rollback for failed transactions
+						try
+						{
+							if (req.IsTransaction() && m_persistentMysqlSession)
+								m_persistentMysqlSession->rollback();
+						}
+						catch (...) {}
+					}
+					else
+						RecreatePersistentMySQLSession();
+
+					// Drop this request: set error code and push the response to let it arrive to the DBCallback handler 
+					req.m_errorCode = static_cast<uint32_t>(DBRequestError::FAILED);
+
+					// If the request requires a callback, push it
+					if (!req.m_fireAndForget)
+					{
+						ThreadPostResponse(std::move(req));
+					}
+					else
+						CompleteFireAndForget(req);
+				}
+				catch (const std::exception& ex)  // catches standard exceptions
+				{
+					MLOG_ERROR(DATABASE, "DBWorker Standard exception: {}", ex.what());
+
+					if (IsPersistentSessionAlive())
+					{
+						try
+						{
+							if (req.IsTransaction() && m_persistentMysqlSession)
+								m_persistentMysqlSession->rollback();
+						}
+						catch (...) {}
+					}
+					else
+						RecreatePersistentMySQLSession();
+
+					// Drop this request: set error code and push the response to let it arrive to the DBCallback handler 
+					req.m_errorCode = static_cast<uint32_t>(DBRequestError::FAILED);
+
+					// If the request requires a callback, push it
+					if (!req.m_fireAndForget)
+					{
+						ThreadPostResponse(std::move(req));
+					}
+					else
+						CompleteFireAndForget(req);
+				}
+				catch (...)
+				{
+					MLOG_ERROR(DATABASE, "DBWorker Unknown exception caught!");
+
+					try
+					{
+						if (req.IsTransaction() && m_persistentMysqlSession)
+							m_persistentMysqlSession->rollback();
+					}
+					catch (...) {}
+
+					// Unknown exception
+					RecreatePersistentMySQLSession();
+
+					// Drop this request: set error code and push the response to let it arrive to the DBCallback handler 
+					req.m_errorCode = static_cast<uint32_t>(DBRequestError::FAILED);
+
+					// If the request requires a callback, push it
+					if (!req.m_fireAndForget)
+					{
+						ThreadPostResponse(std::move(req));
+					}
+					else
+						CompleteFireAndForget(req);
+				}
+			}
+			else // invalid requests being skipped must decrement the requests count as well
+				m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Skips the request without running it and lets the callback know why: it waited too long (EXPIRED, 
+		// whoever made it doesn't care anymore) or MySQL is down (UNAVAILABLE)
+		//-----------------------------------------------------------------------------------------------------
+		void DropRequest(DBRequest& req, DBRequestError reason)
+		{
+			if (reason == DBRequestError::EXPIRED)
+				MLOG_DEBUG(DATABASE, "DBWorker dropping an expired request, queued {}ms ago.", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - req.m_creationTime).count());
+
+			req.m_errorCode = static_cast<uint32_t>(reason);
+
+			if (!req.m_fireAndForget)
+				ThreadPostResponse(std::move(req));
+			else
+				CompleteFireAndForget(req);
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// A fire-and-forget request is done (committed, failed or dropped), lets its m_completionFunc know
+		//-----------------------------------------------------------------------------------------------------
+		void CompleteFireAndForget(DBRequest& req)
+		{
+			if (req.m_completionFunc)
+			{
+				try { req.m_completionFunc(req.m_errorCode); }
+				catch (const std::exception& err) { MLOG_CRITICAL(DATABASE, "Exception caught in a DBRequest completion function. Standard: {}", err.what()); }
+				catch (...) { MLOG_CRITICAL(DATABASE, "Exception caught in a DBRequest completion function: Unknown"); }
+			}
+
+			m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Fire-and-forget requests (saves, logs) can be coalesced in a group commit
+		//-----------------------------------------------------------------------------------------------------
+		bool IsGroupCommittable(const DBRequest& req, std::chrono::steady_clock::time_point now) const
+		{
+			return req.IsValid() && req.m_fireAndForget && !req.IsExpired(now) && (!req.m_cancelToken || !req.m_cancelToken->expired());
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Executes m_internalQueue[begin, end) (all group committable) in a single transaction, consecutive
+		// single-step requests of the same multi-row INSERT statement are also coalesced in a single statement.
+		// 
+		// If anything fails the whole group is rolled back and every request is executed on its own, so a bad 
+		// request only drops itself.
+		//-----------------------------------------------------------------------------------------------------
+		void ExecuteGroupCommit(size_t begin, size_t end)
+		{
+			DropSessionIfStale(m_circuitBreaker, m_circuitGeneration, m_persistentMysqlSession);
+
+			if ((m_circuitBreaker && !m_circuitBreaker->AllowRequest()) || (!m_persistentMysqlSession && RecreatePersistentMySQLSession() != 0))
+			{
+				// Let every request be dropped on its own
+				for (size_t i = begin; i < end; i++)
+					ExecuteRequest(m_internalQueue[i]);
+
+				return;
+			}
+
+			bool failed = false;
+			try
+			{
+				m_persistentMysqlSession->startTransaction();
+
+				size_t i = begin;
+				while (i < end)
+				{
+					const DBRequest& req = m_internalQueue[i];
+					const uint32_t enumVal = req.m_steps[0].m_enumVal;
+
+					size_t rowsEnd = i + 1;
+					if (!req.IsTransaction() && m_db->IsMultiRowInsert(enumVal))
+						while (rowsEnd < end && !m_internalQueue[rowsEnd].IsTransaction() && m_internalQueue[rowsEnd].m_steps[0].m_enumVal == enumVal)
+							rowsEnd++;
+
+					if (rowsEnd - i > 1)
+					{
+						mysqlx::SqlStatement stmt = m_persistentMysqlSession->sql(m_db->GetMultiRowStatement(enumVal, rowsEnd - i));
+						for (size_t r = i; r < rowsEnd; r++)
+							for (auto& param : m_internalQueue[r].m_steps[0].m_bindParams)
+								stmt.bind(param);
+
+						ExecuteStatement(stmt, enumVal);
+						i = rowsEnd;
+					}
+					else
+					{
+						for (auto& step : req.m_steps)
+						{
+							mysqlx::SqlStatement stmt = m_persistentMysqlSession->sql(m_db->GetPreparedStatement(step.m_enumVal));
+							for (auto& param : step.m_bindParams)
+								stmt.bind(param);
+
+							ExecuteStatement(stmt, step.m_enumVal);
+						}
+						i++;
+					}
+				}
+
+				m_persistentMysqlSession->commit();
+			}
+			catch (const mysqlx::Error& err)
+			{
+				MLOG_WARNING(DATABASE, "DBWorker group commit of {} requests failed, MySQL error: {}. Executing them one by one.", end - begin, err.what());
+				failed = true;
+			}
+			catch (const std::exception& ex)
+			{
+				MLOG_WARNING(DATABASE, "DBWorker group commit of {} requests failed, Standard exception: {}. Executing them one by one.", end - begin, ex.what());
+				failed = true;
+			}
+			catch (...)
+			{
+				MLOG_WARNING(DATABASE, "DBWorker group commit of {} requests failed, Unknown exception. Executing them one by one.", end - begin);
+				failed = true;
+			}
+
+			if (!failed)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					m_internalQueue[i].m_committed = true;
+					CompleteFireAndForget(m_internalQueue[i]);
+				}
+
+				return;
+			}
+
+			if (IsPersistentSessionAlive())
+			{
+				try { m_persistentMysqlSession->rollback(); }
+				catch (...) {}
+			}
+			else
+				RecreatePersistentMySQLSession();
+
+			// Error isolation
+			for (size_t i = begin; i < end; i++)
+				ExecuteRequest(m_internalQueue[i]);
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// True if the worker should wait a bit more for other fire-and-forget requests before draining the
+		// m_externalQueues. Must be called with m_externalQueueMutex held.
+		//-----------------------------------------------------------------------------------------------------
+		bool ShouldLingerForGroupCommit() const
+		{
+			if (!m_running || m_groupCommitMaxDelayMs == 0 || m_groupCommitMaxBatch <= 1 || m_externalQueuedCount >= m_groupCommitMaxBatch)
+				return false;
+
+			// Don't delay requests that someone is waiting for
+			for (const auto& lane : m_externalQueues)
+				for (const auto& req : lane)
+					if (!req.m_fireAndForget)
+						return false;
+
+			return true;
+		}
+
+		std::chrono::steady_clock::time_point OldestExternalRequestTime() const
+		{
+			auto oldest = std::chrono::steady_clock::time_point::max();
+			for (const auto& lane : m_externalQueues)
+				if (!lane.empty() && lane.front().m_creationTime < oldest)
+					oldest = lane.front().m_creationTime;
+
+			return oldest;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Pushes the request in its lane. Must be called with m_externalQueueMutex held.
+		//-----------------------------------------------------------------------------------------------------
+		void PushExternal(DBRequest&& req)
+		{
+			if (!req.m_deadline && !req.m_fireAndForget)
+				req.m_deadline = req.m_creationTime + std::chrono::milliseconds(DB_REQUEST_TIMEOUT_IF_MYSQL_DOWN_MS);
+
+			int lane = static_cast<int>(req.m_priority);
+			if (lane < 0 || lane >= static_cast<int>(DBRequestPriority::COUNT))
+				lane = static_cast<int>(DBRequestPriority::INTERACTIVE);
+
+			if (req.m_orderingKey)
+			{
+				auto [it, inserted] = m_pendingKeys.try_emplace(*req.m_orderingKey, PendingKey{ lane, 0 });
+				lane = it->second.lane;
+				it->second.count++;
+			}
+
+			m_externalQueues[lane].push_back(std::move(req));
+			m_externalQueuedCount++;
+			m_requestsSize.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Moves up to DB_PRIORITY_WEIGHTS[lane] requests of each lane in the m_internalQueue, higher priorities
+		// first. Must be called with m_externalQueueMutex held.
+		//-----------------------------------------------------------------------------------------------------
+		void DrainExternal()
+		{
+			for (int lane = 0; lane < static_cast<int>(DBRequestPriority::COUNT); lane++)
+			{
+				auto& queue = m_externalQueues[lane];
+				size_t n = std::min(queue.size(), DB_PRIORITY_WEIGHTS[lane]);
+
+				for (size_t i = 0; i < n; i++)
+				{
+					DBRequest& req = queue.front();
+					if (req.m_orderingKey)
+					{
+						auto it = m_pendingKeys.find(*req.m_orderingKey);
+						if (it != m_pendingKeys.end() && --it->second.count == 0)
+							m_pendingKeys.erase(it);
+					}
+
+					m_internalQueue.push_back(std::move(req));
+					queue.pop_front();
+				}
+
+				m_externalQueuedCount -= n;
+			}
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Records how long the drained requests waited in the queue
+		//-----------------------------------------------------------------------------------------------------
+		void RecordQueueWaits(std::chrono::steady_clock::time_point now)
+		{
+			if (!m_stats)
+				return;
+
+			for (const DBRequest& req : m_internalQueue)
+			{
+				if (!req.IsValid())
+					continue;
+
+				if (DBStatementStats::StatementStats* stats = m_stats->Get(req.m_steps[0].m_enumVal))
+					stats->queueWaitUs.Record(std::chrono::duration_cast<std::chrono::microseconds>(now - req.m_creationTime).count());
+			}
+		}
+
 		void ThreadRoutine()
 		{
 			while (true)
 			{
+				// MySQL went down, check if it's back (the backoff is handled by the circuit breaker)
+				if (m_circuitBreaker && m_circuitBreaker->TryBeginProbe())
+					ProbeConnection();
+
 				std::unique_lock<std::mutex> lock(m_externalQueueMutex);
 
 				// If we Stopped the thread and there's nothing in the queue, exit
-				if (!m_running && m_externalQueue.size() <= 0)
+				if (!m_running && m_externalQueuedCount <= 0)
 				{
 					lock.unlock();
 					break;
 				}
 
 				// Otherwise, we're either still running or there's still something in the queue
-				if (m_externalQueue.size() <= 0) // if we're still running and queue is empty
+				if (m_externalQueuedCount <= 0) // if we're still running and queue is empty
 				{
 					// Sleep
-					while (m_externalQueue.size() <= 0 && m_running)
-						m_execWakeupCond.wait(lock);
+					while (m_externalQueuedCount <= 0 && m_running)
+					{
+						// While the circuit is open, wake up for the recovery probes even if there's nothing to do
+						if (m_circuitBreaker && m_circuitBreaker->GetState() == DBCircuitBreaker::State::OPEN)
+						{
+							if (m_execWakeupCond.wait_until(lock, m_circuitBreaker->GetNextProbeTime()) == std::cv_status::timeout)
+								break;
+						}
+						else
+							m_execWakeupCond.wait(lock);
+					}
 				}
 				else // we have something to run
 				{
 					// We have lock here
 
-					// Swap all pending work into internal queue
-					std::swap(m_internalQueue, m_externalQueue);
+					// Only fire-and-forget requests are waiting, give the others a chance to arrive so they can be group committed,
+					// bounded by the age of the oldest request
+					if (ShouldLingerForGroupCommit())
+					{
+						auto deadline = OldestExternalRequestTime() + std::chrono::milliseconds(m_groupCommitMaxDelayMs);
+						m_execWakeupCond.wait_until(lock, deadline, [this]() { return !ShouldLingerForGroupCommit(); });
+					}
+
+					// Move the weighted share of every lane into internal queue
+					DrainExternal();
 					lock.unlock();
 
-					// Execute the queue
-					for (auto& req : m_internalQueue)
+					// Execute the queue, coalescing consecutive fire-and-forget requests
+					const auto now = std::chrono::steady_clock::now();
+					RecordQueueWaits(now);
+
+					const size_t maxBatch = m_groupCommitMaxBatch;
+
+					size_t i = 0;
+					while (i < m_internalQueue.size())
 					{
-						if (req.IsValid() && (!req.m_cancelToken || !req.m_cancelToken->expired()))
+						size_t groupEnd = i;
+						while (groupEnd < m_internalQueue.size() && groupEnd - i < maxBatch && IsGroupCommittable(m_internalQueue[groupEnd], now))
+							groupEnd++;
+
+						if (groupEnd == i)
+							groupEnd = i + 1;
+
+						// Requests are moved out when they complete, remember their keys
+						if (m_onKeyedRequestDone)
 						{
-							// Do stuff
-							try
-							{
-								// If the persistent session died, attempt to fire it back up once
-								if (!m_persistentMysqlSession)
-								{
-									if (RecreatePersistentMySQLSession() != 0)
-									{
-										// If firing it back fails, drop this request: set error code and push the response to let it arrive to the DBCallback handler 
-										req.m_errorCode = 1;
-
-										// If the request requires a callback, push it
-										if (!req.m_fireAndForget)
-										{
-											ThreadPostResponse(std::move(req));
-										}
-										else
-											m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
-
-										continue;
-									}
-								}
-
-								if (m_persistentMysqlSession)
-								{
-									// Prepare the statement and execute it on the persistent mysql session
-
-									if (req.IsTransaction())
-									{
-										// Start the transaction
-										m_persistentMysqlSession->startTransaction();
-										for (size_t i = 0; i < req.m_steps.size(); i++)
-										{
-											mysqlx::SqlStatement stmt = m_persistentMysqlSession->sql(m_db->GetPreparedStatement(req.m_steps[i].m_enumVal));
-											for (auto& param : req.m_steps[i].m_bindParams)
-												stmt.bind(param);
-
-											req.m_sqlResults.push_back(stmt.execute());
-										}
-
-										m_persistentMysqlSession->commit();
-										req.m_committed = true;
-
-										// If the request requires a callback, set things up
-										if (!req.m_fireAndForget)
-										{
-											ThreadPostResponse(std::move(req));
-										}
-										else
-											m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
-									}
-									else // Single request (m_steps[0] exists because this request IsValid())
-									{
-										mysqlx::SqlStatement stmt = m_persistentMysqlSession->sql(m_db->GetPreparedStatement(req.m_steps[0].m_enumVal));
-										for (auto& param : req.m_steps[0].m_bindParams)
-											stmt.bind(param);
-
-										req.m_sqlResults.push_back(stmt.execute());
-
-										// If the request requires a callback, set things up
-										if (!req.m_fireAndForget)
-										{
-											ThreadPostResponse(std::move(req));
-										}
-										else
-											m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
-									}
-								}
-							}
-							catch (const mysqlx::Error& err)  // catches MySQL Connector/C++ specific exceptions
-							{
-								LOG_ERROR("DBWorker MySQL error: {}", err.what());
-
-								if (IsPersistentSessionAlive())
-								{
-									// Attempt rollback for failed transactions
-									try
-									{
-										if (req.IsTransaction() && m_persistentMysqlSession)
-											m_persistentMysqlSession->rollback();
-									}
-									catch (...) {}
-								}
-								else
-									RecreatePersistentMySQLSession();
-
-								// Drop this request: set error code and push the response to let it arrive to the DBCallback handler 
-								req.m_errorCode = 1;
-
-								// If the request requires a callback, push it
-								if (!req.m_fireAndForget)
-								{
-									ThreadPostResponse(std::move(req));
-								}
-								else
-									m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
-							}
-							catch (const std::exception& ex)  // catches standard exceptions
-							{
-								LOG_ERROR("DBWorker Standard exception: {}", ex.what());
-
-								if (IsPersistentSessionAlive())
-								{
-									try
-									{
-										if (req.IsTransaction() && m_persistentMysqlSession)
-											m_persistentMysqlSession->rollback();
-									}
-									catch (...) {}
-								}
-								else
-									RecreatePersistentMySQLSession();
-
-								// Drop this request: set error code and push the response to let it arrive to the DBCallback handler 
-								req.m_errorCode = 1;
-
-								// If the request requires a callback, push it
-								if (!req.m_fireAndForget)
-								{
-									ThreadPostResponse(std::move(req));
-								}
-								else
-									m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
-							}
-							catch (...)
-							{
-								LOG_ERROR("DBWorker Unknown exception caught!");
-
-								try
-								{
-									if (req.IsTransaction() && m_persistentMysqlSession)
-										m_persistentMysqlSession->rollback();
-								}
-								catch (...) {}
-
-								// Unknown exception
-								RecreatePersistentMySQLSession();
-
-								// Drop this request: set error code and push the response to let it arrive to the DBCallback handler 
-								req.m_errorCode = 1;
-
-								// If the request requires a callback, push it
-								if (!req.m_fireAndForget)
-								{
-									ThreadPostResponse(std::move(req));
-								}
-								else
-									m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
-							}
+							m_executingKeys.clear();
+							for (size_t k = i; k < groupEnd; k++)
+								if (m_internalQueue[k].m_orderingKey)
+									m_executingKeys.push_back(*m_internalQueue[k].m_orderingKey);
 						}
-						else // invalid requests being skipped must decrement the requests count as well
-							m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
+
+						if (groupEnd - i > 1)
+							ExecuteGroupCommit(i, groupEnd);
+						else
+							ExecuteRequest(m_internalQueue[i]);
+
+						i = groupEnd;
+
+						if (m_onKeyedRequestDone)
+							for (uint64_t key : m_executingKeys)
+								m_onKeyedRequestDone(key);
+
+						// Don't hold back the responses for the whole drain
+						if (m_pendingResponses.size() >= DB_RESPONSES_BATCH_MAX_SIZE)
+							FlushResponses();
 					}
 
 					m_internalQueue.clear();
+					FlushResponses();
+
+					m_busyUs.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - now).count(), std::memory_order_relaxed);
 				}
 			}
 		}
@@ -313,29 +751,102 @@ namespace NECRO
 		//-----------------------------------------------------------------------------------------------------
 		void ThreadPostResponse(DBRequest&& req)
 		{
+			// Typed requests: materialize the rows here on the DBWorker thread and release the results
+			if (req.m_decoder && req.m_errorCode == static_cast<uint32_t>(DBRequestError::NONE))
+			{
+				try
+				{
+					size_t rows = req.m_decoder(req.m_sqlResults);
+
+					if (m_stats)
+						if (DBStatementStats::StatementStats* stats = m_stats->Get(req.m_steps[0].m_enumVal))
+							stats->rows.Record(rows);
+				}
+				catch (const mysqlx::Error& err)
+				{
+					MLOG_ERROR(DATABASE, "DBWorker rows decoding MySQL error: {}", err.what());
+					req.m_errorCode = static_cast<uint32_t>(DBRequestError::FAILED);
+				}
+				catch (const std::exception& ex)
+				{
+					MLOG_ERROR(DATABASE, "DBWorker rows decoding Standard exception: {}", ex.what());
+					req.m_errorCode = static_cast<uint32_t>(DBRequestError::FAILED);
+				}
+				catch (...)
+				{
+					MLOG_ERROR(DATABASE, "DBWorker rows decoding Unknown exception caught!");
+					req.m_errorCode = static_cast<uint32_t>(DBRequestError::FAILED);
+				}
+
+				req.m_sqlResults.clear();
+			}
+
 			// Preserve the life of the m_noticeFunc in this scope before it gets moved
 			std::function<void()> func = std::move(req.m_noticeFunc);
 
-			// Post the callback on the thread that originated the request
+			// The callback is posted with the other responses of this drain (FlushResponses), the request completes there
 			if (req.m_callback)
 			{
-				// Capture the request
-				auto reqPtr = std::make_shared<DBRequest>(std::move(req));
-				boost::asio::post(reqPtr->m_callbackContexRef, [reqPtr]()
-					{
-						try { reqPtr->m_callback(reqPtr->m_errorCode, reqPtr->m_sqlResults); }
-						catch (const mysqlx::Error& err) { LOG_CRITICAL("Exception caught during DBCallback handling. MySQL Error: {}", err.what()); }
-						catch (const std::exception& err) { LOG_CRITICAL("Exception caught during DBCallback handling. Standard: {}", err.what()); }
-						catch (...) { LOG_CRITICAL("Exception caught during DBCallback handling: Unknown"); }
-					});
+				req.m_completionTime = std::chrono::steady_clock::now();
+				m_pendingResponses.push_back(std::move(req));
 			}
+			else
+				m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
 
 			// Call notice function if set
 			if (func)
 				func();
+		}
 
-			// Request completed
-			m_requestsSize.fetch_sub(1, std::memory_order_relaxed);
+		//-----------------------------------------------------------------------------------------------------
+		// Posts the pending responses to the threads that originated them, one post (and one allocation) per
+		// io_context, the callbacks of a batch run back to back in the order the requests were executed
+		//-----------------------------------------------------------------------------------------------------
+		void FlushResponses()
+		{
+			if (m_pendingResponses.empty())
+				return;
+
+			const size_t count = m_pendingResponses.size();
+
+			// Few distinct io_contexts (one per NetworkThread), a linear scan is enough
+			std::vector<std::pair<boost::asio::io_context*, std::shared_ptr<std::vector<DBRequest>>>> batches;
+			for (DBRequest& req : m_pendingResponses)
+			{
+				boost::asio::io_context* ctx = &req.m_callbackContexRef;
+
+				auto it = std::find_if(batches.begin(), batches.end(), [ctx](const auto& b) { return b.first == ctx; });
+				if (it == batches.end())
+				{
+					batches.emplace_back(ctx, std::make_shared<std::vector<DBRequest>>());
+					batches.back().second->reserve(count);
+					it = batches.end() - 1;
+				}
+
+				it->second->push_back(std::move(req));
+			}
+			m_pendingResponses.clear();
+
+			for (auto& [ctx, batch] : batches)
+			{
+				boost::asio::post(*ctx, [batch, stats = m_stats]()
+					{
+						for (DBRequest& req : *batch)
+						{
+							if (stats && req.IsValid())
+								if (DBStatementStats::StatementStats* s = stats->Get(req.m_steps[0].m_enumVal))
+									s->callbackDelayUs.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - req.m_completionTime).count());
+
+							try { req.m_callback(req.m_errorCode, req.m_sqlResults); }
+							catch (const mysqlx::Error& err) { MLOG_CRITICAL(DATABASE, "Exception caught during DBCallback handling. MySQL Error: {}", err.what()); }
+							catch (const std::exception& err) { MLOG_CRITICAL(DATABASE, "Exception caught during DBCallback handling. Standard: {}", err.what()); }
+							catch (...) { MLOG_CRITICAL(DATABASE, "Exception caught during DBCallback handling: Unknown"); }
+						}
+					});
+			}
+
+			// Requests completed
+			m_requestsSize.fetch_sub(count, std::memory_order_relaxed);
 		}
 
 	public:
@@ -347,10 +858,53 @@ namespace NECRO
 			if (m_db->Init(URI) == 0)
 				return 0;
 
-			LOG_ERROR("Could not initialize DatabaseWorker internal db, MySQL may be not running.");
+			MLOG_ERROR(DATABASE, "Could not initialize DatabaseWorker internal db, MySQL may be not running.");
 			return 1;
 		}
 
+		void SetCircuitBreaker(DBCircuitBreaker* breaker)
+		{
+			m_circuitBreaker = breaker;
+			m_circuitGeneration = breaker ? breaker->GetGeneration() : 0;
+			m_directCircuitGeneration = m_circuitGeneration;
+		}
+
+		void SetOnKeyedRequestDone(std::function<void(uint64_t)> func)
+		{
+			m_onKeyedRequestDone = std::move(func);
+		}
+
+		void SetStats(DBStatementStats* stats)
+		{
+			m_stats = stats;
+		}
+
+		// Time spent executing drains since the DBWorker was created, in microseconds
+		uint64_t GetBusyUs() const
+		{
+			return m_busyUs.load(std::memory_order_relaxed);
+		}
+
+		// Statements of the internal db, available after Setup
+		const std::unordered_map<uint32_t, std::string>& GetStatements() const
+		{
+			return m_db->GetStatements();
+		}
+
+		bool IsRunning() const
+		{
+			return m_running;
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Sets up the group commit of fire-and-forget requests, can be called while the worker is running
+		//-----------------------------------------------------------------------------------------------------
+		void SetGroupCommit(size_t maxBatch, uint32_t maxDelayMs)
+		{
+			m_groupCommitMaxBatch = maxBatch > 0 ? maxBatch : 1;
+			m_groupCommitMaxDelayMs = maxDelayMs;
+		}
+
 		//-----------------------------------------------------------------------------------------------------
 		// Starts the thread with its ThreadRoutine
 		//-----------------------------------------------------------------------------------------------------
@@ -358,7 +912,7 @@ namespace NECRO
 		{
 			if (m_thread.joinable())
 			{
-				LOG_WARNING("Attempting to start while thread is still joinable. This should not happen. Trying to stop and join.");
+				MLOG_WARNING(DATABASE, "Attempting to start while thread is still joinable. This should not happen. Trying to stop and join.");
 				Stop();
 				Join();
 			}
@@ -427,8 +981,7 @@ namespace NECRO
 		{
 			{
 				std::lock_guard<std::mutex> lock(m_externalQueueMutex);
-				m_externalQueue.push_back(std::move(req));
-				m_requestsSize.fetch_add(1, std::memory_order_relaxed);
+				PushExternal(std::move(req));
 			}
 
 			m_execWakeupCond.notify_one();
@@ -460,8 +1013,7 @@ namespace NECRO
 				// When checking the queue, also check the internal queue, requests that yet have to be processed
 				if (m_requestsSize.load(std::memory_order_relaxed) < DB_QUEUE_MAX_SIZE)
 				{
-					m_externalQueue.push_back(std::move(req));
-					m_requestsSize.fetch_add(1, std::memory_order_relaxed);
+					PushExternal(std::move(req));
 					success = true;
 				}
 			}
@@ -477,6 +1029,18 @@ namespace NECRO
 			return m_requestsSize.load(std::memory_order_relaxed);
 		}
 
+		// ----------------------------------------------------------------------------------------------------
+		// How long the oldest queued (not yet executing) request has been waiting, 0 if nothing is queued
+		//-----------------------------------------------------------------------------------------------------
+		uint64_t GetOldestQueuedWaitMs()
+		{
+			std::lock_guard<std::mutex> lock(m_externalQueueMutex);
+			if (m_externalQueuedCount == 0)
+				return 0;
+
+			return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - OldestExternalRequestTime()).count();
+		}
+
 		// -----------------------------------------
 		// DIRECT DB
 		// -----------------------------------------
@@ -490,19 +1054,19 @@ namespace NECRO
 				}
 				catch (const mysqlx::Error& err)  // catches MySQL Connector/C++ specific exceptions
 				{
-					LOG_ERROR("CreateDirectPersistentMySQLSession MySQL error: {}", err.what());
+					MLOG_ERROR(DATABASE, "CreateDirectPersistentMySQLSession MySQL error: {}", err.what());
 					m_directPersistentMysqlSession.reset();
 					return -1;
 				}
 				catch (const std::exception& ex)  // catches standard exceptions
 				{
-					LOG_ERROR("CreateDirectPersistentMySQLSession Standard exception: {}", ex.what());
+					MLOG_ERROR(DATABASE, "CreateDirectPersistentMySQLSession Standard exception: {}", ex.what());
 					m_directPersistentMysqlSession.reset();
 					return -1;
 				}
 				catch (...)
 				{
-					LOG_ERROR("CreateDirectPersistentMySQLSession Unknown exception caught!");
+					MLOG_ERROR(DATABASE, "CreateDirectPersistentMySQLSession Unknown exception caught!");
 					m_directPersistentMysqlSession.reset();
 					return -1;
 				}
@@ -555,7 +1119,7 @@ namespace NECRO
 		{
 			std::vector<mysqlx::SqlResult> results;
 
-			if (!req.IsValid())
+			if (!req.IsValid() || (m_circuitBreaker && !m_circuitBreaker->AllowRequest()))
 			{
 				// Return an empty sqlResult, the caller will interpret it as an error
 				return results;
@@ -563,6 +1127,8 @@ namespace NECRO
 
 			std::unique_lock<std::mutex> lock(m_directPersistentConnMutex);
 
+			DropSessionIfStale(m_circuitBreaker, m_directCircuitGeneration, m_directPersistentMysqlSession);
+
 			try
 			{
 				// If the persistent session died, attempt to fire it back up once, if this doesn't work, notify the caller and he'll decide what to do.
@@ -588,7 +1154,7 @@ namespace NECRO
 							for (auto& param : req.m_steps[i].m_bindParams)
 								stmt.bind(param);
 
-							results.push_back(stmt.execute());
+							results.push_back(ExecuteStatement(stmt, req.m_steps[i].m_enumVal));
 						}
 
 						m_directPersistentMysqlSession->commit();
@@ -602,7 +1168,7 @@ namespace NECRO
 						for (auto& param : req.m_steps[0].m_bindParams)
 							stmt.bind(param);
 
-						results.push_back(stmt.execute());
+						results.push_back(ExecuteStatement(stmt, req.m_steps[0].m_enumVal));
 
 						return results;
 					}
@@ -610,7 +1176,7 @@ namespace NECRO
 			}
 			catch (const mysqlx::Error& err)  // catches MySQL Connector/C++ specific exceptions
 			{
-				LOG_ERROR("DBWorker MySQL error: {}", err.what());
+				MLOG_ERROR(DATABASE, "DBWorker MySQL error: {}", err.what());
 
 				if (IsDirectPersistentSessionAlive())
 				{
@@ -627,7 +1193,7 @@ namespace NECRO
 			}
 			catch (const std::exception& ex)  // catches standard exceptions
 			{
-				LOG_ERROR("DBWorker Standard exception: {}", ex.what());
+				MLOG_ERROR(DATABASE, "DBWorker Standard exception: {}", ex.what());
 
 				if (IsDirectPersistentSessionAlive())
 				{
@@ -643,7 +1209,7 @@ namespace NECRO
 			}
 			catch (...)
 			{
-				LOG_ERROR("DBWorker Unknown exception caught!");
+				MLOG_ERROR(DATABASE, "DBWorker Unknown exception caught!");
 
 				try
 				{
@@ -3,20 +3,44 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <optional>
+#include <algorithm>
 
 #include "Logger.h"
 #include "FileLogger.h"
 #include "ConsoleLogger.h"
 
 #include "DatabaseWorker.h"
+#include "DBWorkerRouter.h"
 
 #include "LoginDatabase.h"
 #include "CharactersDatabase.h"
 
 namespace NECRO
 {
+// How often the elastic monitor samples the DBWorkers
+inline constexpr uint32_t DB_ELASTIC_CHECK_INTERVAL_MS = 1000;
+
+// Consecutive overloaded samples needed to add a DBWorker, so a single burst doesn't grow the pool
+inline constexpr uint32_t DB_ELASTIC_GROW_SAMPLES = 3;
+
+// Default thresholds, overridden by SetElasticThresholds
+inline constexpr size_t DB_ELASTIC_DEFAULT_GROW_QUEUE_DEPTH = 256;
+inline constexpr uint32_t DB_ELASTIC_DEFAULT_GROW_WAIT_MS = 200;
+inline constexpr uint32_t DB_ELASTIC_DEFAULT_SHRINK_IDLE_MS = 300000;
+
 //-------------------------------------------------------------------------------------------
 // Pool of DBWorkers used to split DBRequests across multiple threads.
+//
+// If Setup is given a maxN greater than n the pool is elastic: maxN DBWorkers are created,
+// n of them are started and a monitor thread starts more (up to maxN) while the queues stay
+// deep or requests wait too long, and stops the extra ones (closing their MySQL sessions)
+// after they've been idle for a while.
 //-------------------------------------------------------------------------------------------
 template<class T>
 class DatabaseWorkerPool
@@ -24,48 +48,310 @@ class DatabaseWorkerPool
 private:
 	std::vector<std::unique_ptr<DatabaseWorker<T>>> m_databases;
 
+	// Shared by all the DBWorkers, so that one MySQL outage is detected (and probed) once for the whole pool
+	DBCircuitBreaker m_circuitBreaker;
+
+	// Per-statement telemetry, shared by all the DBWorkers
+	DBStatementStats m_stats;
+
+	// Busy time of every DBWorker at the last ReportStats, to compute the utilization over the interval
+	std::vector<uint64_t>					m_lastBusyUs;
+	std::chrono::steady_clock::time_point	m_lastStatsReport;
+
+	// Round robin cursor for the requests that don't have an ordering key
+	std::atomic<size_t> m_nextWorker{ 0 };
+
+	// The first m_activeCount DBWorkers receive new requests, it only changes under the unique lock of m_resizeMutex
+	size_t				m_minWorkers = 0;
+	std::atomic<size_t> m_activeCount{ 0 };
+
+	// Enqueues take it shared, starting/stopping DBWorkers takes it unique
+	std::shared_mutex	m_resizeMutex;
+
+	// Set by Setup when maxN > n, only then m_activeCount can change
+	bool				m_elastic = false;
+
+	// Keys with requests in flight stay on the DBWorker they were routed to, even if m_activeCount changes in the meantime.
+	// Only used by elastic pools, a fixed-size pool always hashes a key to the same DBWorker.
+	DBWorkerRouter		m_router;
+
+	// Elastic monitor
+	std::thread					m_elasticThread;
+	std::mutex					m_elasticMutex;
+	std::condition_variable		m_elasticCond;
+	bool						m_elasticRunning = false;
+
+	size_t		m_growQueueDepth = DB_ELASTIC_DEFAULT_GROW_QUEUE_DEPTH;
+	uint32_t	m_growWaitMs = DB_ELASTIC_DEFAULT_GROW_WAIT_MS;
+	uint32_t	m_shrinkIdleMs = DB_ELASTIC_DEFAULT_SHRINK_IDLE_MS;
+
+	// ------------------------------------------------------------------------------
+	// Keyed requests are hashed to a stable DBWorker, so requests of the same key never
+	// run out of order on different workers. If the pool is elastic and pin is true the key stays
+	// on that DBWorker until all its requests are done (see ReleaseKey), so resizing the pool can't
+	// reorder them. A fixed-size pool skips the DBWorkerRouter entirely, the hash alone is stable.
+	// Unkeyed requests go to the least busy of two workers picked round robin, so we don't
+	// have to scan every worker on every enqueue.
+	//
+	// Must be called with m_resizeMutex held (shared)
+	// ------------------------------------------------------------------------------
+	size_t PickWorker(const DBRequest& req, bool pin)
+	{
+		const size_t n = m_activeCount.load(std::memory_order_relaxed);
+
+		if (req.m_orderingKey && !m_elastic)
+			return DBWorkerRouter::HashKey(*req.m_orderingKey, n);
+
+		if (req.m_orderingKey)
+			return m_router.RouteKey(*req.m_orderingKey, n, pin);
+
+		if (n <= 1)
+			return 0;
+
+		size_t a = m_nextWorker.fetch_add(1, std::memory_order_relaxed) % n;
+		size_t b = (a + 1) % n;
+		return m_databases[b]->GetRequestsSize() < m_databases[a]->GetRequestsSize() ? b : a;
+	}
+
+	// ------------------------------------------------------------------------------
+	// Called by the DBWorkers when a keyed request is done, only for elastic pools
+	// ------------------------------------------------------------------------------
+	void ReleaseKey(uint64_t key)
+	{
+		if (!m_elastic)
+			return;
+
+		m_router.ReleaseKey(key);
+	}
+
+	// ------------------------------------------------------------------------------
+	// Samples the active DBWorkers every DB_ELASTIC_CHECK_INTERVAL_MS, starts one more
+	// when they're overloaded and retires the last one when they've been idle for m_shrinkIdleMs
+	// ------------------------------------------------------------------------------
+	void ElasticRoutine()
+	{
+		uint32_t overloadedSamples = 0;
+		auto idleSince = std::chrono::steady_clock::now();
+
+		std::unique_lock<std::mutex> elasticLock(m_elasticMutex);
+		while (m_elasticRunning)
+		{
+			m_elasticCond.wait_for(elasticLock, std::chrono::milliseconds(DB_ELASTIC_CHECK_INTERVAL_MS));
+			if (!m_elasticRunning)
+				break;
+
+			elasticLock.unlock();
+
+			StopRetiringWorker();
+
+			const size_t active = m_activeCount.load(std::memory_order_relaxed);
+			size_t totalQueued = 0;
+			uint64_t oldestWaitMs = 0;
+			for (size_t i = 0; i < active; i++)
+			{
+				totalQueued += m_databases[i]->GetRequestsSize();
+				oldestWaitMs = std::max(oldestWaitMs, m_databases[i]->GetOldestQueuedWaitMs());
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			const bool overloaded = totalQueued / active >= m_growQueueDepth || oldestWaitMs >= m_growWaitMs;
+
+			overloadedSamples = overloaded ? overloadedSamples + 1 : 0;
+
+			// Half the grow thresholds count as load, so the pool doesn't flap around them
+			if (totalQueued / active >= m_growQueueDepth / 2 || oldestWaitMs >= m_growWaitMs / 2)
+				idleSince = now;
+
+			if (overloadedSamples >= DB_ELASTIC_GROW_SAMPLES && active < m_databases.size())
+			{
+				GrowWorker(totalQueued, oldestWaitMs);
+				overloadedSamples = 0;
+				idleSince = now;
+			}
+			else if (active > m_minWorkers && !m_router.GetRetiringWorker() && now - idleSince >= std::chrono::milliseconds(m_shrinkIdleMs))
+			{
+				RetireWorker();
+				idleSince = now;
+			}
+
+			elasticLock.lock();
+		}
+	}
+
+	void GrowWorker(size_t totalQueued, uint64_t oldestWaitMs)
+	{
+		std::unique_lock<std::shared_mutex> lock(m_resizeMutex);
+
+		const size_t index = m_activeCount.load(std::memory_order_relaxed);
+
+		// The worker we were retiring is still running, just take it back
+		if (!m_router.TakeBackRetiring(index) && m_databases[index]->Start() != 0)
+		{
+			MLOG_WARNING(DATABASE, "DatabaseWorkerPool could not start DBWorker '{}', MySQL may be not reachable.", index);
+			return;
+		}
+
+		m_activeCount.store(index + 1, std::memory_order_relaxed);
+		MLOG_INFO(DATABASE, "DatabaseWorkerPool grew to {} DBWorkers ({} queued requests, oldest waiting {}ms).", index + 1, totalQueued, oldestWaitMs);
+	}
+
+	void RetireWorker()
+	{
+		std::unique_lock<std::shared_mutex> lock(m_resizeMutex);
+
+		const size_t index = m_activeCount.load(std::memory_order_relaxed) - 1;
+		m_activeCount.store(index, std::memory_order_relaxed);
+		m_router.BeginRetiring(index);
+
+		MLOG_INFO(DATABASE, "DatabaseWorkerPool shrinking to {} DBWorkers.", index);
+	}
+
+	// ------------------------------------------------------------------------------
+	// The retiring DBWorker is stopped once DBWorkerRouter::CanStopRetiring says it's drained
+	// ------------------------------------------------------------------------------
+	void StopRetiringWorker()
+	{
+		if (!m_router.GetRetiringWorker())
+			return;
+
+		std::unique_lock<std::shared_mutex> lock(m_resizeMutex);
+
+		const size_t index = *m_router.GetRetiringWorker();
+		if (!m_router.CanStopRetiring(m_databases[index]->GetRequestsSize()))
+			return;
+
+		m_databases[index]->Stop();
+		m_databases[index]->Join();
+		m_router.OnRetiringStopped();
+	}
+
 public:
 
-	int Setup(int n, const std::string& URI)
+	// ------------------------------------------------------------------------------
+	// Creates max(n, maxN) DBWorkers, only the first n are started by Start
+	// ------------------------------------------------------------------------------
+	int Setup(int n, const std::string& URI, int maxN = -1)
 	{
-		for (int i = 0; i < n; i++)
+		const int total = std::max(n, maxN);
+		m_elastic = total > n;
+
+		for (int i = 0; i < total; i++)
 		{
 			m_databases.push_back(std::make_unique<DatabaseWorker<T>>());
+			m_databases[i]->SetCircuitBreaker(&m_circuitBreaker);
+
+			if (m_elastic)
+				m_databases[i]->SetOnKeyedRequestDone([this](uint64_t key) { ReleaseKey(key); });
+
+			m_databases[i]->SetStats(&m_stats);
 
 			if (m_databases[i]->Setup(URI) != 0)
 				return -1;
 		}
 
+		if (!m_databases.empty())
+			m_stats.Setup(m_databases[0]->GetStatements());
+
+		m_minWorkers = static_cast<size_t>(n);
+		m_router.Setup(total);
+		m_lastBusyUs.assign(total, 0);
+		m_lastStatsReport = std::chrono::steady_clock::now();
 		return 0;
 	}
 
+	// ------------------------------------------------------------------------------
+	// Sets when the elastic pool grows (average queued requests per DBWorker or wait of
+	// the oldest queued request) and after how long of low load it shrinks
+	// ------------------------------------------------------------------------------
+	void SetElasticThresholds(size_t growQueueDepth, uint32_t growWaitMs, uint32_t shrinkIdleMs)
+	{
+		m_growQueueDepth = growQueueDepth > 0 ? growQueueDepth : 1;
+		m_growWaitMs = growWaitMs > 0 ? growWaitMs : 1;
+		m_shrinkIdleMs = shrinkIdleMs;
+	}
+
 
-	int Start()
+	// ------------------------------------------------------------------------------
+	// Sets up the group commit of fire-and-forget requests on all the DBWorkers
+	// ------------------------------------------------------------------------------
+	void SetGroupCommit(size_t maxBatch, uint32_t maxDelayMs)
 	{
 		for (int i = 0; i < m_databases.size(); i++)
+			m_databases[i]->SetGroupCommit(maxBatch, maxDelayMs);
+	}
+
+	int Start()
+	{
+		for (size_t i = 0; i < m_minWorkers; i++)
 		{
 			if (m_databases[i]->Start() != 0)
 			{
-				LOG_ERROR("Error while starting a DatabaseWorkerPool! Databases could not start.");
+				MLOG_ERROR(DATABASE, "Error while starting a DatabaseWorkerPool! Databases could not start.");
 				return -1;
 			}
 		}
 
+		m_activeCount = m_minWorkers;
+
+		if (m_elastic)
+		{
+			m_elasticRunning = true;
+			m_elasticThread = std::thread(&DatabaseWorkerPool::ElasticRoutine, this);
+		}
+
 		return 0;
 	}
 
 	void Stop()
 	{
+		{
+			std::lock_guard<std::mutex> lock(m_elasticMutex);
+			m_elasticRunning = false;
+		}
+		m_elasticCond.notify_one();
+
+		if (m_elasticThread.joinable())
+			m_elasticThread.join();
+
+		std::unique_lock<std::shared_mutex> lock(m_resizeMutex);
 		for (int i = 0; i < m_databases.size(); i++)
 			m_databases[i]->Stop();
 	}
 
 	void Join()
 	{
+		std::unique_lock<std::shared_mutex> lock(m_resizeMutex);
 		for (int i = 0; i < m_databases.size(); i++)
 			m_databases[i]->Join();
 	}
 
+	// ------------------------------------------------------------------------------
+	// Logs the per-statement stats and the DBWorkers utilization since the last call
+	// and appends them to 'exposition' (Prometheus text format) for scraping
+	// ------------------------------------------------------------------------------
+	void ReportStats(const std::string& poolName, DBStatsExposition& exposition)
+	{
+		const auto now = std::chrono::steady_clock::now();
+		const uint64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastStatsReport).count();
+		m_lastStatsReport = now;
+
+		m_stats.Report(poolName, exposition);
+
+		for (size_t i = 0; i < m_databases.size(); i++)
+		{
+			const uint64_t busyUs = m_databases[i]->GetBusyUs();
+			const double utilization = elapsedUs > 0 ? static_cast<double>(busyUs - m_lastBusyUs[i]) / elapsedUs : 0.0;
+			m_lastBusyUs[i] = busyUs;
+
+			if (!m_databases[i]->IsRunning())
+				continue;
+
+			MLOG_INFO(DATABASE, "[DB STATS] {} DBWorker {} | utilization: {:.1f}% | queued: {}", poolName, i, utilization * 100.0, m_databases[i]->GetRequestsSize());
+			exposition.Add("necro_db_worker_utilization", "gauge", "{pool=\"" + poolName + "\",worker=\"" + std::to_string(i) + "\"} " + std::to_string(utilization));
+			exposition.Add("necro_db_worker_queued", "gauge", "{pool=\"" + poolName + "\",worker=\"" + std::to_string(i) + "\"} " + std::to_string(m_databases[i]->GetRequestsSize()));
+		}
+	}
+
 	void CloseDBs()
 	{
 		for (int i = 0; i < m_databases.size(); i++)
@@ -73,85 +359,68 @@ public:
 	}
 
 	// ------------------------------------------------------------------------------
-	// Tries to enqueue the DBRequest in the least-busy DBWorker thread
+	// Tries to enqueue the DBRequest in the DBWorker thread chosen by PickWorker
 	// ------------------------------------------------------------------------------
 	bool TryEnqueue(DBRequest&& dbRequest)
 	{
-		int leastBusyIndex = -1;
-		size_t curBest = SIZE_MAX;
+		std::shared_lock<std::shared_mutex> lock(m_resizeMutex);
 
-		for (int i = 0; i < m_databases.size(); i++)
-		{
-			size_t thisNum = m_databases[i]->GetRequestsSize();
-			if (thisNum < curBest)
-			{
-				curBest = thisNum;
-				leastBusyIndex = i;
-			}
-		}
+		std::optional<uint64_t> key = dbRequest.m_orderingKey;
+		if (m_databases[PickWorker(dbRequest, true)]->TryEnqueue(std::move(dbRequest)))
+			return true;
+
+		if (key)
+			ReleaseKey(*key);
 
-		return m_databases[leastBusyIndex]->TryEnqueue(std::move(dbRequest));
+		return false;
 	}
 
 	// ------------------------------------------------------------------------------
-	// Enqueus the DBRequest in the least-busy DBWorker thread
+	// Enqueus the DBRequest in the DBWorker thread chosen by PickWorker
 	// ------------------------------------------------------------------------------
 	void Enqueue(DBRequest&& dbRequest)
 	{
-		int leastBusyIndex = -1;
-		size_t curBest = SIZE_MAX;
-
-		for (int i = 0; i < m_databases.size(); i++)
-		{
-			size_t thisNum = m_databases[i]->GetRequestsSize();
-			if (thisNum < curBest)
-			{
-				curBest = thisNum;
-				leastBusyIndex = i;
-			}
-		}
-
-		m_databases[leastBusyIndex]->Enqueue(std::move(dbRequest));
+		std::shared_lock<std::shared_mutex> lock(m_resizeMutex);
+		m_databases[PickWorker(dbRequest, true)]->Enqueue(std::move(dbRequest));
 	}
 
 	std::vector<mysqlx::SqlResult> DirectExecute(const DBRequest& req)
 	{
-		int leastBusyIndex = -1;
-		size_t curBest = SIZE_MAX;
-
-		for (int i = 0; i < m_databases.size(); i++)
-		{
-			size_t thisNum = m_databases[i]->GetRequestsSize();
-			if (thisNum < curBest)
-			{
-				curBest = thisNum;
-				leastBusyIndex = i;
-			}
-		}
-
-		return m_databases[leastBusyIndex]->DirectExecute(std::move(req));
+		std::shared_lock<std::shared_mutex> lock(m_resizeMutex);
+		return m_databases[PickWorker(req, false)]->DirectExecute(req);
 	}
 
 
 	// ------------------------------------------------------------------------------
-	// Enqueus the DBRequest in every 
+	// Enqueus the DBRequest in every running DBWorker (broadcasts don't take part in key routing)
 	// ------------------------------------------------------------------------------
 	void EnqueueInAll(DBRequest&& toEnqueue)
 	{
+		std::shared_lock<std::shared_mutex> lock(m_resizeMutex);
+		toEnqueue.m_orderingKey.reset();
+
 		for (int i = 0; i < m_databases.size(); i++)
 		{
+			if (!m_databases[i]->IsRunning())
+				continue;
+
 			DBRequest copy(toEnqueue);
 			m_databases[i]->Enqueue(std::move(copy));
 		}
 	}
 
 	// ------------------------------------------------------------------------------
-	// Enqueus the DBRequest in every 
+	// Enqueus the DBRequest in every running DBWorker
 	// ------------------------------------------------------------------------------
 	void DirectExecuteInAll(DBRequest&& toEnqueue)
 	{
+		std::shared_lock<std::shared_mutex> lock(m_resizeMutex);
+
 		for (int i = 0; i < m_databases.size(); i++)
 		{
+			if (!m_databases[i]->IsRunning())
+				continue;
+
 			DBRequest copy(toEnqueue);
 			m_databases[i]->DirectExecute(std::move(copy));
 		}
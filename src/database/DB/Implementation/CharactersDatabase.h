@@ -19,7 +19,31 @@ namespace NECRO
 		CHAR_CHECK_BELONGS_TO_ACCOUNTID,
 		CHAR_DELETE_CHARACTER,
 		CHAR_SEL_BY_CHARID,
-		CHAR_SAVE_CHARACTER
+		CHAR_SAVE_CHARACTER,
+		CHAR_SAVE_CHARACTER_PROGRESS,	// only the CHARACTER_DIRTY_PROGRESS columns
+		CHAR_SAVE_CHARACTER_LOCATION,	// only the CHARACTER_DIRTY_LOCATION columns
+		CHAR_SEL_ALL_NAMES,				// startup load of the CharacterNameIndex
+		CHAR_INS_CHARACTER_IF_NAME_FREE,	// CHAR_INS_CHARACTER params, affects 0 rows if the name is taken (needs the UNIQUE key on name, see sql/CHARACTERS_NAME_UNIQUE.sql)
+		CHAR_SEL_NAME_UNIQUE_INDEX		// returns a row if the UNIQUE key on name exists
+	};
+
+	//-------------------------------------------------------
+	// Typed row of CHAR_SEL_ENUM and CHAR_SEL_BY_CHARID
+	//-------------------------------------------------------
+	struct CharacterRow
+	{
+		uint32_t	id = 0;			// CHAR_SEL_ENUM only
+		uint32_t	accountID = 0;	// CHAR_SEL_BY_CHARID only
+		std::string	name;
+		uint8_t		race = 0;
+		uint8_t		gameClass = 0;
+		uint8_t		gender = 0;
+		uint8_t		level = 0;
+		uint32_t	xp = 0;
+		uint32_t	zone = 0;
+		float		pos_x = 0.0f;
+		float		pos_y = 0.0f;
+		float		pos_z = 0.0f;
 	};
 
 	//-----------------------------------------------------------------------------------------------------
@@ -27,6 +51,22 @@ namespace NECRO
 	//-----------------------------------------------------------------------------------------------------
 	class CharactersDatabase : public Database
 	{
+	private:
+		// [name, race, class, gender, level, xp, zone, pos_x, pos_y, pos_z] starting at column 'first'
+		static void DecodeCharacterColumns(mysqlx::Row& row, int first, CharacterRow& r)
+		{
+			r.name		= row[first].get<std::string>();
+			r.race		= static_cast<uint8_t>(row[first + 1].get<int>());
+			r.gameClass	= static_cast<uint8_t>(row[first + 2].get<int>());
+			r.gender	= static_cast<uint8_t>(row[first + 3].get<int>());
+			r.level		= static_cast<uint8_t>(row[first + 4].get<int>());
+			r.xp		= row[first + 5].get<uint32_t>();
+			r.zone		= row[first + 6].get<uint32_t>();
+			r.pos_x		= row[first + 7].get<float>();
+			r.pos_y		= row[first + 8].get<float>();
+			r.pos_z		= row[first + 9].get<float>();
+		}
+
 	public:
 		int Init(const std::string& URI) override
 		{
@@ -43,6 +83,7 @@ namespace NECRO
 		void PrepareAllStatements() override
 		{
 			m_statementsMap.clear();
+			m_multiRowInserts.clear();
 
 			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::KEEP_ALIVE), ("SELECT 1"));
 			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_SEL_ENUM), ("SELECT id, name, race, class, gender, level, xp, zone, pos_x, pos_y, pos_z FROM necrochars.characters WHERE accountid = ?;"));
@@ -59,6 +100,35 @@ namespace NECRO
 			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_DELETE_CHARACTER), "DELETE FROM necrochars.characters WHERE id = ? AND name = ? AND accountid = ?");
 			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_SEL_BY_CHARID), ("SELECT accountid, name, race, class, gender, level, xp, zone, pos_x, pos_y, pos_z FROM necrochars.characters WHERE id = ?;"));
 			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_SAVE_CHARACTER), ("UPDATE necrochars.characters SET level = ?, xp = ?, zone = ?, pos_x = ?, pos_y = ?, pos_z = ? WHERE id = ?;"));
+			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_SAVE_CHARACTER_PROGRESS), ("UPDATE necrochars.characters SET level = ?, xp = ? WHERE id = ?;"));
+			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_SAVE_CHARACTER_LOCATION), ("UPDATE necrochars.characters SET zone = ?, pos_x = ?, pos_y = ?, pos_z = ? WHERE id = ?;"));
+			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_SEL_ALL_NAMES), ("SELECT name FROM necrochars.characters;"));
+
+			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_INS_CHARACTER_IF_NAME_FREE), "INSERT INTO necrochars.characters (accountid, name, race, class, gender, level, xp, zone, pos_x, pos_y, pos_z) "
+				"VALUES (?,?,?,?,?,?,?,?,?,?,?) ON DUPLICATE KEY UPDATE id = id");
+			PrepareStatement(static_cast<int>(CharactersDatabaseStatements::CHAR_SEL_NAME_UNIQUE_INDEX), ("SELECT 1 FROM information_schema.statistics WHERE table_schema = 'necrochars' "
+				"AND table_name = 'characters' AND index_name = 'name_UNIQUE' AND non_unique = 0 LIMIT 1;"));
+		}
+
+		//-----------------------------------------------------------------------------------------------------
+		// Row decoders, to be used with DBRequest::SetTypedCallback
+		//-----------------------------------------------------------------------------------------------------
+		// [id, name, race, class, gender, level, xp, zone, pos_x, pos_y, pos_z]
+		static CharacterRow DecodeCharacterEnumRow(mysqlx::Row& row)
+		{
+			CharacterRow r;
+			r.id = row[0].get<uint32_t>();
+			DecodeCharacterColumns(row, 1, r);
+			return r;
+		}
+
+		// [accountid, name, race, class, gender, level, xp, zone, pos_x, pos_y, pos_z]
+		static CharacterRow DecodeCharacterByIDRow(mysqlx::Row& row)
+		{
+			CharacterRow r;
+			r.accountID = row[0].get<uint32_t>();
+			DecodeCharacterColumns(row, 1, r);
+			return r;
 		}
 
 		int Close() override
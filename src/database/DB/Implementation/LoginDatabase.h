@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "Database.h"
 #include "DBConnection.h"
 
@@ -23,6 +25,16 @@ namespace NECRO
 		CREDENTIALS_CHECK			// Credentials check introduced after Proof of Work protocol change, selects the ID and the password
 	};
 
+	//-------------------------------------------------------
+	// Typed row of SEL_SESSIONKEY_BY_GREETCODE (authip is not decoded)
+	//-------------------------------------------------------
+	struct SessionKeyRow
+	{
+		uint32_t				userID = 0;
+		std::vector<uint8_t>	sessionKey;
+		uint32_t				startTime = 0;
+	};
+
 	//-----------------------------------------------------------------------------------------------------
 	// Wrapper for login database connection
 	//-----------------------------------------------------------------------------------------------------
@@ -44,6 +56,7 @@ namespace NECRO
 		void PrepareAllStatements() override
 		{
 			m_statementsMap.clear();
+			m_multiRowInserts.clear();
 
 			PrepareStatement(static_cast<int>(LoginDatabaseStatements::SEL_ACCOUNT_ID_BY_NAME), ("SELECT id FROM necroauth.users WHERE username = ?;"));
 			PrepareStatement(static_cast<int>(LoginDatabaseStatements::CHECK_PASSWORD), ("SELECT password FROM necroauth.users WHERE id = ?;"));
@@ -58,6 +71,22 @@ namespace NECRO
 			PrepareStatement(static_cast<int>(LoginDatabaseStatements::CREDENTIALS_CHECK), ("SELECT id, password FROM necroauth.users WHERE username = ?;"));
 		}
 
+		//-----------------------------------------------------------------------------------------------------
+		// Row decoders, to be used with DBRequest::SetTypedCallback
+		//-----------------------------------------------------------------------------------------------------
+		// [userid, sessionKey, starttime, authip]
+		static SessionKeyRow DecodeSessionKeyRow(mysqlx::Row& row)
+		{
+			SessionKeyRow r;
+			r.userID = row[0].get<uint32_t>();
+
+			mysqlx::bytes keyBytes = row[1].get<mysqlx::bytes>();
+			r.sessionKey.assign(keyBytes.begin(), keyBytes.end());
+
+			r.startTime = row[2].get<uint32_t>();
+			return r;
+		}
+
 		int Close() override
 		{
 			m_pool.Close();
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <array>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/crypto.h>
+
+#include "AES.h"
+
+namespace NECRO
+{
+	// --------------------------------------------------------------------------------------------------------------------------------
+	// Session key handoff: NECROAuth pushes every session it issues (greetcode -> accountID, session key) to the NECROWorld on the same
+	// host, so the world can accept the client without reading active_sessions back from MySQL.
+	//
+	// One message per UDP datagram on 127.0.0.1, authenticated with HMAC-SHA256 over a secret shared by the two configs.
+	// Message: [MAGIC (uint32) | ACCOUNT_ID (uint32) | ISSUED_AT (uint64, unix time) | GREETCODE (16) | SESSION_KEY (16) | HMAC (32)]
+	//
+	// Delivery is best-effort: a lost message just makes the world fall back to MySQL for that greetcode.
+	// --------------------------------------------------------------------------------------------------------------------------------
+	inline constexpr uint32_t SESSION_KEY_HANDOFF_MAGIC = 0x4B53454E; // "NESK"
+	inline constexpr size_t SESSION_KEY_HANDOFF_HMAC_SIZE = 32;
+	inline constexpr size_t SESSION_KEY_HANDOFF_PAYLOAD_SIZE = 4 + 4 + 8 + AES_128_KEY_SIZE + AES_128_KEY_SIZE;
+	inline constexpr size_t SESSION_KEY_HANDOFF_MESSAGE_SIZE = SESSION_KEY_HANDOFF_PAYLOAD_SIZE + SESSION_KEY_HANDOFF_HMAC_SIZE;
+
+	struct SessionKeyHandoffMessage
+	{
+		uint32_t								accountID = 0;
+		uint64_t								issuedAt = 0;
+		std::array<uint8_t, AES_128_KEY_SIZE>	greetCode{};
+		std::array<uint8_t, AES_128_KEY_SIZE>	sessionKey{};
+
+		void Serialize(const std::string& secret, uint8_t* out) const
+		{
+			uint8_t* p = out;
+			std::memcpy(p, &SESSION_KEY_HANDOFF_MAGIC, sizeof(SESSION_KEY_HANDOFF_MAGIC));	p += sizeof(SESSION_KEY_HANDOFF_MAGIC);
+			std::memcpy(p, &accountID, sizeof(accountID));									p += sizeof(accountID);
+			std::memcpy(p, &issuedAt, sizeof(issuedAt));									p += sizeof(issuedAt);
+			std::memcpy(p, greetCode.data(), greetCode.size());								p += greetCode.size();
+			std::memcpy(p, sessionKey.data(), sessionKey.size());							p += sessionKey.size();
+
+			Sign(secret, out, p);
+		}
+
+		// Returns false if the datagram is not a valid message signed with secret
+		bool Deserialize(const std::string& secret, const uint8_t* in, size_t size)
+		{
+			if (size != SESSION_KEY_HANDOFF_MESSAGE_SIZE)
+				return false;
+
+			uint32_t magic = 0;
+			std::memcpy(&magic, in, sizeof(magic));
+			if (magic != SESSION_KEY_HANDOFF_MAGIC)
+				return false;
+
+			uint8_t expected[SESSION_KEY_HANDOFF_HMAC_SIZE];
+			Sign(secret, in, expected);
+			if (CRYPTO_memcmp(expected, in + SESSION_KEY_HANDOFF_PAYLOAD_SIZE, SESSION_KEY_HANDOFF_HMAC_SIZE) != 0)
+				return false;
+
+			const uint8_t* p = in + sizeof(magic);
+			std::memcpy(&accountID, p, sizeof(accountID));			p += sizeof(accountID);
+			std::memcpy(&issuedAt, p, sizeof(issuedAt));			p += sizeof(issuedAt);
+			std::memcpy(greetCode.data(), p, greetCode.size());		p += greetCode.size();
+			std::memcpy(sessionKey.data(), p, sessionKey.size());
+			return true;
+		}
+
+	private:
+		// HMAC of the payload, written at out
+		static void Sign(const std::string& secret, const uint8_t* payload, uint8_t* out)
+		{
+			unsigned int len = 0;
+			HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()), payload, SESSION_KEY_HANDOFF_PAYLOAD_SIZE, out, &len);
+		}
+	};
+}
@@ -8,10 +8,17 @@
 
 namespace NECRO
 {
+// Column groups of a character that changed since its last save, only the dirty groups are written on the DB
+inline constexpr uint8_t CHARACTER_DIRTY_NONE       = 0x00;
+inline constexpr uint8_t CHARACTER_DIRTY_PROGRESS   = 0x01; // level, xp
+inline constexpr uint8_t CHARACTER_DIRTY_LOCATION   = 0x02; // zone, pos_x, pos_y, pos_z
+inline constexpr uint8_t CHARACTER_DIRTY_ALL        = CHARACTER_DIRTY_PROGRESS | CHARACTER_DIRTY_LOCATION;
+
 // Matches DB table structure necroauth.realmlist, parsed from CharacterDataOnWire
 struct CharacterData
 {
     uint32_t id;
+    uint32_t accountID = 0; // owner, used as DB ordering key. Not sent on the wire
 
     uint8_t characterNameLength;
     std::string characterName;
@@ -9,7 +9,7 @@
 
 namespace NECRO
 {
-	bool Config::Load(const std::string& filePath)
+	bool Config::Load(const std::string& filePath, bool printTable)
 	{
 		m_confMap.clear();
 
@@ -41,6 +41,9 @@ namespace NECRO
 			m_confMap.emplace(vName, vValue);
 		}
 
+		if (!printTable)
+			return true;
+
 		// Print it
 		LOG_INFO("CONFIG: Loaded {} - Printing Table:", filePath);
 		for (auto& v : m_confMap)
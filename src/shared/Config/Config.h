@@ -17,7 +17,8 @@ namespace NECRO
 			return conf;
 		}
 
-		bool			Load(const std::string& filePath);
+		// printTable logs every key, off for the reloads
+		bool			Load(const std::string& filePath, bool printTable = true);
 
 		int				GetInt(const std::string& key, int fallback);
 		float			GetFloat(const std::string& key, float fallback);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+
+#include "Config.h"
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+	// -----------------------------------------------------------------------------------------------------------------------------
+	// Setting that can change while the server is running (config hot reload). Get() is a relaxed atomic load, so it can be read
+	// from any thread on every use instead of being copied at startup.
+	//
+	// Load() reads it from a Config: a missing key keeps the current value, a value that is not a number or is out of [min, max]
+	// is rejected (logged, the current value is kept).
+	// -----------------------------------------------------------------------------------------------------------------------------
+	template<typename T>
+	class LiveSetting
+	{
+		static_assert(std::is_integral_v<T>, "LiveSetting only supports integral and bool settings");
+
+	private:
+		std::atomic<T>	m_value;
+		const char*		m_key;
+		T				m_min;
+		T				m_max;
+
+	public:
+		LiveSetting(const char* key, T defaultValue, T min, T max) : m_value(defaultValue), m_key(key), m_min(min), m_max(max)
+		{
+		}
+
+		T Get() const
+		{
+			return m_value.load(std::memory_order_relaxed);
+		}
+
+		const char* GetKey() const
+		{
+			return m_key;
+		}
+
+		// False if the value in conf was rejected. logChanges is set on reloads, to trace what was tuned
+		bool Load(Config& conf, bool logChanges)
+		{
+			T cur = Get();
+			T value = cur;
+
+			if constexpr (std::is_same_v<T, bool>)
+				value = conf.GetBool(m_key, cur);
+			else
+			{
+				int64_t raw = 0;
+				try
+				{
+					raw = conf.GetInt(m_key, static_cast<int>(cur));
+				}
+				catch (const std::exception&)
+				{
+					LOG_WARNING("Setting {} is not a number, keeping {}.", m_key, cur);
+					return false;
+				}
+
+				if (raw < static_cast<int64_t>(m_min) || raw > static_cast<int64_t>(m_max))
+				{
+					LOG_WARNING("Setting {} = {} is out of range [{}, {}], keeping {}.", m_key, raw, m_min, m_max, cur);
+					return false;
+				}
+
+				value = static_cast<T>(raw);
+			}
+
+			if (value != cur)
+			{
+				m_value.store(value, std::memory_order_relaxed);
+
+				if (logChanges)
+					LOG_OK("Setting {} changed: {} -> {}.", m_key, cur, value);
+			}
+
+			return true;
+		}
+	};
+
+	// Log levels setting ("111111"), levels holds the current ones and is only changed if the value is valid
+	inline bool LoadLogLevels(Config& conf, const char* key, Logger::LogLevels& levels)
+	{
+		std::string str = conf.GetString(key, levels.to_string());
+		if (!Logger::ParseLevels(str, levels))
+		{
+			LOG_WARNING("Setting {} = {} is not a valid log levels mask, keeping {}.", key, str, levels.to_string());
+			return false;
+		}
+
+		return true;
+	}
+}
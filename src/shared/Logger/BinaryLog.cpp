@@ -0,0 +1,515 @@
+#include "BinaryLog.h"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+#include <fmt/args.h>
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+    BinaryLog::ThreadBufferOwner::~ThreadBufferOwner()
+    {
+        if (!buffer)
+            return;
+
+        // The thread is exiting, what it logged goes to the file now and the flush thread forgets the buffer
+        std::lock_guard<std::mutex> lock(buffer->m_mutex);
+        if (!buffer->m_data.empty())
+            BinaryLog::Instance().FlushBuffer(*buffer);
+
+        buffer->m_orphaned = true;
+    }
+
+    BinaryLog::~BinaryLog()
+    {
+        StopFlushThread();
+
+        // The thread_local buffers are gone already, only the file is left to close
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_enabled.store(false, std::memory_order_release);
+
+        if (m_file)
+        {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    bool BinaryLog::Open(const std::string& path, uint32_t flushIntervalMs)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (m_file)
+            return true;
+
+        m_file = std::fopen(path.c_str(), "ab");
+        if (!m_file)
+            return false;
+
+        m_path = path;
+        m_flushIntervalMs = flushIntervalMs > 0 ? flushIntervalMs : 1;
+
+        // Every file (and every append to it) starts with the header, Decode skips the repeated ones
+        uint32_t header[2] = { FILE_MAGIC, FILE_VERSION };
+        std::fwrite(header, sizeof(header), 1, m_file);
+
+        // Sites registered while recording to a previous file
+        for (size_t i = 0; i < m_sites.size(); i++)
+            WriteSite(static_cast<uint32_t>(i + 1), m_sites[i]);
+
+        m_generation++;
+        m_enabled.store(true, std::memory_order_release);
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> flushLock(m_flushMutex);
+            m_flushRunning = true;
+        }
+        m_flushThread = std::thread(&BinaryLog::FlushRoutine, this);
+        return true;
+    }
+
+    void BinaryLog::Close()
+    {
+        if (!m_enabled.load(std::memory_order_acquire))
+            return;
+
+        StopFlushThread();
+
+        std::vector<uint8_t> spare;
+        FlushAllBuffers(spare);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_enabled.store(false, std::memory_order_release);
+
+        if (m_file)
+        {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    uint32_t BinaryLog::RegisterSite(Site& site, uint8_t level, const char* file, int line, std::string_view format, std::initializer_list<BinaryLogArgType> args)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Another thread got here first
+        uint32_t id = site.id.load(std::memory_order_relaxed);
+        if (id != 0)
+            return id;
+
+        SiteInfo info;
+        info.level = level;
+        info.line = static_cast<uint32_t>(line);
+        info.file = file ? file : "";
+        info.format.assign(format.data(), format.size());
+        info.args.assign(args.begin(), args.end());
+
+        m_sites.push_back(std::move(info));
+        id = static_cast<uint32_t>(m_sites.size());
+
+        // Written right away, before any event of this site can reach the file
+        if (m_file)
+            WriteSite(id, m_sites.back());
+
+        site.id.store(id, std::memory_order_release);
+        return id;
+    }
+
+    void BinaryLog::WriteSite(uint32_t id, const SiteInfo& info)
+    {
+        ThreadBuffer record;
+
+        record.Append(static_cast<uint8_t>(RecordKind::SITE));
+        record.Append(id);
+        record.Append(info.level);
+        record.Append(info.line);
+        record.AppendString(info.file);
+        record.AppendString(info.format);
+        record.Append(static_cast<uint8_t>(info.args.size()));
+        for (BinaryLogArgType type : info.args)
+            record.Append(type);
+
+        std::fwrite(record.m_data.data(), 1, record.m_data.size(), m_file);
+        record.m_data.clear();
+    }
+
+    BinaryLog::ThreadBuffer& BinaryLog::GetThreadBuffer()
+    {
+        thread_local ThreadBufferOwner owner;
+
+        if (!owner.buffer)
+        {
+            owner.buffer = std::make_shared<ThreadBuffer>();
+            owner.buffer->m_data.reserve(BUFFER_FLUSH_SIZE + 1024);
+
+            std::lock_guard<std::mutex> lock(m_buffersMutex);
+            m_buffers.push_back(owner.buffer);
+        }
+
+        return *owner.buffer;
+    }
+
+    // Called with the buffer locked, returns where the new event starts
+    size_t BinaryLog::BeginEvent(ThreadBuffer& buffer)
+    {
+        uint32_t generation = m_generation.load(std::memory_order_acquire);
+        if (buffer.m_generation != generation)
+        {
+            // Logged for a file that's closed now
+            buffer.m_data.clear();
+            buffer.m_generation = generation;
+        }
+
+        return buffer.m_data.size();
+    }
+
+    // Called with the buffer locked
+    void BinaryLog::EndEvent(ThreadBuffer& buffer, size_t eventStart)
+    {
+        constexpr size_t headerSize = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint16_t);
+
+        size_t argsSize = buffer.m_data.size() - eventStart - headerSize;
+        if (argsSize > UINT16_MAX)
+        {
+            buffer.m_data.resize(eventStart);
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        uint16_t size = static_cast<uint16_t>(argsSize);
+        std::memcpy(buffer.m_data.data() + eventStart + headerSize - sizeof(uint16_t), &size, sizeof(uint16_t));
+
+        // The flush interval is up to the flush thread
+        if (buffer.m_data.size() >= BUFFER_FLUSH_SIZE)
+            FlushBuffer(buffer);
+    }
+
+    // Called with the buffer locked
+    void BinaryLog::FlushBuffer(ThreadBuffer& buffer)
+    {
+        WriteRecords(buffer.m_data, buffer.m_generation);
+        buffer.m_data.clear();
+    }
+
+    void BinaryLog::WriteRecords(const std::vector<uint8_t>& data, uint32_t generation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_file && generation == m_generation.load(std::memory_order_relaxed))
+        {
+            std::fwrite(data.data(), 1, data.size(), m_file);
+            std::fflush(m_file);
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------
+    // Writes every buffer each m_flushIntervalMs, the logging threads only write theirs when it's full
+    // ------------------------------------------------------------------------------------------------------------------
+    void BinaryLog::FlushRoutine()
+    {
+        std::vector<uint8_t> spare;
+        spare.reserve(BUFFER_FLUSH_SIZE + 1024);
+
+        std::unique_lock<std::mutex> lock(m_flushMutex);
+        while (m_flushRunning)
+        {
+            m_flushCond.wait_for(lock, std::chrono::milliseconds(m_flushIntervalMs));
+            if (!m_flushRunning)
+                break;
+
+            lock.unlock();
+            FlushAllBuffers(spare);
+            lock.lock();
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------
+    // Each buffer is swapped with the empty spare under its lock and written after, so the owner thread only waits
+    // for the swap. The buffers of the exited threads are dropped.
+    // ------------------------------------------------------------------------------------------------------------------
+    void BinaryLog::FlushAllBuffers(std::vector<uint8_t>& spare)
+    {
+        std::lock_guard<std::mutex> buffersLock(m_buffersMutex);
+
+        for (auto it = m_buffers.begin(); it != m_buffers.end();)
+        {
+            ThreadBuffer& buffer = **it;
+            uint32_t generation = 0;
+            bool orphaned = false;
+
+            {
+                std::lock_guard<std::mutex> lock(buffer.m_mutex);
+                if (!buffer.m_data.empty())
+                    buffer.m_data.swap(spare);
+
+                generation = buffer.m_generation;
+                orphaned = buffer.m_orphaned;
+            }
+
+            if (!spare.empty())
+            {
+                WriteRecords(spare, generation);
+                spare.clear();
+            }
+
+            it = orphaned ? m_buffers.erase(it) : it + 1;
+        }
+    }
+
+    void BinaryLog::StopFlushThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_flushMutex);
+            m_flushRunning = false;
+        }
+        m_flushCond.notify_one();
+
+        if (m_flushThread.joinable())
+            m_flushThread.join();
+    }
+
+    // ------------------------------------------------------------------------------------------------------------------
+    // Offline decoding
+    // ------------------------------------------------------------------------------------------------------------------
+    namespace
+    {
+        class BinaryLogCursor
+        {
+        private:
+            const uint8_t*  m_data;
+            size_t          m_size;
+            size_t          m_pos = 0;
+            bool            m_failed = false;
+
+        public:
+            BinaryLogCursor(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+            template<typename T>
+            T Read()
+            {
+                T v{};
+                if (m_pos + sizeof(T) > m_size)
+                {
+                    m_failed = true;
+                    m_pos = m_size;
+                    return v;
+                }
+
+                std::memcpy(&v, m_data + m_pos, sizeof(T));
+                m_pos += sizeof(T);
+                return v;
+            }
+
+            std::string ReadString()
+            {
+                uint16_t len = Read<uint16_t>();
+                if (m_pos + len > m_size)
+                {
+                    m_failed = true;
+                    m_pos = m_size;
+                    return {};
+                }
+
+                std::string s(reinterpret_cast<const char*>(m_data + m_pos), len);
+                m_pos += len;
+                return s;
+            }
+
+            void Skip(size_t n)
+            {
+                m_pos = std::min(m_pos + n, m_size);
+            }
+
+            size_t GetPos() const { return m_pos; }
+            bool AtEnd() const { return m_pos >= m_size; }
+            bool HasFailed() const { return m_failed; }
+        };
+
+        struct DecodedSite
+        {
+            uint8_t                         level = 0;
+            uint32_t                        line = 0;
+            std::string                     file;
+            std::string                     format;
+            std::vector<BinaryLogArgType>   args;
+        };
+
+        struct DecodedEvent
+        {
+            uint32_t    site;
+            uint64_t    timeNs;
+            size_t      argsPos;
+            uint16_t    argsSize;
+        };
+
+        // The decoded text may go to stdout, the messages of Decode go to stderr so they don't end up in it
+        template<typename... Args>
+        void DecodeMessage(fmt::format_string<Args...> format, Args&&... args)
+        {
+            std::cerr << fmt::format(format, std::forward<Args>(args)...) << '\n';
+        }
+    }
+
+    int BinaryLog::Decode(const std::string& inPath, std::ostream& out)
+    {
+        std::ifstream in(inPath, std::ios::binary);
+        if (!in.is_open())
+        {
+            DecodeMessage("Could not open the binary log '{}'.", inPath);
+            return -1;
+        }
+
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        std::unordered_map<uint32_t, DecodedSite> sites;
+        std::vector<DecodedEvent> events;
+
+        BinaryLogCursor cursor(data.data(), data.size());
+        if (cursor.Read<uint32_t>() != FILE_MAGIC || cursor.Read<uint32_t>() != FILE_VERSION)
+        {
+            DecodeMessage("'{}' is not a binary log (or its version is not supported).", inPath);
+            return -2;
+        }
+
+        // Pass 1: sites and events, a truncated last record (crash) is ignored
+        while (!cursor.AtEnd())
+        {
+            size_t recordStart = cursor.GetPos();
+            uint8_t kind = cursor.Read<uint8_t>();
+
+            if (kind == static_cast<uint8_t>(RecordKind::SITE))
+            {
+                uint32_t id = cursor.Read<uint32_t>();
+
+                DecodedSite site;
+                site.level = cursor.Read<uint8_t>();
+                site.line = cursor.Read<uint32_t>();
+                site.file = cursor.ReadString();
+                site.format = cursor.ReadString();
+
+                uint8_t count = cursor.Read<uint8_t>();
+                for (uint8_t i = 0; i < count; i++)
+                    site.args.push_back(cursor.Read<BinaryLogArgType>());
+
+                if (!cursor.HasFailed())
+                    sites[id] = std::move(site);
+            }
+            else if (kind == static_cast<uint8_t>(RecordKind::EVENT))
+            {
+                DecodedEvent e;
+                e.site = cursor.Read<uint32_t>();
+                e.timeNs = cursor.Read<uint64_t>();
+                e.argsSize = cursor.Read<uint16_t>();
+                e.argsPos = cursor.GetPos();
+                cursor.Skip(e.argsSize);
+
+                if (!cursor.HasFailed() && e.argsPos + e.argsSize <= data.size())
+                    events.push_back(e);
+            }
+            else if (kind == (FILE_MAGIC & 0xFF))
+            {
+                // Header of a following Open on the same file
+                cursor.Skip(sizeof(uint32_t) * 2 - 1);
+            }
+            else
+            {
+                DecodeMessage("Binary log '{}' has an unknown record at offset {}, the rest is skipped.", inPath, recordStart);
+                break;
+            }
+
+            if (cursor.HasFailed())
+            {
+                DecodeMessage("Binary log '{}' ends with a truncated record at offset {}.", inPath, recordStart);
+                break;
+            }
+        }
+
+        // Threads write their buffers one after the other
+        std::stable_sort(events.begin(), events.end(), [](const DecodedEvent& a, const DecodedEvent& b) { return a.timeNs < b.timeNs; });
+
+        // Pass 2: format
+        size_t unknownSites = 0;
+        for (const DecodedEvent& e : events)
+        {
+            auto it = sites.find(e.site);
+            if (it == sites.end())
+            {
+                unknownSites++;
+                continue;
+            }
+
+            const DecodedSite& site = it->second;
+
+            fmt::dynamic_format_arg_store<fmt::format_context> store;
+            BinaryLogCursor args(data.data() + e.argsPos, e.argsSize);
+
+            for (BinaryLogArgType type : site.args)
+            {
+                switch (type)
+                {
+                    case BinaryLogArgType::INT:
+                        store.push_back(args.Read<int64_t>());
+                        break;
+
+                    case BinaryLogArgType::UINT:
+                        store.push_back(args.Read<uint64_t>());
+                        break;
+
+                    case BinaryLogArgType::FLOAT:
+                        store.push_back(args.Read<float>());
+                        break;
+
+                    case BinaryLogArgType::DOUBLE:
+                        store.push_back(args.Read<double>());
+                        break;
+
+                    case BinaryLogArgType::BOOL:
+                        store.push_back(args.Read<uint8_t>() != 0);
+                        break;
+
+                    case BinaryLogArgType::CHAR:
+                        store.push_back(args.Read<char>());
+                        break;
+
+                    default:
+                        store.push_back(args.ReadString());
+                        break;
+                }
+            }
+
+            std::string message;
+            try
+            {
+                message = fmt::vformat(site.format, store);
+            }
+            catch (const std::exception& ex)
+            {
+                message = fmt::format("{} (could not be formatted: {})", site.format, ex.what());
+            }
+
+            // "YYYY-MM-DD HH:MM:SS.uuuuuu"
+            std::time_t seconds = static_cast<std::time_t>(e.timeNs / 1000000000ull);
+            std::tm bt = Utility::localtime_xp(seconds);
+            char stamp[64];
+            size_t stampLen = std::strftime(stamp, sizeof(stamp), "%F %T", &bt);
+
+            out << "[" << std::string_view(stamp, stampLen) << "." << fmt::format("{:06}", (e.timeNs / 1000) % 1000000) << "] "
+                << "[" << Logger::GetLogLevelStr(static_cast<Logger::LogLevel>(site.level)) << "] "
+                << "[" << site.file << ":" << site.line << "] " << message << '\n';
+        }
+
+        out.flush();
+
+        if (unknownSites > 0)
+            DecodeMessage("Binary log '{}': {} events of unknown sites were skipped.", inPath, unknownSites);
+
+        DecodeMessage("Decoded {} events ({} sites) of '{}'.", events.size() - unknownSites, sites.size(), inPath);
+        return 0;
+    }
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
+#include <type_traits>
+#include <ostream>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+
+#define FMT_HEADER_ONLY
+#include <fmt/core.h>
+
+namespace NECRO
+{
+    // Type of an argument of a binary log event, decided at compile time by the type given to the LOG macro
+    enum class BinaryLogArgType : uint8_t
+    {
+        INT = 0,    // int64
+        UINT,       // uint64
+        FLOAT,
+        DOUBLE,
+        BOOL,
+        CHAR,
+        STRING      // uint16 length + bytes, types that aren't listed here are formatted with "{}" on the caller
+    };
+
+    template<typename T>
+    constexpr BinaryLogArgType BinaryLogArgTypeOf()
+    {
+        using D = std::decay_t<T>;
+
+        if constexpr (std::is_same_v<D, bool>)
+            return BinaryLogArgType::BOOL;
+        else if constexpr (std::is_same_v<D, char>)
+            return BinaryLogArgType::CHAR;
+        else if constexpr (std::is_integral_v<D>)
+            return std::is_signed_v<D> ? BinaryLogArgType::INT : BinaryLogArgType::UINT;
+        else if constexpr (std::is_same_v<D, float>)
+            return BinaryLogArgType::FLOAT;
+        else if constexpr (std::is_floating_point_v<D>)
+            return BinaryLogArgType::DOUBLE;
+        else
+            return BinaryLogArgType::STRING;
+    }
+
+    //---------------------------------------------------------------------------
+    // Binary deferred-format log.
+    //
+    // When it's open, the lines that would go to the FileLogger are recorded as
+    // [site ID | time | raw arguments] in a buffer of the calling thread, no
+    // formatting and no I/O. Each LOG call site registers once (format string,
+    // file, line, level and argument types written to the file as a SITE record).
+    // The buffer is written to the file by its thread when it's full or when the
+    // thread exits, and by the flush thread every flushIntervalMs, so what a quiet
+    // thread logged doesn't wait for its next log.
+    //
+    // The file is decoded offline with Decode (NECROWorld --decode-log <file>).
+    // Records are in the native byte order.
+    //---------------------------------------------------------------------------
+    class BinaryLog
+    {
+    public:
+        static constexpr uint32_t   FILE_MAGIC = 0x474C424E; // "NBLG"
+        static constexpr uint32_t   FILE_VERSION = 1;
+        static constexpr size_t     BUFFER_FLUSH_SIZE = 64 * 1024;
+        static constexpr size_t     MAX_STRING_ARG_SIZE = 4096;
+
+        enum class RecordKind : uint8_t
+        {
+            SITE = 1,   // u32 id, u8 level, u32 line, u16+file, u16+format, u8 count, count * BinaryLogArgType
+            EVENT       // u32 site id, u64 ns since epoch, u16 size, arguments
+        };
+
+        // One per LOG call site (static), 0 until it's registered
+        struct Site
+        {
+            std::atomic<uint32_t> id{ 0 };
+        };
+
+    private:
+        struct SiteInfo
+        {
+            uint8_t                         level = 0;
+            uint32_t                        line = 0;
+            std::string                     file;
+            std::string                     format;
+            std::vector<BinaryLogArgType>   args;
+        };
+
+        class ThreadBuffer
+        {
+        public:
+            std::mutex              m_mutex;            // the owner thread and the flush thread
+            std::vector<uint8_t>    m_data;
+            uint32_t                m_generation = 0;
+            bool                    m_orphaned = false; // the owner thread exited
+
+            template<typename T>
+            void Append(const T& v)
+            {
+                size_t pos = m_data.size();
+                m_data.resize(pos + sizeof(T));
+                std::memcpy(m_data.data() + pos, &v, sizeof(T));
+            }
+
+            void AppendString(std::string_view s)
+            {
+                uint16_t len = static_cast<uint16_t>(s.size() < MAX_STRING_ARG_SIZE ? s.size() : MAX_STRING_ARG_SIZE);
+                Append(len);
+                m_data.insert(m_data.end(), s.data(), s.data() + len);
+            }
+
+            template<typename T>
+            void WriteArg(const T& v)
+            {
+                using D = std::decay_t<T>;
+                constexpr BinaryLogArgType type = BinaryLogArgTypeOf<T>();
+
+                if constexpr (type == BinaryLogArgType::INT)
+                    Append(static_cast<int64_t>(v));
+                else if constexpr (type == BinaryLogArgType::UINT)
+                    Append(static_cast<uint64_t>(v));
+                else if constexpr (type == BinaryLogArgType::FLOAT || type == BinaryLogArgType::DOUBLE || type == BinaryLogArgType::CHAR)
+                    Append(v);
+                else if constexpr (type == BinaryLogArgType::BOOL)
+                    Append(static_cast<uint8_t>(v ? 1 : 0));
+                else if constexpr (std::is_convertible_v<const D&, std::string_view>)
+                    AppendString(std::string_view(v));
+                else
+                    AppendString(fmt::format("{}", v));
+            }
+        };
+
+        // Held by the thread_local of each logging thread, writes its buffer when the thread exits
+        struct ThreadBufferOwner
+        {
+            std::shared_ptr<ThreadBuffer> buffer;
+
+            ~ThreadBufferOwner();
+        };
+
+        // Lock order: m_buffersMutex, ThreadBuffer::m_mutex, m_mutex
+        std::mutex              m_mutex;        // file and sites
+        std::FILE*              m_file = nullptr;
+        std::string             m_path;
+        std::vector<SiteInfo>   m_sites;        // by id - 1, kept across Open/Close so a new file gets them all again
+
+        std::atomic<bool>       m_enabled{ false };
+        std::atomic<uint32_t>   m_generation{ 0 };  // bumped on every Open, buffers of a previous file are discarded
+        uint32_t                m_flushIntervalMs = 1000;
+
+        std::mutex                                  m_buffersMutex; // only taken to register a new thread and by the flush thread
+        std::vector<std::shared_ptr<ThreadBuffer>>  m_buffers;
+
+        // Flush thread
+        std::thread                 m_flushThread;
+        std::mutex                  m_flushMutex;
+        std::condition_variable     m_flushCond;
+        bool                        m_flushRunning = false;
+
+        std::atomic<uint64_t>   m_dropped{ 0 };
+
+        uint32_t        RegisterSite(Site& site, uint8_t level, const char* file, int line, std::string_view format, std::initializer_list<BinaryLogArgType> args);
+        void            WriteSite(uint32_t id, const SiteInfo& info);
+        ThreadBuffer&   GetThreadBuffer();
+        size_t          BeginEvent(ThreadBuffer& buffer);
+        void            EndEvent(ThreadBuffer& buffer, size_t eventStart);
+        void            FlushBuffer(ThreadBuffer& buffer);
+        void            WriteRecords(const std::vector<uint8_t>& data, uint32_t generation);
+        void            FlushRoutine();
+        void            FlushAllBuffers(std::vector<uint8_t>& spare);
+        void            StopFlushThread();
+
+    public:
+        static BinaryLog& Instance()
+        {
+            static BinaryLog instance;
+            return instance;
+        }
+
+        ~BinaryLog();
+
+        // Starts recording to path (appends), false if it can't be opened
+        bool Open(const std::string& path, uint32_t flushIntervalMs);
+
+        // Stops the flush thread, writes the buffers of all the threads and closes the file
+        void Close();
+
+        static bool IsEnabled()
+        {
+            return Instance().m_enabled.load(std::memory_order_relaxed);
+        }
+
+        uint64_t GetDroppedCount() const
+        {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+
+        // format was checked against the arguments by the LOG macro already
+        template<typename... Args>
+        static void Record(Site& site, uint8_t level, const char* file, int line, fmt::string_view format, const Args&... args)
+        {
+            BinaryLog& log = Instance();
+
+            uint32_t id = site.id.load(std::memory_order_acquire);
+            if (id == 0)
+                id = log.RegisterSite(site, level, file, line, std::string_view(format.data(), format.size()), { BinaryLogArgTypeOf<Args>()... });
+
+            uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+            ThreadBuffer& buffer = log.GetThreadBuffer();
+            std::lock_guard<std::mutex> lock(buffer.m_mutex);
+            size_t eventStart = log.BeginEvent(buffer);
+
+            buffer.Append(static_cast<uint8_t>(RecordKind::EVENT));
+            buffer.Append(id);
+            buffer.Append(now);
+            buffer.Append(static_cast<uint16_t>(0)); // size, set by EndEvent
+            (buffer.WriteArg(args), ...);
+
+            log.EndEvent(buffer, eventStart);
+        }
+
+        // Writes the text of the binary log at inPath (same lines as the FileLogger, with microseconds), in time order.
+        // Its own messages (errors, summary) go to stderr
+        static int Decode(const std::string& inPath, std::ostream& out);
+    };
+}
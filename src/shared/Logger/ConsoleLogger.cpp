@@ -1,5 +1,4 @@
 #include "ConsoleLogger.h"
-#include <cstdarg>
 
 namespace NECRO
 {
@@ -30,32 +29,25 @@ namespace NECRO
         }
     }
 
-    void ConsoleLogger::Log(const std::string& message, Logger::LogLevel lvl, const char* file, int line, ...)
+    void ConsoleLogger::Write(const std::string& timestamp, Logger::LogLevel lvl, const char* file, int line, const std::string& message)
     {
-        // Prepare to handle variadic arguments
-        va_list args;
-        va_start(args, line); // 'line' is the last argument before variadic ones
-
-        // lock_guard will automatically release the mutex as soon as it is destroyed
-        std::lock_guard<std::mutex> guard(m_logMutex);
-
-        // Get timestamp
-        std::string nowTimestamp = Utility::time_stamp();
-
         // Get color
         std::string colorCode = GetColor(lvl);
 
         // Get level
         std::string lvlStr = GetLogLevelStr(lvl);
 
-        std::cout << colorCode << "[" << nowTimestamp << "] " << "[" << lvlStr << "]";
+        std::cout << colorCode << "[" << timestamp << "] " << "[" << lvlStr << "]";
 
         if (file != nullptr)
             std::cout << " [" << file << ":" << line << "]";
 
         // Print the formatted message
-        std::cout << " " << message << "\033[0m" << std::endl;
+        std::cout << " " << message << "\033[0m" << '\n';
+    }
 
-        va_end(args);
+    void ConsoleLogger::Flush()
+    {
+        std::cout.flush();
     }
 }
@@ -6,6 +6,10 @@ namespace NECRO
 {
 	class ConsoleLogger : public Logger
 	{
+	protected:
+		virtual void Write(const std::string& timestamp, Logger::LogLevel lvl, const char* file, int line, const std::string& message) override;
+		virtual void Flush() override;
+
 	public:
 		static ConsoleLogger& Instance()
 		{
@@ -14,8 +18,6 @@ namespace NECRO
 		}
 
 		std::string GetColor(LogLevel lvl);
-
-		virtual void Log(const std::string& message, Logger::LogLevel lvl, const char* file, int line, ...) override;
 	};
 
 }
@@ -1,7 +1,6 @@
 #include "FileLogger.h"
 
 #include <string>
-#include <cstdarg>
 
 namespace NECRO
 {
@@ -26,35 +25,30 @@ namespace NECRO
     }
 
 
-    void FileLogger::Log(const std::string& message, Logger::LogLevel lvl, const char* file, int line, ...)
+    void FileLogger::Write(const std::string& timestamp, Logger::LogLevel lvl, const char* file, int line, const std::string& message)
     {
-        // Prepare to handle variadic arguments
-        va_list args;
-        va_start(args, line); // 'line' is the last argument before variadic ones
-
-        std::lock_guard<std::mutex> guard(m_logMutex);
-
         if (!m_logFile.is_open())
         {
             std::cerr << "Attempt to log to an unopened file." << std::endl;
             return;
         }
 
-        // Get timestamp
-        std::string nowTimestamp = Utility::time_stamp();
-
         // Get level
         std::string levelStr = GetLogLevelStr(lvl);
 
         // Format and write the log message
-        m_logFile << "[" << nowTimestamp << "] " << "[" << levelStr << "] ";
+        m_logFile << "[" << timestamp << "] " << "[" << levelStr << "] ";
 
         if (file != nullptr)
             m_logFile << "[" << file << ":" << line << "] ";
 
         // Write the formatted message
-        m_logFile << message << std::endl;
+        m_logFile << message << '\n';
+    }
 
-        va_end(args);
+    void FileLogger::Flush()
+    {
+        if (m_logFile.is_open())
+            m_logFile.flush();
     }
 }
@@ -13,6 +13,10 @@ namespace NECRO
 
 		std::ofstream m_logFile;
 
+	protected:
+		virtual void Write(const std::string& timestamp, Logger::LogLevel lvl, const char* file, int line, const std::string& message) override;
+		virtual void Flush() override;
+
 	public:
 		static FileLogger& Instance()
 		{
@@ -24,7 +28,5 @@ namespace NECRO
 		FileLogger(const std::string& filePath);
 
 		~FileLogger();
-
-		virtual void Log(const std::string& message, Logger::LogLevel lvl, const char* file, int line, ...) override;
 	};
 }
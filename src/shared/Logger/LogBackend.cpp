@@ -0,0 +1,244 @@
+#include "LogBackend.h"
+
+#include <algorithm>
+#include <ctime>
+
+namespace NECRO
+{
+    // Records taken from a single ring per pass, so a flooding thread can't starve the others
+    static constexpr size_t LOG_BACKEND_MAX_BATCH_PER_RING = 1024;
+
+    LogBackend::~LogBackend()
+    {
+        Stop();
+    }
+
+    void LogBackend::Start(size_t ringCapacity, LogOverflowPolicy policy, uint32_t flushIntervalMs)
+    {
+        if (IsRunning())
+            return;
+
+        m_ringCapacity = std::max<size_t>(ringCapacity, 2);
+        m_policy = policy;
+        m_flushIntervalMs = flushIntervalMs;
+        m_stopRequested = false;
+
+        // Rings of a previous run are not reused, threads register a new one on their next log
+        m_generation++;
+
+        m_thread = std::thread(&LogBackend::Run, this);
+        m_running.store(true, std::memory_order_release);
+    }
+
+    void LogBackend::Stop()
+    {
+        if (!IsRunning())
+            return;
+
+        // New logs go back to the synchronous path. The pushes that already saw the backend running are waited out while
+        // the thread is still draining (a BLOCK push needs it), then it writes what's left and exits
+        m_running.store(false);
+        while (m_pushesInFlight.load() != 0)
+            std::this_thread::yield();
+
+        m_stopRequested.store(true, std::memory_order_release);
+
+        if (m_thread.joinable())
+            m_thread.join();
+
+        // Whatever was pushed after its last pass
+        Drain();
+        FlushSinks();
+
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        m_rings.clear();
+    }
+
+    LogRing* LogBackend::GetThreadRing()
+    {
+        struct ThreadRing
+        {
+            std::shared_ptr<LogRing>    ring;
+            uint32_t                    generation = 0;
+
+            ~ThreadRing()
+            {
+                if (ring)
+                    ring->m_orphaned.store(true, std::memory_order_release);
+            }
+        };
+
+        thread_local ThreadRing threadRing;
+
+        uint32_t generation = m_generation.load(std::memory_order_acquire);
+        if (!threadRing.ring || threadRing.generation != generation)
+        {
+            if (threadRing.ring)
+                threadRing.ring->m_orphaned.store(true, std::memory_order_release);
+
+            threadRing.ring = std::make_shared<LogRing>(m_ringCapacity);
+            threadRing.generation = generation;
+
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            m_rings.push_back(threadRing.ring);
+        }
+
+        return threadRing.ring.get();
+    }
+
+    bool LogBackend::Push(LogRecord&& record)
+    {
+        // Counted before checking m_running (both seq_cst, as in Stop): either Stop waits for this push or the push sees it stopping
+        struct InFlight
+        {
+            std::atomic<uint32_t>& count;
+            explicit InFlight(std::atomic<uint32_t>& c) : count(c) { count.fetch_add(1); }
+            ~InFlight() { count.fetch_sub(1); }
+        } inFlight(m_pushesInFlight);
+
+        if (!m_running.load())
+            return false;
+
+        LogRing* ring = GetThreadRing();
+
+        if (ring->TryPush(std::move(record)))
+            return true;
+
+        if (m_policy == LogOverflowPolicy::DROP)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // BLOCK: wait for the backend to make room (TryPush only moves the record when it succeeds).
+        // The thread keeps draining until Stop has waited out this push
+        m_blocked.fetch_add(1, std::memory_order_relaxed);
+        while (!ring->TryPush(std::move(record)))
+            std::this_thread::yield();
+
+        return true;
+    }
+
+    void LogBackend::Run()
+    {
+        using namespace std::chrono;
+
+        steady_clock::time_point lastFlush = steady_clock::now();
+
+        while (true)
+        {
+            bool stopping = m_stopRequested.load(std::memory_order_acquire);
+
+            size_t written = Drain();
+
+            steady_clock::time_point now = steady_clock::now();
+            if (now - lastFlush >= milliseconds(m_flushIntervalMs))
+            {
+                FlushSinks();
+                lastFlush = now;
+            }
+
+            if (written == 0)
+            {
+                if (stopping)
+                    break;
+
+                std::this_thread::sleep_for(milliseconds(1));
+            }
+        }
+
+        FlushSinks();
+    }
+
+    size_t LogBackend::Drain()
+    {
+        m_batch.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            for (auto it = m_rings.begin(); it != m_rings.end();)
+            {
+                LogRing& ring = **it;
+
+                LogRecord record;
+                size_t popped = 0;
+                while (popped < LOG_BACKEND_MAX_BATCH_PER_RING && ring.TryPop(record))
+                {
+                    m_batch.push_back(std::move(record));
+                    popped++;
+                }
+
+                // The thread exited and everything it logged was taken
+                if (ring.m_orphaned.load(std::memory_order_acquire) && ring.IsEmpty())
+                    it = m_rings.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        // Drops are reported on every sink that logged in this batch
+        uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != m_droppedReported && !m_batch.empty())
+        {
+            std::vector<Logger*> sinks;
+            for (const LogRecord& r : m_batch)
+                if (std::find(sinks.begin(), sinks.end(), r.sink) == sinks.end())
+                    sinks.push_back(r.sink);
+
+            for (Logger* sink : sinks)
+            {
+                LogRecord warning;
+                warning.sink = sink;
+                warning.level = Logger::LogLevel::LOG_LEVEL_WARNING;
+                warning.time = std::chrono::system_clock::now();
+                warning.message = fmt::format("LogBackend: {} log records dropped (ring full), {} in total.", dropped - m_droppedReported, dropped);
+                m_batch.push_back(std::move(warning));
+            }
+
+            m_droppedReported = dropped;
+        }
+
+        // Rings are drained one after the other, keep the lines in time order
+        std::stable_sort(m_batch.begin(), m_batch.end(), [](const LogRecord& a, const LogRecord& b) { return a.time < b.time; });
+
+        for (const LogRecord& r : m_batch)
+        {
+            {
+                // Only contended while Stop() hands the sink back to the synchronous path
+                std::lock_guard<std::mutex> guard(r.sink->m_logMutex);
+                r.sink->Write(TimeStamp(r.time), r.level, r.file, r.line, r.message);
+            }
+
+            if (std::find(m_dirtySinks.begin(), m_dirtySinks.end(), r.sink) == m_dirtySinks.end())
+                m_dirtySinks.push_back(r.sink);
+        }
+
+        return m_batch.size();
+    }
+
+    void LogBackend::FlushSinks()
+    {
+        for (Logger* sink : m_dirtySinks)
+        {
+            std::lock_guard<std::mutex> guard(sink->m_logMutex);
+            sink->Flush();
+        }
+
+        m_dirtySinks.clear();
+    }
+
+    const std::string& LogBackend::TimeStamp(std::chrono::system_clock::time_point time)
+    {
+        // "YYYY-MM-DD HH:MM:SS", built once per second
+        std::time_t t = std::chrono::system_clock::to_time_t(time);
+        if (t != m_lastStampSecond || m_lastStamp.empty())
+        {
+            std::tm bt = Utility::localtime_xp(t);
+            char buf[64];
+            m_lastStamp.assign(buf, std::strftime(buf, sizeof(buf), "%F %T", &bt));
+            m_lastStampSecond = t;
+        }
+
+        return m_lastStamp;
+    }
+}
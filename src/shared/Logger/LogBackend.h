@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <ctime>
+
+#include "Logger.h"
+
+namespace NECRO
+{
+    // A log line as captured on the calling thread, timestamped and written by the LogBackend thread
+    struct LogRecord
+    {
+        Logger*                                 sink = nullptr;
+        Logger::LogLevel                        level = Logger::LogLevel::LOG_LEVEL_INFO;
+        const char*                             file = nullptr; // __FILE__, static storage
+        int                                     line = 0;
+        std::chrono::system_clock::time_point   time;
+        std::string                             message;
+    };
+
+    // What a thread does when its ring is full
+    enum class LogOverflowPolicy
+    {
+        DROP = 0,   // the record is discarded and counted
+        BLOCK       // the thread waits for the backend to make room
+    };
+
+    //---------------------------------------------------------------------------
+    // Single producer, single consumer ring of LogRecords. One per logging thread,
+    // the LogBackend thread is the only consumer.
+    //---------------------------------------------------------------------------
+    class LogRing
+    {
+    private:
+        std::vector<LogRecord>  m_slots;
+        size_t                  m_mask;
+
+        alignas(64) std::atomic<size_t> m_head{ 0 };    // next slot to pop, written by the consumer
+        alignas(64) std::atomic<size_t> m_tail{ 0 };    // next slot to push, written by the producer
+
+    public:
+        std::atomic<bool> m_orphaned{ false };          // the producer thread exited
+
+        // capacity is rounded up to a power of 2
+        explicit LogRing(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+
+            m_slots.resize(size);
+            m_mask = size - 1;
+        }
+
+        bool TryPush(LogRecord&& record)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+                return false;
+
+            m_slots[tail & m_mask] = std::move(record);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPop(LogRecord& out)
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire))
+                return false;
+
+            out = std::move(m_slots[head & m_mask]);
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool IsEmpty() const
+        {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+    };
+
+    //---------------------------------------------------------------------------
+    // Asynchronous logging backend.
+    //
+    // Once started, Logger::Log pushes the already formatted message into the
+    // ring of the calling thread (no locks, no I/O) and this thread timestamps,
+    // writes them in batches and flushes the sinks every flushIntervalMs.
+    // When it's not running, the Loggers write synchronously as before.
+    //---------------------------------------------------------------------------
+    class LogBackend
+    {
+    private:
+        std::mutex                              m_ringsMutex;   // only taken to register a new thread and to drop the exited ones
+        std::vector<std::shared_ptr<LogRing>>   m_rings;
+
+        std::thread             m_thread;
+        std::atomic<bool>       m_running{ false };
+        std::atomic<bool>       m_stopRequested{ false };
+        std::atomic<uint32_t>   m_generation{ 0 };              // bumped on every Start, threads re-register their ring
+        std::atomic<uint32_t>   m_pushesInFlight{ 0 };          // Stop waits for them before the final Drain
+
+        size_t                  m_ringCapacity = 8192;
+        LogOverflowPolicy       m_policy = LogOverflowPolicy::DROP;
+        uint32_t                m_flushIntervalMs = 1000;
+
+        std::atomic<uint64_t>   m_dropped{ 0 };
+        std::atomic<uint64_t>   m_blocked{ 0 };
+        uint64_t                m_droppedReported = 0;
+
+        // Backend thread state
+        std::vector<LogRecord>  m_batch;
+        std::vector<Logger*>    m_dirtySinks;
+        std::time_t             m_lastStampSecond = 0;
+        std::string             m_lastStamp;
+
+        LogRing*    GetThreadRing();
+        void        Run();
+        size_t      Drain();
+        void        FlushSinks();
+        const std::string& TimeStamp(std::chrono::system_clock::time_point time);
+
+    public:
+        static LogBackend& Instance()
+        {
+            static LogBackend instance;
+            return instance;
+        }
+
+        ~LogBackend();
+
+        void Start(size_t ringCapacity, LogOverflowPolicy policy, uint32_t flushIntervalMs);
+
+        // Writes everything that was logged so far and stops the thread, logs are synchronous again afterwards
+        void Stop();
+
+        bool IsRunning() const
+        {
+            return m_running.load(std::memory_order_acquire);
+        }
+
+        // Called by Logger::Log. False if the backend is not running (anymore), the record is left untouched and the
+        // caller writes it synchronously. A record dropped by a full ring returns true, see GetDroppedCount
+        bool Push(LogRecord&& record);
+
+        uint64_t GetDroppedCount() const
+        {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+
+        uint64_t GetBlockedCount() const
+        {
+            return m_blocked.load(std::memory_order_relaxed);
+        }
+    };
+}
@@ -1,4 +1,5 @@
 #include "Logger.h"
+#include "LogBackend.h"
 
 namespace NECRO
 {
@@ -28,4 +29,30 @@ namespace NECRO
             return "DEFAULT";
         }
     }
+
+    void Logger::Log(std::string message, LogLevel level, const char* file, int line, ...)
+    {
+        LogBackend& backend = LogBackend::Instance();
+        if (backend.IsRunning())
+        {
+            LogRecord record;
+            record.sink = this;
+            record.level = level;
+            record.file = file;
+            record.line = line;
+            record.time = std::chrono::system_clock::now();
+            record.message = std::move(message);
+
+            if (backend.Push(std::move(record)))
+                return;
+
+            // Stopped in the meantime, Push left the record untouched
+            message = std::move(record.message);
+        }
+
+        // lock_guard will automatically release the mutex as soon as it is destroyed
+        std::lock_guard<std::mutex> guard(m_logMutex);
+        Write(Utility::time_stamp(), level, file, line, message);
+        Flush();
+    }
 }
\ No newline at end of file
@@ -1,15 +1,28 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <mutex>
 #include <bitset>
+#include <atomic>
 
 #define FMT_HEADER_ONLY
 #include <fmt/core.h>
 #include <fmt/format.h>
 
 #include "Utility.h"
+#include "BinaryLog.h"
+
+// Levels compiled in, one bit per LogLevel (INFO is bit 0, as in the ConsoleLoggingLevel setting). The calls of a level that
+// is not compiled in are removed, their arguments are never evaluated.
+// Every level is compiled in by default, release builds included, so DEBUG can be turned on at runtime (i.e. to capture it in
+// the BinaryLog) with the Loggers and module levels. Builds that never need it can define this as 0x3D to strip DEBUG
+#ifndef NECRO_LOG_COMPILED_LEVELS
+    #define NECRO_LOG_COMPILED_LEVELS 0x3F
+#endif
+
+#define NECRO_LOG_LEVEL_COMPILED(level) (((NECRO_LOG_COMPILED_LEVELS) >> static_cast<int>(level)) & 1)
 
 namespace NECRO
 {
@@ -18,6 +31,8 @@ namespace NECRO
     //---------------------------------------------------------------------------
     class Logger
     {
+        friend class LogBackend;
+
     public:
         enum class LogLevel
         {
@@ -30,43 +45,156 @@ namespace NECRO
             LAST_VALUE // used to have the size of this enum
         };
 
+        // Modules can have their own runtime levels on top of the Loggers ones (i.e. NetworkLoggingLevel)
+        enum class LogModule
+        {
+            GENERAL = 0,
+            NETWORK,
+            DATABASE,
+            WORLD,
+            NDB,
+            LAST_VALUE
+        };
+
+    private:
+        // Bit set = level disabled for the module, so that the zero-initialized default has everything enabled
+        inline static std::atomic<uint32_t> s_moduleDisabledLevels[static_cast<int>(LogModule::LAST_VALUE)];
+
     protected:
         // Protects concurrent logs from multiple threads
         std::mutex m_logMutex;
 
-        std::string GetLogLevelStr(LogLevel level);
+
+        // Writes a single line, called with m_logMutex held (by Log or by the LogBackend thread)
+        virtual void Write(const std::string& timestamp, LogLevel level, const char* file, int line, const std::string& message) = 0;
+        virtual void Flush() = 0;
 
     public:
-        // TODO if we want to enable/disable logs or log levels while the servers are up and running, we need to protect these with an std::atomic
-        bool m_logEnabled = true;
+        using LogLevels = std::bitset<static_cast<int>(LogLevel::LAST_VALUE)>;
+
+        // Atomics, they can be changed by a config reload while the servers are up and running
+        std::atomic<bool> m_logEnabled{ true };
+
+        // Bitflag to enable/disable log levels, all enabled by default
+        std::atomic<uint32_t> m_logEnabledLevels{ (1u << static_cast<int>(LogLevel::LAST_VALUE)) - 1 };
+
+        virtual ~Logger() = default;
 
-        // Bitflag to enable/disable log levels
-        std::bitset<static_cast<int>(LogLevel::LAST_VALUE)> m_logEnabledSet = std::bitset<static_cast<int>(LogLevel::LAST_VALUE)>().set(); // Initialize to all 1
+        // Hands the line to the LogBackend if it's running, otherwise writes and flushes it right away.
+        // Taken by value, so the formatted message is moved into the LogRecord
+        virtual void Log(std::string message, LogLevel level, const char* file, int line, ...);
 
-        virtual void Log(const std::string& message, LogLevel level, const char* file, int line, ...) = 0;
+        static std::string GetLogLevelStr(LogLevel level);
+
+        bool IsEnabled(LogLevel level) const
+        {
+            return m_logEnabled.load(std::memory_order_relaxed) && (m_logEnabledLevels.load(std::memory_order_relaxed) & (1u << static_cast<int>(level)));
+        }
+
+        LogLevels GetEnabledLevels() const
+        {
+            return LogLevels(m_logEnabledLevels.load(std::memory_order_relaxed));
+        }
+
+        void SetEnabledLevels(const LogLevels& levels)
+        {
+            m_logEnabledLevels.store(static_cast<uint32_t>(levels.to_ulong()), std::memory_order_relaxed);
+        }
+
+        // "111111" (CRITICAL first, as in the config files), false if str is not made of LAST_VALUE '0'/'1'
+        static bool ParseLevels(const std::string& str, LogLevels& out)
+        {
+            if (str.size() != out.size() || str.find_first_not_of("01") != std::string::npos)
+                return false;
+
+            out = LogLevels(str);
+            return true;
+        }
+
+        static bool IsModuleEnabled(LogModule module, LogLevel level)
+        {
+            return !(s_moduleDisabledLevels[static_cast<int>(module)].load(std::memory_order_relaxed) & (1u << static_cast<int>(level)));
+        }
+
+        static LogLevels GetModuleLevels(LogModule module)
+        {
+            return ~LogLevels(s_moduleDisabledLevels[static_cast<int>(module)].load(std::memory_order_relaxed));
+        }
+
+        static void SetModuleLevels(LogModule module, const LogLevels& levels)
+        {
+            s_moduleDisabledLevels[static_cast<int>(module)].store(static_cast<uint32_t>((~levels).to_ulong()), std::memory_order_relaxed);
+        }
 
         template<typename... Args>
         void LogFmt(LogLevel level, const char* file, int line, fmt::format_string<Args...> fmtStr, Args&&... args)
         {
-            if (!m_logEnabled || !m_logEnabledSet[static_cast<int>(level)])
+            if (!IsEnabled(level))
                 return;
 
+            Log(fmt::format(fmtStr, std::forward<Args>(args)...), level, file, line);
+        }
+
+        // Formats the message once and hands it to both Loggers, either can be null.
+        // While the BinaryLog is open, the file line is recorded there instead (not formatted)
+        template<typename... Args>
+        static void LogFmtTo(Logger* console, Logger* file, BinaryLog::Site& site, LogLevel level, const char* srcFile, int line, fmt::format_string<Args...> fmtStr, Args&&... args)
+        {
+            if (file && BinaryLog::IsEnabled())
+            {
+                BinaryLog::Record(site, static_cast<uint8_t>(level), srcFile, line, fmtStr, args...);
+
+                file = nullptr;
+                if (!console)
+                    return;
+            }
+
             std::string message = fmt::format(fmtStr, std::forward<Args>(args)...);
-            Log(message, level, file, line);
+
+            // The last Logger takes the message
+            if (console)
+                console->Log(file ? message : std::move(message), level, srcFile, line);
+
+            if (file)
+                file->Log(std::move(message), level, srcFile, line);
         }
 
         #define cLog ConsoleLogger::Instance()
         #define fLog FileLogger::Instance()
 
-        #define LOG_FMT(logger, level, ...) (logger).LogFmt(level, __FILE__, __LINE__, __VA_ARGS__)
+        // Every check happens before the arguments are evaluated: compile-time level, module level, then the Loggers' levels
+        #define LOG_FMT(logger, level, ...) do { if constexpr (NECRO_LOG_LEVEL_COMPILED(level)) { if ((logger).IsEnabled(level)) (logger).LogFmt(level, __FILE__, __LINE__, __VA_ARGS__); } } while(0)
+
+        #define MLOG_FMT(module, level, message, ...) do { \
+            if constexpr (NECRO_LOG_LEVEL_COMPILED(level)) \
+            { \
+                if (Logger::IsModuleEnabled(module, level)) \
+                { \
+                    Logger* necroLogConsole = cLog.IsEnabled(level) ? &cLog : nullptr; \
+                    Logger* necroLogFile = fLog.IsEnabled(level) ? &fLog : nullptr; \
+                    if (necroLogConsole || necroLogFile) \
+                    { \
+                        static BinaryLog::Site necroLogSite; \
+                        Logger::LogFmtTo(necroLogConsole, necroLogFile, necroLogSite, level, __FILE__, __LINE__, message, ##__VA_ARGS__); \
+                    } \
+                } \
+            } } while(0)
 
         // LOG uses the default Loggers instances, cLog and fLog (consoleLog, fileLog), by default logging on the console will also log on the file
-        #define LOG_INFO(message, ...) do {LOG_FMT(cLog, Logger::LogLevel::LOG_LEVEL_INFO, message, ##__VA_ARGS__); LOG_FMT(fLog, Logger::LogLevel::LOG_LEVEL_INFO, message, ##__VA_ARGS__);} while(0)
-        #define LOG_OK(message, ...) do {LOG_FMT(cLog, Logger::LogLevel::LOG_LEVEL_OKSTATUS, message, ##__VA_ARGS__); LOG_FMT(fLog, Logger::LogLevel::LOG_LEVEL_OKSTATUS, message, ##__VA_ARGS__);} while(0)
-        #define LOG_DEBUG(message, ...) do {LOG_FMT(cLog, Logger::LogLevel::LOG_LEVEL_DEBUG, message, ##__VA_ARGS__); LOG_FMT(fLog, Logger::LogLevel::LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);} while(0)
-        #define LOG_WARNING(message, ...) do{LOG_FMT(cLog, Logger::LogLevel::LOG_LEVEL_WARNING, message, ##__VA_ARGS__); LOG_FMT(fLog, Logger::LogLevel::LOG_LEVEL_WARNING, message, ##__VA_ARGS__);} while(0)
-        #define LOG_ERROR(message, ...) do {LOG_FMT(cLog, Logger::LogLevel::LOG_LEVEL_ERROR, message, ##__VA_ARGS__); LOG_FMT(fLog, Logger::LogLevel::LOG_LEVEL_ERROR, message, ##__VA_ARGS__);} while(0)
-        #define LOG_CRITICAL(message, ...) do {LOG_FMT(cLog, Logger::LogLevel::LOG_LEVEL_CRITICAL, message, ##__VA_ARGS__); LOG_FMT(fLog, Logger::LogLevel::LOG_LEVEL_CRITICAL, message, ##__VA_ARGS__);} while(0)
+        #define LOG_INFO(message, ...) MLOG_FMT(Logger::LogModule::GENERAL, Logger::LogLevel::LOG_LEVEL_INFO, message, ##__VA_ARGS__)
+        #define LOG_OK(message, ...) MLOG_FMT(Logger::LogModule::GENERAL, Logger::LogLevel::LOG_LEVEL_OKSTATUS, message, ##__VA_ARGS__)
+        #define LOG_DEBUG(message, ...) MLOG_FMT(Logger::LogModule::GENERAL, Logger::LogLevel::LOG_LEVEL_DEBUG, message, ##__VA_ARGS__)
+        #define LOG_WARNING(message, ...) MLOG_FMT(Logger::LogModule::GENERAL, Logger::LogLevel::LOG_LEVEL_WARNING, message, ##__VA_ARGS__)
+        #define LOG_ERROR(message, ...) MLOG_FMT(Logger::LogModule::GENERAL, Logger::LogLevel::LOG_LEVEL_ERROR, message, ##__VA_ARGS__)
+        #define LOG_CRITICAL(message, ...) MLOG_FMT(Logger::LogModule::GENERAL, Logger::LogLevel::LOG_LEVEL_CRITICAL, message, ##__VA_ARGS__)
+
+        // M(ODULE) Log, same as LOG but filtered by the runtime levels of the module too. i.e. MLOG_DEBUG(NETWORK, "...")
+        #define MLOG_INFO(module, message, ...) MLOG_FMT(Logger::LogModule::module, Logger::LogLevel::LOG_LEVEL_INFO, message, ##__VA_ARGS__)
+        #define MLOG_OK(module, message, ...) MLOG_FMT(Logger::LogModule::module, Logger::LogLevel::LOG_LEVEL_OKSTATUS, message, ##__VA_ARGS__)
+        #define MLOG_DEBUG(module, message, ...) MLOG_FMT(Logger::LogModule::module, Logger::LogLevel::LOG_LEVEL_DEBUG, message, ##__VA_ARGS__)
+        #define MLOG_WARNING(module, message, ...) MLOG_FMT(Logger::LogModule::module, Logger::LogLevel::LOG_LEVEL_WARNING, message, ##__VA_ARGS__)
+        #define MLOG_ERROR(module, message, ...) MLOG_FMT(Logger::LogModule::module, Logger::LogLevel::LOG_LEVEL_ERROR, message, ##__VA_ARGS__)
+        #define MLOG_CRITICAL(module, message, ...) MLOG_FMT(Logger::LogModule::module, Logger::LogLevel::LOG_LEVEL_CRITICAL, message, ##__VA_ARGS__)
 
         // S(PECIFIC) Log, allows to call log on a specific Logger object, may be useful for Daily loggers
         #define SLOG(logger, level, message, ...) (logger).Log(message, level, __FILE__, __LINE__, ##__VA_ARGS__)
@@ -0,0 +1,199 @@
+#include "MapCollisionGrid.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <unordered_set>
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+	// Returns the value of a 'key = value;' line
+	static std::string GetLineValue(const std::string& line)
+	{
+		size_t start = line.find('=');
+		if (start == std::string::npos)
+			return "";
+
+		std::string val = line.substr(start + 1, line.find(';') - start - 1);
+		val.erase(0, val.find_first_not_of(" \t"));
+		val.erase(val.find_last_not_of(" \t\r") + 1);
+		return val;
+	}
+
+	// Reads the IDs of the tiles that have a collider from a tiledef (.ntdef).
+	// Per-Tile data: ID, ZOffset, CollEnabled, CollOffsetX, ColOffsetY, CollWidth, CollHeight, OcclusionEnabled, OcclOffX, OcclOffY, zCellModifier
+	static bool LoadTileColliders(const std::string& path, std::unordered_set<int>& outColliders)
+	{
+		std::ifstream file(path);
+		if (!file.is_open())
+		{
+			LOG_ERROR("Could not load tiledef at: '{}'.", path);
+			return false;
+		}
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			// Strip comments
+			line = line.substr(0, line.find('#'));
+
+			if (line.find("ENDTILESETS") != std::string::npos)
+				break;
+
+			// Skip 'key = value;' lines, END markers and empty lines
+			if (line.find('=') != std::string::npos || line.find("END") != std::string::npos || line.find(',') == std::string::npos)
+				continue;
+
+			std::stringstream ss(line);
+			std::string id, zOffset, collEnabled;
+			if (std::getline(ss, id, ',') && std::getline(ss, zOffset, ',') && std::getline(ss, collEnabled, ','))
+			{
+				if (std::atoi(collEnabled.c_str()) != 0)
+					outColliders.insert(std::atoi(id.c_str()));
+			}
+		}
+
+		return true;
+	}
+
+	bool MapCollisionGrid::LoadFromFile(const std::string& mapFileName)
+	{
+		const std::string path = MAPFILES_DIRECTORY + mapFileName;
+
+		std::ifstream file(path);
+		if (!file.is_open())
+		{
+			LOG_ERROR("Could not load mapfile at: '{}'.", path);
+			return false;
+		}
+
+		std::string line;
+		std::string tiledefName;
+
+		// Header
+		int width = 0, height = 0, nLayers = 0;
+		while (std::getline(file, line))
+		{
+			if (line.find("tiledefName") != std::string::npos)
+				tiledefName = GetLineValue(line);
+			else if (line.find("width") != std::string::npos)
+				width = std::atoi(GetLineValue(line).c_str());
+			else if (line.find("height") != std::string::npos)
+				height = std::atoi(GetLineValue(line).c_str());
+			else if (line.find("nLayers") != std::string::npos)
+				nLayers = std::atoi(GetLineValue(line).c_str());
+			else if (line.find("layer") != std::string::npos)
+				break; // first layer starts
+		}
+
+		if (width <= 0 || height <= 0 || nLayers <= 0)
+		{
+			LOG_ERROR("Mapfile '{}' has an invalid header (width: '{}', height: '{}', nLayers: '{}').", path, width, height, nLayers);
+			return false;
+		}
+
+		std::unordered_set<int> colliders;
+		if (!LoadTileColliders(TILEDEFS_DIRECTORY + tiledefName, colliders))
+			return false;
+
+		m_width = width;
+		m_height = height;
+		m_nLayers = nLayers;
+
+		const size_t words = (static_cast<size_t>(width) * height + 63) / 64;
+		m_walkable.assign(nLayers, std::vector<uint64_t>(words, 0));
+		m_blocking.assign(nLayers, std::vector<uint64_t>(words, 0));
+
+		// Layers, 'line' is 'layer0:'
+		for (int layer = 0; layer < nLayers; layer++)
+		{
+			std::getline(file, line); // {
+
+			for (int y = 0; y < height; y++)
+			{
+				if (!std::getline(file, line))
+				{
+					LOG_ERROR("Mapfile '{}' is truncated at layer '{}', row '{}'.", path, layer, y);
+					m_nLayers = 0;
+					return false;
+				}
+
+				std::stringstream ss(line);
+				std::string val;
+				for (int x = 0; x < width && std::getline(ss, val, ','); x++)
+				{
+					int tileID = std::atoi(val.c_str());
+					if (tileID == 0) // empty
+						continue;
+
+					if (colliders.find(tileID) != colliders.end())
+						SetBit(m_blocking, layer, x, y);
+					else
+						SetBit(m_walkable, layer, x, y);
+				}
+			}
+
+			std::getline(file, line); // };
+			std::getline(file, line); // next 'layerX:' or 'PrefabList'
+		}
+
+		return true;
+	}
+
+	bool MapCollisionGrid::IsBoxBlocked(int layer, int minX, int minY, int maxX, int maxY) const
+	{
+		for (int y = minY; y <= maxY; y++)
+			for (int x = minX; x <= maxX; x++)
+				if (IsBlocking(layer, x, y))
+					return true;
+
+		return false;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------------------------
+	// Walks all the cells touched by the segment (Bresenham). The starting cell is skipped by default, so that an entity
+	// that is already inside of a blocking cell (for example, after changing layer) is still allowed to walk out of it.
+	// -----------------------------------------------------------------------------------------------------------------------------
+	bool MapCollisionGrid::IsLineBlocked(int layer, int fromX, int fromY, int toX, int toY, bool includeStart) const
+	{
+		int dx = std::abs(toX - fromX);
+		int dy = -std::abs(toY - fromY);
+		int sx = fromX < toX ? 1 : -1;
+		int sy = fromY < toY ? 1 : -1;
+		int err = dx + dy;
+
+		int x = fromX;
+		int y = fromY;
+
+		if (includeStart && IsBlocking(layer, x, y))
+			return true;
+
+		while (x != toX || y != toY)
+		{
+			int e2 = 2 * err;
+
+			// Diagonal step, don't allow to squeeze between two blocking cells
+			if (e2 >= dy && e2 <= dx && IsBlocking(layer, x + sx, y) && IsBlocking(layer, x, y + sy))
+				return true;
+
+			if (e2 >= dy)
+			{
+				err += dy;
+				x += sx;
+			}
+			if (e2 <= dx)
+			{
+				err += dx;
+				y += sy;
+			}
+
+			if (IsBlocking(layer, x, y))
+				return true;
+		}
+
+		return false;
+	}
+}
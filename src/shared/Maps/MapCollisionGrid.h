@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NECRO
+{
+	// Directory (relative to the working directory) where the map files (.nmap) and their tiledefs (.ntdef) are stored
+	inline const char* MAPFILES_DIRECTORY = "Maps/";
+	inline const char* TILEDEFS_DIRECTORY = "Maps/tiledefs/";
+
+	// -----------------------------------------------------------------------------------------------------------------------------
+	// Compact, per-layer, collision representation of a map, loaded from the .nmap referenced by the MapDef.
+	//
+	// For every layer there are two bitsets of width*height bits (cell index = y * width + x):
+	// - walkable:	there is a tile in that cell that doesn't have a collider
+	// - blocking:	there is a tile in that cell that has a collider (as defined by the tiledef). As the client does, collisions only
+	//				happen between things that are on the same layer.
+	//
+	// Tile colliders are treated as covering the whole cell. Prefab colliders of the map (PrefabList) are not loaded.
+	// -----------------------------------------------------------------------------------------------------------------------------
+	class MapCollisionGrid
+	{
+	private:
+		int m_width = 0;
+		int m_height = 0;
+		int m_nLayers = 0;
+
+		std::vector<std::vector<uint64_t>> m_walkable; // [layer][word]
+		std::vector<std::vector<uint64_t>> m_blocking; // [layer][word]
+
+		bool TestBit(const std::vector<std::vector<uint64_t>>& grid, int layer, int x, int y) const
+		{
+			size_t index = static_cast<size_t>(y) * m_width + x;
+			return (grid[layer][index >> 6] >> (index & 63)) & 1ULL;
+		}
+
+		void SetBit(std::vector<std::vector<uint64_t>>& grid, int layer, int x, int y)
+		{
+			size_t index = static_cast<size_t>(y) * m_width + x;
+			grid[layer][index >> 6] |= (1ULL << (index & 63));
+		}
+
+		bool InBounds(int layer, int x, int y) const
+		{
+			return layer >= 0 && layer < m_nLayers && x >= 0 && x < m_width && y >= 0 && y < m_height;
+		}
+
+	public:
+		bool	LoadFromFile(const std::string& mapFileName);
+		bool	IsLoaded() const { return m_nLayers > 0; }
+
+		// Out of bounds cells/layers are never walkable and always blocking
+		bool	IsWalkable(int layer, int x, int y) const { return InBounds(layer, x, y) && TestBit(m_walkable, layer, x, y); }
+		bool	IsBlocking(int layer, int x, int y) const { return !InBounds(layer, x, y) || TestBit(m_blocking, layer, x, y); }
+
+		// Queries (in cell coordinates)
+		bool	IsBoxBlocked(int layer, int minX, int minY, int maxX, int maxY) const;
+		bool	IsLineBlocked(int layer, int fromX, int fromY, int toX, int toY, bool includeStart = false) const;
+	};
+}
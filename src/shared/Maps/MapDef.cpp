@@ -5,24 +5,25 @@
 
 namespace NECRO
 {
-	MapDef::MapDef(uint32_t mapID, const NDB* mapDb)
+	MapDef::MapDef(uint32_t mapID, const MapDefColumns& cols, const NDBRow& row)
 	{
 		try
 		{
 			m_mapID = mapID;
 
-			// Load Fields (Hard Gets can throw here, but it's fine since if the definitions fail to load, we can't start the server)
-			m_mapName = mapDb->GetString(m_mapID, "MapName");
-			m_mapType = mapDb->GetInt(m_mapID, "MapType");
+			// Load Fields, the columns were checked when they were bound
+			m_mapName = cols.mapName.Get(row);
+			m_mapType = cols.mapType.Get(row);
 
-			m_width		= mapDb->GetInt(m_mapID, "Width");
-			m_height	= mapDb->GetInt(m_mapID, "Height");
-			m_nLayers	= mapDb->GetInt(m_mapID, "NLayers");
+			m_width		= cols.width.Get(row);
+			m_height	= cols.height.Get(row);
+			m_nLayers	= cols.nLayers.Get(row);
 
-			m_mapFileName = mapDb->GetString(m_mapID, "MapFileName");
+			m_mapFileName = cols.mapFileName.Get(row);
 
 			// Load Map Static Definition
-
+			if (!m_collisionGrid.LoadFromFile(m_mapFileName))
+				throw std::runtime_error("Could not load the map file '" + m_mapFileName + "'");
 		}
 		catch (const std::exception& e)
 		{
@@ -3,10 +3,34 @@
 #include <cstdint>
 #include <string>
 
-#include "NDB.h"
+#include "NDBReader.h"
+#include "MapCollisionGrid.h"
 
 namespace NECRO
 {
+	// Values of MapDef::m_mapType
+	enum class MapType
+	{
+		EXTERIOR = 0,	// Persistent, there's always one Zone loaded for it
+		INSTANCED		// Zones are spawned on demand and torn down when left empty
+	};
+
+	// Columns of 'maps_db' the MapDefs are built from, bound once when the NDB is opened
+	struct MapDefColumns
+	{
+		NDBColumn<std::string>	mapName{ "MapName" };
+		NDBColumn<int>			mapType{ "MapType" };
+		NDBColumn<int>			width{ "Width" };
+		NDBColumn<int>			height{ "Height" };
+		NDBColumn<int>			nLayers{ "NLayers" };
+		NDBColumn<std::string>	mapFileName{ "MapFileName" };
+
+		bool Bind(const NDBSchema& schema)
+		{
+			return schema.Bind(mapName, mapType, width, height, nLayers, mapFileName);
+		}
+	};
+
 	// -----------------------------------------------------------------------------------------------------------------------------
 	// Description of a map's static content. 
 	// 
@@ -34,7 +58,13 @@ namespace NECRO
 
 		std::string m_mapFileName;
 
+		// Static content loaded from m_mapFileName
+		MapCollisionGrid m_collisionGrid;
+
 	public:
-		MapDef(uint32_t mapID, const NDB* mapDb);
+		// cols must be bound to the schema row was read with
+		MapDef(uint32_t mapID, const MapDefColumns& cols, const NDBRow& row);
+
+		bool IsInstanced() const { return m_mapType != static_cast<int>(MapType::EXTERIOR); }
 	};
 }
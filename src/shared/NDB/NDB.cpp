@@ -1,6 +1,6 @@
 #include "NDB.h"
 
-#include <fstream>
+#include <algorithm>
 #include <stdexcept>
 
 #include "FileLogger.h"
@@ -8,249 +8,115 @@
 
 namespace NECRO
 {
-	const NDBValue* NDB::TryFind(const NDBRow& row, const std::string& colID) const
+	bool NDB::FindRow(uint32_t rowID, size_t& rowIndex) const
 	{
-		auto it = m_valuesMap.find(colID);
-		if (it == m_valuesMap.end() || it->second >= row.m_values.size())
-		{
-			LOG_WARNING("NDB with ID: '{}'. Called TryFind on '{}', but it doesn't exist!", m_id, colID);
-			return nullptr;
-		}
-
-		return &row.m_values[it->second];
-	}
-
-	const NDBValue* NDB::TryFind(uint32_t rowID, const std::string& colID) const
-	{
-		auto it = m_rows.find(rowID);
-		if (it == m_rows.end())
-		{
-			LOG_WARNING("NDB with ID: '{}'. Called TryFind on RowID:'{}', but it doesn't exist!", m_id, rowID);
-			return nullptr;
-		}
+		auto it = std::lower_bound(m_index.begin(), m_index.end(), rowID, [](const std::pair<uint32_t, uint32_t>& e, uint32_t id) { return e.first < id; });
+		if (it == m_index.end() || it->first != rowID)
+			return false;
 
-		return TryFind(it->second, colID);
+		rowIndex = it->second;
+		return true;
 	}
 
-	// Maps file markers to states
-	static const std::unordered_map<std::string, NDBLoadState> ndbFileMarkers = 
-	{
-		{"DEFINITION_START", NDBLoadState::DEFINITION},
-		{"DEFINITION_END",   NDBLoadState::NONE},
-		{"STRUCTURE_START",  NDBLoadState::STRUCTURE},
-		{"STRUCTURE_END",    NDBLoadState::NONE},
-		{"ROWS_START",       NDBLoadState::ROWS},
-		{"ROWS_END",         NDBLoadState::NONE},
-	};
-
-
 	bool NDB::LoadFromDisk(const std::string& path)
 	{
 		m_isOpenAndValid = false;
-		m_rows.clear();
-		m_valuesMap.clear();
 		m_id = "";
-
-		std::ifstream ndbFile;
-
-		ndbFile.open(path);
-
-		if (!ndbFile.is_open())
-		{
-			LOG_ERROR("Could not load NDB at: '{}'.", path);
+		m_schema.Clear();
+		m_rowIDs.clear();
+		m_index.clear();
+		m_ints.clear();
+		m_floats.clear();
+		m_bools.clear();
+		m_strings.clear();
+
+		NDBReader reader;
+		if (!reader.Open(path))
 			return false;
-		}
 
-		// Intialize loading state
-		NDBLoadState curState = NDBLoadState::NONE;
+		m_id = reader.GetID();
+		m_schema = reader.GetSchema();
 
-		// Data used while loading
-		std::vector<std::string> structureTypes;	// all the data types - filled during Load and referenced while reading rows
-		size_t curRowCount = 0;						// number of rows
-		size_t structureCurIndex = 0;
+		m_ints.resize(m_schema.GetCount(NDBValueType::INT));
+		m_floats.resize(m_schema.GetCount(NDBValueType::FLOAT));
+		m_bools.resize(m_schema.GetCount(NDBValueType::BOOL));
+		m_strings.resize(m_schema.GetCount(NDBValueType::STRING));
 
-		bool doneLoading = false;
-		std::string line;
-		while (!doneLoading)
+		NDBRow row;
+		uint32_t rowID = 0;
+		while (reader.ReadRow(row, rowID))
 		{
-			std::getline(ndbFile, line);
-
-			// Skip empty lines
-			if (line.empty())
-				continue;
-
-			// Delete spaces
-			line.erase(remove_if(line.begin(), line.end(), [](unsigned char c) { return std::isspace(c); }), line.end());
-
-			// Skip comments
-			if (line[0] == '#')
-				continue;
-
-			// Look for markers and adjust state
-			if (auto it = ndbFileMarkers.find(line); it != ndbFileMarkers.end()) 
-			{
-				curState = it->second;
-				continue;
-			}
-
-			// Look for end
-			if (line == "NDB_END")
-			{
-				doneLoading = true;
-				break;
-			}
+			m_index.push_back({ rowID, static_cast<uint32_t>(m_rowIDs.size()) });
+			m_rowIDs.push_back(rowID);
 
-			// Load
-			switch (curState)
-			{
-				// Definitions are hard-coded and must be loaded in order
-				case NDBLoadState::DEFINITION:
-				{
-					// ID
-					m_id = line.substr(line.find(":") + 1);
+			for (size_t i = 0; i < m_ints.size(); i++)
+				m_ints[i].push_back(row.m_ints[i]);
 
-					// If any other definition will be added, we'll std::getLine here and continue reading, like:
-					// 
-					// std::getLine(ndbFile, line)
-					// NEXT_FIELD
-					// m_nextField = line.substr(line.find(":") + 1);
+			for (size_t i = 0; i < m_floats.size(); i++)
+				m_floats[i].push_back(row.m_floats[i]);
 
-					break;
-				}
+			for (size_t i = 0; i < m_bools.size(); i++)
+				m_bools[i].push_back(row.m_bools[i]);
 
-				case NDBLoadState::STRUCTURE:
-				{
-					size_t columnPos = line.find(':');
-					std::string columnName = line.substr(0, columnPos);
-					std::string columnType = line.substr(columnPos + 1);
-
-					// columnName will be at position curIndex inside a row
-					m_valuesMap[columnName] = structureCurIndex;
-					structureCurIndex++;
-
-					// We save the types of the data, so when we read a row we know what type it is going to be right away
-					structureTypes.push_back(columnType);
-					break;
-				}
-
-				case NDBLoadState::ROWS:
-				{
-					// Here we read whole row
-					NDBRow row;
-
-					// What we are currently reading (cursor on: 0,0,0,0,0)
-					size_t currentColumnIndx = 0;
-					uint32_t rowID = 0; // id of the row, written on the very first read (currentColumnIndx)
-
-					// Get all the text until the next separator ','
-					bool rowEnded = false;
-
-					size_t startPos = 0;
-					while (!rowEnded)
-					{
-						size_t commaPos = line.substr(startPos, std::string::npos).find(',');
-						std::string curColumn = line.substr(startPos, commaPos);
-
-						// Find last value of the row
-						if (curColumn.find(';') != std::string::npos)
-						{
-							curColumn = curColumn.substr(0, curColumn.find(';'));
-							rowEnded = true;
-						}
-
-						if (structureTypes[currentColumnIndx] == "int")
-						{
-							// Special Case: Read the ID of the row
-							if (currentColumnIndx == 0)
-							{
-								rowID = std::stoi(curColumn);
-							}
-
-							// Any other int (including ID)
-							row.m_values.push_back(NDBValue(std::stoi(curColumn)));
-						}
-						else if (structureTypes[currentColumnIndx] == "float")
-						{
-							row.m_values.push_back(NDBValue(std::stof(curColumn)));
-						}
-						else if (structureTypes[currentColumnIndx] == "bool")
-						{
-							if(curColumn == "true")
-								row.m_values.push_back(NDBValue(true));
-							else
-								row.m_values.push_back(NDBValue(false));
-						}
-						else if (structureTypes[currentColumnIndx] == "string")
-						{
-							row.m_values.push_back(NDBValue(curColumn));
-						}
-						else
-						{
-							LOG_ERROR("NDB with ID: '{}' is ill formed! Structure contains a:'{}' which is not supported!", m_id, structureTypes[currentColumnIndx]);
-							return false;
-						}
-
-						startPos += commaPos+1;
-						currentColumnIndx++;
-					}
+			for (size_t i = 0; i < m_strings.size(); i++)
+				m_strings[i].push_back(std::move(row.m_strings[i]));
+		}
 
-					// Row has ended - insert it into the ndb
-					auto it = m_rows.find(rowID);
-					if (it == m_rows.end())
-					{
-						m_rows.insert({ rowID, row });
-						curRowCount++;
-					}
-					else
-						LOG_ERROR("NDB with ID: '{}'. Duplicated RowID:'{}'!", m_id, rowID);
+		if (reader.HasFailed())
+			return false;
 
-					break;
-				}
+		// Same ID twice: the first row wins, the others stay in the columns but can't be found
+		std::stable_sort(m_index.begin(), m_index.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
 
-				default:
-					continue;
-			}
+		auto dup = std::adjacent_find(m_index.begin(), m_index.end(), [](const auto& a, const auto& b) { return a.first == b.first; });
+		while (dup != m_index.end())
+		{
+			MLOG_ERROR(NDB, "NDB with ID: '{}'. Duplicated RowID:'{}'!", m_id, dup->first);
+			dup = std::adjacent_find(dup + 1, m_index.end(), [](const auto& a, const auto& b) { return a.first == b.first; });
 		}
+		m_index.erase(std::unique(m_index.begin(), m_index.end(), [](const auto& a, const auto& b) { return a.first == b.first; }), m_index.end());
 
 		m_isOpenAndValid = true;
-		LOG_OK("'{}' successfully loaded! Loaded '{}' rows.", path, curRowCount);
+		MLOG_OK(NDB, "'{}' successfully loaded! Loaded '{}' rows.", path, m_index.size());
 		return true;
 	}
 
+	template<typename T>
+	std::pair<size_t, size_t> NDB::Locate(uint32_t rowID, const char* col) const
+	{
+		size_t rowIndex = 0;
+		if (!FindRow(rowID, rowIndex))
+			throw std::runtime_error(fmt::format("NDBGet: RowID '{}' doesn't exist (column '{}')", rowID, col));
+
+		size_t slot = 0;
+		if (!m_schema.Resolve(col, NDBTypeTraits<T>::TYPE, slot))
+			throw std::runtime_error(fmt::format("NDBGet: Bad column '{}' on row '{}' (expected {})", col, rowID, NDBValueTypeName(NDBTypeTraits<T>::TYPE)));
+
+		return { rowIndex, slot };
+	}
+
 	// "Hard" gets
 	int NDB::GetInt(uint32_t rowID, const char* col) const
 	{
-		const NDBValue* v = TryFind(rowID, col);
-		if (!v || !v->AsInt())
-			throw std::runtime_error(fmt::format("NDBGetInt: Bad column '{}' on row '{}' (expected int)", col, rowID));
-
-		return *v->AsInt();
+		auto [rowIndex, slot] = Locate<int>(rowID, col);
+		return m_ints[slot][rowIndex];
 	}
 
 	float NDB::GetFloat(uint32_t rowID, const char* col) const
 	{
-		const NDBValue* v = TryFind(rowID, col);
-		if (!v || !v->AsFloat())
-			throw std::runtime_error(fmt::format("NDBGetFloat: Bad column '{}' on row '{}' (expected float)", col, rowID));
-
-		return *v->AsFloat();
+		auto [rowIndex, slot] = Locate<float>(rowID, col);
+		return m_floats[slot][rowIndex];
 	}
 
 	bool NDB::GetBool(uint32_t rowID, const char* col) const
 	{
-		const NDBValue* v = TryFind(rowID, col);
-		if (!v || !v->AsBool())
-			throw std::runtime_error(fmt::format("NDBGetBool: Bad column '{}' on row '{}' (expected bool)", col, rowID));
-
-		return *v->AsBool();
+		auto [rowIndex, slot] = Locate<bool>(rowID, col);
+		return m_bools[slot][rowIndex] != 0;
 	}
 
 	std::string NDB::GetString(uint32_t rowID, const char* col) const
 	{
-		const NDBValue* v = TryFind(rowID, col);
-		if (!v || !v->AsString())
-			throw std::runtime_error(fmt::format("NDBGetString: Bad column '{}' on row '{}' (expected string)", col, rowID));
-
-		return *v->AsString();
+		auto [rowIndex, slot] = Locate<std::string>(rowID, col);
+		return m_strings[slot][rowIndex];
 	}
 }
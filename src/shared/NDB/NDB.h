@@ -1,19 +1,23 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <vector>
+#include <utility>
 
 #include "NDBValue.h"
 #include "NDBRow.h"
+#include "NDBSchema.h"
+#include "NDBReader.h"
 
 namespace NECRO
 {
-	enum class NDBLoadState {NONE, DEFINITION, STRUCTURE, ROWS};
-
 	// -----------------------------------------------------------------------
 	// NECRO Database file. 
 	// 
 	// Definition for database files used by both the client and worldserver.
+	//
+	// Stored by column: every column is a contiguous array of its type, 
+	// indexed by row index. Row IDs map to row indices with a sorted array.
 	// -----------------------------------------------------------------------
 	class NDB
 	{
@@ -21,8 +25,33 @@ namespace NECRO
 		bool m_isOpenAndValid;
 		std::string m_id;
 
-		std::unordered_map<uint32_t, NDBRow>	m_rows;				// ID of the row -> row object. The id of the row is parsed upon loading
-		std::unordered_map<std::string, size_t> m_valuesMap;		// column name -> index inside of m_values of the NDBRow
+		NDBSchema m_schema;
+
+		std::vector<uint32_t>							m_rowIDs;	// row index -> ID of the row, in file order
+		std::vector<std::pair<uint32_t, uint32_t>>		m_index;	// (ID of the row, row index), sorted by ID
+
+		// [slot][row index]
+		std::vector<std::vector<int>>			m_ints;
+		std::vector<std::vector<float>>			m_floats;
+		std::vector<std::vector<uint8_t>>		m_bools;
+		std::vector<std::vector<std::string>>	m_strings;
+
+		template<typename T>
+		const std::vector<std::vector<typename NDBTypeTraits<T>::Storage>>& Columns() const
+		{
+			if constexpr (std::is_same_v<T, int>)
+				return m_ints;
+			else if constexpr (std::is_same_v<T, float>)
+				return m_floats;
+			else if constexpr (std::is_same_v<T, bool>)
+				return m_bools;
+			else
+				return m_strings;
+		}
+
+		// Row index of rowID and slot of col, throws on errors
+		template<typename T>
+		std::pair<size_t, size_t> Locate(uint32_t rowID, const char* col) const;
 
 	public:
 		NDB() : m_isOpenAndValid(false), m_id("INVALID_NDB")
@@ -40,15 +69,35 @@ namespace NECRO
 				return nullptr;
 		}
 
-		// "Hard" gets. These throw on errors 
+		const NDBSchema& GetSchema() const
+		{
+			return m_schema;
+		}
+
+		size_t GetRowCount() const
+		{
+			return m_rowIDs.size();
+		}
+
+		uint32_t GetRowID(size_t rowIndex) const
+		{
+			return m_rowIDs[rowIndex];
+		}
+
+		// Row index of rowID, false if it doesn't exist
+		bool FindRow(uint32_t rowID, size_t& rowIndex) const;
+
+		// Value of a bound column (GetSchema().Bind(...)) at rowIndex
+		template<typename T>
+		typename NDBTypeTraits<T>::Result Get(size_t rowIndex, const NDBColumn<T>& col) const
+		{
+			return Columns<T>()[col.GetSlot()][rowIndex];
+		}
+
+		// "Hard" gets by name. These throw on errors 
 		int				GetInt(uint32_t rowID, const char* col) const;
 		float			GetFloat(uint32_t rowID, const char* col) const;
 		bool			GetBool(uint32_t rowID, const char* col) const;
 		std::string		GetString(uint32_t rowID, const char* col) const;
-
-		const NDBValue* TryFind(const NDBRow& row, const std::string& colID) const;
-		const NDBValue* TryFind(uint32_t rowID, const std::string& colID) const;
-
-		const std::unordered_map<uint32_t, NDBRow>& GetRows() const { return m_rows; }
 	};
 }
@@ -6,39 +6,49 @@
 
 namespace NECRO
 {
-	int NDBManager::LoadFromDefinition()
+	bool NDBManager::ReadDefinition(std::vector<std::string>& paths)
 	{
-		LOG_INFO("NDBManager: started loading at '{}'...", NDBS_DEFINITION_FILE_PATH);
-
-		int loadedCount = 0;
 		std::ifstream file;
 		file.open(NDBS_DEFINITION_FILE_PATH);
 
-		if (file.is_open())
+		if (!file.is_open())
 		{
-			std::string line;
-			while (std::getline(file, line))
-			{
-				// Skip empty lines
-				if (line.empty())
-					continue;
+			MLOG_ERROR(NDB, "NDBManager: could not open '{}'", NDBS_DEFINITION_FILE_PATH);
+			return false;
+		}
 
-				// Delete spaces
-				line.erase(remove_if(line.begin(), line.end(), [](unsigned char c) { return std::isspace(c); }), line.end());
+		std::string line;
+		while (std::getline(file, line))
+		{
+			// Skip empty lines
+			if (line.empty())
+				continue;
 
-				// Skip comments
-				if (line[0] == '#')
-					continue;
+			// Delete spaces
+			line.erase(remove_if(line.begin(), line.end(), [](unsigned char c) { return std::isspace(c); }), line.end());
 
-				if (AddDB("NDB/"+line))
-					loadedCount++;
-			}
+			// Skip comments
+			if (line.empty() || line[0] == '#')
+				continue;
+
+			paths.push_back("NDB/" + line);
 		}
-		else
-		{
-			LOG_ERROR("NDBManager: could not open '{}'", NDBS_DEFINITION_FILE_PATH);
+
+		return true;
+	}
+
+	int NDBManager::LoadFromDefinition()
+	{
+		MLOG_INFO(NDB, "NDBManager: started loading at '{}'...", NDBS_DEFINITION_FILE_PATH);
+
+		std::vector<std::string> paths;
+		if (!ReadDefinition(paths))
 			return 0;
-		}
+
+		int loadedCount = 0;
+		for (const std::string& path : paths)
+			if (AddDB(path))
+				loadedCount++;
 
 		m_ndbsLoaded = true;
 
@@ -50,7 +60,7 @@ namespace NECRO
 		auto it = m_dbs.find(id);
 		if (it == m_dbs.end())
 		{
-			LOG_WARNING("NDBManager: Tried to get NDB with ID: '{}' but it was not loaded!", id);
+			MLOG_WARNING(NDB, "NDBManager: Tried to get NDB with ID: '{}' but it was not loaded!", id);
 			return nullptr;
 		}
 		else
@@ -65,20 +75,20 @@ namespace NECRO
 			auto it = m_dbs.find(*db.GetID());
 			if (it == m_dbs.end())
 			{
-				LOG_OK("NDBManager: Loaded '{}'.", *db.GetID());
+				MLOG_OK(NDB, "NDBManager: Loaded '{}'.", *db.GetID());
 
 				m_dbs.insert({ *db.GetID(), std::move(db)});
 				return true;
 			}
 			else
 			{
-				LOG_WARNING("NDBManager: Could not load '{}'. ID was already in the DB manager!", *db.GetID());
+				MLOG_WARNING(NDB, "NDBManager: Could not load '{}'. ID was already in the DB manager!", *db.GetID());
 				return false;
 			}
 		}
 		else
 		{
-			LOG_WARNING("NDBManager: Could not load '{}'.", path);
+			MLOG_WARNING(NDB, "NDBManager: Could not load '{}'.", path);
 			return false;
 		}
 	}
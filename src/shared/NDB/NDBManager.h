@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include "NDB.h"
 
 namespace NECRO
@@ -24,6 +25,9 @@ namespace NECRO
 		bool m_ndbsLoaded = false;
 
 	public:
+		// Paths of the NDBs listed in NDBS_DEFINITION_FILE_PATH, false if it couldn't be read
+		static bool ReadDefinition(std::vector<std::string>& paths);
+
 		int LoadFromDefinition();
 
 		const NDB* GetDB(const std::string& id) const; 
@@ -0,0 +1,245 @@
+#include "NDBReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "FileLogger.h"
+#include "ConsoleLogger.h"
+
+namespace NECRO
+{
+	// std::stoi and std::stof stop at the first character that's not part of the number, the whole value has to be one
+	static int ParseInt(const std::string& str)
+	{
+		size_t parsed = 0;
+		int v = std::stoi(str, &parsed);
+		if (parsed != str.size())
+			throw std::invalid_argument("'" + str + "' is not an int");
+
+		return v;
+	}
+
+	static float ParseFloat(const std::string& str)
+	{
+		size_t parsed = 0;
+		float v = std::stof(str, &parsed);
+		if (parsed != str.size())
+			throw std::invalid_argument("'" + str + "' is not a float");
+
+		return v;
+	}
+
+	bool NDBReader::NextLine()
+	{
+		while (std::getline(m_file, m_line))
+		{
+			// Delete spaces
+			m_line.erase(std::remove_if(m_line.begin(), m_line.end(), [](unsigned char c) { return std::isspace(c); }), m_line.end());
+
+			// Skip empty lines and comments
+			if (m_line.empty() || m_line[0] == '#')
+				continue;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	bool NDBReader::Open(const std::string& path)
+	{
+		m_file.close();
+		m_file.clear();
+		m_path = path;
+		m_id.clear();
+		m_schema.Clear();
+		m_rowsRead = 0;
+		m_inRows = false;
+		m_ended = false;
+		m_failed = false;
+
+		m_file.open(path);
+
+		if (!m_file.is_open())
+		{
+			MLOG_ERROR(NDB, "Could not load NDB at: '{}'.", path);
+			m_failed = true;
+			return false;
+		}
+
+		NDBLoadState curState = NDBLoadState::NONE;
+
+		while (NextLine())
+		{
+			if (m_line == "DEFINITION_START")
+				curState = NDBLoadState::DEFINITION;
+			else if (m_line == "STRUCTURE_START")
+				curState = NDBLoadState::STRUCTURE;
+			else if (m_line == "DEFINITION_END" || m_line == "STRUCTURE_END")
+				curState = NDBLoadState::NONE;
+			else if (m_line == "ROWS_START")
+			{
+				if (m_schema.GetColumns().empty())
+				{
+					MLOG_ERROR(NDB, "NDB with ID: '{}' is ill formed! It has rows but no structure.", m_id);
+					m_failed = true;
+					return false;
+				}
+
+				// Rows are read by ReadRow
+				m_inRows = true;
+				return true;
+			}
+			else if (m_line == "NDB_END")
+				break;
+			else if (curState == NDBLoadState::DEFINITION)
+			{
+				// Definitions are hard-coded, only the ID for now
+				m_id = m_line.substr(m_line.find(':') + 1);
+				m_schema.SetNDBID(m_id);
+			}
+			else if (curState == NDBLoadState::STRUCTURE)
+			{
+				size_t columnPos = m_line.find(':');
+				std::string columnName = m_line.substr(0, columnPos);
+				std::string columnType = m_line.substr(columnPos + 1);
+
+				NDBValueType type;
+				if (columnType == "int")
+					type = NDBValueType::INT;
+				else if (columnType == "float")
+					type = NDBValueType::FLOAT;
+				else if (columnType == "bool")
+					type = NDBValueType::BOOL;
+				else if (columnType == "string")
+					type = NDBValueType::STRING;
+				else
+				{
+					MLOG_ERROR(NDB, "NDB with ID: '{}' is ill formed! Structure contains a:'{}' which is not supported!", m_id, columnType);
+					m_failed = true;
+					return false;
+				}
+
+				// The first column is the ID of the row
+				if (m_schema.GetColumns().empty() && type != NDBValueType::INT)
+				{
+					MLOG_ERROR(NDB, "NDB with ID: '{}' is ill formed! The first column '{}' must be the int ID of the row.", m_id, columnName);
+					m_failed = true;
+					return false;
+				}
+
+				if (!m_schema.AddColumn(columnName, type))
+				{
+					MLOG_ERROR(NDB, "NDB with ID: '{}' is ill formed! Column '{}' is defined twice.", m_id, columnName);
+					m_failed = true;
+					return false;
+				}
+			}
+		}
+
+		// No rows
+		m_ended = true;
+		return true;
+	}
+
+	bool NDBReader::ReadRow(NDBRow& row, uint32_t& rowID)
+	{
+		if (!m_inRows || m_ended || m_failed)
+			return false;
+
+		if (!NextLine())
+		{
+			// Truncated file, the rows read so far may be only part of them
+			MLOG_ERROR(NDB, "NDB with ID: '{}' is ill formed! The file ends without ROWS_END.", m_id);
+			m_failed = true;
+			return false;
+		}
+
+		if (m_line == "ROWS_END" || m_line == "NDB_END")
+		{
+			m_ended = true;
+			return false;
+		}
+
+		if (!ParseRow(row, rowID))
+		{
+			m_failed = true;
+			return false;
+		}
+
+		m_rowsRead++;
+		return true;
+	}
+
+	bool NDBReader::ParseRow(NDBRow& row, uint32_t& rowID)
+	{
+		row.Clear();
+		rowID = 0;
+
+		const std::vector<NDBColumnInfo>& columns = m_schema.GetColumns();
+
+		// Values are separated by ',' and the row ends with ';'
+		size_t rowEnd = m_line.find(';');
+		if (rowEnd == std::string::npos)
+			rowEnd = m_line.size();
+
+		size_t col = 0;
+		try
+		{
+			size_t startPos = 0;
+			while (startPos <= rowEnd)
+			{
+				size_t commaPos = m_line.find(',', startPos);
+				if (commaPos == std::string::npos || commaPos > rowEnd)
+					commaPos = rowEnd;
+
+				if (col >= columns.size())
+				{
+					MLOG_ERROR(NDB, "NDB with ID: '{}' is ill formed! Row '{}' has more values than the structure.", m_id, m_line);
+					return false;
+				}
+
+				// Values are appended in file order, so each one lands on the slot of its column
+				std::string curColumn = m_line.substr(startPos, commaPos - startPos);
+
+				switch (columns[col].type)
+				{
+					case NDBValueType::INT:
+						row.m_ints.push_back(ParseInt(curColumn));
+						break;
+
+					case NDBValueType::FLOAT:
+						row.m_floats.push_back(ParseFloat(curColumn));
+						break;
+
+					case NDBValueType::BOOL:
+						row.m_bools.push_back(curColumn == "true" ? 1 : 0);
+						break;
+
+					default:
+						row.m_strings.push_back(std::move(curColumn));
+						break;
+				}
+
+				startPos = commaPos + 1;
+				col++;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			MLOG_ERROR(NDB, "NDB with ID: '{}' is ill formed! Row '{}' could not be parsed: '{}'.", m_id, m_line, e.what());
+			return false;
+		}
+
+		if (col != columns.size())
+		{
+			MLOG_ERROR(NDB, "NDB with ID: '{}' is ill formed! Row '{}' has less values than the structure.", m_id, m_line);
+			return false;
+		}
+
+		// The first column is always the int ID
+		rowID = static_cast<uint32_t>(row.m_ints[0]);
+		return true;
+	}
+}
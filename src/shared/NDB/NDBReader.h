@@ -0,0 +1,77 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "NDBValue.h"
+#include "NDBRow.h"
+#include "NDBSchema.h"
+
+namespace NECRO
+{
+	enum class NDBLoadState {NONE, DEFINITION, STRUCTURE, ROWS};
+
+	// -----------------------------------------------------------------------------------------------------------------------------
+	// Streaming reader of a NDB file.
+	//
+	// Open() parses the definition and the structure, then ReadRow() parses one row at a time into the row given by the caller,
+	// so a Store can be built straight from the file without keeping the whole NDB in memory.
+	//
+	// Usage is:
+	// NDBReader reader; reader.Open(path); reader.GetSchema().Bind(columns...);
+	// while (reader.ReadRow(row, rowID)) -> build the def of rowID with column.Get(row) ...
+	// -----------------------------------------------------------------------------------------------------------------------------
+	class NDBReader
+	{
+	private:
+		std::ifstream	m_file;
+		std::string		m_path;
+		std::string		m_id;
+
+		NDBSchema		m_schema;
+
+		std::string		m_line;
+		size_t			m_rowsRead = 0;
+		bool			m_inRows = false;
+		bool			m_ended = false;
+		bool			m_failed = false;
+
+		// Next meaningful line (no spaces, no comments) in m_line, false at the end of the file
+		bool			NextLine();
+		bool			ParseRow(NDBRow& row, uint32_t& rowID);
+
+	public:
+		// Reads the definition and the structure, stops at the first row
+		bool Open(const std::string& path);
+
+		// Reads the next row into row (its storage is reused), false at the end of the rows or on a malformed row or a missing
+		// ROWS_END (HasFailed)
+		bool ReadRow(NDBRow& row, uint32_t& rowID);
+
+		bool HasFailed() const
+		{
+			return m_failed;
+		}
+
+		const std::string& GetID() const
+		{
+			return m_id;
+		}
+
+		const std::string& GetPath() const
+		{
+			return m_path;
+		}
+
+		size_t GetRowsRead() const
+		{
+			return m_rowsRead;
+		}
+
+		const NDBSchema& GetSchema() const
+		{
+			return m_schema;
+		}
+	};
+}
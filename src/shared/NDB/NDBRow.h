@@ -9,25 +9,41 @@ namespace NECRO
 {
 	// ---------------------------------------------------------------------------------------------
 	// A row inside of a NDB file.
+	//
+	// Values are grouped by type, the value of a column is Values<T>()[slot], where slot is the
+	// index of the column among the columns of the same type (see NDBSchema, NDBColumn).
 	// ---------------------------------------------------------------------------------------------
 	class NDBRow
 	{
 		friend class NDB;
-		friend class NDBValue;
+		friend class NDBReader;
 
 	private:
-		std::vector<NDBValue> m_values;
+		std::vector<int>			m_ints;
+		std::vector<float>			m_floats;
+		std::vector<uint8_t>		m_bools;
+		std::vector<std::string>	m_strings;
 
-	public:
-		std::size_t Size() const 
-		{ 
-			return m_values.size(); 
+		void Clear()
+		{
+			m_ints.clear();
+			m_floats.clear();
+			m_bools.clear();
+			m_strings.clear();
 		}
 
-		// Access NDBRow[index]
-		const NDBValue& operator[] (size_t col) const 
-		{ 
-			return m_values.at(col);
+	public:
+		template<typename T>
+		const std::vector<typename NDBTypeTraits<T>::Storage>& Values() const
+		{
+			if constexpr (std::is_same_v<T, int>)
+				return m_ints;
+			else if constexpr (std::is_same_v<T, float>)
+				return m_floats;
+			else if constexpr (std::is_same_v<T, bool>)
+				return m_bools;
+			else
+				return m_strings;
 		}
 	};
 }
@@ -0,0 +1,55 @@
+#include "NDBSchema.h"
+
+#include "FileLogger.h"
+#include "ConsoleLogger.h"
+
+namespace NECRO
+{
+	void NDBSchema::Clear()
+	{
+		m_ndbID.clear();
+		m_columnsMap.clear();
+		m_columns.clear();
+		m_typeCounts.fill(0);
+	}
+
+	bool NDBSchema::AddColumn(const std::string& name, NDBValueType type)
+	{
+		NDBColumnInfo info{ type, m_typeCounts[static_cast<size_t>(type)] };
+
+		if (!m_columnsMap.insert({ name, info }).second)
+			return false;
+
+		m_columns.push_back(info);
+		m_typeCounts[static_cast<size_t>(type)]++;
+		return true;
+	}
+
+	const NDBColumnInfo* NDBSchema::Find(const std::string& name) const
+	{
+		auto it = m_columnsMap.find(name);
+		if (it == m_columnsMap.end())
+			return nullptr;
+
+		return &it->second;
+	}
+
+	bool NDBSchema::Resolve(const char* name, NDBValueType type, size_t& slot) const
+	{
+		const NDBColumnInfo* info = Find(name);
+		if (!info)
+		{
+			MLOG_ERROR(NDB, "NDB with ID: '{}'. Column '{}' doesn't exist!", m_ndbID, name);
+			return false;
+		}
+
+		if (info->type != type)
+		{
+			MLOG_ERROR(NDB, "NDB with ID: '{}'. Column '{}' is a '{}', expected '{}'!", m_ndbID, name, NDBValueTypeName(info->type), NDBValueTypeName(type));
+			return false;
+		}
+
+		slot = info->slot;
+		return true;
+	}
+}
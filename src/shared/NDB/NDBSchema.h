@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+
+#include "NDBValue.h"
+#include "NDBRow.h"
+
+namespace NECRO
+{
+	// Column of a NDB, slot is its index among the columns of the same type
+	struct NDBColumnInfo
+	{
+		NDBValueType	type;
+		size_t			slot;
+	};
+
+	// -----------------------------------------------------------------------------------------------------------------------------
+	// Structure of a NDB: the columns in file order, their types and slots.
+	// Name lookups only happen here, when NDBColumns are bound.
+	// -----------------------------------------------------------------------------------------------------------------------------
+	class NDBSchema
+	{
+	private:
+		std::string												m_ndbID;
+		std::unordered_map<std::string, NDBColumnInfo>			m_columnsMap;	// column name -> info
+		std::vector<NDBColumnInfo>								m_columns;		// in file order
+		std::array<size_t, static_cast<size_t>(NDBValueType::COUNT)>	m_typeCounts{};
+
+	public:
+		void Clear();
+
+		void SetNDBID(const std::string& ndbID)
+		{
+			m_ndbID = ndbID;
+		}
+
+		// False if the column already exists
+		bool AddColumn(const std::string& name, NDBValueType type);
+
+		const NDBColumnInfo* Find(const std::string& name) const;
+
+		// Slot of the column name, logs and returns false if it doesn't exist or it's not of the given type
+		bool Resolve(const char* name, NDBValueType type, size_t& slot) const;
+
+		const std::vector<NDBColumnInfo>& GetColumns() const
+		{
+			return m_columns;
+		}
+
+		size_t GetCount(NDBValueType type) const
+		{
+			return m_typeCounts[static_cast<size_t>(type)];
+		}
+
+		// Binds all the columns, false if any of them couldn't be bound
+		template<typename... Columns>
+		bool Bind(Columns&... columns) const
+		{
+			return (columns.Bind(*this) & ...);
+		}
+	};
+
+	// -----------------------------------------------------------------------------------------------------------------------------
+	// Typed column declared by the code that reads a NDB (the Stores).
+	//
+	// The name and type are fixed at compile time, Bind() checks them against the NDBSchema once at load and keeps the slot, then
+	// Get() is a plain index into the typed values of the row.
+	// -----------------------------------------------------------------------------------------------------------------------------
+	template<typename T>
+	class NDBColumn
+	{
+	public:
+		static constexpr size_t INVALID_SLOT = SIZE_MAX;
+
+	private:
+		const char*	m_name;
+		size_t		m_slot = INVALID_SLOT;
+
+	public:
+		constexpr explicit NDBColumn(const char* name) : m_name(name)
+		{
+		}
+
+		bool Bind(const NDBSchema& schema)
+		{
+			if (schema.Resolve(m_name, NDBTypeTraits<T>::TYPE, m_slot))
+				return true;
+
+			m_slot = INVALID_SLOT;
+			return false;
+		}
+
+		bool IsBound() const
+		{
+			return m_slot != INVALID_SLOT;
+		}
+
+		const char* GetName() const
+		{
+			return m_name;
+		}
+
+		size_t GetSlot() const
+		{
+			return m_slot;
+		}
+
+		// The column must be bound to the schema the row was read with
+		typename NDBTypeTraits<T>::Result Get(const NDBRow& row) const
+		{
+			return row.Values<T>()[m_slot];
+		}
+	};
+}
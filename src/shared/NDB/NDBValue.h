@@ -1,7 +1,8 @@
 #pragma once
 
-#include <variant>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 
 namespace NECRO
 {
@@ -10,51 +11,59 @@ namespace NECRO
 		INT,
 		FLOAT,
 		BOOL,
-		STRING
+		STRING,
+
+		COUNT
 	};
 
 	// ---------------------------------------------------------------------------------------------------------------------------
-	// A value inside of a NecroDatabase. It's similar to a QueryResult we would have gotten if we would have used a standard DB
+	// C++ type of the values of a NDB column. Values are stored in typed contiguous arrays (Storage), bools as uint8_t to stay
+	// away from std::vector<bool>. Result is what the accessors return.
 	// ---------------------------------------------------------------------------------------------------------------------------
-	class NDBValue
+	template<typename T>
+	struct NDBTypeTraits;
+
+	template<>
+	struct NDBTypeTraits<int>
 	{
-	private:
-		NDBValueType m_type;
-		std::variant<int, float, bool, std::string> m_data;
-
-	public:
-		explicit NDBValue(int v) : m_type(NDBValueType::INT), m_data(v){}
-		explicit NDBValue(float v) : m_type(NDBValueType::FLOAT), m_data(v){}
-		explicit NDBValue(bool v) : m_type(NDBValueType::BOOL), m_data(v){}
-		explicit NDBValue(std::string v) : m_type(NDBValueType::STRING), m_data(std::move(v)){}
-		explicit NDBValue(const char* v) : m_type(NDBValueType::STRING), m_data(std::string(v)) {}
-
-		NDBValueType GetType() const 
-		{ 
-			return m_type; 
-		}
+		static constexpr NDBValueType TYPE = NDBValueType::INT;
+		using Storage = int;
+		using Result = int;
+	};
 
-		// ---------------------------------------------------------------------------------------------------------------------------
-		// Get values
-		// ---------------------------------------------------------------------------------------------------------------------------
-		const int* AsInt() const
-		{
-			return m_type == NDBValueType::INT ? &std::get<int>(m_data) : nullptr;
-		}
+	template<>
+	struct NDBTypeTraits<float>
+	{
+		static constexpr NDBValueType TYPE = NDBValueType::FLOAT;
+		using Storage = float;
+		using Result = float;
+	};
 
-		const float* AsFloat() const
-		{
-			return m_type == NDBValueType::FLOAT ? &std::get<float>(m_data) : nullptr;
-		}
+	template<>
+	struct NDBTypeTraits<bool>
+	{
+		static constexpr NDBValueType TYPE = NDBValueType::BOOL;
+		using Storage = uint8_t;
+		using Result = bool;
+	};
 
-		const bool* AsBool() const
-		{
-			return m_type == NDBValueType::BOOL ? &std::get<bool>(m_data) : nullptr;
-		}
+	template<>
+	struct NDBTypeTraits<std::string>
+	{
+		static constexpr NDBValueType TYPE = NDBValueType::STRING;
+		using Storage = std::string;
+		using Result = const std::string&;
+	};
 
-		const std::string* AsString() const  
+	inline const char* NDBValueTypeName(NDBValueType type)
+	{
+		switch (type)
 		{
-			return m_type == NDBValueType::STRING ? &std::get<std::string>(m_data) : nullptr;
+			case NDBValueType::INT:		return "int";
+			case NDBValueType::FLOAT:	return "float";
+			case NDBValueType::BOOL:	return "bool";
+			case NDBValueType::STRING:	return "string";
+			default:					return "invalid";
 		}
-	};
+	}
 }
@@ -1,14 +1,34 @@
 #include "MapDefStore.h"
 
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
 namespace NECRO
 {
-	void MapDefStore::LoadAll(const NDB* mapDb)
+	bool MapDefStore::LoadAll(NDBReader& mapDb)
 	{
-		// Load all the maps defined in the map's NDB
-		for (auto& it : mapDb->GetRows()) 
+		MapDefColumns cols;
+		if (!cols.Bind(mapDb.GetSchema()))
+		{
+			MLOG_ERROR(NDB, "NDB with ID: '{}' doesn't match the MapDef columns!", mapDb.GetID());
+			return false;
+		}
+
+		// Load all the maps defined in the map's NDB, one row at a time
+		NDBRow row;
+		uint32_t mapID = 0;
+		while (mapDb.ReadRow(row, mapID))
 		{
-			m_defs.insert({ it.first, std::make_unique<MapDef>(it.first, mapDb) });
+			if (m_defs.find(mapID) != m_defs.end())
+			{
+				MLOG_ERROR(NDB, "NDB with ID: '{}'. Duplicated RowID:'{}'!", mapDb.GetID(), mapID);
+				continue;
+			}
+
+			m_defs.insert({ mapID, std::make_unique<MapDef>(mapID, cols, row) });
 		}
+
+		return !mapDb.HasFailed();
 	}
 
 	const MapDef* MapDefStore::GetDef(uint32_t mapID) const
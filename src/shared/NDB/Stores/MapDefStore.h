@@ -14,7 +14,10 @@ namespace NECRO
 		std::unordered_map<uint32_t, std::unique_ptr<MapDef>> m_defs;
 
 	public:
-		void			LoadAll(const NDB* mapDb);
+		// Builds a MapDef for every row left in mapDb, false if the NDB is ill formed
+		bool			LoadAll(NDBReader& mapDb);
 		const MapDef*	GetDef(uint32_t mapID) const;
+
+		const std::unordered_map<uint32_t, std::unique_ptr<MapDef>>& GetDefs() const { return m_defs; }
 	};
 }
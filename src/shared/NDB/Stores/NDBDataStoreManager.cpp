@@ -0,0 +1,79 @@
+#include "NDBDataStoreManager.h"
+
+#include <algorithm>
+
+#include "ConsoleLogger.h"
+#include "FileLogger.h"
+
+namespace NECRO
+{
+	bool NDBDataStoreManager::GetLastWriteTime(std::filesystem::file_time_type& writeTime)
+	{
+		std::vector<std::string> paths;
+		if (!NDBManager::ReadDefinition(paths))
+			return false;
+
+		paths.push_back(NDBS_DEFINITION_FILE_PATH);
+
+		std::error_code ec;
+		writeTime = std::filesystem::file_time_type::min();
+		for (const std::string& path : paths)
+		{
+			std::filesystem::file_time_type t = std::filesystem::last_write_time(path, ec);
+			if (ec)
+				return false;
+
+			writeTime = std::max(writeTime, t);
+		}
+
+		return true;
+	}
+
+	int NDBDataStoreManager::LoadAll()
+	{
+		std::vector<std::string> paths;
+		if (!NDBManager::ReadDefinition(paths))
+			return 0;
+
+		int loadedCount = 0;
+		bool mapsLoaded = false;
+
+		for (const std::string& path : paths)
+		{
+			NDBReader reader;
+			if (!reader.Open(path))
+				continue;
+
+			int res = LoadStore(reader);
+			if (res == -1)
+			{
+				MLOG_WARNING(NDB, "NDBDataStoreManager: NDB '{}' at '{}' has no Store, skipped.", reader.GetID(), path);
+				continue;
+			}
+			else if (res != 0)
+				continue;
+
+			if (reader.GetID() == "maps_db")
+				mapsLoaded = true;
+
+			MLOG_OK(NDB, "'{}' successfully loaded into its Store! Loaded '{}' rows.", path, reader.GetRowsRead());
+			loadedCount++;
+		}
+
+		if (!mapsLoaded)
+		{
+			MLOG_ERROR(NDB, "NDBDataStoreManager: NDB 'maps_db' could not be loaded.");
+			return 0;
+		}
+
+		return loadedCount;
+	}
+
+	int NDBDataStoreManager::LoadStore(NDBReader& reader)
+	{
+		if (reader.GetID() == "maps_db")
+			return m_mapDefStore.LoadAll(reader) ? 0 : -2;
+
+		return -1;
+	}
+}
@@ -1,32 +1,52 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+
 #include "MapDefStore.h"
 #include "NDBManager.h"
 
 namespace NECRO
 {
+	// --------------------------------------------------------------------------------------------------------------
+	// Owns the Stores built from the NDBs.
+	//
+	// Stores are populated straight from the NDB files (NDBReader), one row at a time, the NDBs are never fully
+	// loaded in memory.
+	//
+	// Once loaded a NDBDataStoreManager is never modified, a reload builds a new one (a new version).
+	// --------------------------------------------------------------------------------------------------------------
 	class NDBDataStoreManager
 	{
 	private:
 		MapDefStore m_mapDefStore;
+		uint32_t	m_version = 0;
 
 	public:
-		int LoadAll(const NDBManager& dbManager)
-		{
-			auto* mapDB = dbManager.GetDB("maps_db");
+		// Latest write time of NDBS_DEFINITION_FILE_PATH and the NDBs it lists, false if any of them can't be read
+		static bool GetLastWriteTime(std::filesystem::file_time_type& writeTime);
 
-			if (mapDB)
-			{
-				m_mapDefStore.LoadAll(mapDB);
-				return 1;
-			}
+		// Streams every NDB listed in NDBS_DEFINITION_FILE_PATH into its Store. Returns the number of Stores loaded,
+		// 0 if a required one ('maps_db') could not be loaded
+		int LoadAll();
 
-			return 0;
-		}
+		// Streams a single NDB into the Store of its ID. Returns 0 on success, -1 if no Store is built from that NDB,
+		// -2 if the NDB is ill formed
+		int LoadStore(NDBReader& reader);
 
 		const MapDefStore& GetMapDefStore() const
 		{
 			return m_mapDefStore;
 		}
+
+		void SetVersion(uint32_t version)
+		{
+			m_version = version;
+		}
+
+		uint32_t GetVersion() const
+		{
+			return m_version;
+		}
 	};
 }
@@ -128,6 +128,47 @@ namespace NECRO
                 return -1;
         }
 
+        //-----------------------------------------------------------------------------------------------------------------
+        // Encrypts 'plaintext' and appends it to this message as a full [PCKT_SIZE | IV | TAG | CIPHERTEXT] frame.
+        // The ciphertext and tag are written straight into the message buffer, so the plaintext is never copied. 
+        // Allows batching multiple frames (for example, shared broadcast packets) in a single NetworkMessage/write.
+        //-----------------------------------------------------------------------------------------------------------------
+        int AESEncryptAppend(const uint8_t* plaintext, size_t plaintextLen, unsigned char* key, AES::IV& iv, unsigned char* aad, int aadLen)
+        {
+            const size_t frameSize = sizeof(uint32_t) + GCM_IV_SIZE + GCM_TAG_SIZE + plaintextLen;
+
+            // Make sure the whole frame fits
+            if (GetRemainingSpace() < frameSize)
+            {
+                CompactData();
+
+                if (GetRemainingSpace() < frameSize)
+                    m_data.resize(m_wpos + frameSize);
+            }
+
+            // Write the iv as bytes
+            std::array<uint8_t, GCM_IV_SIZE> ivBytes;
+            iv.ToByteArray(ivBytes);
+
+            uint8_t* frame = GetWritePointer();
+            uint8_t* tagPtr = frame + sizeof(uint32_t) + GCM_IV_SIZE;
+            uint8_t* cipherPtr = tagPtr + GCM_TAG_SIZE;
+
+            int ciphertext_len = AES::Encrypt(const_cast<uint8_t*>(plaintext), static_cast<int>(plaintextLen), aad, aadLen, key, ivBytes.data(), GCM_IV_SIZE, cipherPtr, tagPtr);
+            if (ciphertext_len < 0)
+                return -1;
+
+            uint32_t packetSize = GCM_IV_SIZE + GCM_TAG_SIZE + ciphertext_len;
+            packetSize = htonl(packetSize);
+
+            std::memcpy(frame, &packetSize, sizeof(packetSize));
+            std::memcpy(frame + sizeof(uint32_t), ivBytes.data(), GCM_IV_SIZE);
+            m_wpos += sizeof(uint32_t) + GCM_IV_SIZE + GCM_TAG_SIZE + ciphertext_len;
+
+            iv.IncrementCounter(); // increment counter here! So we are sure each encrypt operation increases the counter
+            return ciphertext_len;
+        }
+
         int AESDecrypt(unsigned char* key, unsigned char* aad, int aadLen, uint64_t& expectedCounter, uint32_t* expectedPrefix = nullptr)
         {
             if (GetActiveSize() < sizeof(uint32_t)) // not enough data to even start decrypting
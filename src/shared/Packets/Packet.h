@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <string>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
 
 namespace NECRO
@@ -165,4 +167,9 @@ namespace NECRO
 
     };
 
+    //----------------------------------------------------------------------------------------------------------------
+    // Immutable, refcounted packet used for broadcasts. It is serialized once and every recipient shares the same
+    // buffer instead of receiving its own copy. Encryption is done per session, reading directly from here.
+    //----------------------------------------------------------------------------------------------------------------
+    using SharedPacket = std::shared_ptr<const Packet>;
 }
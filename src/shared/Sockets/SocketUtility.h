@@ -80,11 +80,11 @@ namespace NECRO
 
 			if (startupValue != 0)
 			{
-				LOG_ERROR(std::string("Error during SocketUtility::Initialize() [" + std::to_string(startupValue) + "]"));
+				MLOG_ERROR(NETWORK, std::string("Error during SocketUtility::Initialize() [" + std::to_string(startupValue) + "]"));
 				return;
 			}
 
-			LOG_OK("SocketUtility::Initialize() successful!");
+			MLOG_OK(NETWORK, "SocketUtility::Initialize() successful!");
 #endif
 		}
 	};
@@ -17,7 +17,7 @@ namespace NECRO
 		}
 		else
 		{
-			LOG_ERROR("Error while setting m_inSocket. Given ptr was invalid!");
+			MLOG_ERROR(NETWORK, "Error while setting m_inSocket. Given ptr was invalid!");
 			m_inSocket = nullptr;
 			m_threadID = -1;
 
@@ -36,7 +36,7 @@ namespace NECRO
 
 		if (ec)
 		{
-			LOG_ERROR("Error while opening Acceptor Socket.");
+			MLOG_ERROR(NETWORK, "Error while opening Acceptor Socket.");
 			return false;
 		}
 
@@ -44,7 +44,7 @@ namespace NECRO
 
 		if (ec)
 		{
-			LOG_ERROR("Error while binding Acceptor Socket.");
+			MLOG_ERROR(NETWORK, "Error while binding Acceptor Socket.");
 			return false;
 		}
 
@@ -52,7 +52,7 @@ namespace NECRO
 
 		if (ec)
 		{
-			LOG_ERROR("Error while listening Acceptor Socket.");
+			MLOG_ERROR(NETWORK, "Error while listening Acceptor Socket.");
 			return false;
 		}
 
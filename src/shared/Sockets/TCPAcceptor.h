@@ -64,7 +64,7 @@ namespace NECRO
 				}
 				else
 				{
-					LOG_ERROR("Error while accepting client socket. {}", ec.what());
+					MLOG_ERROR(NETWORK, "Error while accepting client socket. {}", ec.what());
 
 					// Make sure, even in the event of an error, that the accept-loop continues so the server doesn't stall
 					// It's the responsability of the SocketManager, so he'll handle it in the errorCallback
@@ -27,8 +27,8 @@ namespace NECRO
 
 		if (m_socket == INVALID_SOCKET)
 		{
-			LOG_ERROR(std::string("Error 1 during TCPSocket::Create()"));
-			LOG_ERROR(std::to_string(SocketUtility::GetLastError()));
+			MLOG_ERROR(NETWORK, std::string("Error 1 during TCPSocket::Create()"));
+			MLOG_ERROR(NETWORK, std::to_string(SocketUtility::GetLastError()));
 		}
 	}
 
@@ -45,8 +45,8 @@ namespace NECRO
 
 		if (m_socket == INVALID_SOCKET)
 		{
-			LOG_ERROR(std::string("Error 2 during TCPSocket::Create()"));
-			LOG_ERROR(std::to_string(SocketUtility::GetLastError()));
+			MLOG_ERROR(NETWORK, std::string("Error 2 during TCPSocket::Create()"));
+			MLOG_ERROR(NETWORK, std::to_string(SocketUtility::GetLastError()));
 		}
 	}
 
@@ -67,7 +67,7 @@ namespace NECRO
 
 		if (err != 0)
 		{
-			LOG_ERROR(std::string("Error during TCPSocket::Bind() [" + std::to_string(SocketUtility::GetLastError()) + "]"));
+			MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Bind() [" + std::to_string(SocketUtility::GetLastError()) + "]"));
 			return SocketUtility::GetLastError();
 		}
 
@@ -80,7 +80,7 @@ namespace NECRO
 
 		if (err != 0)
 		{
-			LOG_ERROR(std::string("Error during TCPSocket::Listen() [" + std::to_string(SocketUtility::GetLastError()) + "]"));
+			MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Listen() [" + std::to_string(SocketUtility::GetLastError()) + "]"));
 			return SocketUtility::GetLastError();
 		}
 
@@ -95,7 +95,7 @@ namespace NECRO
 		{
 			if (!SocketUtility::ErrorIsWouldBlock() && !SocketUtility::ErrorIsIsInProgres())
 			{
-				LOG_ERROR(std::string("Error during TCPSocket::Connect() [") + std::to_string(SocketUtility::GetLastError()) + "]");
+				MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Connect() [") + std::to_string(SocketUtility::GetLastError()) + "]");
 				return SocketUtility::GetLastError();
 			}
 		}
@@ -133,7 +133,7 @@ namespace NECRO
 					if (SocketUtility::ErrorIsWouldBlock())
 						return bytesSentTotal;
 
-					LOG_ERROR(std::string("Error during TCPSocket::Send() [") + std::to_string(SocketUtility::GetLastError()) + "]");
+					MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Send() [") + std::to_string(SocketUtility::GetLastError()) + "]");
 					return -1;
 				}
 			}
@@ -147,7 +147,7 @@ namespace NECRO
 					if (sslError == SSL_ERROR_WANT_READ || sslError == SSL_ERROR_WANT_WRITE)
 						return bytesSentTotal;
 
-					LOG_ERROR(std::string("Error during TCPSocket::Send() [") + std::to_string(sslError) + "]");
+					MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Send() [") + std::to_string(sslError) + "]");
 					return -1;
 				}
 			}
@@ -194,7 +194,7 @@ namespace NECRO
 			//Shutdown();
 			Close();
 
-			LOG_ERROR(std::string("Error during TCPSocket::SysSend() [") + std::to_string(SocketUtility::GetLastError()) + "]");
+			MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::SysSend() [") + std::to_string(SocketUtility::GetLastError()) + "]");
 			return -1;
 		}
 
@@ -209,7 +209,7 @@ namespace NECRO
 		m_inBuffer.CompactData();
 		if (m_inBuffer.EnlargeBufferIfNeeded() != 0)
 		{
-			LOG_ERROR("EnlargeBufferIfNeeded() returned an error!");
+			MLOG_ERROR(NETWORK, "EnlargeBufferIfNeeded() returned an error!");
 			return -1;
 		}
 
@@ -225,7 +225,7 @@ namespace NECRO
 				if (SocketUtility::ErrorIsWouldBlock())
 					return 0;
 
-				LOG_ERROR(std::string("Error during TCPSocket::Receive() [") + std::to_string(SocketUtility::GetLastError()) + "]");
+				MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Receive() [") + std::to_string(SocketUtility::GetLastError()) + "]");
 				return -1;
 			}
 		}
@@ -242,12 +242,12 @@ namespace NECRO
 				else if (sslError == SSL_ERROR_ZERO_RETURN)
 				{
 					// Shutdown gracefully
-					LOG_DEBUG("Received SSL_ERROR_ZERO_RETURN. Shutting down socket gracefully.");
+					MLOG_DEBUG(NETWORK, "Received SSL_ERROR_ZERO_RETURN. Shutting down socket gracefully.");
 					return -1;
 				}
 				else
 				{
-					LOG_ERROR(std::string("Error during TCPSocket::Receive() [") + std::to_string(SocketUtility::GetLastError()) + "]");
+					MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Receive() [") + std::to_string(SocketUtility::GetLastError()) + "]");
 					return -1;
 				}
 			}
@@ -259,7 +259,7 @@ namespace NECRO
 		// Make sure to update the write pos
 		m_inBuffer.WriteCompleted(bytesReceived);
 
-		LOG_INFO("Received {} bytes of something!", bytesReceived);
+		MLOG_INFO(NETWORK, "Received {} bytes of something!", bytesReceived);
 
 		if(ReadCallback() == -1)	// this will handle the data we've received, unless it returns -1 (error)
 			return -1;
@@ -280,7 +280,7 @@ namespace NECRO
 			//Shutdown();
 			Close();
 
-			LOG_ERROR(std::string("Error during TCPSocket::Receive() [") + std::to_string(SocketUtility::GetLastError()) + "]");
+			MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Receive() [") + std::to_string(SocketUtility::GetLastError()) + "]");
 			return -1;
 		}
 
@@ -295,7 +295,7 @@ namespace NECRO
 
 		if (result != 0)
 		{
-			LOG_ERROR(std::string("Error during TCPSocket::SetBlockingEnabled(" + std::to_string(blocking) + ") [") + std::to_string(SocketUtility::GetLastError()) + "]");
+			MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::SetBlockingEnabled(" + std::to_string(blocking) + ") [") + std::to_string(SocketUtility::GetLastError()) + "]");
 			return SocketUtility::GetLastError();
 		}
 
@@ -305,7 +305,7 @@ namespace NECRO
 
 		if (flags == -1)
 		{
-			LOG_ERROR(std::string("Error during TCPSocket::SetBlockingEnabled(" + std::to_string(blocking) + ") [") + std::to_string(SocketUtility::GetLastError()) + "]");
+			MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::SetBlockingEnabled(" + std::to_string(blocking) + ") [") + std::to_string(SocketUtility::GetLastError()) + "]");
 			return SocketUtility::GetLastError();
 		}
 
@@ -315,7 +315,7 @@ namespace NECRO
 
 		if (result != 0)
 		{
-			LOG_ERROR(std::string("Error during TCPSocket::SetBlockingEnabled(" + std::to_string(blocking) + ") [") + std::to_string(SocketUtility::GetLastError()) + "]");
+			MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::SetBlockingEnabled(" + std::to_string(blocking) + ") [") + std::to_string(SocketUtility::GetLastError()) + "]");
 			return SocketUtility::GetLastError();
 		}
 
@@ -329,7 +329,7 @@ namespace NECRO
 
 		if (optResult != 0)
 		{
-			LOG_ERROR(std::string("Error during TCPSocket::SetSocketOption(" + std::to_string(optName) + ") [") + std::to_string(SocketUtility::GetLastError()) + "]");
+			MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::SetSocketOption(" + std::to_string(optName) + ") [") + std::to_string(SocketUtility::GetLastError()) + "]");
 			return SocketUtility::GetLastError();
 		}
 
@@ -347,14 +347,14 @@ namespace NECRO
 		int result = shutdown(m_socket, SD_SEND);
 
 		if (result < 0)
-			LOG_ERROR("Error while shutting down the socket");
+			MLOG_ERROR(NETWORK, "Error while shutting down the socket");
 
 		return result;
 #else
 		int result = shutdown(m_socket, SHUT_WR);
 
 		if (result < 0)
-			LOG_ERROR("Error while shutting down the socket");
+			MLOG_ERROR(NETWORK, "Error while shutting down the socket");
 
 		return result;
 #endif
@@ -380,7 +380,7 @@ namespace NECRO
 		}
 		catch(...)
 		{
-			LOG_CRITICAL("Caught exception while trying to free OpenSSL data.");
+			MLOG_CRITICAL(NETWORK, "Caught exception while trying to free OpenSSL data.");
 		}
 
 #ifdef _WIN32
@@ -436,24 +436,24 @@ namespace NECRO
 
 			if (err == SSL_ERROR_ZERO_RETURN)
 			{
-				LOG_INFO("TLS connection closed by peer during handshake.");
+				MLOG_INFO(NETWORK, "TLS connection closed by peer during handshake.");
 				success = false;
 				break;
 			}
 
 			if (err == SSL_ERROR_SYSCALL)
 			{
-				LOG_ERROR("System call error during TLS handshake. Ret: {}.", ret);
+				MLOG_ERROR(NETWORK, "System call error during TLS handshake. Ret: {}.", ret);
 				success = false;
 				break;
 			}
 
 			// Otherwise, we got an error
-			LOG_ERROR("TLSPerformHandshake failed!");
+			MLOG_ERROR(NETWORK, "TLSPerformHandshake failed!");
 			if (err == SSL_ERROR_SSL)
 			{
 				if (SSL_get_verify_result(m_ssl) != X509_V_OK)
-					LOG_ERROR("Verify error: {}\n", X509_verify_cert_error_string(SSL_get_verify_result(m_ssl)));
+					MLOG_ERROR(NETWORK, "Verify error: {}\n", X509_verify_cert_error_string(SSL_get_verify_result(m_ssl)));
 
 				success = false;
 			}
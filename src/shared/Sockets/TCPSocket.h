@@ -109,7 +109,7 @@ namespace NECRO
 			{
 				if (!SocketUtility::ErrorIsWouldBlock())
 				{
-					LOG_ERROR(std::string("Error during TCPSocket::Accept()"));
+					MLOG_ERROR(NETWORK, std::string("Error during TCPSocket::Accept()"));
 				}
 				return nullptr;
 			}
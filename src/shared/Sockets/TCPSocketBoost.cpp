@@ -84,7 +84,7 @@ namespace NECRO
 					}
 					else
 					{
-						LOG_ERROR("Error during handshake: {}", ec.what());
+						MLOG_ERROR(NETWORK, "Error during handshake: {}", ec.what());
 						m_UnderlyingState = UnderlyingState::CRITICAL_ERROR;
 					}
 				});
@@ -101,7 +101,7 @@ namespace NECRO
 		m_inBuffer.CompactData();
 		if (m_inBuffer.EnlargeBufferIfNeeded() != 0)
 		{
-			LOG_ERROR("EnlargeBufferIfNeeded() returned an error!");
+			MLOG_ERROR(NETWORK, "EnlargeBufferIfNeeded() returned an error!");
 			CloseSocket();
 			return;
 		}
@@ -123,7 +123,7 @@ namespace NECRO
 	{
 		if (err)
 		{
-			LOG_ERROR("ERROR ON InternalReadCallback {}. SHUTTING DOWN SOCKET!", err.what());
+			MLOG_ERROR(NETWORK, "ERROR ON InternalReadCallback {}. SHUTTING DOWN SOCKET!", err.what());
 			CloseSocket();
 		}
 		else
@@ -132,7 +132,7 @@ namespace NECRO
 
 			if (AsyncReadCallback() == -1)
 			{
-				LOG_DEBUG("ERROR ON InternalReadCallback! AsyncReadCallback returned -1!");
+				MLOG_DEBUG(NETWORK, "ERROR ON InternalReadCallback! AsyncReadCallback returned -1!");
 				CloseSocket();
 			}
 		}
@@ -190,7 +190,7 @@ namespace NECRO
 	{
 		if (err)
 		{
-			LOG_ERROR("ERROR ON InternalWriteCallback {}. SHUTTING DOWN SOCKET!", err.what());
+			MLOG_ERROR(NETWORK, "ERROR ON InternalWriteCallback {}. SHUTTING DOWN SOCKET!", err.what());
 			CloseSocket();
 		}
 		else
@@ -233,7 +233,7 @@ namespace NECRO
 			if (ec == boost::asio::error::operation_aborted)
 				return;
 
-			LOG_DEBUG("TLS shutdown timed out, forcing close.");
+			MLOG_DEBUG(NETWORK, "TLS shutdown timed out, forcing close.");
 			ForceCloseSocket();
 		});
 
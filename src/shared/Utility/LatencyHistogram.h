@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <array>
+
+namespace NECRO
+{
+// -----------------------------------------------------------------------------------------------------------------------------
+// Lock-free histogram of durations (or any uint64_t sample) with power of two buckets.
+// Bucket 0 holds the samples equal to 0, bucket i holds the samples in [2^(i-1), 2^i).
+//
+// Record() can be called from any thread, readers (reports, scraping) can read concurrently. Percentiles are approximated
+// to the upper bound of the bucket they fall in (clamped to the max recorded sample).
+// -----------------------------------------------------------------------------------------------------------------------------
+class LatencyHistogram
+{
+public:
+	static constexpr size_t BUCKETS_N = 64;
+
+	// Plain copy of the histogram, used to compute stats without racing with writers
+	struct Snapshot
+	{
+		std::array<uint64_t, BUCKETS_N> buckets{};
+		uint64_t count = 0;
+		uint64_t sum = 0;
+		uint64_t max = 0;
+
+		uint64_t Percentile(double p) const
+		{
+			if (count == 0)
+				return 0;
+
+			uint64_t target = static_cast<uint64_t>(p * count);
+			if (target >= count)
+				target = count - 1;
+
+			uint64_t seen = 0;
+			for (size_t i = 0; i < BUCKETS_N; i++)
+			{
+				seen += buckets[i];
+				if (seen > target)
+				{
+					uint64_t upperBound = (i == 0) ? 0 : ((1ULL << i) - 1);
+					return upperBound < max ? upperBound : max;
+				}
+			}
+
+			return max;
+		}
+
+		uint64_t Avg() const
+		{
+			return count > 0 ? sum / count : 0;
+		}
+	};
+
+private:
+	std::array<std::atomic<uint64_t>, BUCKETS_N> m_buckets{};
+	std::atomic<uint64_t> m_count{0};
+	std::atomic<uint64_t> m_sum{0};
+	std::atomic<uint64_t> m_max{0};
+
+	static size_t BucketFor(uint64_t v)
+	{
+		size_t b = 0;
+		while (v > 0 && b < BUCKETS_N - 1)
+		{
+			v >>= 1;
+			b++;
+		}
+		return b;
+	}
+
+public:
+	void Record(uint64_t v)
+	{
+		m_buckets[BucketFor(v)].fetch_add(1, std::memory_order_relaxed);
+		m_count.fetch_add(1, std::memory_order_relaxed);
+		m_sum.fetch_add(v, std::memory_order_relaxed);
+
+		uint64_t curMax = m_max.load(std::memory_order_relaxed);
+		while (v > curMax && !m_max.compare_exchange_weak(curMax, v, std::memory_order_relaxed))
+			;
+	}
+
+	// Copies the current values. If reset is true the histogram restarts from zero (used by periodic reports)
+	Snapshot TakeSnapshot(bool reset)
+	{
+		Snapshot s;
+		for (size_t i = 0; i < BUCKETS_N; i++)
+			s.buckets[i] = reset ? m_buckets[i].exchange(0, std::memory_order_relaxed) : m_buckets[i].load(std::memory_order_relaxed);
+
+		s.count = reset ? m_count.exchange(0, std::memory_order_relaxed) : m_count.load(std::memory_order_relaxed);
+		s.sum = reset ? m_sum.exchange(0, std::memory_order_relaxed) : m_sum.load(std::memory_order_relaxed);
+		s.max = reset ? m_max.exchange(0, std::memory_order_relaxed) : m_max.load(std::memory_order_relaxed);
+		return s;
+	}
+};
+}
@@ -0,0 +1,61 @@
+#include "ProcessMemory.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cstdio>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+namespace NECRO
+{
+namespace Utility
+{
+	size_t GetCurrentRSS()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters{};
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+
+		return static_cast<size_t>(counters.WorkingSetSize);
+#else
+		// Second field of statm is the resident set, in pages
+		FILE* statm = std::fopen("/proc/self/statm", "r");
+		if (!statm)
+			return 0;
+
+		long pages = 0;
+		long resident = 0;
+		int read = std::fscanf(statm, "%ld %ld", &pages, &resident);
+		std::fclose(statm);
+
+		if (read != 2)
+			return 0;
+
+		return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+
+	size_t GetPeakRSS()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters{};
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+
+		return static_cast<size_t>(counters.PeakWorkingSetSize);
+#else
+		rusage usage{};
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0;
+
+		// ru_maxrss is in kilobytes on Linux
+		return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+	}
+}
+}
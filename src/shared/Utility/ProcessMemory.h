@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+namespace NECRO
+{
+namespace Utility
+{
+	// Resident memory (working set on Windows) of this process, in bytes. 0 if it can't be read
+	size_t GetCurrentRSS();
+
+	// Highest resident memory this process reached so far, in bytes. 0 if it can't be read
+	size_t GetPeakRSS();
+}
+}
@@ -0,0 +1,5 @@
+-- Character names are unique (case-insensitive, as the column collation).
+-- CHAR_INS_CHARACTER_IF_NAME_FREE relies on this key to reject a taken name atomically.
+-- Rename any duplicated name before applying it, or the ALTER fails.
+ALTER TABLE `necrochars`.`characters`
+  ADD UNIQUE KEY `name_UNIQUE` (`name`);